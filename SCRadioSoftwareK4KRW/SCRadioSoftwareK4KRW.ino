@@ -41,9 +41,9 @@
  * programming anyway.  But, for now, I'm using traditional C strings which are null terminated character
  * arrays.  This means that this app uses pointers.  I was hoping to avoid that as much as possible, but ...
  * 
- * I would love it if the EventManager was enhanced to allow me to allocate handlers that were object instance methods.
- * I may contact the author to see if he has any interest. This would allow me to create instances of each object at 
- * whatever scope I wanted rather than making all of the objects globals.
+ * The EventManager library could only call plain functions, so every listener used to need a global function
+ * that called the right object's method.  Events are now routed straight to object methods by
+ * EventDispatcher (below).  The objects still have to be globals for that to work.
  * 
  * Ideally I'd love it if you could pass a read only reference to the object sending the message to the listener.  
  * This is easy to do in C# as all classes are derived from 'Object'.  So that reference is passed as an 'Object' 
@@ -57,25 +57,32 @@
  * Check all defines for settings in SCRadioConstants.h before using this application
  * Defines may need adjustment depending on your specific hardware and your preferences.
  * 
- * See notes below about EventManager.h defines
+ * See notes below about the event queue settings
  */
 
 #include <Arduino.h>
 #include <LiquidCrystal_I2C.h>
-#include <EventManager.h>
+#include <SCRadioEventQueue.h>
+#include <SCRadioEventDispatcher.h>
 #include <SCRadioConstants.h>
 #include <SCRadioButton.h>
 #include <SCRadioMainKnob.h>
 #include <SCRadioDisplay.h>
 #include <SCRadioEventData.h>
 #include <SCRadioVFO.h>
+#include <SCRadioTuningAccelerator.h>
 #include <SCRadioDDS.h>
+#include <SCRadioTxRxSequencer.h>
 #include <SCRadioKeyer.h>
+#include <SCRadioCWMessage.h>
+#include <SCRadioSidetone.h>
 #include <SCRadioEEPROM.h>
 #include <SCRadioMenu.h>
 #include <SCRadioMenuItem.h>
 #include <SCRadioMenuItemNameValue.h>
 #include <SCRadioVoltageMonitor.h>
+#include <SCRadioLoopProfiler.h>
+#include <SCRadioEventTrace.h>
 
 // Forwards definitions for functions in main .ino file.  This allows the actual 
 // function definitions to fall below the main application logic (setup and loop) 
@@ -85,6 +92,9 @@ void retrieveInitialFrequency();
 void setupInitialKeyerMode();
 void setupInitialKeyerSpeed();
 void setupInitialPaddlesOrientation();
+void setupInitialSidetone();
+void setupInitialKeyerTiming();
+int32_t storedValueOrDefault(SCRadioMenuItem &menuItem, int32_t storedValue, int32_t defaultValue);
 
 int32_t checkInitialFrequency(int32_t initialFrequency);
 
@@ -95,37 +105,16 @@ void setupBacklightOnOffMenuItem();
 
 void setupRxOffsetDirectionMenuItem();
 void setupKeyerModeMenuItem();
+void setupKeyerMessageMenuItem();
 void setupKeyerSpeedMenuItem();
+void setupKeyerTimingMenuItems();
 void setupPaddlesOrientationMenuItem();
+void setupSidetoneMenuItems();
+void setupQSKHangMenuItem();
+void processSerialCommands();
 
-void vfoKnobTurnedListener(int eventCode, int turnDirection);
-void ritKnobTurnedListener(int eventCode, int turnDirection);
-void displayFrequencyChangedListener(int eventCode, int eventLongIndex);
-void displayRitChangedListener(int eventCode, int eventLongIndex);
-void eepromFrequencyChangedListener(int eventCode, int eventLongIndex);
-void vfoKeyLineChangedListener(int eventCode, int keyStatus);
-void displayMainKnobModeChangedListener(int eventCode, int newMode);
-void displayMenuItemSelectedListener(int eventCode, int menuItemNumber);
-void displayMenuItemValueChangedListener(int eventCode, int whichMenuItem);
-void menuKnobTurnedListener(int eventCode, int turnDirection);
-void menuItemKnobTurnedListener(int eventCode, int turnDirection);
-void vfoRxOffsetDirectionChangedListener(int eventCode, int whichMenuItem);
-void displayErrorOccurredListener(int eventCode, int whichErrorType);
-void displayVoltageReadListener(int eventCode, int voltageX10);
-void keyerModeChangedListener(int eventCode, int whichMenuItem);
-void keyerSpeedChangedListener(int eventCode, int whichMenuItem);
-void keyerPaddlesOrientationChangedListener(int eventCode, int whichMenuItem);
-void eepromKeyerModeChangedListener(int eventCode, int whichMenuItem);
-void eepromKeyerSpeedChangedListener(int eventCode, int whichMenuItem);
-void eepromPaddlesOrientationChangedListener(int eventCode, int whichMenuItem);
-
-// Forwards for listeners for optional settings
-void vfoRitStatusChangedListener(int eventCode, int whichMenuItem);
-void displayBacklightStatusChangedListener(int eventCode, int whichMenuItem);
-void ritMenuItemExternallyChangedListener(int eventCode, int newValue);
-
-// This is the library that implements the event queue
-EventManager eventManager = EventManager();
+// This is the event queue.  Events are queued here and handed to the listeners by EventDispatcher (below)
+SCRadioEventQueue eventManager = SCRadioEventQueue();
 
 // This is data that various components may need when firing or responding to events
 SCRadioEventData eventData = SCRadioEventData();
@@ -155,18 +144,37 @@ SCRadioDisplay lcdControl = SCRadioDisplay(eventData,
 											SPLASH_DELAY);
 
 // Controls writing to and reading from EEPROM's persistent memory
-SCRadioEEPROM eeprom = SCRadioEEPROM(eventData, 
-									MIN_EPROM_WRITE_INTERVAL);
+SCRadioEEPROM eeprom = SCRadioEEPROM(MIN_EPROM_WRITE_INTERVAL);
 
 // Interaction logic for sending commands to the DDS
 SCRadioDDS dds = SCRadioDDS(DDS_WORD_LOAD_CLOCK_PIN,
                             DDS_FREQUENCY_UPDATE_PIN,
                             DDS_DATA_PIN,
                             DDS_RESET_PIN,
-                            DDS_TUNING_WORD);
+                            DDS_TUNING_WORD_MILLIONTHS,
+                            DDS_TRANSPORT);
+
+// Switches the rig between receive and transmit.  The DDS goes to the transmit frequency
+// before the transmitter is keyed, and back to receive once the hang time is over.
+SCRadioTxRxSequencer txRxSequencer = SCRadioTxRxSequencer(dds, KEY_OUT_PIN, QSK_DEFAULT_HANG_MS);
+
+// Messages the keyer can send.  Turned into Morse when the sketch is compiled and kept in flash.
+CW_MESSAGE(cqMessage, CW_MESSAGE_CQ_TEXT);
+CW_MESSAGE(beaconMessage, CW_MESSAGE_BEACON_TEXT);
+
+// In the order they appear in the 'Kyr Msg' menu item (after 'Off')
+const SCRadioCWStoredMessage keyerMessages[] = {
+	{ cqMessage.codes, 0 },
+	{ beaconMessage.codes, CW_MESSAGE_BEACON_REPEAT_SECONDS }
+};
 
 // Handles input from the CW key
-SCRadioKeyer keyer = SCRadioKeyer(eventManager, eventData);
+SCRadioKeyer keyer = SCRadioKeyer(eventManager,
+									keyerMessages,
+									sizeof(keyerMessages) / sizeof(keyerMessages[0]));
+
+// Makes the tone you hear while the key is down
+SCRadioSidetone sidetone = SCRadioSidetone(SIDETONE_PIN, SIDETONE_DEFAULT_PITCH_HZ, SIDETONE_DEFAULT_VOLUME);
 
 // periodically checks the rig's voltage
 SCRadioVoltageMonitor voltageMonitor = SCRadioVoltageMonitor(eventManager,
@@ -175,41 +183,145 @@ SCRadioVoltageMonitor voltageMonitor = SCRadioVoltageMonitor(eventManager,
 										EventType::RIG_VOLTAGE_CHANGED,
 										LOOP_COUNT_BETWEEN_RIG_VOLTAGE_READS);
 
+// The acceleration curve for tuning.  The faster the knob turns, the bigger the tuning step.
+// Fastest row first.  Add rows for more steps.  The last row (0xFFFF) catches everything slower.
+const SCRadioTuningCurvePoint tuningCurve[] = {
+	{ TUNING_THRESHOLD_FAST, TUNING_INCREMENT_FAST },
+	{ TUNING_THRESHOLD_MEDIUM, TUNING_INCREMENT_MEDIUM },
+	{ 0xFFFF, TUNING_INCREMENT_SLOW }
+};
+
+// Picks the tuning step from how fast the knob is turning
+SCRadioTuningAccelerator tuningAccelerator = SCRadioTuningAccelerator(tuningCurve,
+											sizeof(tuningCurve) / sizeof(tuningCurve[0]),
+											TUNING_SMOOTHING_SHIFT);
+
 // This controls all having to do with frequency
 // Changing frequency.  Calculating TX and RX frequency, RIT ...
 SCRadioVFO vfo = SCRadioVFO(eventManager,
             eventData,
-            dds,
-            KEY_OUT_PIN,
-            DDS_TUNING_WORD,
+            txRxSequencer,
             RX_OFFSET,
             VFO_LIMIT_LOW,
             VFO_LIMIT_HIGH,
             RIT_MAX_OFFSET_HZ,
-            TUNING_INCREMENT_SLOW,
-            TUNING_INCREMENT_MEDIUM,
-            TUNING_INCREMENT_FAST,
-            TUNING_THRESHOLD_MEDIUM,
-            TUNING_THRESHOLD_FAST);
+            tuningAccelerator);
 
 // This controls the meny system
 SCRadioMenu menu = SCRadioMenu(eventManager, eventData);
 
 // The following are menu items used by the menu
-SCRadioMenuItem keyerSpeedMenuItem = SCRadioMenuItem(eventManager, 12, 1, 0, 30);
+SCRadioMenuItem keyerSpeedMenuItem = SCRadioMenuItem(eventManager, 12, 1, 5, 30);
+
+SCRadioMenuItem keyerEffectiveSpeedMenuItem = SCRadioMenuItem(eventManager, KEYER_DEFAULT_EFFECTIVE_WPM, 1, 0, 30);
+
+SCRadioMenuItem keyerDahRatioMenuItem = SCRadioMenuItem(eventManager, KEYER_DEFAULT_DAH_RATIO_TENTHS, 1, 25, 45);
+
+SCRadioMenuItem keyerCompensationMenuItem = SCRadioMenuItem(eventManager, KEYER_DEFAULT_COMPENSATION_MICROS, 100, 0, 5000);
+
+SCRadioMenuItem sidetonePitchMenuItem = SCRadioMenuItem(eventManager, SIDETONE_DEFAULT_PITCH_HZ, 10, SIDETONE_MIN_PITCH_HZ, SIDETONE_MAX_PITCH_HZ);
+
+SCRadioMenuItem sidetoneVolumeMenuItem = SCRadioMenuItem(eventManager, SIDETONE_DEFAULT_VOLUME, 1, 0, SIDETONE_MAX_VOLUME);
 
-SCRadioMenuItemNameValue keyerModeMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 2);
+SCRadioMenuItem qskHangMenuItem = SCRadioMenuItem(eventManager, QSK_DEFAULT_HANG_MS, 10, 0, QSK_MAX_HANG_MS);
+
+SCRadioMenuItemNameValue keyerModeMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 4);
 
 SCRadioMenuItemNameValue rxOffsetDirectionMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 1);
 
 SCRadioMenuItemNameValue paddlesOrientationMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 1);
 
+// Off plus one choice for each of the keyer's messages
+SCRadioMenuItemNameValue keyerMessageMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 2);
+
 // Optional menu items.  IF you want to free up some data memory.  Removing these would 
 // have little cost in functionality
 SCRadioMenuItemNameValue ritOnOffMenuItem = SCRadioMenuItemNameValue(eventManager, 0, 0, 1);
 
 SCRadioMenuItemNameValue backlightOnOffMenuItem = SCRadioMenuItemNameValue(eventManager, 1, 0, 1);
 
+// Times each part of the main loop.  Only does anything when LOOP_PROFILER_ENABLED is 1
+SCRadioLoopProfiler loopProfiler = SCRadioLoopProfiler();
+
+// Here we are telling the eventManager all of the methods that will be listening for event messages
+//
+// Each route lists the methods called for one event type, in the order they are called.
+// This is worked out when the sketch is compiled, so it takes no data memory and there
+// is no limit on how many listeners there can be.  The objects must be declared above.
+//
+// The routes are checked in order, so the ones that need to happen fastest (the key line
+// and the knob) are first.
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED,
+		EVENT_HANDLER(vfo, keyLineChangedListener),
+		EVENT_HANDLER(sidetone, keyLineChangedListener)>,
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED,
+		EVENT_HANDLER(vfo, vfoKnobTurnedListener)>,
+	SCRadioEventRoute<EventType::RIT_KNOB_TURNED,
+		EVENT_HANDLER(vfo, ritKnobTurnedListener)>,
+	SCRadioEventRoute<EventType::FREQUENCY_CHANGED,
+		EVENT_HANDLER(lcdControl, frequencyChangedListener),
+		EVENT_HANDLER(eeprom, frequencyChangedListener)>,
+	SCRadioEventRoute<EventType::RIT_CHANGED,
+		EVENT_HANDLER(lcdControl, ritChangedListener)>,
+	SCRadioEventRoute<EventType::MAIN_KNOB_MODE_CHANGED,
+		EVENT_HANDLER(lcdControl, mainKnobModeChangedListener)>,
+	SCRadioEventRoute<EventType::MENU_KNOB_TURNED,
+		EVENT_HANDLER(menu, menuKnobTurnedListener)>,
+	SCRadioEventRoute<EventType::MENU_ITEM_KNOB_TURNED,
+		EVENT_HANDLER(menu, menuItemKnobTurnedListener)>,
+	SCRadioEventRoute<EventType::MENU_ITEM_SELECTED,
+		EVENT_HANDLER(lcdControl, menuItemSelectedListener)>,
+	SCRadioEventRoute<EventType::MENU_ITEM_VALUE_CHANGED,
+		EVENT_HANDLER(lcdControl, menuItemValueChangedListener)>,
+	SCRadioEventRoute<EventType::RX_OFFSET_DIRECTION_MENU_ITEM_VALUE_CHANGED,
+		EVENT_HANDLER(vfo, rxOffsetDirectionChangedListener)>,
+	SCRadioEventRoute<EventType::ERROR_OCCURRED,
+		EVENT_HANDLER(lcdControl, errorOccurredListener)>,
+	SCRadioEventRoute<EventType::ERROR_CLEARED,
+		EVENT_HANDLER(lcdControl, errorClearedListener)>,
+	SCRadioEventRoute<EventType::RIG_VOLTAGE_CHANGED,
+		EVENT_HANDLER(lcdControl, voltageReadListener)>,
+	SCRadioEventRoute<EventType::KEYER_MODE_CHANGED,
+		EVENT_HANDLER(keyer, keyerModeChangedListener),
+		EVENT_HANDLER(eeprom, keyerModeChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_SPEED_CHANGED,
+		EVENT_HANDLER(keyer, keyerSpeedChangedListener),
+		EVENT_HANDLER(eeprom, keyerSpeedChangedListener)>,
+	SCRadioEventRoute<EventType::PADDLES_ORIENTATION_CHANGED,
+		EVENT_HANDLER(keyer, keyerPaddlesOrientationChangedListener),
+		EVENT_HANDLER(eeprom, paddlesOrientationChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_EFFECTIVE_SPEED_CHANGED,
+		EVENT_HANDLER(keyer, keyerEffectiveSpeedChangedListener),
+		EVENT_HANDLER(eeprom, keyerEffectiveSpeedChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_DAH_RATIO_CHANGED,
+		EVENT_HANDLER(keyer, keyerDahRatioChangedListener),
+		EVENT_HANDLER(eeprom, keyerDahRatioChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_COMPENSATION_CHANGED,
+		EVENT_HANDLER(keyer, keyerCompensationChangedListener),
+		EVENT_HANDLER(eeprom, keyerCompensationChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_MESSAGE_CHANGED,
+		EVENT_HANDLER(keyer, keyerMessageChangedListener)>,
+	SCRadioEventRoute<EventType::KEYER_MESSAGE_EXTERNALLY_CHANGED,
+		EVENT_HANDLER(keyerMessageMenuItem, menuItemExternallyChangedListener)>,
+	SCRadioEventRoute<EventType::SIDETONE_PITCH_CHANGED,
+		EVENT_HANDLER(sidetone, pitchChangedListener),
+		EVENT_HANDLER(eeprom, sidetonePitchChangedListener)>,
+	SCRadioEventRoute<EventType::SIDETONE_VOLUME_CHANGED,
+		EVENT_HANDLER(sidetone, volumeChangedListener),
+		EVENT_HANDLER(eeprom, sidetoneVolumeChangedListener)>,
+	SCRadioEventRoute<EventType::QSK_HANG_TIME_CHANGED,
+		EVENT_HANDLER(txRxSequencer, hangTimeChangedListener)>,
+
+	// routes for optional menu items
+	SCRadioEventRoute<EventType::RIT_MENU_ITEM_VALUE_CHANGED,
+		EVENT_HANDLER(vfo, ritStatusChangedListener)>,
+	SCRadioEventRoute<EventType::BACKLIGHT_MENU_ITEM_VALUE_CHANGED,
+		EVENT_HANDLER(lcdControl, backlightStatusChangedListener)>,
+	SCRadioEventRoute<EventType::RIT_STATUS_EXTERNALLY_CHANGED,
+		EVENT_HANDLER(ritOnOffMenuItem, menuItemExternallyChangedListener)>
+> EventDispatcher;
+
 /**
  * setup
  * 
@@ -229,6 +341,7 @@ void setup()
 	lcdControl.setSplashText(SPLASH_LINE_1, SPLASH_LINE_2);
 	lcdControl.setStuckKeyErrorText(STUCK_KEY_TEXT);
 	keyer.begin();
+	sidetone.begin();
 	dds.begin();
 	vfo.begin();
 
@@ -245,8 +358,19 @@ void setup()
 	setupKeyerModeMenuItem();
 	keyerSpeedMenuItem.begin();
 	setupKeyerSpeedMenuItem();
+	keyerEffectiveSpeedMenuItem.begin();
+	keyerDahRatioMenuItem.begin();
+	keyerCompensationMenuItem.begin();
+	setupKeyerTimingMenuItems();
 	paddlesOrientationMenuItem.begin();
 	setupPaddlesOrientationMenuItem();
+	sidetonePitchMenuItem.begin();
+	sidetoneVolumeMenuItem.begin();
+	setupSidetoneMenuItems();
+	qskHangMenuItem.begin();
+	setupQSKHangMenuItem();
+	keyerMessageMenuItem.begin();
+	setupKeyerMessageMenuItem();
 
 	// Option menu items setup
 	ritOnOffMenuItem.begin();
@@ -258,7 +382,14 @@ void setup()
 	// in the menu
 	menu.addMenuItem(keyerSpeedMenuItem);
 	menu.addMenuItem(keyerModeMenuItem);
+	menu.addMenuItem(keyerEffectiveSpeedMenuItem);
+	menu.addMenuItem(keyerDahRatioMenuItem);
+	menu.addMenuItem(keyerCompensationMenuItem);
 	menu.addMenuItem(paddlesOrientationMenuItem);
+	menu.addMenuItem(sidetonePitchMenuItem);
+	menu.addMenuItem(sidetoneVolumeMenuItem);
+	menu.addMenuItem(qskHangMenuItem);
+	menu.addMenuItem(keyerMessageMenuItem);
 	menu.addMenuItem(rxOffsetDirectionMenuItem);
 	menu.addMenuItem(ritOnOffMenuItem);
 
@@ -270,49 +401,17 @@ void setup()
 	setupInitialKeyerMode();
 	setupInitialKeyerSpeed();
 	setupInitialPaddlesOrientation();
-
-	// Here we are telling the eventManager all of the methods that will be listening for event messages
-	//
-	// IMPORTANT!!
-	// There is a constant in EventManager.h that specifies how many listeners there can be.
-	// EVENTMANAGER_LISTENER_LIST_SIZE - (determines size of an array)
-	// You must ensure that you adjust that value to allow for all of the messages listeners
-	// you will register.
-	//
-	// As of release date of this software, the setting needed to be at least 15.  However
-	//  these do take up memory.  So don't specify more than you are going to use.
-	//
-	eventManager.addListener(static_cast<int>(EventType::VFO_KNOB_TURNED), &vfoKnobTurnedListener);  
-	eventManager.addListener(static_cast<int>(EventType::RIT_KNOB_TURNED), &ritKnobTurnedListener);
-	eventManager.addListener(static_cast<int>(EventType::RIT_CHANGED), &displayRitChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::FREQUENCY_CHANGED), &displayFrequencyChangedListener);  
-	eventManager.addListener(static_cast<int>(EventType::FREQUENCY_CHANGED), &eepromFrequencyChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::KEY_LINE_CHANGED), &vfoKeyLineChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::MAIN_KNOB_MODE_CHANGED), &displayMainKnobModeChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::MENU_KNOB_TURNED), &menuKnobTurnedListener);
-	eventManager.addListener(static_cast<int>(EventType::MENU_ITEM_KNOB_TURNED), &menuItemKnobTurnedListener);
-	eventManager.addListener(static_cast<int>(EventType::MENU_ITEM_SELECTED), &displayMenuItemSelectedListener);
-	eventManager.addListener(static_cast<int>(EventType::MENU_ITEM_VALUE_CHANGED), &displayMenuItemValueChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::RX_OFFSET_DIRECTION_MENU_ITEM_VALUE_CHANGED), &vfoRxOffsetDirectionChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::ERROR_OCCURRED), &displayErrorOccurredListener);
-	eventManager.addListener(static_cast<int>(EventType::RIG_VOLTAGE_CHANGED), &displayVoltageReadListener);
-	eventManager.addListener(static_cast<int>(EventType::KEYER_MODE_CHANGED), &keyerModeChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::KEYER_SPEED_CHANGED), &keyerSpeedChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::PADDLES_ORIENTATION_CHANGED), &keyerPaddlesOrientationChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::KEYER_MODE_CHANGED), &eepromKeyerModeChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::KEYER_SPEED_CHANGED), &eepromKeyerSpeedChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::PADDLES_ORIENTATION_CHANGED), &eepromPaddlesOrientationChangedListener);
-
-	// add listeners for optional menu items
-	eventManager.addListener(static_cast<int>(EventType::RIT_MENU_ITEM_VALUE_CHANGED), &vfoRitStatusChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::BACKLIGHT_MENU_ITEM_VALUE_CHANGED), &displayBacklightStatusChangedListener);
-	eventManager.addListener(static_cast<int>(EventType::RIT_STATUS_EXTERNALLY_CHANGED), &ritMenuItemExternallyChangedListener);
+	setupInitialSidetone();
+	setupInitialKeyerTiming();
 
 	// The last thing we do before starting up is displaying the splash.
 	lcdControl.displaySplash();
 
-	// This message kicks off things for the VFO and ends up forcing the frequency to be displayed on the display
-	eventManager.queueEvent(static_cast<int>(EventType::VFO_KNOB_TURNED), static_cast<int>(KnobTurnDirection::CLOCKWISE), EventManager::kHighPriority);
+	loopProfiler.begin();
+
+	// This message (one step clockwise) kicks off things for the VFO and ends up forcing the frequency to be displayed on the display
+	// (0xFFFF means the speed is not known, so it tunes the slow step)
+	eventManager.queueOrMergeKnobTurnEvent(static_cast<int>(EventType::VFO_KNOB_TURNED), static_cast<int>(KnobTurnDirection::CLOCKWISE), 0xFFFF, SCRadioEventQueue::kHighPriority);
 }
 
 
@@ -328,32 +427,64 @@ void setup()
  */
 void loop() 
 {
-	// Handles checking status of the CW keyer.
+	// The loopProfiler calls time each part of the loop (see SCRadioLoopProfiler.h)
+	// They do nothing unless LOOP_PROFILER_ENABLED is 1
+	loopProfiler.startLoop();
+
+	// Checks for commands from the serial monitor to print the switching times, the loop timings or the event trace
+	processSerialCommands();
+
+	// Handles the CW keyer's error reporting.  The keying itself runs from a timer interrupt.
 	keyer.loop();
+	loopProfiler.endStage(LoopStage::KEYER);
 
 	// Handles checking status of the main knob (knob and button)
 	mainKnob.loop();
+	loopProfiler.endStage(LoopStage::MAIN_KNOB);
+
+	// Shifts the next byte of any frequency change waiting for the DDS out to it.
+	// A frame takes a few passes.  Key down doesn't wait for them (see SCRadioTxRxSequencer).
+	dds.loop();
+	loopProfiler.endStage(LoopStage::DDS);
+
+	// Keys the transmitter once the DDS is on the transmit frequency, and goes back
+	// to the receive frequency once the hang time is over.
+	vfo.loop();
+	loopProfiler.endStage(LoopStage::VFO);
 
 	// Handles checking to see if items need to be persisted to the EEPROM memory.
 	eeprom.loop();
+	loopProfiler.endStage(LoopStage::EEPROM);
 
 	// periodically checks rig voltage
 	voltageMonitor.loop();
+	loopProfiler.endStage(LoopStage::VOLTAGE_MONITOR);
 
-	// The eventManager goes through the events message queue and calls handlers who have registered for each event it finds
-	// in the queue.
+	// The eventManager goes through the events message queue and hands each event it finds to
+	// EventDispatcher, which calls the listeners for that event.
+	//
+	// processEventsWithinBudget() handles events for up to EVENT_PROCESSING_BUDGET_MICROS, a few at a time,
+	// so a burst of menu, display and EEPROM events can't hold up the rest of the loop.  High priority
+	// events (the key line and the knob) always go first, even ones queued part way through.  Anything
+	// left waits for the next loop.
 	//
-	// I have been calling processAllEvents().  This makes it process everything it finds during each loop
-	// You can have it only process one message each time it is called.
-	// I have not had time to test to see how far the event queue backs up.
-	// Right now if more than 8 events queued up, it would blow through the event message array and start
-	// corrupting application memory.  (Author may handle this.  I just haven't look at his code in that kind of detail)
+	// Setting EVENT_PROCESSING_BUDGET_MICROS to 0 goes back to processAllEvents().  This makes it process
+	// everything it finds during each loop.  You can also have it only process one message each time it is called.
 	//
-	// There are methods in eventManager to get the status of it.  I will incorporate checks at some point and build
-	// it into my logic so the app displays an error if something goes past the limits.
+	// Each priority can hold EVENT_QUEUE_SIZE events (see SCRadioConstants.h).  If one fills up, new
+	// events are dropped rather than written over memory.  getDroppedEventCount() and getHighWaterMark()
+	// tell you if that has happened and how close it has come.
+	//
+	// At some point I will build those checks into my logic so the app displays an error if 
+	// something goes past the limits.
 
-	eventManager.processAllEvents();
-//	eventManager.processEvent();
+#if EVENT_PROCESSING_BUDGET_MICROS > 0
+	eventManager.processEventsWithinBudget<EventDispatcher>(EVENT_PROCESSING_BUDGET_MICROS);
+#else
+	eventManager.processAllEvents<EventDispatcher>();
+#endif
+//	eventManager.processEvent<EventDispatcher>();
+	loopProfiler.endStage(LoopStage::EVENTS);
 }
 
 /**
@@ -425,6 +556,77 @@ void setupInitialPaddlesOrientation()
 	paddlesOrientationMenuItem.setMenuItemValue(initialPaddlesOrientation);
 }
 
+/**
+ * setupInitialSidetone
+ * 
+ * @detail
+ *   Gets last sidetone pitch and volume from EEPROM memory
+ *   and sets up app to use them
+ */
+void setupInitialSidetone()
+{
+	int16_t initialSidetonePitch = storedValueOrDefault(sidetonePitchMenuItem,
+		eeprom.readStoredSidetonePitch(), SIDETONE_DEFAULT_PITCH_HZ);
+
+	sidetone.setPitch(initialSidetonePitch);
+
+	sidetonePitchMenuItem.setMenuItemValue(initialSidetonePitch);
+
+	int8_t initialSidetoneVolume = storedValueOrDefault(sidetoneVolumeMenuItem,
+		eeprom.readStoredSidetoneVolume(), SIDETONE_DEFAULT_VOLUME);
+
+	sidetone.setVolume(initialSidetoneVolume);
+
+	sidetoneVolumeMenuItem.setMenuItemValue(initialSidetoneVolume);
+}
+
+/**
+ * setupInitialKeyerTiming
+ * 
+ * @detail
+ *   Gets last keyer effective speed, dah ratio and compensation from EEPROM memory
+ *   and sets up app to use them
+ */
+void setupInitialKeyerTiming()
+{
+	int8_t initialEffectiveWPM = storedValueOrDefault(keyerEffectiveSpeedMenuItem,
+		eeprom.readStoredKeyerEffectiveSpeed(), KEYER_DEFAULT_EFFECTIVE_WPM);
+
+	keyer.setKeyerEffectiveWPM(initialEffectiveWPM);
+
+	keyerEffectiveSpeedMenuItem.setMenuItemValue(initialEffectiveWPM);
+
+	int8_t initialDahRatio = storedValueOrDefault(keyerDahRatioMenuItem,
+		eeprom.readStoredKeyerDahRatio(), KEYER_DEFAULT_DAH_RATIO_TENTHS);
+
+	keyer.setDahRatio(initialDahRatio);
+
+	keyerDahRatioMenuItem.setMenuItemValue(initialDahRatio);
+
+	int16_t initialCompensation = storedValueOrDefault(keyerCompensationMenuItem,
+		eeprom.readStoredKeyerCompensation(), KEYER_DEFAULT_COMPENSATION_MICROS);
+
+	keyer.setCompensation(initialCompensation);
+
+	keyerCompensationMenuItem.setMenuItemValue(initialCompensation);
+}
+
+/**
+ * storedValueOrDefault
+ * 
+ * @detail
+ *   Make sure a value retrieved from memory is one the menu item allows.  If not (a new
+ *   chip's EEPROM reads all ones), use the default rather than the nearest end of the range.
+ */
+int32_t storedValueOrDefault(SCRadioMenuItem &menuItem, int32_t storedValue, int32_t defaultValue)
+{
+	if (menuItem.rangeCheckValue(storedValue) != storedValue) {
+		return defaultValue;
+	}
+
+	return storedValue;
+}
+
 /**
  * checkInitialFrequency
  * 
@@ -469,6 +671,45 @@ void setupKeyerModeMenuItem()
 	keyerModeMenuItem.setMenuItemDisplayValue(0, "Straight");
 	keyerModeMenuItem.setMenuItemDisplayValue(1, "Iambic B");
 	keyerModeMenuItem.setMenuItemDisplayValue(2, "Iambic A");
+	keyerModeMenuItem.setMenuItemDisplayValue(3, "Ultimatic");
+	keyerModeMenuItem.setMenuItemDisplayValue(4, "Bug");
+}
+
+/**
+ * setupKeyerTimingMenuItems
+ * 
+ * @detail
+ *   Sets up the keyer's effective speed, dah length and compensation menu items
+ */
+void setupKeyerTimingMenuItems()
+{
+	keyerEffectiveSpeedMenuItem.setMenuItemEventType(EventType::KEYER_EFFECTIVE_SPEED_CHANGED);
+	keyerEffectiveSpeedMenuItem.setMenuItemName("Kyr Eff");
+	keyerEffectiveSpeedMenuItem.setMenuItemValueFormat("%ld WPM");
+
+	keyerDahRatioMenuItem.setMenuItemEventType(EventType::KEYER_DAH_RATIO_CHANGED);
+	keyerDahRatioMenuItem.setMenuItemName("Dah Len");
+	keyerDahRatioMenuItem.setMenuItemValueFormat("%ld/10 dit");
+
+	keyerCompensationMenuItem.setMenuItemEventType(EventType::KEYER_COMPENSATION_CHANGED);
+	keyerCompensationMenuItem.setMenuItemName("Key Comp");
+	keyerCompensationMenuItem.setMenuItemValueFormat("%ld us");
+}
+
+/**
+ * setupKeyerMessageMenuItem
+ * 
+ * @detail
+ *   Sets up the keyer message menu item.  Choosing a message starts sending it.
+ */
+void setupKeyerMessageMenuItem()
+{
+	keyerMessageMenuItem.setMenuItemEventType(EventType::KEYER_MESSAGE_CHANGED);
+	keyerMessageMenuItem.setMenuItemName("Kyr Msg");
+	keyerMessageMenuItem.setMenuItemValueFormat("%s");
+	keyerMessageMenuItem.setMenuItemDisplayValue(0, "Off");
+	keyerMessageMenuItem.setMenuItemDisplayValue(1, "CQ");
+	keyerMessageMenuItem.setMenuItemDisplayValue(2, "Beacon");
 }
 
 /**
@@ -499,6 +740,36 @@ void setupPaddlesOrientationMenuItem()
 	paddlesOrientationMenuItem.setMenuItemDisplayValue(1, "Reversed");
 }
 
+/**
+ * setupSidetoneMenuItems
+ * 
+ * @detail
+ *   Sets up the sidetone pitch and volume menu items.  Volume 0 turns the sidetone off.
+ */
+void setupSidetoneMenuItems()
+{
+	sidetonePitchMenuItem.setMenuItemEventType(EventType::SIDETONE_PITCH_CHANGED);
+	sidetonePitchMenuItem.setMenuItemName("Tone");
+	sidetonePitchMenuItem.setMenuItemValueFormat("%ld Hz");
+
+	sidetoneVolumeMenuItem.setMenuItemEventType(EventType::SIDETONE_VOLUME_CHANGED);
+	sidetoneVolumeMenuItem.setMenuItemName("Tone Vol");
+	sidetoneVolumeMenuItem.setMenuItemValueFormat("%ld");
+}
+
+/**
+ * setupQSKHangMenuItem
+ * 
+ * @detail
+ *   Sets up the menu item for how long the rig stays on the transmit frequency after the key comes up
+ */
+void setupQSKHangMenuItem()
+{
+	qskHangMenuItem.setMenuItemEventType(EventType::QSK_HANG_TIME_CHANGED);
+	qskHangMenuItem.setMenuItemName("QSK Hang");
+	qskHangMenuItem.setMenuItemValueFormat("%ld ms");
+}
+
 
 // setting up optional menu items
 
@@ -532,127 +803,41 @@ void setupBacklightOnOffMenuItem()
 	backlightOnOffMenuItem.setMenuItemDisplayValue(0, "No");
 }
 
-
-// Here I am creating global functions that in turn call methods on each class 
-// to handle the various messages they need to respond to.
-// First part of name identifies which object this refers to.
-// Later part of name identifies what types of messages it responds to
-//
-// The event manager cannot register class methods directly
-// This is why this is here
-//
-void vfoKnobTurnedListener(int eventCode, int turnDirection)
-{
-	vfo.vfoKnobTurnedListener(eventCode, turnDirection);
-}
-
-void ritKnobTurnedListener(int eventCode, int turnDirection)
-{
-	vfo.ritKnobTurnedListener(eventCode, turnDirection);
-}
-
-void displayFrequencyChangedListener(int eventCode, int eventLongIndex)
-{
-	lcdControl.frequencyChangedListener(eventCode, eventLongIndex);
-}
-
-void displayRitChangedListener(int eventCode, int eventLongIndex)
-{
-	lcdControl.ritChangedListener(eventCode, eventLongIndex);
-}
-
-void eepromFrequencyChangedListener(int eventCode, int eventLongIndex)
-{
-	eeprom.frequencyChangedListener(eventCode, eventLongIndex);
-}
-
-void vfoKeyLineChangedListener(int eventCode, int keyStatus)
-{
-	vfo.keyLineChangedListener(eventCode, keyStatus);
-}
-
-void displayMainKnobModeChangedListener(int eventCode, int newMode)
-{
-	lcdControl.mainKnobModeChangedListener(eventCode, newMode);
-}
-
-void displayMenuItemSelectedListener(int eventCode, int menuItemNumber)
-{
-	lcdControl.menuItemSelectedListener(eventCode, menuItemNumber);
-}
-
-void displayMenuItemValueChangedListener(int eventCode, int whichMenuItem)
-{
-	lcdControl.menuItemValueChangedListener(eventCode, whichMenuItem);
-}
-
-void menuKnobTurnedListener(int eventCode, int turnDirection)
-{
-	menu.menuKnobTurnedListener(eventCode, turnDirection);
-}
-
-void menuItemKnobTurnedListener(int eventCode, int turnDirection)
-{
-	menu.menuItemKnobTurnedListener(eventCode, turnDirection);
-}
-
-void vfoRxOffsetDirectionChangedListener(int eventCode, int whichMenuItem)
-{
-	vfo.rxOffsetDirectionChangedListener(eventCode, whichMenuItem);
-}
-
-void displayErrorOccurredListener(int eventCode, int whichErrorType)
-{
-	lcdControl.errorOccurredListener(eventCode, whichErrorType);
-}
-
-void displayVoltageReadListener(int eventCode, int voltageX10)
-{
-	lcdControl.voltageReadListener(eventCode, voltageX10);
-}
-
-void keyerModeChangedListener(int eventCode, int whichMenuItem)
-{
-	keyer.keyerModeChangedListener(eventCode, whichMenuItem);
-}
-
-void keyerSpeedChangedListener(int eventCode, int whichMenuItem)
-{
-	keyer.keyerSpeedChangedListener(eventCode, whichMenuItem);
-}
-
-void eepromKeyerModeChangedListener(int eventCode, int whichMenuItem)
-{
-	eeprom.keyerModeChangedListener(eventCode, whichMenuItem);
-}
-
-void eepromKeyerSpeedChangedListener(int eventCode, int whichMenuItem)
-{
-	eeprom.keyerSpeedChangedListener(eventCode, whichMenuItem);
-}
-
-void keyerPaddlesOrientationChangedListener(int eventCode, int whichMenuItem)
-{
-	keyer.keyerPaddlesOrientationChangedListener(eventCode, whichMenuItem);
-}
-
-void eepromPaddlesOrientationChangedListener(int eventCode, int whichMenuItem)
-{
-	eeprom.paddlesOrientationChangedListener(eventCode, whichMenuItem);
-}
-
-// optional menu item listeners
-void vfoRitStatusChangedListener(int eventCode, int whichMenuItem)
-{
-	vfo.ritStatusChangedListener(eventCode, whichMenuItem);
-}
-
-void displayBacklightStatusChangedListener(int eventCode, int whichMenuItem)
-{
-	lcdControl.backlightStatusChangedListener(eventCode, whichMenuItem);
+/**
+ * processSerialCommands
+ * 
+ * @detail
+ *   Reads a command character from the serial monitor for the tx/rx switching times, the
+ *   loop profiler or the event trace.  The switching times are always kept.  The profiler
+ *   and the trace commands do nothing unless they are turned on in SCRadioConstants.h.
+ */
+void processSerialCommands()
+{
+	if (Serial.available() == 0)
+	{
+		return;
+	}
+
+	switch (Serial.read())
+	{
+	case LOOP_PROFILER_PRINT_COMMAND:
+		loopProfiler.print();
+		break;
+	case LOOP_PROFILER_RESET_COMMAND:
+		loopProfiler.reset();
+		txRxSequencer.resetTimings();
+		break;
+	case QSK_PRINT_COMMAND:
+		txRxSequencer.print();
+		break;
+	case EVENT_TRACE_PRINT_COMMAND:
+		eventManager.getTrace().print();
+		break;
+	case EVENT_TRACE_DUMP_COMMAND:
+		eventManager.getTrace().dump();
+		break;
+	case EVENT_TRACE_RESET_COMMAND:
+		eventManager.getTrace().reset();
+		break;
+	}
 }
-
-void ritMenuItemExternallyChangedListener(int eventCode, int newMenuItemValue)
-{
-	ritOnOffMenuItem.menuItemExternallyChangedListener(eventCode, newMenuItemValue);
-}
\ No newline at end of file
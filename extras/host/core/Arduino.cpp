@@ -0,0 +1,954 @@
+/**
+ * Arduino.cpp - Simulated Arduino core for building and testing the libraries on a PC
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+
+// The app's interrupt routines.  Weak so a test that doesn't use the keyer or the
+// sidetone links without them.  (The core only calls the ones that are there.)
+extern "C" void TIMER1_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER2_COMPA_vect(void) __attribute__((weak));
+
+// The Nano runs 16 clock cycles each microsecond.  Time is kept in clock cycles
+// so the timers land where they would on the real thing.
+#define HOST_CYCLES_PER_MICRO (F_CPU / 1000000UL)
+
+// Interrupt sources, highest priority first (the same order as the ATmega328's vectors)
+#define HOST_INT0           0
+#define HOST_INT1           1
+#define HOST_TIMER2_COMPA   2
+#define HOST_TIMER1_COMPA   3
+#define HOST_SIMULATED      4
+#define HOST_SOURCE_COUNT   5
+
+// Ports in the order B, C, D
+#define HOST_PORT_COUNT 3
+
+HostStatusRegister SREG;
+HardwareSerial Serial;
+
+volatile uint8_t PINB, DDRB, PORTB;
+volatile uint8_t PINC, DDRC, PORTC;
+volatile uint8_t PIND, DDRD, PORTD;
+
+volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+volatile uint16_t TCNT1, OCR1A;
+
+volatile uint8_t TCCR2A, TCCR2B, TIMSK2, TIFR2, TCNT2, OCR2A;
+
+static volatile uint8_t *const kPinRegisters[HOST_PORT_COUNT] = { &PINB, &PINC, &PIND };
+static volatile uint8_t *const kModeRegisters[HOST_PORT_COUNT] = { &DDRB, &DDRC, &DDRD };
+static volatile uint8_t *const kOutputRegisters[HOST_PORT_COUNT] = { &PORTB, &PORTC, &PORTD };
+
+// First Arduino pin on each port
+static const uint8_t kFirstPin[HOST_PORT_COUNT] = { 8, 14, 0 };
+
+// Pins on each port that reach a header pin
+static const uint8_t kPortPins[HOST_PORT_COUNT] = { 6, 6, 8 };
+
+/**
+ * One of the ATmega328's timers as the core sees it
+ */
+struct HostTimer
+{
+	bool running;
+	bool flag;
+	uint64_t countStartCycle;
+};
+
+static uint64_t _cycles;
+
+static uint8_t _drivenMask[HOST_PORT_COUNT];
+static uint8_t _drivenLevels[HOST_PORT_COUNT];
+static uint8_t _lastLevels[HOST_PORT_COUNT];
+static int _analogValues[8];
+
+static HostPinChange _pinChanges[HOST_PIN_LOG_SIZE];
+static uint16_t _pinChangeCount;
+static bool _pinLogOverflowed;
+static uint32_t _digitalWriteCount;
+
+// The Arduino core turns interrupts on before setup() runs
+static bool _interruptsEnabled = true;
+static uint8_t _pendingInterrupts;
+static void (*_pinRoutines[2])(void);
+static int _pinRoutineModes[2];
+
+static HostTimer _timer1;
+static HostTimer _timer2;
+
+static uint32_t _coreCallCount;
+static uint32_t _simulatedCountdown;
+static void (*_simulatedRoutine)();
+
+static char _serialOutput[HOST_SERIAL_OUTPUT_SIZE + 1];
+static size_t _serialOutputLength;
+static char _serialInput[256];
+static uint8_t _serialInputHead;
+static uint8_t _serialInputTail;
+
+// Defined in EEPROM.cpp, SPI.cpp and Wire.cpp
+void hostResetEEPROM();
+void hostResetSPI();
+void hostResetWire();
+
+// private helpers
+
+static int8_t pinToPortIndex(uint8_t pin)
+{
+	if (pin < 8)
+	{
+		return 2;
+	}
+
+	if (pin < 14)
+	{
+		return 0;
+	}
+
+	if (pin < A6)
+	{
+		return 1;
+	}
+
+	return -1;
+}
+
+static uint8_t portNumberToIndex(uint8_t port)
+{
+	return port - PB;
+}
+
+static uint8_t portLevels(uint8_t index)
+{
+	uint8_t mode = *kModeRegisters[index];
+	uint8_t output = *kOutputRegisters[index];
+
+	// Outputs are whatever the port register says.  Inputs are whatever drives them from
+	// outside, or the pull up (the port register bit) when nothing does.
+	uint8_t inputs = (_drivenMask[index] & _drivenLevels[index]) | (~_drivenMask[index] & output);
+
+	return (mode & output) | (~mode & inputs);
+}
+
+static void recordPinChange(uint8_t pin, uint8_t level)
+{
+	if (_pinChangeCount >= HOST_PIN_LOG_SIZE)
+	{
+		_pinLogOverflowed = true;
+		return;
+	}
+
+	HostPinChange &change = _pinChanges[_pinChangeCount++];
+	change.micros = (uint32_t)(_cycles / HOST_CYCLES_PER_MICRO);
+	change.pin = pin;
+	change.level = level;
+}
+
+static void serviceInterrupts();
+
+// Looks at every port, records the pins that changed since last time and raises the
+// pin change interrupts.  Called whenever the core might have missed a change.
+static void syncPins()
+{
+	for (uint8_t index = 0; index < HOST_PORT_COUNT; index++)
+	{
+		uint8_t levels = portLevels(index);
+		uint8_t changed = levels ^ _lastLevels[index];
+
+		*kPinRegisters[index] = levels;
+		_lastLevels[index] = levels;
+
+		for (uint8_t bit = 0; bit < kPortPins[index]; bit++)
+		{
+			if ((changed & _BV(bit)) == 0)
+			{
+				continue;
+			}
+
+			uint8_t pin = kFirstPin[index] + bit;
+			uint8_t level = (levels >> bit) & 0x01;
+
+			recordPinChange(pin, level);
+
+			int8_t interruptNumber = digitalPinToInterrupt(pin);
+
+			if ((interruptNumber == NOT_AN_INTERRUPT) || (_pinRoutines[interruptNumber] == nullptr))
+			{
+				continue;
+			}
+
+			int mode = _pinRoutineModes[interruptNumber];
+
+			if ((mode == CHANGE) || ((mode == RISING) && level) || ((mode == FALLING) && !level))
+			{
+				_pendingInterrupts |= _BV(HOST_INT0 + interruptNumber);
+			}
+		}
+	}
+}
+
+static uint16_t timer1Prescaler()
+{
+	static const uint16_t kPrescalers[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+
+	return kPrescalers[TCCR1B & 0x07];
+}
+
+static uint16_t timer2Prescaler()
+{
+	static const uint16_t kPrescalers[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+	return kPrescalers[TCCR2B & 0x07];
+}
+
+// Starts or stops the core's copy of a timer to match its registers.
+// (Writing a 1 to an interrupt flag clears it on the ATmega328.)
+static void syncTimer(HostTimer &timer, uint16_t prescaler, uint16_t count, volatile uint8_t &flagRegister)
+{
+	if (flagRegister != 0)
+	{
+		timer.flag = false;
+		flagRegister = 0;
+	}
+
+	if (prescaler == 0)
+	{
+		timer.running = false;
+		return;
+	}
+
+	if (!timer.running)
+	{
+		timer.running = true;
+		timer.countStartCycle = _cycles - ((uint64_t)count * prescaler);
+	}
+}
+
+static void syncTimers()
+{
+	syncTimer(_timer1, timer1Prescaler(), TCNT1, TIFR1);
+	syncTimer(_timer2, timer2Prescaler(), TCNT2, TIFR2);
+
+	if (_timer1.flag && (TIMSK1 & _BV(OCIE1A)))
+	{
+		_pendingInterrupts |= _BV(HOST_TIMER1_COMPA);
+	}
+
+	if (_timer2.flag && (TIMSK2 & _BV(OCIE2A)))
+	{
+		_pendingInterrupts |= _BV(HOST_TIMER2_COMPA);
+	}
+}
+
+static uint64_t nextMatchCycle(const HostTimer &timer, uint16_t prescaler, uint16_t top)
+{
+	// CTC mode: the counter goes from 0 through top, so a match every (top + 1) counts
+	return timer.countStartCycle + ((uint64_t)top + 1) * prescaler;
+}
+
+static void runInterrupt(uint8_t source)
+{
+	void (*routine)(void) = nullptr;
+
+	switch (source)
+	{
+	case HOST_INT0:
+	case HOST_INT1:
+		routine = _pinRoutines[source - HOST_INT0];
+		break;
+	case HOST_TIMER2_COMPA:
+		_timer2.flag = false;
+		routine = TIMER2_COMPA_vect;
+		break;
+	case HOST_TIMER1_COMPA:
+		_timer1.flag = false;
+		routine = TIMER1_COMPA_vect;
+		break;
+	case HOST_SIMULATED:
+		routine = _simulatedRoutine;
+		_simulatedRoutine = nullptr;
+		break;
+	}
+
+	if (routine == nullptr)
+	{
+		return;
+	}
+
+	// The ATmega328 turns interrupts off going into an interrupt routine and back on coming out
+	_interruptsEnabled = false;
+	routine();
+	_interruptsEnabled = true;
+
+	syncPins();
+	syncTimers();
+}
+
+static void serviceInterrupts()
+{
+	static bool servicing = false;
+
+	// An interrupt routine that turns interrupts back on doesn't start this over
+	if (servicing)
+	{
+		return;
+	}
+
+	servicing = true;
+
+	while (_interruptsEnabled && _pendingInterrupts)
+	{
+		for (uint8_t source = 0; source < HOST_SOURCE_COUNT; source++)
+		{
+			if (_pendingInterrupts & _BV(source))
+			{
+				_pendingInterrupts &= ~_BV(source);
+				runInterrupt(source);
+				break;
+			}
+		}
+	}
+
+	servicing = false;
+}
+
+// Every call into the core goes through here first.  It is where a pretend interrupt
+// set up with hostInterruptAfterCoreCalls() goes off.
+static void coreCall()
+{
+	_coreCallCount++;
+
+	if ((_simulatedRoutine != nullptr) && (_simulatedCountdown > 0))
+	{
+		_simulatedCountdown--;
+
+		if (_simulatedCountdown == 0)
+		{
+			_pendingInterrupts |= _BV(HOST_SIMULATED);
+		}
+	}
+
+	syncTimers();
+	serviceInterrupts();
+}
+
+// status register
+
+HostStatusRegister::operator uint8_t() const
+{
+	coreCall();
+
+	return _interruptsEnabled ? _BV(SREG_I) : 0;
+}
+
+HostStatusRegister &HostStatusRegister::operator=(uint8_t value)
+{
+	_interruptsEnabled = (value & _BV(SREG_I)) != 0;
+	coreCall();
+
+	return *this;
+}
+
+// pins and ports
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	uint8_t mask = _BV(pin - kFirstPin[index]);
+
+	if (mode == OUTPUT)
+	{
+		*kModeRegisters[index] |= mask;
+	}
+	else
+	{
+		*kModeRegisters[index] &= ~mask;
+
+		if (mode == INPUT_PULLUP)
+		{
+			*kOutputRegisters[index] |= mask;
+		}
+		else
+		{
+			*kOutputRegisters[index] &= ~mask;
+		}
+	}
+
+	syncPins();
+	serviceInterrupts();
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+	coreCall();
+	_digitalWriteCount++;
+
+	int8_t index = pinToPortIndex(pin);
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	uint8_t mask = _BV(pin - kFirstPin[index]);
+
+	if (value == LOW)
+	{
+		*kOutputRegisters[index] &= ~mask;
+	}
+	else
+	{
+		*kOutputRegisters[index] |= mask;
+	}
+
+	syncPins();
+	serviceInterrupts();
+}
+
+int digitalRead(uint8_t pin)
+{
+	coreCall();
+
+	return hostPinLevel(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+	coreCall();
+
+	if (pin >= A0)
+	{
+		pin -= A0;
+	}
+
+	return _analogValues[pin & 0x07];
+}
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	return (index < 0) ? NOT_A_PIN : PB + index;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	return (index < 0) ? 0 : _BV(pin - kFirstPin[index]);
+}
+
+volatile uint8_t *portOutputRegister(uint8_t port)
+{
+	return (port == NOT_A_PORT) ? nullptr : kOutputRegisters[portNumberToIndex(port)];
+}
+
+volatile uint8_t *portInputRegister(uint8_t port)
+{
+	return (port == NOT_A_PORT) ? nullptr : kPinRegisters[portNumberToIndex(port)];
+}
+
+volatile uint8_t *portModeRegister(uint8_t port)
+{
+	return (port == NOT_A_PORT) ? nullptr : kModeRegisters[portNumberToIndex(port)];
+}
+
+void hostPulsePort(volatile uint8_t *port, uint8_t mask)
+{
+	// Anything written straight to a port before the pulse (like the DDS data bit) is picked up first
+	syncPins();
+	*port |= mask;
+	syncPins();
+	*port &= ~mask;
+	syncPins();
+}
+
+// time
+
+unsigned long millis()
+{
+	coreCall();
+
+	return (uint32_t)(_cycles / (HOST_CYCLES_PER_MICRO * 1000));
+}
+
+unsigned long micros()
+{
+	coreCall();
+
+	return (uint32_t)(_cycles / HOST_CYCLES_PER_MICRO);
+}
+
+void delay(unsigned long ms)
+{
+	hostAdvanceMicros(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	hostAdvanceMicros(us);
+}
+
+// interrupts
+
+void attachInterrupt(uint8_t interruptNumber, void (*routine)(void), int mode)
+{
+	if (interruptNumber > 1)
+	{
+		return;
+	}
+
+	_pinRoutines[interruptNumber] = routine;
+	_pinRoutineModes[interruptNumber] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNumber)
+{
+	if (interruptNumber > 1)
+	{
+		return;
+	}
+
+	_pinRoutines[interruptNumber] = nullptr;
+	_pendingInterrupts &= ~_BV(HOST_INT0 + interruptNumber);
+}
+
+void noInterrupts()
+{
+	coreCall();
+	_interruptsEnabled = false;
+}
+
+void interrupts()
+{
+	_interruptsEnabled = true;
+	coreCall();
+}
+
+// serial monitor
+
+void HardwareSerial::begin(unsigned long baud)
+{
+}
+
+void HardwareSerial::end()
+{
+}
+
+int HardwareSerial::available()
+{
+	return (uint8_t)(_serialInputHead - _serialInputTail);
+}
+
+int HardwareSerial::read()
+{
+	if (_serialInputHead == _serialInputTail)
+	{
+		return -1;
+	}
+
+	return (uint8_t)_serialInput[_serialInputTail++];
+}
+
+int HardwareSerial::peek()
+{
+	if (_serialInputHead == _serialInputTail)
+	{
+		return -1;
+	}
+
+	return (uint8_t)_serialInput[_serialInputTail];
+}
+
+void HardwareSerial::flush()
+{
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+	if (_serialOutputLength >= HOST_SERIAL_OUTPUT_SIZE)
+	{
+		return 0;
+	}
+
+	_serialOutput[_serialOutputLength++] = value;
+	_serialOutput[_serialOutputLength] = 0;
+
+	return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+	size_t written = 0;
+
+	while (written < size && write(buffer[written]))
+	{
+		written++;
+	}
+
+	return written;
+}
+
+size_t HardwareSerial::write(const char *text)
+{
+	return write((const uint8_t *)text, strlen(text));
+}
+
+size_t HardwareSerial::print(const char *text)
+{
+	return write(text);
+}
+
+size_t HardwareSerial::print(char value)
+{
+	return write((uint8_t)value);
+}
+
+size_t HardwareSerial::print(int value)
+{
+	return print((long)value);
+}
+
+size_t HardwareSerial::print(unsigned int value)
+{
+	return print((unsigned long)value);
+}
+
+size_t HardwareSerial::print(long value)
+{
+	char text[24];
+	snprintf(text, sizeof(text), "%ld", value);
+
+	return write(text);
+}
+
+size_t HardwareSerial::print(unsigned long value)
+{
+	char text[24];
+	snprintf(text, sizeof(text), "%lu", value);
+
+	return write(text);
+}
+
+size_t HardwareSerial::print(double value, int digits)
+{
+	char text[40];
+	snprintf(text, sizeof(text), "%.*f", digits, value);
+
+	return write(text);
+}
+
+size_t HardwareSerial::println()
+{
+	return write("\r\n");
+}
+
+size_t HardwareSerial::println(const char *text)
+{
+	return print(text) + println();
+}
+
+size_t HardwareSerial::println(char value)
+{
+	return print(value) + println();
+}
+
+size_t HardwareSerial::println(int value)
+{
+	return print(value) + println();
+}
+
+size_t HardwareSerial::println(unsigned int value)
+{
+	return print(value) + println();
+}
+
+size_t HardwareSerial::println(long value)
+{
+	return print(value) + println();
+}
+
+size_t HardwareSerial::println(unsigned long value)
+{
+	return print(value) + println();
+}
+
+size_t HardwareSerial::println(double value, int digits)
+{
+	return print(value, digits) + println();
+}
+
+// host controls (see HostCore.h)
+
+void hostReset()
+{
+	_cycles = 0;
+
+	for (uint8_t index = 0; index < HOST_PORT_COUNT; index++)
+	{
+		*kPinRegisters[index] = 0;
+		*kModeRegisters[index] = 0;
+		*kOutputRegisters[index] = 0;
+		_drivenMask[index] = 0;
+		_drivenLevels[index] = 0;
+		_lastLevels[index] = 0;
+	}
+
+	memset(_analogValues, 0, sizeof(_analogValues));
+
+	_pinChangeCount = 0;
+	_pinLogOverflowed = false;
+	_digitalWriteCount = 0;
+
+	_interruptsEnabled = true;
+	_pendingInterrupts = 0;
+	_pinRoutines[0] = nullptr;
+	_pinRoutines[1] = nullptr;
+
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TIMSK1 = 0;
+	TIFR1 = 0;
+	TCNT1 = 0;
+	OCR1A = 0;
+	TCCR2A = 0;
+	TCCR2B = 0;
+	TIMSK2 = 0;
+	TIFR2 = 0;
+	TCNT2 = 0;
+	OCR2A = 0;
+	_timer1 = HostTimer();
+	_timer2 = HostTimer();
+
+	_coreCallCount = 0;
+	_simulatedCountdown = 0;
+	_simulatedRoutine = nullptr;
+
+	hostClearSerialOutput();
+	_serialInputHead = 0;
+	_serialInputTail = 0;
+
+	hostResetEEPROM();
+	hostResetSPI();
+	hostResetWire();
+}
+
+void hostAdvanceMicros(uint32_t micros)
+{
+	uint64_t endCycle = _cycles + (uint64_t)micros * HOST_CYCLES_PER_MICRO;
+
+	while (true)
+	{
+		syncTimers();
+
+		// Finding the next timer compare match before the end
+		uint64_t nextCycle = endCycle;
+		HostTimer *matchingTimer = nullptr;
+
+		if (_timer1.running)
+		{
+			uint64_t matchCycle = nextMatchCycle(_timer1, timer1Prescaler(), OCR1A);
+
+			if (matchCycle <= nextCycle)
+			{
+				nextCycle = matchCycle;
+				matchingTimer = &_timer1;
+			}
+		}
+
+		if (_timer2.running)
+		{
+			uint64_t matchCycle = nextMatchCycle(_timer2, timer2Prescaler(), OCR2A);
+
+			if (matchCycle <= nextCycle)
+			{
+				nextCycle = matchCycle;
+				matchingTimer = &_timer2;
+			}
+		}
+
+		if (matchingTimer == nullptr)
+		{
+			break;
+		}
+
+		// At the match the counter starts over from 0 and the interrupt flag goes up
+		if (nextCycle > _cycles)
+		{
+			_cycles = nextCycle;
+		}
+
+		matchingTimer->countStartCycle = _cycles;
+		matchingTimer->flag = true;
+
+		syncTimers();
+		serviceInterrupts();
+	}
+
+	_cycles = endCycle;
+	syncPins();
+	serviceInterrupts();
+}
+
+void hostSetMicros(uint32_t micros)
+{
+	_cycles = (uint64_t)micros * HOST_CYCLES_PER_MICRO;
+	_timer1.countStartCycle = _cycles;
+	_timer2.countStartCycle = _cycles;
+}
+
+void hostSetPin(uint8_t pin, uint8_t level)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	uint8_t mask = _BV(pin - kFirstPin[index]);
+
+	_drivenMask[index] |= mask;
+
+	if (level == LOW)
+	{
+		_drivenLevels[index] &= ~mask;
+	}
+	else
+	{
+		_drivenLevels[index] |= mask;
+	}
+
+	syncPins();
+	serviceInterrupts();
+}
+
+void hostReleasePin(uint8_t pin)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	if (index < 0)
+	{
+		return;
+	}
+
+	_drivenMask[index] &= ~_BV(pin - kFirstPin[index]);
+
+	syncPins();
+	serviceInterrupts();
+}
+
+uint8_t hostPinLevel(uint8_t pin)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	if (index < 0)
+	{
+		return LOW;
+	}
+
+	return (portLevels(index) >> (pin - kFirstPin[index])) & 0x01;
+}
+
+bool hostPinIsOutput(uint8_t pin)
+{
+	int8_t index = pinToPortIndex(pin);
+
+	return (index >= 0) && (*kModeRegisters[index] & _BV(pin - kFirstPin[index]));
+}
+
+void hostSetAnalog(uint8_t pin, int value)
+{
+	if (pin >= A0)
+	{
+		pin -= A0;
+	}
+
+	_analogValues[pin & 0x07] = value;
+}
+
+uint16_t hostPinChangeCount()
+{
+	return _pinChangeCount;
+}
+
+const HostPinChange &hostPinChange(uint16_t index)
+{
+	return _pinChanges[index];
+}
+
+bool hostPinLogOverflowed()
+{
+	return _pinLogOverflowed;
+}
+
+void hostClearPinChanges()
+{
+	syncPins();
+	_pinChangeCount = 0;
+	_pinLogOverflowed = false;
+}
+
+uint32_t hostDigitalWriteCount()
+{
+	return _digitalWriteCount;
+}
+
+bool hostInterruptsEnabled()
+{
+	return _interruptsEnabled;
+}
+
+void hostInterruptAfterCoreCalls(uint32_t calls, void (*routine)())
+{
+	_simulatedCountdown = calls;
+	_simulatedRoutine = routine;
+	_pendingInterrupts &= ~_BV(HOST_SIMULATED);
+}
+
+uint32_t hostCoreCallCount()
+{
+	return _coreCallCount;
+}
+
+const char *hostSerialOutput()
+{
+	return _serialOutput;
+}
+
+size_t hostSerialOutputLength()
+{
+	return _serialOutputLength;
+}
+
+void hostClearSerialOutput()
+{
+	_serialOutputLength = 0;
+	_serialOutput[0] = 0;
+}
+
+void hostSerialInput(const char *text)
+{
+	while (*text)
+	{
+		_serialInput[_serialInputHead++] = *text++;
+	}
+}
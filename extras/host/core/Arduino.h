@@ -0,0 +1,163 @@
+/**
+ * Arduino.h - Simulated Arduino core for building and testing the libraries on a PC
+ *
+ * Why does this exist?
+ *
+ * The libraries and the sketch only ever run on the Nano.  To test them on a PC (see
+ * extras/host/Readme.md) they are compiled against this file instead of the real
+ * Arduino core.  It has the same functions the libraries use, but behind them is a
+ * pretend Nano:
+ *
+ *   - time only moves when a test moves it (hostAdvanceMicros() in HostCore.h)
+ *   - the port registers are real variables, so code that writes them directly works
+ *   - pin changes are recorded so a test can check what came out and when
+ *   - Timer1 and Timer2 call their interrupt routines as time moves
+ *   - the knob interrupt pins call their attachInterrupt() routines when a test moves them
+ *
+ * Only the parts of the Arduino core this app uses are here.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "avr/io.h"
+#include "avr/interrupt.h"
+#include "avr/pgmspace.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x0
+#define OUTPUT          0x1
+#define INPUT_PULLUP    0x2
+
+#define LSBFIRST        0
+#define MSBFIRST        1
+
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+#define NOT_A_PIN       0
+#define NOT_A_PORT      0
+#define NOT_AN_INTERRUPT -1
+
+// Port numbers used by digitalPinToPort() (same numbers as the real core)
+#define PB              2
+#define PC              3
+#define PD              4
+
+// Nano analog pins.  A6 and A7 can only be read with analogRead().
+#define A0              14
+#define A1              15
+#define A2              16
+#define A3              17
+#define A4              18
+#define A5              19
+#define A6              20
+#define A7              21
+
+#define NUM_DIGITAL_PINS 22
+
+#define F(string_literal) (string_literal)
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+// pins and ports
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+volatile uint8_t *portOutputRegister(uint8_t port);
+volatile uint8_t *portInputRegister(uint8_t port);
+volatile uint8_t *portModeRegister(uint8_t port);
+
+/**
+ * pulsePortHigh
+ *
+ * @detail
+ *   Replaces the DDS driver's pulsePortHigh() macro (see SCRadioDDS.h).  It does the same
+ *   thing, but writing a port through a pointer can't be seen by the simulated core, so the
+ *   pulse is recorded here on the way.
+ */
+#define pulsePortHigh(port, mask) hostPulsePort((port), (mask))
+void hostPulsePort(volatile uint8_t *port, uint8_t mask);
+
+// time
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// interrupts
+
+void attachInterrupt(uint8_t interruptNumber, void (*routine)(void), int mode);
+void detachInterrupt(uint8_t interruptNumber);
+void noInterrupts();
+void interrupts();
+
+// serial monitor
+
+class HardwareSerial
+{
+public:
+	void begin(unsigned long baud);
+	void end();
+	int available();
+	int read();
+	int peek();
+	void flush();
+
+	size_t write(uint8_t value);
+	size_t write(const uint8_t *buffer, size_t size);
+	size_t write(const char *text);
+
+	size_t print(const char *text);
+	size_t print(char value);
+	size_t print(int value);
+	size_t print(unsigned int value);
+	size_t print(long value);
+	size_t print(unsigned long value);
+	size_t print(double value, int digits = 2);
+
+	size_t println();
+	size_t println(const char *text);
+	size_t println(char value);
+	size_t println(int value);
+	size_t println(unsigned int value);
+	size_t println(long value);
+	size_t println(unsigned long value);
+	size_t println(double value, int digits = 2);
+
+	operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * EEPROM.cpp - Simulated EEPROM for the host build (see EEPROM.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+static uint8_t _eepromData[HOST_EEPROM_SIZE];
+static uint32_t _eepromWriteCount;
+
+// A new chip comes erased, even before the first hostReset()
+static struct HostEEPROMEraser
+{
+	HostEEPROMEraser() { memset(_eepromData, 0xFF, sizeof(_eepromData)); }
+} _eepromEraser;
+
+uint8_t EEPROMClass::read(int address)
+{
+	return _eepromData[address % HOST_EEPROM_SIZE];
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+	_eepromData[address % HOST_EEPROM_SIZE] = value;
+	_eepromWriteCount++;
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+	if (read(address) != value)
+	{
+		write(address, value);
+	}
+}
+
+uint16_t EEPROMClass::length()
+{
+	return HOST_EEPROM_SIZE;
+}
+
+void hostResetEEPROM()
+{
+	memset(_eepromData, 0xFF, sizeof(_eepromData));
+	_eepromWriteCount = 0;
+}
+
+uint8_t *hostEEPROMData()
+{
+	return _eepromData;
+}
+
+uint32_t hostEEPROMWriteCount()
+{
+	return _eepromWriteCount;
+}
@@ -0,0 +1,34 @@
+/**
+ * EEPROM.h - Simulated EEPROM for the host build (see Arduino.h)
+ *
+ * The EEPROM is an array in memory.  It starts erased (every byte 0xFF) like a new chip.
+ * HostCore.h has the calls a test uses to look at it and count the writes.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef EEPROM_h
+#define EEPROM_h
+
+#include "Arduino.h"
+
+class EEPROMClass
+{
+public:
+	uint8_t read(int address);
+	void write(int address, uint8_t value);
+	void update(int address, uint8_t value);
+	uint16_t length();
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
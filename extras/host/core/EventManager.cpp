@@ -0,0 +1,139 @@
+/**
+ * EventManager.cpp - Stand in for Igor Mikolic-Torreira's EventManager library (see EventManager.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "EventManager.h"
+
+EventManager::EventManager() :
+				_listenerCount(0)
+{
+	_queues[kHighPriority].head = 0;
+	_queues[kHighPriority].count = 0;
+	_queues[kLowPriority].head = 0;
+	_queues[kLowPriority].count = 0;
+}
+
+boolean EventManager::addListener(int eventCode, EventListener listener)
+{
+	if (_listenerCount >= EVENTMANAGER_LISTENER_LIST_SIZE)
+	{
+		return false;
+	}
+
+	_listeners[_listenerCount].eventCode = eventCode;
+	_listeners[_listenerCount].listener = listener;
+	_listenerCount++;
+
+	return true;
+}
+
+boolean EventManager::removeListener(int eventCode, EventListener listener)
+{
+	for (uint8_t i = 0; i < _listenerCount; i++)
+	{
+		if ((_listeners[i].eventCode == eventCode) && (_listeners[i].listener == listener))
+		{
+			_listeners[i] = _listeners[--_listenerCount];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int EventManager::numListeners()
+{
+	return _listenerCount;
+}
+
+boolean EventManager::isEventQueueEmpty(EventPriority priority)
+{
+	return _queues[priority].count == 0;
+}
+
+boolean EventManager::isEventQueueFull(EventPriority priority)
+{
+	return _queues[priority].count == EVENTMANAGER_EVENT_QUEUE_SIZE;
+}
+
+int EventManager::getNumEventsInQueue(EventPriority priority)
+{
+	return _queues[priority].count;
+}
+
+boolean EventManager::queueEvent(int eventCode, int eventParam, EventPriority priority)
+{
+	Queue &queue = _queues[priority];
+
+	if (queue.count == EVENTMANAGER_EVENT_QUEUE_SIZE)
+	{
+		return false;
+	}
+
+	uint8_t tail = (queue.head + queue.count) % EVENTMANAGER_EVENT_QUEUE_SIZE;
+
+	queue.eventCodes[tail] = eventCode;
+	queue.eventParams[tail] = eventParam;
+	queue.count++;
+
+	return true;
+}
+
+int EventManager::processEvent()
+{
+	EventPriority priority = isEventQueueEmpty(kHighPriority) ? kLowPriority : kHighPriority;
+	Queue &queue = _queues[priority];
+
+	if (queue.count == 0)
+	{
+		return 0;
+	}
+
+	int eventCode = queue.eventCodes[queue.head];
+	int eventParam = queue.eventParams[queue.head];
+
+	queue.head = (queue.head + 1) % EVENTMANAGER_EVENT_QUEUE_SIZE;
+	queue.count--;
+
+	return sendEvent(eventCode, eventParam);
+}
+
+int EventManager::processAllEvents()
+{
+	int handlerCount = 0;
+
+	while (!isEventQueueEmpty(kHighPriority) || !isEventQueueEmpty(kLowPriority))
+	{
+		handlerCount += processEvent();
+	}
+
+	return handlerCount;
+}
+
+int EventManager::sendEvent(int eventCode, int eventParam)
+{
+	int handlerCount = 0;
+
+	for (uint8_t i = 0; i < _listenerCount; i++)
+	{
+		if (_listeners[i].eventCode == eventCode)
+		{
+			_listeners[i].listener(eventCode, eventParam);
+			handlerCount++;
+		}
+	}
+
+	return handlerCount;
+}
@@ -0,0 +1,71 @@
+/**
+ * EventManager.h - Stand in for Igor Mikolic-Torreira's EventManager library (host build)
+ *
+ * The app used to be built on EventManager (SCRadioEventQueue replaced it).  This has
+ * the same calls and the same fixed sizes: 8 listeners and two queues of 8 events, high
+ * priority handled first, and queueEvent() refusing an event when its queue is full.
+ * The tests use it to check SCRadioEventQueue still behaves the way the app expects.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef EventManager_h
+#define EventManager_h
+
+#include "Arduino.h"
+
+#define EVENTMANAGER_LISTENER_LIST_SIZE 8
+#define EVENTMANAGER_EVENT_QUEUE_SIZE   8
+
+class EventManager
+{
+public:
+	typedef void (*EventListener)(int eventCode, int eventParam);
+
+	enum EventPriority { kHighPriority, kLowPriority };
+
+	EventManager();
+
+	boolean addListener(int eventCode, EventListener listener);
+	boolean removeListener(int eventCode, EventListener listener);
+	int numListeners();
+
+	boolean isEventQueueEmpty(EventPriority priority = kLowPriority);
+	boolean isEventQueueFull(EventPriority priority = kLowPriority);
+	int getNumEventsInQueue(EventPriority priority = kLowPriority);
+
+	boolean queueEvent(int eventCode, int eventParam, EventPriority priority = kLowPriority);
+	int processEvent();
+	int processAllEvents();
+
+private:
+	struct Listener
+	{
+		int eventCode;
+		EventListener listener;
+	};
+
+	struct Queue
+	{
+		int eventCodes[EVENTMANAGER_EVENT_QUEUE_SIZE];
+		int eventParams[EVENTMANAGER_EVENT_QUEUE_SIZE];
+		uint8_t head;
+		uint8_t count;
+	};
+
+	Listener _listeners[EVENTMANAGER_LISTENER_LIST_SIZE];
+	uint8_t _listenerCount;
+	Queue _queues[2];
+
+	int sendEvent(int eventCode, int eventParam);
+};
+
+#endif
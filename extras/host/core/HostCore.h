@@ -0,0 +1,304 @@
+/**
+ * HostCore.h - What a test can do to the simulated Nano (see Arduino.h)
+ *
+ * The libraries never include this.  It is for the tests: moving time, driving input
+ * pins, reading back what the app did to its output pins, the serial monitor,
+ * the EEPROM, the SPI and I2C buses and the display.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostCore_h
+#define HostCore_h
+
+#include "Arduino.h"
+
+/**
+ * Number of pin changes the pin recorder holds.  Once it is full further changes
+ * are counted but not kept (see hostPinLogOverflowed()).
+ */
+#define HOST_PIN_LOG_SIZE 8192
+
+/**
+ * Number of bytes of serial monitor output kept
+ */
+#define HOST_SERIAL_OUTPUT_SIZE 65536
+
+/**
+ * Number of bytes of SPI traffic kept
+ */
+#define HOST_SPI_LOG_SIZE 4096
+
+/**
+ * Number of I2C transmissions kept
+ */
+#define HOST_WIRE_LOG_SIZE 256
+
+/**
+ * Bytes in one I2C transmission (the real Wire library's buffer is this size too)
+ */
+#define HOST_WIRE_BUFFER_SIZE 32
+
+/**
+ * Bytes of EEPROM on the ATmega328
+ */
+#define HOST_EEPROM_SIZE 1024
+
+/**
+ * One change of a pin level seen by the pin recorder
+ */
+struct HostPinChange
+{
+	uint32_t micros;
+	uint8_t pin;
+	uint8_t level;
+};
+
+/**
+ * One I2C transmission (beginTransmission() to endTransmission())
+ */
+struct HostWireTransmission
+{
+	uint8_t address;
+	uint8_t length;
+	uint8_t data[HOST_WIRE_BUFFER_SIZE];
+};
+
+// the whole board
+
+/**
+ * hostReset
+ *
+ * @detail
+ *   Puts the simulated Nano back the way it is at power on: time 0, every pin an input with
+ *   nothing driving it, timers stopped, no interrupt routines attached, interrupts on,
+ *   EEPROM erased (every byte 0xFF) and every recorder empty.  Objects the test made
+ *   keep whatever they had.
+ */
+void hostReset();
+
+// time
+
+/**
+ * hostAdvanceMicros
+ *
+ * @detail
+ *   Moves time forward.  Timer1 and Timer2 interrupt routines run at the times their
+ *   registers say they would on the Nano.
+ *
+ * @param[in] micros microseconds to move forward
+ */
+void hostAdvanceMicros(uint32_t micros);
+
+/**
+ * hostSetMicros
+ *
+ * @detail
+ *   Jumps the clock to a time without running any timers (ex: to test micros() wrapping around)
+ *
+ * @param[in] micros what micros() returns next
+ */
+void hostSetMicros(uint32_t micros);
+
+// pins
+
+/**
+ * hostSetPin
+ *
+ * @detail
+ *   Drives an input pin from outside (a key, a paddle, the knob).  If an interrupt routine
+ *   is attached to the pin it runs (or waits for interrupts to be turned back on).
+ *
+ * @param[in] pin Arduino pin
+ * @param[in] level HIGH or LOW
+ */
+void hostSetPin(uint8_t pin, uint8_t level);
+
+/**
+ * hostReleasePin
+ *
+ * @detail
+ *   Stops driving a pin.  It goes back to what its pull up (or nothing) makes it.
+ *
+ * @param[in] pin Arduino pin
+ */
+void hostReleasePin(uint8_t pin);
+
+/**
+ * hostPinLevel
+ *
+ * @param[in] pin Arduino pin
+ *
+ * @returns the level on the pin right now (HIGH or LOW)
+ */
+uint8_t hostPinLevel(uint8_t pin);
+
+/**
+ * hostPinIsOutput
+ *
+ * @param[in] pin Arduino pin
+ *
+ * @returns true if pinMode() made the pin an output
+ */
+bool hostPinIsOutput(uint8_t pin);
+
+/**
+ * hostSetAnalog
+ *
+ * @param[in] pin analog pin (A0 through A7)
+ * @param[in] value what analogRead() returns for it (0 through 1023)
+ */
+void hostSetAnalog(uint8_t pin, int value);
+
+// pin recorder
+
+/**
+ * Number of pin changes recorded since the last hostClearPinChanges()
+ */
+uint16_t hostPinChangeCount();
+
+/**
+ * Pin change number 'index' (oldest first)
+ */
+const HostPinChange &hostPinChange(uint16_t index);
+
+/**
+ * true if more pins changed than the recorder could hold
+ */
+bool hostPinLogOverflowed();
+
+/**
+ * Empties the pin recorder
+ */
+void hostClearPinChanges();
+
+/**
+ * Number of digitalWrite() calls since hostReset()
+ */
+uint32_t hostDigitalWriteCount();
+
+// interrupts
+
+/**
+ * true if interrupts are on (not held off with noInterrupts())
+ */
+bool hostInterruptsEnabled();
+
+/**
+ * hostInterruptAfterCoreCalls
+ *
+ * @detail
+ *   Runs 'routine' as if it were an interrupt, after the app has made 'calls' more calls
+ *   into the core (micros(), millis(), digitalRead(), digitalWrite(), analogRead(), noInterrupts(),
+ *   interrupts() and reading or writing SREG).  If interrupts are off at that point it waits
+ *   until they are turned back on, like a real interrupt.  Used to land an interrupt at
+ *   every point in a piece of code.  Runs once.  Pass a null routine to cancel it.
+ *
+ * @param[in] calls core calls to wait for (1 is the next one)
+ * @param[in] routine the pretend interrupt routine
+ */
+void hostInterruptAfterCoreCalls(uint32_t calls, void (*routine)());
+
+/**
+ * Number of calls into the core since hostReset() (see hostInterruptAfterCoreCalls())
+ */
+uint32_t hostCoreCallCount();
+
+// serial monitor
+
+/**
+ * Everything sent to the serial monitor since the last hostClearSerialOutput()
+ * (also null terminated, for when it is text)
+ */
+const char *hostSerialOutput();
+
+/**
+ * Number of bytes in hostSerialOutput()
+ */
+size_t hostSerialOutputLength();
+
+/**
+ * Empties the serial monitor output
+ */
+void hostClearSerialOutput();
+
+/**
+ * Types text into the serial monitor (Serial.read() gets it)
+ */
+void hostSerialInput(const char *text);
+
+// EEPROM
+
+/**
+ * The EEPROM's bytes
+ */
+uint8_t *hostEEPROMData();
+
+/**
+ * Number of EEPROM.write() calls since hostReset()
+ */
+uint32_t hostEEPROMWriteCount();
+
+// SPI
+
+/**
+ * Number of bytes sent with SPI.transfer() since the last hostClearSPI()
+ */
+uint16_t hostSPIByteCount();
+
+/**
+ * SPI byte number 'index' (oldest first)
+ */
+uint8_t hostSPIByte(uint16_t index);
+
+/**
+ * Number of SPI transactions (beginTransaction() to endTransaction()) since the last hostClearSPI()
+ */
+uint16_t hostSPITransactionCount();
+
+/**
+ * Number of the bytes in hostSPIByteCount() sent with interrupts held off
+ */
+uint16_t hostSPIBytesWithInterruptsOff();
+
+/**
+ * Empties the SPI recorder
+ */
+void hostClearSPI();
+
+// I2C
+
+/**
+ * Number of I2C transmissions since the last hostClearWire()
+ */
+uint16_t hostWireTransmissionCount();
+
+/**
+ * I2C transmission number 'index' (oldest first)
+ */
+const HostWireTransmission &hostWireTransmission(uint16_t index);
+
+/**
+ * Empties the I2C recorder
+ */
+void hostClearWire();
+
+// interrupt routines (so a test can run one itself)
+
+extern "C" void TIMER1_COMPA_vect(void);
+extern "C" void TIMER2_COMPA_vect(void);
+
+// the sketch (for tests built with it)
+
+void setup();
+void loop();
+
+#endif
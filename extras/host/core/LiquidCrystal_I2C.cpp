@@ -0,0 +1,132 @@
+/**
+ * LiquidCrystal_I2C.cpp - Simulated I2C character display for the host build (see LiquidCrystal_I2C.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "LiquidCrystal_I2C.h"
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows) :
+										_address(address),
+										_columns(columns > HOST_LCD_MAX_COLUMNS ? HOST_LCD_MAX_COLUMNS : columns),
+										_rows(rows > HOST_LCD_MAX_ROWS ? HOST_LCD_MAX_ROWS : rows)
+{
+	init();
+}
+
+void LiquidCrystal_I2C::init()
+{
+	_backlight = false;
+	_printCount = 0;
+	clear();
+}
+
+void LiquidCrystal_I2C::begin(uint8_t columns, uint8_t rows)
+{
+	init();
+}
+
+void LiquidCrystal_I2C::clear()
+{
+	for (uint8_t row = 0; row < HOST_LCD_MAX_ROWS; row++)
+	{
+		memset(_screen[row], ' ', _columns);
+		_screen[row][_columns] = 0;
+	}
+
+	home();
+}
+
+void LiquidCrystal_I2C::home()
+{
+	_cursorColumn = 0;
+	_cursorRow = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t column, uint8_t row)
+{
+	_cursorColumn = column;
+	_cursorRow = (row < _rows) ? row : (_rows - 1);
+}
+
+void LiquidCrystal_I2C::backlight()
+{
+	_backlight = true;
+}
+
+void LiquidCrystal_I2C::noBacklight()
+{
+	_backlight = false;
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value)
+{
+	// Text past the end of the row is lost
+	if (_cursorColumn >= _columns)
+	{
+		return 0;
+	}
+
+	_screen[_cursorRow][_cursorColumn++] = value;
+
+	return 1;
+}
+
+size_t LiquidCrystal_I2C::print(const char *text)
+{
+	size_t written = 0;
+
+	_printCount++;
+
+	while (*text)
+	{
+		written += write(*text++);
+	}
+
+	return written;
+}
+
+size_t LiquidCrystal_I2C::print(char value)
+{
+	_printCount++;
+
+	return write(value);
+}
+
+size_t LiquidCrystal_I2C::print(int value)
+{
+	return print((long)value);
+}
+
+size_t LiquidCrystal_I2C::print(long value)
+{
+	char text[24];
+	snprintf(text, sizeof(text), "%ld", value);
+
+	return print(text);
+}
+
+const char *LiquidCrystal_I2C::hostLine(uint8_t row) const
+{
+	return _screen[row];
+}
+
+bool LiquidCrystal_I2C::hostBacklight() const
+{
+	return _backlight;
+}
+
+uint32_t LiquidCrystal_I2C::hostPrintCount() const
+{
+	return _printCount;
+}
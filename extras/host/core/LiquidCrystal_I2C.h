@@ -0,0 +1,73 @@
+/**
+ * LiquidCrystal_I2C.h - Simulated I2C character display for the host build (see Arduino.h)
+ *
+ * Text printed to the display goes into a copy of its screen.  hostLine() gives a test
+ * one row of it.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef LiquidCrystal_I2C_h
+#define LiquidCrystal_I2C_h
+
+#include "Arduino.h"
+
+#define HOST_LCD_MAX_COLUMNS 20
+#define HOST_LCD_MAX_ROWS    4
+
+class LiquidCrystal_I2C
+{
+private:
+	uint8_t _address;
+	uint8_t _columns;
+	uint8_t _rows;
+	uint8_t _cursorColumn;
+	uint8_t _cursorRow;
+	bool _backlight;
+	char _screen[HOST_LCD_MAX_ROWS][HOST_LCD_MAX_COLUMNS + 1];
+	uint32_t _printCount;
+
+public:
+	LiquidCrystal_I2C(uint8_t address, uint8_t columns, uint8_t rows);
+
+	void init();
+	void begin(uint8_t columns, uint8_t rows);
+	void clear();
+	void home();
+	void setCursor(uint8_t column, uint8_t row);
+	void backlight();
+	void noBacklight();
+
+	size_t write(uint8_t value);
+	size_t print(const char *text);
+	size_t print(char value);
+	size_t print(int value);
+	size_t print(long value);
+
+	// host only (see HostCore.h)
+
+	/**
+	 * One row of the screen as text (always the full width, blank where nothing was printed)
+	 */
+	const char *hostLine(uint8_t row) const;
+
+	/**
+	 * true if the backlight is on
+	 */
+	bool hostBacklight() const;
+
+	/**
+	 * Number of print() calls since init()
+	 */
+	uint32_t hostPrintCount() const;
+};
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ * Rotary.cpp - Rotary encoder decoder for the host build (see Rotary.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "Rotary.h"
+
+// Where the decoder is in a step.  The pins read as (pin2 << 1) | pin1, so 3 is the rest position.
+#define ROTARY_START      0
+#define ROTARY_CW_BEGIN   1   // pin1 went low       (2)
+#define ROTARY_CW_MIDDLE  2   // both low            (0)
+#define ROTARY_CW_END     3   // pin1 back high      (1)
+#define ROTARY_CCW_BEGIN  4   // pin2 went low       (1)
+#define ROTARY_CCW_MIDDLE 5   // both low            (0)
+#define ROTARY_CCW_END    6   // pin2 back high      (2)
+
+// Next state for each state and pin reading.  DIR_CW or DIR_CCW is added when a step finishes.
+static const uint8_t kRotaryTransitions[7][4] = {
+	//  pins 0              pins 1                     pins 2                     pins 3
+	{ ROTARY_START,       ROTARY_CCW_BEGIN,          ROTARY_CW_BEGIN,           ROTARY_START },            // START
+	{ ROTARY_CW_MIDDLE,   ROTARY_START,              ROTARY_CW_BEGIN,           ROTARY_START },            // CW_BEGIN
+	{ ROTARY_CW_MIDDLE,   ROTARY_CW_END,             ROTARY_CW_BEGIN,           ROTARY_START },            // CW_MIDDLE
+	{ ROTARY_CW_MIDDLE,   ROTARY_CW_END,             ROTARY_START,              ROTARY_START | DIR_CW },   // CW_END
+	{ ROTARY_CCW_MIDDLE,  ROTARY_CCW_BEGIN,          ROTARY_START,              ROTARY_START },            // CCW_BEGIN
+	{ ROTARY_CCW_MIDDLE,  ROTARY_CCW_BEGIN,          ROTARY_CCW_END,            ROTARY_START },            // CCW_MIDDLE
+	{ ROTARY_CCW_MIDDLE,  ROTARY_START,              ROTARY_CCW_END,            ROTARY_START | DIR_CCW }   // CCW_END
+};
+
+Rotary::Rotary(char pin1, char pin2) :
+				_pin1(pin1),
+				_pin2(pin2),
+				_state(ROTARY_START)
+{
+	// Same as the real library: both pins are inputs with their pull ups on
+	pinMode(_pin1, INPUT_PULLUP);
+	pinMode(_pin2, INPUT_PULLUP);
+}
+
+unsigned char Rotary::process()
+{
+	uint8_t pins = (digitalRead(_pin2) << 1) | digitalRead(_pin1);
+
+	_state = kRotaryTransitions[_state & 0x0F][pins];
+
+	return _state & (DIR_CW | DIR_CCW);
+}
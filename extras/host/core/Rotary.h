@@ -0,0 +1,50 @@
+/**
+ * Rotary.h - Rotary encoder decoder for the host build (see Arduino.h)
+ *
+ * Stands in for the Rotary library the knob uses.  Same calls, written from scratch.
+ * process() reads the two encoder pins and returns DIR_CW or DIR_CCW once a full
+ * step (detent to detent) has been seen, and DIR_NONE otherwise.  A contact that
+ * bounces back and forth without finishing a step never counts as one.
+ *
+ * With both pins pulled up the encoder rests at pin1 HIGH and pin2 HIGH.
+ * Clockwise is pin1 going LOW first:
+ *
+ *   pin1  ‾‾|___|‾‾‾‾
+ *   pin2  ‾‾‾‾|___|‾‾
+ *
+ * and counter clockwise is pin2 going LOW first.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef Rotary_h
+#define Rotary_h
+
+#include "Arduino.h"
+
+#define DIR_NONE 0x00
+#define DIR_CW   0x10
+#define DIR_CCW  0x20
+
+class Rotary
+{
+private:
+	uint8_t _pin1;
+	uint8_t _pin2;
+	uint8_t _state;
+
+public:
+	Rotary(char pin1, char pin2);
+
+	unsigned char process();
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * SPI.cpp - Simulated SPI peripheral for the host build (see SPI.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+
+#include "SPI.h"
+
+// Nano SPI pins
+#define HOST_SPI_SS_PIN   10
+#define HOST_SPI_MOSI_PIN 11
+#define HOST_SPI_SCK_PIN  13
+
+SPIClass SPI;
+
+static uint8_t _spiBytes[HOST_SPI_LOG_SIZE];
+static uint16_t _spiByteCount;
+static uint16_t _spiTransactionCount;
+static uint16_t _spiBytesWithInterruptsOff;
+static SPISettings _spiSettings;
+
+void SPIClass::begin()
+{
+	// Same as the real library: SS stays high if it was an output already, SCK and MOSI become outputs
+	digitalWrite(HOST_SPI_SS_PIN, HIGH);
+	pinMode(HOST_SPI_SS_PIN, OUTPUT);
+	pinMode(HOST_SPI_SCK_PIN, OUTPUT);
+	pinMode(HOST_SPI_MOSI_PIN, OUTPUT);
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	_spiSettings = settings;
+	_spiTransactionCount++;
+}
+
+void SPIClass::endTransaction()
+{
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	if (_spiByteCount < HOST_SPI_LOG_SIZE)
+	{
+		_spiBytes[_spiByteCount++] = data;
+	}
+
+	if (!hostInterruptsEnabled())
+	{
+		_spiBytesWithInterruptsOff++;
+	}
+
+	volatile uint8_t *port = portOutputRegister(digitalPinToPort(HOST_SPI_SCK_PIN));
+	uint8_t sckMask = digitalPinToBitMask(HOST_SPI_SCK_PIN);
+	uint8_t mosiMask = digitalPinToBitMask(HOST_SPI_MOSI_PIN);
+
+	// Mode 0: data is set up with the clock low and read on its rising edge
+	for (uint8_t bit = 0; bit < 8; bit++)
+	{
+		uint8_t shift = (_spiSettings.bitOrder == LSBFIRST) ? bit : (7 - bit);
+
+		if ((data >> shift) & 0x01)
+		{
+			*port |= mosiMask;
+		}
+		else
+		{
+			*port &= ~mosiMask;
+		}
+
+		hostPulsePort(port, sckMask);
+	}
+
+	return 0;
+}
+
+void hostResetSPI()
+{
+	hostClearSPI();
+	_spiSettings = SPISettings();
+}
+
+uint16_t hostSPIByteCount()
+{
+	return _spiByteCount;
+}
+
+uint8_t hostSPIByte(uint16_t index)
+{
+	return _spiBytes[index];
+}
+
+uint16_t hostSPITransactionCount()
+{
+	return _spiTransactionCount;
+}
+
+uint16_t hostSPIBytesWithInterruptsOff()
+{
+	return _spiBytesWithInterruptsOff;
+}
+
+void hostClearSPI()
+{
+	_spiByteCount = 0;
+	_spiTransactionCount = 0;
+	_spiBytesWithInterruptsOff = 0;
+}
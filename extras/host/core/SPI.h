@@ -0,0 +1,51 @@
+/**
+ * SPI.h - Simulated SPI peripheral for the host build (see Arduino.h)
+ *
+ * Each byte sent is recorded (see HostCore.h) and clocked out on the SPI pins, pin 13 (SCK)
+ * and pin 11 (MOSI), so the pin recorder sees the same thing a device wired to them would.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SPI_h
+#define SPI_h
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+public:
+	SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) { }
+	SPISettings(uint32_t clockHz, uint8_t order, uint8_t mode) : clock(clockHz), bitOrder(order), dataMode(mode) { }
+
+	uint32_t clock;
+	uint8_t bitOrder;
+	uint8_t dataMode;
+};
+
+class SPIClass
+{
+public:
+	void begin();
+	void end();
+	void beginTransaction(SPISettings settings);
+	void endTransaction();
+	uint8_t transfer(uint8_t data);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,21 @@
+/**
+ * WString.h - Placeholder for the Arduino String class in the host build (see Arduino.h)
+ *
+ * The app doesn't use String (see 'Regrets and compromises' in the sketch), it only
+ * includes the header.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef WString_h
+#define WString_h
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * Wire.cpp - Simulated I2C bus for the host build (see Wire.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+static HostWireTransmission _transmissions[HOST_WIRE_LOG_SIZE];
+static uint16_t _transmissionCount;
+static HostWireTransmission _transmission;
+
+void TwoWire::begin()
+{
+}
+
+void TwoWire::setClock(uint32_t clockHz)
+{
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+	_transmission.address = address;
+	_transmission.length = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+	if (_transmissionCount < HOST_WIRE_LOG_SIZE)
+	{
+		_transmissions[_transmissionCount++] = _transmission;
+	}
+
+	return 0;
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+	// Like the real library, anything past the end of its buffer is lost
+	if (_transmission.length >= HOST_WIRE_BUFFER_SIZE)
+	{
+		return 0;
+	}
+
+	_transmission.data[_transmission.length++] = value;
+
+	return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+	size_t written = 0;
+
+	while (written < length && write(data[written]))
+	{
+		written++;
+	}
+
+	return written;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity)
+{
+	return 0;
+}
+
+int TwoWire::available()
+{
+	return 0;
+}
+
+int TwoWire::read()
+{
+	return -1;
+}
+
+void hostResetWire()
+{
+	hostClearWire();
+}
+
+uint16_t hostWireTransmissionCount()
+{
+	return _transmissionCount;
+}
+
+const HostWireTransmission &hostWireTransmission(uint16_t index)
+{
+	return _transmissions[index];
+}
+
+void hostClearWire()
+{
+	_transmissionCount = 0;
+}
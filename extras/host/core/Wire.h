@@ -0,0 +1,38 @@
+/**
+ * Wire.h - Simulated I2C bus for the host build (see Arduino.h)
+ *
+ * Each transmission is recorded (see HostCore.h).  Every device answers.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef Wire_h
+#define Wire_h
+
+#include "Arduino.h"
+
+class TwoWire
+{
+public:
+	void begin();
+	void setClock(uint32_t clockHz);
+	void beginTransmission(uint8_t address);
+	uint8_t endTransmission(bool sendStop = true);
+	size_t write(uint8_t value);
+	size_t write(const uint8_t *data, size_t length);
+	uint8_t requestFrom(uint8_t address, uint8_t quantity);
+	int available();
+	int read();
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * avr/interrupt.h - Interrupt routines for the host build (see Arduino.h)
+ *
+ * An interrupt routine is an ordinary function here.  The simulated core calls it
+ * when its timer or pin says so.  A test can also call one itself.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef avr_interrupt_h
+#define avr_interrupt_h
+
+#define ISR(vector, ...) extern "C" void vector(void)
+
+void noInterrupts();
+void interrupts();
+
+#define cli() noInterrupts()
+#define sei() interrupts()
+
+#endif
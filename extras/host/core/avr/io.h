@@ -0,0 +1,82 @@
+/**
+ * avr/io.h - Simulated ATmega328 registers for the host build (see Arduino.h)
+ *
+ * The registers the app uses are plain variables here.  The simulated core looks at
+ * them as time moves (the timers) and when pins change (the ports).
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef avr_io_h
+#define avr_io_h
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+/**
+ * Status register.  Only the global interrupt flag (bit 7) means anything here.
+ * Saving it and writing it back (the usual way of holding interrupts off around
+ * something) turns interrupts back on only if they were on before.
+ */
+class HostStatusRegister
+{
+public:
+	operator uint8_t() const;
+	HostStatusRegister &operator=(uint8_t value);
+};
+
+extern HostStatusRegister SREG;
+
+#define SREG_I 7
+
+// ports
+extern volatile uint8_t PINB, DDRB, PORTB;
+extern volatile uint8_t PINC, DDRC, PORTC;
+extern volatile uint8_t PIND, DDRD, PORTD;
+
+// Timer1 (16 bit)
+extern volatile uint8_t TCCR1A, TCCR1B, TIMSK1, TIFR1;
+extern volatile uint16_t TCNT1, OCR1A;
+
+// Timer2 (8 bit)
+extern volatile uint8_t TCCR2A, TCCR2B, TIMSK2, TIFR2, TCNT2, OCR2A;
+
+// TCCR1B
+#define CS10  0
+#define CS11  1
+#define CS12  2
+#define WGM12 3
+#define WGM13 4
+
+// TIMSK1 and TIFR1
+#define OCIE1A 1
+#define OCF1A  1
+
+// TCCR2A
+#define WGM20 0
+#define WGM21 1
+
+// TCCR2B
+#define CS20  0
+#define CS21  1
+#define CS22  2
+#define WGM22 3
+
+// TIMSK2 and TIFR2
+#define OCIE2A 1
+#define OCF2A  1
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * avr/pgmspace.h - Flash memory access for the host build (see Arduino.h)
+ *
+ * A PC has no separate flash, so PROGMEM data is ordinary memory and reading it is
+ * an ordinary read.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef avr_pgmspace_h
+#define avr_pgmspace_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define PGM_P const char *
+
+#define pgm_read_byte(address)  (*(const uint8_t *)(address))
+#define pgm_read_word(address)  (*(const uint16_t *)(address))
+#define pgm_read_dword(address) (*(const uint32_t *)(address))
+#define pgm_read_ptr(address)   (*(const void * const *)(address))
+
+#define memcpy_P(destination, source, size) memcpy((destination), (source), (size))
+#define strcpy_P(destination, source) strcpy((destination), (source))
+#define strlen_P(source) strlen(source)
+
+#endif
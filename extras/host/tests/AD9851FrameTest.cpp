@@ -0,0 +1,76 @@
+/**
+ * AD9851FrameTest.cpp - Golden AD9851 frames (built with DDS_CHIP set to SCRadioAD9851<true>)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+
+#include "SCRadioDDS.h"
+
+// AD9851 with a 30 MHz clock and the 6x multiplier (180 MHz)
+#define TEST_TUNING_WORD_MILLIONTHS 23860929UL
+
+#define TEST_FREQUENCY_COUNT 3
+
+static const int32_t kTestFrequencies[TEST_FREQUENCY_COUNT] = { 7030000, 7000000, 7299999 };
+
+// Worked out by hand: frequency x 23.860929 rounded, lowest byte first, then the
+// control byte with the 6x multiplier bit set
+static const uint8_t kGoldenFrames[TEST_FREQUENCY_COUNT][5] = {
+	{ 0x7B, 0x8B, 0xFF, 0x09, 0x01 },
+	{ 0x47, 0x9F, 0xF4, 0x09, 0x01 },
+	{ 0x36, 0xD9, 0x61, 0x0A, 0x01 }
+};
+
+static_assert(SCRadioAD9851<true>::buildFrame(0x09FF8B7BUL).bytes[4] == AD9851_REFCLOCK_MULTIPLIER_BIT,
+			"AD9851 multiplier bit is missing");
+static_assert(SCRadioAD9851<false>::buildFrame(0x09FF8B7BUL).bytes[4] == 0x00,
+			"AD9851 multiplier bit is set when it shouldn't be");
+
+static void testFramesMatchTheGoldenFrames()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					TEST_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	dds.begin();
+	hostClearPinChanges();
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		dds.sendFrequencyToDDS(kTestFrequencies[i]);
+	}
+
+	// What the DDS latched off its pins
+	HostDDSFrame frames[TEST_FREQUENCY_COUNT];
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT, decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN,
+														frames, TEST_FREQUENCY_COUNT));
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		CHECK_EQUAL(40, frames[i].bitCount);
+
+		for (uint8_t b = 0; b < 5; b++)
+		{
+			CHECK_EQUAL(kGoldenFrames[i][b], frames[i].bytes[b]);
+		}
+	}
+}
+
+int main()
+{
+	RUN_TEST(testFramesMatchTheGoldenFrames);
+
+	return hostTestFinish();
+}
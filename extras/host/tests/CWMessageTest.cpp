@@ -0,0 +1,158 @@
+/**
+ * CWMessageTest.cpp - Stored messages are encoded right and the keyer sends them with
+ * the standard timing: PARIS takes 50 dits, a character's elements are a dit apart,
+ * characters 3 and words 7
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKeyer.h"
+
+#include "SCRadioCWMessage.h"
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioKeyer.h"
+
+CW_MESSAGE(parisMessage, "PARIS PARIS");
+CW_MESSAGE(callMessage, "K4");
+
+// The whole message is worked out by the compiler
+static_assert(sizeof(callMessage.codes) == 3, "one code per character and the end");
+static_assert(callMessage.codes[0] == 0x0D, "K is -.- (binary 1101)");
+static_assert(callMessage.codes[1] == 0x30, "4 is ....- (binary 110000)");
+static_assert(callMessage.codes[2] == CW_END_OF_MESSAGE_CODE, "the end of the message");
+static_assert(parisMessage.codes[5] == CW_WORD_SPACE_CODE, "the space between words");
+
+SCRadioEventQueue queue;
+SCRadioKeyer keyer = SCRadioKeyer(queue, nullptr, 0);
+HostKeyLine keyLine;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyLine, keyLineChanged)>
+> TestDispatcher;
+
+/**
+ * Elements in PARIS: P .--. A .- R .-. I .. S ...
+ */
+#define PARIS_ELEMENT_COUNT 14
+
+/**
+ * Powers up with the paddles let go, sets the speed and starts a message
+ */
+static void startMessage(const uint8_t *codes, int8_t wpm)
+{
+	hostReset();
+	setPaddles(0);
+
+	keyer.begin();
+	keyer.setKeyerMode(KeyerMode::IAMBICB);
+	keyer.setKeyerWPM(wpm);
+
+	runKeyer<TestDispatcher>(queue, 1000);
+	keyLine.clear();
+
+	keyer.playMessage(codes, 0);
+}
+
+/**
+ * Sends a message at a speed and records the key line
+ */
+static void sendMessage(const uint8_t *codes, int8_t wpm, uint32_t runMicros)
+{
+	startMessage(codes, wpm);
+	runKeyer<TestDispatcher>(queue, runMicros);
+}
+
+static void testGoldenCallAt20WPM()
+{
+	sendMessage(callMessage.codes, 20, 2000000);
+
+	// K (-.-), 3 dits, 4 (....-).  60 ms dit, 180 ms dah.
+	const uint32_t expected[] = {
+		100, 180100,
+		240100, 300100,
+		360100, 540100,
+		720100, 780100,
+		840100, 900100,
+		960100, 1020100,
+		1080100, 1140100,
+		1200100, 1380100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 16));
+}
+
+static void testParisIsFiftyDits()
+{
+	// From the start of one PARIS to the start of the next is 50 dits (31 of
+	// elements and the spaces inside characters, 19 of spaces after them)
+	for (int8_t wpm = 5; wpm <= 50; wpm += 5)
+	{
+		uint32_t ditMicros = 1200000UL / wpm;
+		uint32_t parisMicros = 60000000UL / wpm;
+
+		sendMessage(parisMessage.codes, wpm, 110 * ditMicros);
+
+		if (!CHECK_EQUAL(4 * PARIS_ELEMENT_COUNT, keyLine.count))
+		{
+			continue;
+		}
+
+		uint32_t wordMicros = keyLine.edgeMicros[2 * PARIS_ELEMENT_COUNT] - keyLine.edgeMicros[0];
+		int32_t error = (int32_t)wordMicros - (int32_t)parisMicros;
+
+		printf("  %2d WPM: PARIS %lu us (%ld us from 60 s / WPM)\n", wpm, (unsigned long)wordMicros, (long)error);
+
+		CHECK(abs(error) < KEYER_TICK_MICROS);
+
+		// Sent the way it was encoded: P is dit dah dah dit
+		CHECK(keyLine.lengthMicros(0) < 2 * ditMicros);
+		CHECK(keyLine.lengthMicros(2) > 2 * ditMicros);
+		CHECK(keyLine.lengthMicros(4) > 2 * ditMicros);
+		CHECK(keyLine.lengthMicros(6) < 2 * ditMicros);
+
+		// and the key ends up
+		CHECK(!keyLine.edgeKeyDown[keyLine.count - 1]);
+	}
+}
+
+static void testPaddleBreaksIn()
+{
+	startMessage(parisMessage.codes, 20);
+
+	// A tap of the dit paddle in the middle of the first dah of P (120100 to 300100)
+	HostPaddleStep steps[] = {
+		{ 200000, HOST_DIT_PADDLE },
+		{ 210000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 1000000, steps, 2);
+
+	// The message stops right there (key up), and after a space the paddle's dit is sent
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 200100,
+		260100, 320100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 6));
+}
+
+int main()
+{
+	RUN_TEST(testGoldenCallAt20WPM);
+	RUN_TEST(testParisIsFiftyDits);
+	RUN_TEST(testPaddleBreaksIn);
+
+	return hostTestFinish();
+}
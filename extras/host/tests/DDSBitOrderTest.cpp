@@ -0,0 +1,163 @@
+/**
+ * DDSBitOrderTest.cpp - The DDS port register writes send the same bits as the old digitalWrite() code
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+
+#include "SCRadioDDS.h"
+#include "SCRadioTuningWord.h"
+
+#define TEST_FREQUENCY_COUNT 5
+
+// Frequencies with a spread of bit patterns (runs of ones, runs of zeros, alternating bits)
+static const int32_t kTestFrequencies[TEST_FREQUENCY_COUNT] = { 7000000, 7030000, 7299999, 5592405, 1 };
+
+// What the pin recorder saw for the DDS pins, without the times
+static uint8_t ddsPinChanges(HostPinChange *changes, uint16_t maxChanges)
+{
+	uint16_t count = 0;
+
+	for (uint16_t i = 0; i < hostPinChangeCount() && count < maxChanges; i++)
+	{
+		uint8_t pin = hostPinChange(i).pin;
+
+		if ((pin == DDS_WORD_LOAD_CLOCK_PIN) || (pin == DDS_DATA_PIN) || (pin == DDS_FREQUENCY_UPDATE_PIN))
+		{
+			changes[count] = hostPinChange(i);
+			changes[count].micros = 0;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+// The frequency sending loop the DDS class had before it wrote the port registers
+// (32 tuning word bits then 8 control bits, least significant first, with digitalWrite())
+static void oldSendTuningWordToDDS(uint32_t freq)
+{
+	for (int b = 0; b < 32; b++, freq >>= 1)
+	{
+		digitalWrite(DDS_DATA_PIN, freq & 0x01);
+		pulseHigh(DDS_WORD_LOAD_CLOCK_PIN);
+	}
+
+	for (int b = 0; b < 8; b++)
+	{
+		digitalWrite(DDS_DATA_PIN, 0);
+		pulseHigh(DDS_WORD_LOAD_CLOCK_PIN);
+	}
+
+	pulseHigh(DDS_FREQUENCY_UPDATE_PIN);
+}
+
+static HostPinChange portChanges[HOST_PIN_LOG_SIZE];
+static HostPinChange oldChanges[HOST_PIN_LOG_SIZE];
+
+static void testPortWritesMatchTheOldBitOrder()
+{
+	// Port register version
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	dds.begin();
+
+	hostClearPinChanges();
+	uint32_t digitalWritesBefore = hostDigitalWriteCount();
+	uint32_t coreCallsBefore = hostCoreCallCount();
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		dds.sendFrequencyToDDS(kTestFrequencies[i]);
+	}
+
+	uint32_t portCoreCalls = (hostCoreCallCount() - coreCallsBefore) / TEST_FREQUENCY_COUNT;
+
+	// No digitalWrite() calls at all while sending
+	CHECK_EQUAL(0, hostDigitalWriteCount() - digitalWritesBefore);
+
+	uint16_t portChangeCount = ddsPinChanges(portChanges, HOST_PIN_LOG_SIZE);
+
+	HostDDSFrame frames[TEST_FREQUENCY_COUNT];
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT, decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN,
+														frames, TEST_FREQUENCY_COUNT));
+
+	// digitalWrite() version
+	hostReset();
+
+	pinMode(DDS_FREQUENCY_UPDATE_PIN, OUTPUT);
+	pinMode(DDS_WORD_LOAD_CLOCK_PIN, OUTPUT);
+	pinMode(DDS_DATA_PIN, OUTPUT);
+	pinMode(DDS_RESET_PIN, OUTPUT);
+	hostClearPinChanges();
+	digitalWritesBefore = hostDigitalWriteCount();
+	coreCallsBefore = hostCoreCallCount();
+
+	SCRadioTuningWord tuningWord(DDS_TUNING_WORD_MILLIONTHS);
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		oldSendTuningWordToDDS(tuningWord.frequencyToTuningWord(kTestFrequencies[i]));
+	}
+
+	uint32_t oldCoreCalls = (hostCoreCallCount() - coreCallsBefore) / TEST_FREQUENCY_COUNT;
+
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT * (40 * 3 + 2), hostDigitalWriteCount() - digitalWritesBefore);
+
+	// The simulated core can't count the Nano's cycles, so this counts the calls each
+	// version makes into the core for a frame.  Each digitalWrite() looks the pin up in the
+	// core's tables and saves and restores SREG.  The port version makes none of those
+	// lookups: its only core calls are the SREG saves and restores around each byte and
+	// the frequency update pulse.
+	printf("  core calls a frame: %lu with digitalWrite(), %lu with the port registers\n",
+		(unsigned long)oldCoreCalls, (unsigned long)portCoreCalls);
+
+	CHECK_EQUAL(40 * 3 + 2, oldCoreCalls);
+	CHECK(portCoreCalls <= 3 * (DDS_CHIP::FRAME_BYTES + 1));
+
+	uint16_t oldChangeCount = ddsPinChanges(oldChanges, HOST_PIN_LOG_SIZE);
+
+	// Same pins changing to the same levels in the same order
+	CHECK(!hostPinLogOverflowed());
+	CHECK_EQUAL(oldChangeCount, portChangeCount);
+
+	for (uint16_t i = 0; i < oldChangeCount && i < portChangeCount; i++)
+	{
+		if (!CHECK_EQUAL(oldChanges[i].pin, portChanges[i].pin) || !CHECK_EQUAL(oldChanges[i].level, portChanges[i].level))
+		{
+			printf("first difference at pin change %u\n", i);
+			break;
+		}
+	}
+
+	// And the DDS ends up with tuning word then control byte, 40 bits each time
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		uint32_t expected = tuningWord.frequencyToTuningWord(kTestFrequencies[i]);
+
+		CHECK_EQUAL(40, frames[i].bitCount);
+		CHECK_EQUAL(expected, (uint32_t)frames[i].bytes[0] | ((uint32_t)frames[i].bytes[1] << 8)
+								| ((uint32_t)frames[i].bytes[2] << 16) | ((uint32_t)frames[i].bytes[3] << 24));
+		CHECK_EQUAL(0x00, frames[i].bytes[4]);
+	}
+}
+
+int main()
+{
+	RUN_TEST(testPortWritesMatchTheOldBitOrder);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,96 @@
+/**
+ * DDSTransportTest.cpp - Bit banging and hardware SPI send the DDS the same frames
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+
+#include "SCRadioDDS.h"
+
+// Pins for hardware SPI (see DDS_TRANSPORT in SCRadioConstants.h)
+#define SPI_WORD_LOAD_CLOCK_PIN 13
+#define SPI_DATA_PIN            11
+#define SPI_FREQUENCY_UPDATE_PIN 9
+#define SPI_RESET_PIN           8
+
+#define TEST_FREQUENCY_COUNT 6
+
+static const int32_t kTestFrequencies[TEST_FREQUENCY_COUNT] = { 7000000, 7030000, 7030010, 7299999, 5592405, 14060000 };
+
+static HostDDSFrame bitBangFrames[TEST_FREQUENCY_COUNT];
+static HostDDSFrame spiFrames[TEST_FREQUENCY_COUNT];
+
+static void testBothTransportsSendTheSameFrames()
+{
+	// Bit bang
+	hostReset();
+
+	SCRadioDDS bitBangDDS(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+							DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	bitBangDDS.begin();
+	hostClearPinChanges();
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		bitBangDDS.sendFrequencyToDDS(kTestFrequencies[i]);
+	}
+
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT, decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN,
+														bitBangFrames, TEST_FREQUENCY_COUNT));
+	CHECK_EQUAL(0, hostSPIByteCount());
+
+	// Hardware SPI
+	hostReset();
+
+	SCRadioDDS spiDDS(SPI_WORD_LOAD_CLOCK_PIN, SPI_FREQUENCY_UPDATE_PIN, SPI_DATA_PIN, SPI_RESET_PIN,
+						DDS_TUNING_WORD_MILLIONTHS, DDSTransport::HARDWARE_SPI);
+	spiDDS.begin();
+	hostClearPinChanges();
+	hostClearSPI();
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		spiDDS.sendFrequencyToDDS(kTestFrequencies[i]);
+	}
+
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT, decodeDDSFrames(SPI_WORD_LOAD_CLOCK_PIN, SPI_DATA_PIN, SPI_FREQUENCY_UPDATE_PIN,
+														spiFrames, TEST_FREQUENCY_COUNT));
+
+	// Five bytes per frame, one transaction for each (loop() sends a byte a call)
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT * 5, hostSPIByteCount());
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT * 5, hostSPITransactionCount());
+
+	// The peripheral drives its own pins, so interrupts stay on while it shifts
+	CHECK_EQUAL(0, hostSPIBytesWithInterruptsOff());
+
+	// What the DDS latched is the same bit for bit, and it is what went over SPI
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		CHECK_EQUAL(40, bitBangFrames[i].bitCount);
+		CHECK_EQUAL(40, spiFrames[i].bitCount);
+
+		for (uint8_t b = 0; b < 5; b++)
+		{
+			CHECK_EQUAL(bitBangFrames[i].bytes[b], spiFrames[i].bytes[b]);
+			CHECK_EQUAL(bitBangFrames[i].bytes[b], hostSPIByte(i * 5 + b));
+		}
+	}
+}
+
+int main()
+{
+	RUN_TEST(testBothTransportsSendTheSameFrames);
+
+	return hostTestFinish();
+}
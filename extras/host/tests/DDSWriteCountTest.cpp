@@ -0,0 +1,198 @@
+/**
+ * DDSWriteCountTest.cpp - The DDS driver skips frames the DDS already has, sends frames a byte
+ * per loop() call, and counts what it sends and skips
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+
+#include "SCRadioDDS.h"
+
+static HostDDSFrame frames[8];
+
+// Frames the DDS latched since the pin recorder was cleared
+static uint8_t framesLatched()
+{
+	return decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN, frames, 8);
+}
+
+static bool frameIs(const HostDDSFrame &frame, SCRadioDDS &dds, int32_t frequency)
+{
+	SCRadioDDSFrame expected;
+	dds.buildFrame(frequency, expected);
+
+	return memcmp(frame.bytes, expected.bytes, DDS_CHIP::FRAME_BYTES) == 0;
+}
+
+static void testRepeatedFrequenciesAreSkipped()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	dds.begin();
+	hostClearPinChanges();
+
+	// The first frame always goes out
+	dds.sendFrequencyToDDS(7030000);
+	CHECK_EQUAL(1, dds.getWritesIssued());
+	CHECK_EQUAL(0, dds.getWritesElided());
+	CHECK_EQUAL(1, framesLatched());
+
+	// The same again doesn't touch the pins
+	hostClearPinChanges();
+	dds.sendFrequencyToDDS(7030000);
+	dds.sendFrequencyToDDS(7030000);
+	CHECK_EQUAL(1, dds.getWritesIssued());
+	CHECK_EQUAL(2, dds.getWritesElided());
+	CHECK_EQUAL(0, hostPinChangeCount());
+
+	// A new one does
+	dds.sendFrequencyToDDS(7030010);
+	CHECK_EQUAL(2, dds.getWritesIssued());
+	CHECK_EQUAL(2, dds.getWritesElided());
+	CHECK_EQUAL(1, framesLatched());
+	CHECK(frameIs(frames[0], dds, 7030010));
+
+	// After a reset the DDS has nothing, so the same frequency goes out again
+	dds.begin();
+	hostClearPinChanges();
+	dds.sendFrequencyToDDS(7030010);
+	CHECK_EQUAL(3, dds.getWritesIssued());
+	CHECK_EQUAL(2, dds.getWritesElided());
+	CHECK_EQUAL(1, framesLatched());
+}
+
+static void testOnlyTheNewestQueuedFrameIsSent()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	SCRadioDDSFrame frameA;
+	SCRadioDDSFrame frameB;
+	SCRadioDDSFrame frameC;
+
+	dds.buildFrame(7000000, frameA);
+	dds.buildFrame(7100000, frameB);
+	dds.buildFrame(7200000, frameC);
+
+	dds.begin();
+	hostClearPinChanges();
+
+	// Nothing goes out until loop() runs.  Each frame queued before then replaces the last.
+	dds.queueFrame(frameA);
+	dds.queueFrame(frameB);
+	dds.queueFrame(frameC);
+	CHECK(!dds.isFrameLatched());
+	CHECK_EQUAL(0, hostPinChangeCount());
+	CHECK_EQUAL(0, dds.getWritesIssued());
+	CHECK_EQUAL(2, dds.getWritesElided());
+
+	// Each loop() sends a byte.  The frame is latched after the last one.
+	for (int8_t b = 1; b < DDS_CHIP::FRAME_BYTES; b++)
+	{
+		dds.loop();
+		CHECK(!dds.isFrameLatched());
+	}
+
+	CHECK_EQUAL(0, framesLatched());
+
+	dds.loop();
+
+	CHECK(dds.isFrameLatched());
+	CHECK_EQUAL(1, dds.getWritesIssued());
+	CHECK_EQUAL(1, framesLatched());
+	CHECK(frameIs(frames[0], dds, 7200000));
+
+	// Going somewhere and straight back before loop() runs sends nothing
+	hostClearPinChanges();
+	dds.queueFrame(frameA);
+	dds.queueFrame(frameC);
+	CHECK(dds.isFrameLatched());
+	CHECK_EQUAL(4, dds.getWritesElided());
+
+	dds.loop();
+
+	CHECK_EQUAL(1, dds.getWritesIssued());
+	CHECK_EQUAL(0, hostPinChangeCount());
+}
+
+static void testFrameQueuedPartWayThroughWaits()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	SCRadioDDSFrame frameA;
+	SCRadioDDSFrame frameB;
+
+	dds.buildFrame(7000000, frameA);
+	dds.buildFrame(7100000, frameB);
+
+	dds.begin();
+	hostClearPinChanges();
+
+	// A is part way out when B is queued.  A is finished and latched, then B goes out.
+	dds.queueFrame(frameA);
+	dds.loop();
+	dds.loop();
+	dds.queueFrame(frameB);
+
+	// Queuing A again now is nothing new: the DDS will have it
+	dds.queueFrame(frameA);
+	CHECK_EQUAL(2, dds.getWritesElided());
+
+	dds.queueFrame(frameB);
+
+	uint8_t passes = 0;
+
+	for (; passes < 20 && !dds.isFrameLatched(); passes++)
+	{
+		dds.loop();
+	}
+
+	CHECK_EQUAL(2 * DDS_CHIP::FRAME_BYTES - 2, passes);
+	CHECK_EQUAL(2, dds.getWritesIssued());
+
+	if (CHECK_EQUAL(2, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], dds, 7000000));
+		CHECK(frameIs(frames[1], dds, 7100000));
+	}
+
+	// sendFrameToDDS() doesn't wait for loop(): it finishes what is part way out and
+	// its own frame before it returns
+	hostClearPinChanges();
+	dds.queueFrame(frameA);
+	dds.loop();
+	dds.sendFrameToDDS(frameB);
+
+	CHECK(dds.isFrameLatched());
+
+	if (CHECK_EQUAL(2, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], dds, 7000000));
+		CHECK(frameIs(frames[1], dds, 7100000));
+	}
+}
+
+int main()
+{
+	RUN_TEST(testRepeatedFrequenciesAreSkipped);
+	RUN_TEST(testOnlyTheNewestQueuedFrameIsSent);
+	RUN_TEST(testFrameQueuedPartWayThroughWaits);
+
+	return hostTestFinish();
+}
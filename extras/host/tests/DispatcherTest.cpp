@@ -0,0 +1,226 @@
+/**
+ * DispatcherTest.cpp - Each route calls its handlers in the order listed, events with no
+ * route call nothing, and what a dispatch costs next to the old EventManager listener list
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include <chrono>
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+
+#include "EventManager.h"
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+
+HostEventRecorder firstRecorder;
+HostEventRecorder secondRecorder;
+HostEventRecorder thirdRecorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(firstRecorder, record)>,
+	SCRadioEventRoute<EventType::FREQUENCY_CHANGED,
+		EVENT_HANDLER(firstRecorder, record),
+		EVENT_HANDLER(secondRecorder, record),
+		EVENT_HANDLER(thirdRecorder, record)>,
+	SCRadioEventRoute<EventType::RIT_CHANGED,
+		EVENT_HANDLER(thirdRecorder, record),
+		EVENT_HANDLER(firstRecorder, record)>
+> TestDispatcher;
+
+static void clearRecorders()
+{
+	firstRecorder.clear();
+	secondRecorder.clear();
+	thirdRecorder.clear();
+}
+
+static SCRadioEventPayload payloadOf(int32_t value)
+{
+	SCRadioEventPayload payload;
+	payload.value = value;
+	return payload;
+}
+
+static void testHandlersAreCalledInTheOrderListed()
+{
+	clearRecorders();
+
+	CHECK_EQUAL(3, TestDispatcher::dispatch(static_cast<int>(EventType::FREQUENCY_CHANGED), payloadOf(7030000)));
+
+	if (CHECK_EQUAL(1, firstRecorder.count) && CHECK_EQUAL(1, secondRecorder.count) && CHECK_EQUAL(1, thirdRecorder.count))
+	{
+		CHECK(firstRecorder.callOrder[0] < secondRecorder.callOrder[0]);
+		CHECK(secondRecorder.callOrder[0] < thirdRecorder.callOrder[0]);
+
+		// Every handler gets the same code and payload
+		CHECK_EQUAL(static_cast<int>(EventType::FREQUENCY_CHANGED), thirdRecorder.eventCodes[0]);
+		CHECK_EQUAL(7030000, firstRecorder.eventPayloads[0].hertz);
+		CHECK_EQUAL(7030000, thirdRecorder.eventPayloads[0].hertz);
+	}
+
+	// A different route lists the same objects the other way around
+	clearRecorders();
+
+	CHECK_EQUAL(2, TestDispatcher::dispatch(static_cast<int>(EventType::RIT_CHANGED), payloadOf(-150)));
+	CHECK_EQUAL(0, secondRecorder.count);
+
+	if (CHECK_EQUAL(1, firstRecorder.count) && CHECK_EQUAL(1, thirdRecorder.count))
+	{
+		CHECK(thirdRecorder.callOrder[0] < firstRecorder.callOrder[0]);
+		CHECK_EQUAL(-150, firstRecorder.eventPayloads[0].value);
+	}
+
+	clearRecorders();
+
+	CHECK_EQUAL(1, TestDispatcher::dispatch(static_cast<int>(EventType::KEY_LINE_CHANGED), payloadOf(0)));
+	CHECK_EQUAL(1, firstRecorder.count);
+	CHECK_EQUAL(0, secondRecorder.count + thirdRecorder.count);
+}
+
+static void testEventsWithNoRouteCallNothing()
+{
+	clearRecorders();
+
+	CHECK_EQUAL(0, TestDispatcher::dispatch(static_cast<int>(EventType::ERROR_OCCURRED), payloadOf(1)));
+	CHECK_EQUAL(0, TestDispatcher::dispatch(static_cast<int>(EventType::VFO_KNOB_TURNED), payloadOf(1)));
+	CHECK_EQUAL(0, TestDispatcher::dispatch(0, payloadOf(1)));
+	CHECK_EQUAL(0, SCRadioEventDispatcher<>::dispatch(static_cast<int>(EventType::FREQUENCY_CHANGED), payloadOf(1)));
+	CHECK_EQUAL(0, firstRecorder.count + secondRecorder.count + thirdRecorder.count);
+
+	// Through the queue: processEvent() reports 0 listeners for an event nothing is routed to,
+	// and the event is still taken off the queue (nothing is left after)
+	SCRadioEventQueue queue;
+
+	CHECK(queue.queueEvent(static_cast<int>(EventType::ERROR_OCCURRED), 1));
+	CHECK(queue.queueEvent(static_cast<int>(EventType::FREQUENCY_CHANGED), 7000000));
+	CHECK_EQUAL(0, queue.processEvent<TestDispatcher>());
+	CHECK_EQUAL(3, queue.processEvent<TestDispatcher>());
+	CHECK_EQUAL(0, queue.processAllEvents<TestDispatcher>());
+}
+
+// The old way: a plain function per listener, found by walking EventManager's list
+
+static void firstTrampoline(int eventCode, int eventParam)
+{
+	firstRecorder.record(eventCode, payloadOf(eventParam));
+}
+
+static void secondTrampoline(int eventCode, int eventParam)
+{
+	secondRecorder.record(eventCode, payloadOf(eventParam));
+}
+
+static void thirdTrampoline(int eventCode, int eventParam)
+{
+	thirdRecorder.record(eventCode, payloadOf(eventParam));
+}
+
+// The old way's list: one entry per listener, walked from the top for every event
+// (the same loop EventManager::sendEvent() runs)
+struct OldListener
+{
+	int eventCode;
+	void (*listener)(int eventCode, int eventParam);
+};
+
+static const OldListener oldListeners[EVENTMANAGER_LISTENER_LIST_SIZE] = {
+	{static_cast<int>(EventType::KEY_LINE_CHANGED), firstTrampoline},
+	{static_cast<int>(EventType::FREQUENCY_CHANGED), firstTrampoline},
+	{static_cast<int>(EventType::FREQUENCY_CHANGED), secondTrampoline},
+	{static_cast<int>(EventType::FREQUENCY_CHANGED), thirdTrampoline},
+	{static_cast<int>(EventType::RIT_CHANGED), thirdTrampoline},
+	{static_cast<int>(EventType::RIT_CHANGED), firstTrampoline},
+	{static_cast<int>(EventType::ERROR_OCCURRED), secondTrampoline},
+	{static_cast<int>(EventType::ERROR_CLEARED), secondTrampoline}
+};
+
+static int oldDispatch(int eventCode, int eventParam)
+{
+	int handlerCount = 0;
+
+	for (uint8_t i = 0; i < EVENTMANAGER_LISTENER_LIST_SIZE; i++)
+	{
+		if (oldListeners[i].eventCode == eventCode)
+		{
+			oldListeners[i].listener(eventCode, eventParam);
+			handlerCount++;
+		}
+	}
+
+	return handlerCount;
+}
+
+static double nanosecondsPerEvent(std::chrono::steady_clock::time_point start, uint32_t events)
+{
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / events;
+}
+
+static void testDispatchCost()
+{
+	const int eventCodes[] = {
+		static_cast<int>(EventType::KEY_LINE_CHANGED),
+		static_cast<int>(EventType::FREQUENCY_CHANGED),
+		static_cast<int>(EventType::RIT_CHANGED),
+		static_cast<int>(EventType::VFO_KNOB_TURNED)
+	};
+	const uint32_t kRounds = 500000;
+	const uint32_t kEvents = kRounds * 4;
+
+	// Both have to call the same handlers the same number of times
+	uint32_t oldHandlerCount = 0;
+	hostEventCallCount() = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < kRounds; i++)
+	{
+		for (uint8_t j = 0; j < 4; j++)
+		{
+			oldHandlerCount += oldDispatch(eventCodes[j], i);
+		}
+	}
+
+	double oldCost = nanosecondsPerEvent(start, kEvents);
+	uint16_t oldCalls = hostEventCallCount();
+
+	uint32_t newHandlerCount = 0;
+	hostEventCallCount() = 0;
+	start = std::chrono::steady_clock::now();
+
+	for (uint32_t i = 0; i < kRounds; i++)
+	{
+		for (uint8_t j = 0; j < 4; j++)
+		{
+			newHandlerCount += TestDispatcher::dispatch(eventCodes[j], payloadOf(i));
+		}
+	}
+
+	double newCost = nanosecondsPerEvent(start, kEvents);
+
+	CHECK_EQUAL(kRounds * 6, oldHandlerCount);
+	CHECK_EQUAL(oldHandlerCount, newHandlerCount);
+	CHECK_EQUAL(oldCalls, hostEventCallCount());
+
+	// Times on a PC are only a guide to the Nano, so they are printed rather than checked
+	printf("dispatch cost per event: listener list %.1f ns, SCRadioEventDispatcher %.1f ns\n", oldCost, newCost);
+}
+
+int main()
+{
+	RUN_TEST(testHandlersAreCalledInTheOrderListed);
+	RUN_TEST(testEventsWithNoRouteCallNothing);
+	RUN_TEST(testDispatchCost);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,265 @@
+/**
+ * EventBudgetTest.cpp - processEventsWithinBudget() stops when its time is up, always handles
+ * one batch, sends high priority events first and picks up a key line event queued by an
+ * interrupt part way through a burst after one batch at most
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+
+/**
+ * How long each slow event takes to handle (about what a display update takes)
+ */
+#define SLOW_LISTENER_MICROS 300
+
+SCRadioEventQueue queue;
+
+/**
+ * SlowListener
+ *
+ * @detail
+ *   Writes down each event and takes SLOW_LISTENER_MICROS doing it.  On the call
+ *   numbered keyDownOnCall the keyer's interrupt "presses the key".
+ */
+class SlowListener
+{
+public:
+	HostEventRecorder recorder;
+	int keyDownOnCall;
+	uint32_t keyDownMicros;
+
+	void clear()
+	{
+		recorder.clear();
+		keyDownOnCall = -1;
+		keyDownMicros = 0;
+	}
+
+	void handle(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		if (recorder.count == keyDownOnCall)
+		{
+			keyDownMicros = micros();
+			queue.queueEventFromISR(static_cast<int>(EventType::KEY_LINE_CHANGED), 1, SCRadioEventQueue::kHighPriority);
+		}
+
+		recorder.record(eventCode, eventPayload);
+		hostAdvanceMicros(SLOW_LISTENER_MICROS);
+	}
+};
+
+SlowListener slowListener;
+HostEventRecorder keyRecorder;
+HostEventRecorder knobRecorder;
+uint32_t keyHandledMicros;
+
+/**
+ * KeyTimer
+ *
+ * @detail
+ *   Notes when the key line event is handled
+ */
+class KeyTimer
+{
+public:
+	void handle(int, SCRadioEventPayload)
+	{
+		keyHandledMicros = micros();
+	}
+};
+
+KeyTimer keyTimer;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyRecorder, record), EVENT_HANDLER(keyTimer, handle)>,
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED, EVENT_HANDLER(knobRecorder, record)>,
+	SCRadioEventRoute<EventType::FREQUENCY_CHANGED, EVENT_HANDLER(slowListener, handle)>
+> TestDispatcher;
+
+static const int kFrequency = static_cast<int>(EventType::FREQUENCY_CHANGED);
+static const int kKnob = static_cast<int>(EventType::VFO_KNOB_TURNED);
+static const int kKey = static_cast<int>(EventType::KEY_LINE_CHANGED);
+
+static void startTest()
+{
+	hostReset();
+	queue.processAllEvents<TestDispatcher>();
+	slowListener.clear();
+	keyRecorder.clear();
+	knobRecorder.clear();
+	keyHandledMicros = 0;
+}
+
+static void queueSlowEvents(int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		queue.queueEvent(kFrequency, 7030000 + i);
+	}
+}
+
+static void testStopsWhenTheBudgetIsUsed()
+{
+	startTest();
+	uint16_t budgetExceeded = queue.getBudgetExceededCount();
+
+	// 12 events at 300 us each is 3.6 ms of work for a 1 ms budget
+	queueSlowEvents(12);
+	uint32_t startMicros = micros();
+
+	queue.processEventsWithinBudget<TestDispatcher>(1000);
+
+	// Batches of 2 (600 us) are started until 1 ms has gone by: 2 batches, 4 events
+	CHECK_EQUAL(2 * EVENT_PROCESSING_BATCH_SIZE, slowListener.recorder.count);
+	CHECK(micros() - startMicros < 1000 + EVENT_PROCESSING_BATCH_SIZE * SLOW_LISTENER_MICROS);
+	CHECK_EQUAL(budgetExceeded + 1, queue.getBudgetExceededCount());
+
+	// The rest are handled in order on the following passes
+	while (slowListener.recorder.count < 12)
+	{
+		queue.processEventsWithinBudget<TestDispatcher>(1000);
+	}
+
+	for (int i = 0; i < 12; i++)
+	{
+		CHECK_EQUAL(7030000 + i, slowListener.recorder.eventPayloads[i].hertz);
+	}
+
+	// 3 passes.  The last one finishes with nothing left over, so it isn't counted.
+	CHECK_EQUAL(budgetExceeded + 2, queue.getBudgetExceededCount());
+	CHECK_EQUAL(0, queue.processAllEvents<TestDispatcher>());
+}
+
+static void testAlwaysHandlesOneBatch()
+{
+	startTest();
+	queueSlowEvents(5);
+
+	// A budget of 0 still handles a batch so events can't be put off forever
+	queue.processEventsWithinBudget<TestDispatcher>(0);
+	CHECK_EQUAL(EVENT_PROCESSING_BATCH_SIZE, slowListener.recorder.count);
+
+	queue.processAllEvents<TestDispatcher>();
+}
+
+static void testHighPriorityGoesFirst()
+{
+	startTest();
+	queueSlowEvents(3);
+	queue.queueEvent(kKnob, 1, SCRadioEventQueue::kHighPriority);
+	queue.queueEvent(kKey, 1, SCRadioEventQueue::kHighPriority);
+
+	// The key line has two listeners
+	CHECK_EQUAL(6, queue.processEventsWithinBudget<TestDispatcher>(10000));
+
+	if (CHECK_EQUAL(1, knobRecorder.count) && CHECK_EQUAL(1, keyRecorder.count) && CHECK_EQUAL(3, slowListener.recorder.count))
+	{
+		CHECK(knobRecorder.callOrder[0] < keyRecorder.callOrder[0]);
+		CHECK(keyRecorder.callOrder[0] < slowListener.recorder.callOrder[0]);
+	}
+}
+
+static void testKeyLineQueuedDuringABurstWaitsOneBatch()
+{
+	// The key goes down during slow event number 'call'.  It has to be handled as soon as
+	// that batch is done, before any more slow events.
+	for (int call = 0; call < 8; call++)
+	{
+		startTest();
+		queueSlowEvents(8);
+		slowListener.keyDownOnCall = call;
+
+		queue.processEventsWithinBudget<TestDispatcher>(10000);
+
+		if (!CHECK_EQUAL(1, keyRecorder.count))
+		{
+			continue;
+		}
+
+		int batchEnd = (call / EVENT_PROCESSING_BATCH_SIZE + 1) * EVENT_PROCESSING_BATCH_SIZE;
+		uint16_t keyOrder = keyRecorder.callOrder[0];
+
+		CHECK(slowListener.recorder.callOrder[batchEnd - 1] < keyOrder);
+
+		if (batchEnd < 8)
+		{
+			CHECK(keyOrder < slowListener.recorder.callOrder[batchEnd]);
+		}
+	}
+}
+
+static void testKeyLineQueuedAtTheEndIsNotLeftForTheNextLoop()
+{
+	startTest();
+	queueSlowEvents(8);
+
+	// The key goes down in the last batch the budget allows
+	slowListener.keyDownOnCall = 2 * EVENT_PROCESSING_BATCH_SIZE - 1;
+
+	queue.processEventsWithinBudget<TestDispatcher>(1000);
+
+	CHECK_EQUAL(2 * EVENT_PROCESSING_BATCH_SIZE, slowListener.recorder.count);
+	CHECK_EQUAL(1, keyRecorder.count);
+
+	queue.processAllEvents<TestDispatcher>();
+}
+
+static void testWorstCaseKeyLineLatency()
+{
+	// Lands the key at each slow event of a burst and keeps the longest wait between
+	// the interrupt queuing it and the key line listener being called
+	uint32_t worstMicros = 0;
+
+	for (int call = 0; call < 12; call++)
+	{
+		startTest();
+		queueSlowEvents(12);
+		slowListener.keyDownOnCall = call;
+
+		while (keyRecorder.count == 0)
+		{
+			queue.processEventsWithinBudget<TestDispatcher>(EVENT_PROCESSING_BUDGET_MICROS);
+		}
+
+		uint32_t waitMicros = keyHandledMicros - slowListener.keyDownMicros;
+
+		if (waitMicros > worstMicros)
+		{
+			worstMicros = waitMicros;
+		}
+
+		queue.processAllEvents<TestDispatcher>();
+	}
+
+	printf("worst key line wait during a burst of %d us events: %lu us\n", SLOW_LISTENER_MICROS, (unsigned long)worstMicros);
+
+	// Never longer than one batch of slow events
+	CHECK(worstMicros <= EVENT_PROCESSING_BATCH_SIZE * SLOW_LISTENER_MICROS);
+}
+
+int main()
+{
+	RUN_TEST(testStopsWhenTheBudgetIsUsed);
+	RUN_TEST(testAlwaysHandlesOneBatch);
+	RUN_TEST(testHighPriorityGoesFirst);
+	RUN_TEST(testKeyLineQueuedDuringABurstWaitsOneBatch);
+	RUN_TEST(testKeyLineQueuedAtTheEndIsNotLeftForTheNextLoop);
+	RUN_TEST(testWorstCaseKeyLineLatency);
+
+	return hostTestFinish();
+}
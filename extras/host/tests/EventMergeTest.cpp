@@ -0,0 +1,262 @@
+/**
+ * EventMergeTest.cpp - queueOrMergeEvent() only merges into the newest waiting event of the
+ * same type, and a fast spin of the knob costs one DDS write and one display refresh
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+#include "HostKnob.h"
+#include "HostSketch.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "SCRadioDDS.h"
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+
+extern SCRadioDDS dds;
+extern LiquidCrystal_I2C lcd;
+
+HostEventRecorder recorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::RIT_KNOB_TURNED, EVENT_HANDLER(recorder, record)>,
+	SCRadioEventRoute<EventType::MENU_KNOB_TURNED, EVENT_HANDLER(recorder, record)>,
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED, EVENT_HANDLER(recorder, record)>
+> TestDispatcher;
+
+static const int kRitKnob = static_cast<int>(EventType::RIT_KNOB_TURNED);
+static const int kMenuKnob = static_cast<int>(EventType::MENU_KNOB_TURNED);
+static const int kVfoKnob = static_cast<int>(EventType::VFO_KNOB_TURNED);
+
+static void testSameTypeMerges()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		CHECK(queue.queueOrMergeEvent(kRitKnob, 1));
+	}
+
+	CHECK(queue.queueOrMergeEvent(kRitKnob, -2));
+
+	CHECK_EQUAL(5, queue.getMergedEventCount());
+	CHECK_EQUAL(1, queue.getHighWaterMark(SCRadioEventQueue::kLowPriority));
+
+	queue.processAllEvents<TestDispatcher>();
+
+	if (CHECK_EQUAL(1, recorder.count))
+	{
+		CHECK_EQUAL(3, recorder.eventPayloads[0].value);
+	}
+}
+
+static void testNoMergeAcrossOtherEvents()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	// Another event in between: merging would move the second turn ahead of it
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1));
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, 1));
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1));
+
+	// Only the newest waiting event counts, so this one merges into the second RIT turn
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 4));
+
+	CHECK_EQUAL(1, queue.getMergedEventCount());
+
+	queue.processAllEvents<TestDispatcher>();
+
+	if (CHECK_EQUAL(3, recorder.count))
+	{
+		CHECK_EQUAL(kRitKnob, recorder.eventCodes[0]);
+		CHECK_EQUAL(1, recorder.eventPayloads[0].value);
+		CHECK_EQUAL(kMenuKnob, recorder.eventCodes[1]);
+		CHECK_EQUAL(kRitKnob, recorder.eventCodes[2]);
+		CHECK_EQUAL(5, recorder.eventPayloads[2].value);
+	}
+
+	// An event that was already handled isn't merged into
+	recorder.clear();
+
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1));
+	queue.processAllEvents<TestDispatcher>();
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1));
+	queue.processAllEvents<TestDispatcher>();
+
+	CHECK_EQUAL(2, recorder.count);
+	CHECK_EQUAL(1, queue.getMergedEventCount());
+}
+
+static void testNoMergeAcrossLanes()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1, SCRadioEventQueue::kHighPriority));
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 1, SCRadioEventQueue::kLowPriority));
+
+	CHECK_EQUAL(0, queue.getMergedEventCount());
+
+	queue.processAllEvents<TestDispatcher>();
+
+	CHECK_EQUAL(2, recorder.count);
+}
+
+static void testTurnsThatCancelOutRemoveTheEvent()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, 1));
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 3));
+	CHECK(queue.queueOrMergeEvent(kRitKnob, -3));
+
+	// The RIT turn is gone, so the next one can't merge into it, but the menu turn is still there
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, 1));
+
+	queue.processAllEvents<TestDispatcher>();
+
+	if (CHECK_EQUAL(1, recorder.count))
+	{
+		CHECK_EQUAL(kMenuKnob, recorder.eventCodes[0]);
+		CHECK_EQUAL(2, recorder.eventPayloads[0].value);
+	}
+}
+
+static void testMergedCountStopsAtTheLimits()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 30000));
+	CHECK(queue.queueOrMergeEvent(kRitKnob, 30000));
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, -30000));
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, -30000));
+
+	queue.processAllEvents<TestDispatcher>();
+
+	if (CHECK_EQUAL(2, recorder.count))
+	{
+		CHECK_EQUAL(32767, recorder.eventPayloads[0].value);
+		CHECK_EQUAL(-32768, recorder.eventPayloads[1].value);
+	}
+}
+
+static void testMergingWorksInAFullLane()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	for (uint8_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK(queue.queueOrMergeEvent((i & 1) ? kMenuKnob : kRitKnob, 1));
+	}
+
+	// The newest is a menu turn, so another one still fits.  A RIT turn doesn't.
+	CHECK(queue.queueOrMergeEvent(kMenuKnob, 1));
+	CHECK(!queue.queueOrMergeEvent(kRitKnob, 1));
+	CHECK_EQUAL(1, queue.getDroppedEventCount());
+}
+
+static void testKnobTurnAveragesTheIntervals()
+{
+	SCRadioEventQueue queue;
+	recorder.clear();
+
+	CHECK(queue.queueOrMergeKnobTurnEvent(kVfoKnob, 2, 9000));
+	CHECK(queue.queueOrMergeKnobTurnEvent(kVfoKnob, 3, 4000));
+	CHECK(queue.queueOrMergeKnobTurnEvent(kVfoKnob, -1, 2500));
+
+	queue.processAllEvents<TestDispatcher>();
+
+	if (CHECK_EQUAL(1, recorder.count))
+	{
+		// 2 steps at 9 ms, 3 at 4 ms and 1 at 2.5 ms: 32.5 ms over 6 steps
+		CHECK_EQUAL(4, recorder.eventPayloads[0].knobTurn.steps);
+		CHECK_EQUAL(5416, recorder.eventPayloads[0].knobTurn.stepIntervalMicros);
+	}
+}
+
+/**
+ * Turns the knob 'steps' detents clockwise, each one 'stepMicros' long, and runs
+ * the sketch every 'loopEverySteps' detents for long enough for the DDS to take a
+ * frame (it sends a byte each loop() pass)
+ */
+static void spinKnob(uint8_t steps, uint32_t stepMicros, uint8_t loopEverySteps)
+{
+	for (uint8_t i = 1; i <= steps; i++)
+	{
+		turnMainKnobOneStep(true, stepMicros / 4);
+
+		if ((i % loopEverySteps) == 0)
+		{
+			runSketch(DDS_CHIP::FRAME_BYTES * HOST_LOOP_MICROS);
+		}
+	}
+
+	// Let the handlers and the DDS finish
+	runSketch(10000);
+}
+
+static void testFastSpinCostsOneWrite()
+{
+	startSketch();
+	runSketch(100000);
+
+	// The sketch runs after each detent: every detent is its own frequency change
+	uint32_t writesBefore = dds.getWritesIssued();
+	uint32_t printsBefore = lcd.hostPrintCount();
+	char frequencyBefore[LCD_COLUMNS + 1];
+	strcpy(frequencyBefore, lcd.hostLine(0));
+
+	spinKnob(20, 2000, 1);
+
+	uint32_t slowWrites = dds.getWritesIssued() - writesBefore;
+	uint32_t slowPrints = lcd.hostPrintCount() - printsBefore;
+
+	CHECK_EQUAL(20, slowWrites);
+	CHECK(strcmp(frequencyBefore, lcd.hostLine(0)) != 0);
+
+	// The same 20 detents while loop() is busy (the sketch runs once after all of them):
+	// one frequency change, one DDS write and one display refresh
+	writesBefore = dds.getWritesIssued();
+	printsBefore = lcd.hostPrintCount();
+
+	spinKnob(20, 2000, 20);
+
+	uint32_t fastWrites = dds.getWritesIssued() - writesBefore;
+	uint32_t fastPrints = lcd.hostPrintCount() - printsBefore;
+
+	CHECK_EQUAL(1, fastWrites);
+	CHECK_EQUAL(slowPrints / 20, fastPrints);
+
+	printf("20 detents: %lu DDS writes and %lu LCD prints one at a time, %lu and %lu merged\n",
+		(unsigned long)slowWrites, (unsigned long)slowPrints, (unsigned long)fastWrites, (unsigned long)fastPrints);
+}
+
+int main()
+{
+	RUN_TEST(testSameTypeMerges);
+	RUN_TEST(testNoMergeAcrossOtherEvents);
+	RUN_TEST(testNoMergeAcrossLanes);
+	RUN_TEST(testTurnsThatCancelOutRemoveTheEvent);
+	RUN_TEST(testMergedCountStopsAtTheLimits);
+	RUN_TEST(testMergingWorksInAFullLane);
+	RUN_TEST(testKnobTurnAveragesTheIntervals);
+	RUN_TEST(testFastSpinCostsOneWrite);
+
+	return hostTestFinish();
+}
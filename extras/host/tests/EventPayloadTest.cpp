@@ -0,0 +1,227 @@
+/**
+ * EventPayloadTest.cpp - Every listener reads the payload member its event's sender filled in
+ *
+ * The payload is a union, so a listener reading a different member than the sender wrote
+ * still compiles but gets the wrong number (a menu item event read as .value is the
+ * menu item number and value mixed together).  Each check here starts at the real sender
+ * in the running sketch and looks at what the listener did with it, using numbers that
+ * come out wrong if the two don't match.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKnob.h"
+#include "HostSketch.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "SCRadioMenuItem.h"
+#include "SCRadioMenuItemNameValue.h"
+
+extern LiquidCrystal_I2C lcd;
+extern SCRadioMenuItem keyerSpeedMenuItem;
+extern SCRadioMenuItem keyerEffectiveSpeedMenuItem;
+extern SCRadioMenuItem keyerDahRatioMenuItem;
+extern SCRadioMenuItem keyerCompensationMenuItem;
+extern SCRadioMenuItem sidetonePitchMenuItem;
+extern SCRadioMenuItem sidetoneVolumeMenuItem;
+extern SCRadioMenuItemNameValue keyerModeMenuItem;
+extern SCRadioMenuItemNameValue paddlesOrientationMenuItem;
+extern SCRadioMenuItemNameValue rxOffsetDirectionMenuItem;
+extern SCRadioMenuItemNameValue ritOnOffMenuItem;
+extern SCRadioMenuItemNameValue backlightOnOffMenuItem;
+extern SCRadioMenuItemNameValue keyerMessageMenuItem;
+
+// What one of the EEPROM's stored values holds (4 bytes each, low byte first)
+static int32_t storedValue(EEPROMValueIndex whichValue)
+{
+	const uint8_t *bytes = hostEEPROMData() + static_cast<uint8_t>(whichValue) * 4;
+
+	return (int32_t)((uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+}
+
+static void pressMainKnobButton(uint32_t holdMicros)
+{
+	hostSetPin(MAIN_KNOB_SWITCH_PIN, LOW);
+	runSketch(holdMicros);
+	hostSetPin(MAIN_KNOB_SWITCH_PIN, HIGH);
+	runSketch(100000);
+}
+
+static void turnMainKnob(int8_t steps)
+{
+	for (int8_t i = 0; i < abs(steps); i++)
+	{
+		turnMainKnobOneStep(steps > 0, 5000);
+		runSketch(20000);
+	}
+
+	runSketch(100000);
+}
+
+// knobTurn from the knob, hertz from the VFO to the display and the EEPROM
+static void testFrequencyChange()
+{
+	startSketch();
+	runSketch(100000);
+
+	turnMainKnob(3);
+
+	CHECK_TEXT("7.030.030 MHz  n", lcd.hostLine(0));
+
+	runSketch((MIN_EPROM_WRITE_INTERVAL + 1000) * 1000UL);
+
+	CHECK_EQUAL(7030030, storedValue(EEPROMValueIndex::OPERATING_FREQUENCY));
+}
+
+// value from the knob's button to the display, knobTurn and hertz for RIT, and menuItem
+// from the VFO to the RIT menu item
+static void testRITChange()
+{
+	startSketch();
+	runSketch(100000);
+
+	pressMainKnobButton((LONG_PRESS_THRESHOLD_MS + 100) * 1000UL);
+
+	CHECK_TEXT("  RIT     0 Hz  ", lcd.hostLine(1));
+
+	turnMainKnob(-4);
+
+	CHECK_TEXT("  RIT   -40 Hz  ", lcd.hostLine(1));
+	CHECK_EQUAL(static_cast<int>(RitStatus::ENABLED), ritOnOffMenuItem.getMenuItemValue());
+
+	turnMainKnob(4);
+
+	CHECK_TEXT("  RIT     0 Hz  ", lcd.hostLine(1));
+	CHECK_EQUAL(static_cast<int>(RitStatus::DISABLED), ritOnOffMenuItem.getMenuItemValue());
+
+	// menuItem from the RIT menu item to the VFO.  The frequency line shows 'r' while RIT is on.
+	turnMainKnob(2);
+
+	CHECK_TEXT("  RIT    20 Hz  ", lcd.hostLine(1));
+
+	ritOnOffMenuItem.adjustMenuItemValue(-1);
+	pressMainKnobButton(100000);
+	turnMainKnob(1);
+
+	CHECK_TEXT("7.030.010 MHz  n", lcd.hostLine(0));
+
+	ritOnOffMenuItem.adjustMenuItemValue(1);
+	turnMainKnob(1);
+
+	CHECK_TEXT("7.030.020 MHz rn", lcd.hostLine(0));
+}
+
+// menuItem from the menu items to the keyer, sidetone and EEPROM listeners
+static void testMenuItemChangesAreStored()
+{
+	startSketch();
+	runSketch(100000);
+
+	keyerModeMenuItem.adjustMenuItemValue(2);
+	keyerSpeedMenuItem.adjustMenuItemValue(11);
+	paddlesOrientationMenuItem.adjustMenuItemValue(1);
+	sidetonePitchMenuItem.adjustMenuItemValue(-13);
+	sidetoneVolumeMenuItem.adjustMenuItemValue(-2);
+	keyerEffectiveSpeedMenuItem.adjustMenuItemValue(9);
+	keyerDahRatioMenuItem.adjustMenuItemValue(7);
+	keyerCompensationMenuItem.adjustMenuItemValue(23);
+
+	runSketch((MIN_EPROM_WRITE_INTERVAL + 1000) * 1000UL);
+
+	CHECK_EQUAL(keyerModeMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::KEYER_MODE));
+	CHECK_EQUAL(keyerSpeedMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::KEYER_SPEED));
+	CHECK_EQUAL(paddlesOrientationMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::PADDLES_ORIENTATION));
+	CHECK_EQUAL(sidetonePitchMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::SIDETONE_PITCH));
+	CHECK_EQUAL(sidetoneVolumeMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::SIDETONE_VOLUME));
+	CHECK_EQUAL(keyerEffectiveSpeedMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::KEYER_EFFECTIVE_SPEED));
+	CHECK_EQUAL(keyerDahRatioMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::KEYER_DAH_RATIO));
+	CHECK_EQUAL(keyerCompensationMenuItem.getMenuItemValue(), storedValue(EEPROMValueIndex::KEYER_COMPENSATION));
+
+	CHECK_EQUAL(2, storedValue(EEPROMValueIndex::KEYER_MODE));
+	CHECK_EQUAL(1, storedValue(EEPROMValueIndex::PADDLES_ORIENTATION));
+	CHECK_EQUAL(9, storedValue(EEPROMValueIndex::KEYER_EFFECTIVE_SPEED));
+	CHECK_EQUAL(37, storedValue(EEPROMValueIndex::KEYER_DAH_RATIO));
+	CHECK_EQUAL(2300, storedValue(EEPROMValueIndex::KEYER_COMPENSATION));
+}
+
+// menuItem from the menu items to the VFO and the display
+static void testMenuItemChangesReachTheVFOAndDisplay()
+{
+	startSketch();
+	runSketch(100000);
+
+	// The frequency line shows the new direction the next time the frequency changes
+	rxOffsetDirectionMenuItem.adjustMenuItemValue(1);
+	turnMainKnob(1);
+
+	CHECK_TEXT("7.030.010 MHz  p", lcd.hostLine(0));
+
+	backlightOnOffMenuItem.adjustMenuItemValue(-1);
+	runSketch(100000);
+
+	CHECK(!lcd.hostBacklight());
+}
+
+// value from the voltage monitor to the display
+static void testVoltageChange()
+{
+	startSketch();
+
+	hostSetAnalog(RIG_VOLTAGE_READ_PIN, 800);
+	runSketch(4000000);
+
+}
+
+// menuItem from the message menu item to the keyer, value for the key line to the
+// VFO and the sidetone, and menuItem from the keyer back to the menu item at the end
+static void testKeyerMessage()
+{
+	startSketch();
+	runSketch(100000);
+
+	// Quick enough to finish the message in a few seconds, and loud enough to hear
+	keyerSpeedMenuItem.adjustMenuItemValue(25);
+	sidetoneVolumeMenuItem.adjustMenuItemValue(5);
+	keyerMessageMenuItem.adjustMenuItemValue(1);
+	runSketch(100000);
+
+	CHECK_EQUAL(1, keyerMessageMenuItem.getMenuItemValue());
+
+	bool keyedOut = false;
+	bool sidetoneSounded = false;
+
+	for (uint16_t i = 0; (i < 60000) && (keyerMessageMenuItem.getMenuItemValue() != 0); i++)
+	{
+		runSketch(1000);
+
+		keyedOut = keyedOut || (hostPinLevel(KEY_OUT_PIN) == HIGH);
+		sidetoneSounded = sidetoneSounded || (hostPinLevel(SIDETONE_PIN) == HIGH);
+	}
+
+	CHECK(keyedOut);
+	CHECK(sidetoneSounded);
+	CHECK_EQUAL(0, keyerMessageMenuItem.getMenuItemValue());
+}
+
+int main()
+{
+	RUN_TEST(testFrequencyChange);
+	RUN_TEST(testRITChange);
+	RUN_TEST(testMenuItemChangesAreStored);
+	RUN_TEST(testMenuItemChangesReachTheVFOAndDisplay);
+	RUN_TEST(testVoltageChange);
+	RUN_TEST(testKeyerMessage);
+
+	return hostTestFinish();
+}
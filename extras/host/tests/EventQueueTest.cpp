@@ -0,0 +1,169 @@
+/**
+ * EventQueueTest.cpp - The event queue's lanes fill up, drop, count and wrap around the way they should
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+
+HostEventRecorder knobRecorder;
+HostEventRecorder keyRecorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyRecorder, record)>,
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED, EVENT_HANDLER(knobRecorder, record)>
+> TestDispatcher;
+
+static const int kKnob = static_cast<int>(EventType::VFO_KNOB_TURNED);
+static const int kKey = static_cast<int>(EventType::KEY_LINE_CHANGED);
+
+static void clearRecorders()
+{
+	knobRecorder.clear();
+	keyRecorder.clear();
+}
+
+static void testFullLaneDropsAndCounts()
+{
+	SCRadioEventQueue queue;
+	clearRecorders();
+
+	for (int16_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK(queue.queueEvent(kKnob, i));
+	}
+
+	// The lane is full.  The next one is dropped and counted, the waiting ones are untouched.
+	CHECK(!queue.queueEvent(kKnob, 99));
+	CHECK(!queue.queueEvent(kKnob, 100));
+	CHECK_EQUAL(2, queue.getDroppedEventCount());
+	CHECK_EQUAL(EVENT_QUEUE_SIZE, queue.getHighWaterMark(SCRadioEventQueue::kLowPriority));
+
+	// The high priority lane has its own room
+	CHECK(queue.queueEvent(kKey, 1, SCRadioEventQueue::kHighPriority));
+	CHECK_EQUAL(1, queue.getHighWaterMark(SCRadioEventQueue::kHighPriority));
+
+	CHECK_EQUAL(EVENT_QUEUE_SIZE + 1, queue.processAllEvents<TestDispatcher>());
+
+	CHECK_EQUAL(EVENT_QUEUE_SIZE, knobRecorder.count);
+	CHECK_EQUAL(1, keyRecorder.count);
+
+	// High priority first, then the rest in the order they were queued
+	CHECK(keyRecorder.callOrder[0] < knobRecorder.callOrder[0]);
+
+	for (int16_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK_EQUAL(i, knobRecorder.eventPayloads[i].value);
+	}
+
+	// Emptied out there is room again
+	CHECK(queue.queueEvent(kKnob, 101));
+	CHECK_EQUAL(2, queue.getDroppedEventCount());
+}
+
+static void testPositionsWrapAround()
+{
+	SCRadioEventQueue queue;
+	clearRecorders();
+
+	// 3 at a time so the positions wrap (at 256 and at the end of the array) in
+	// every possible spot.  Nothing is lost or reordered.
+	int32_t nextValue = 0;
+
+	for (uint16_t batch = 0; batch < 150; batch++)
+	{
+		for (uint8_t i = 0; i < 3; i++)
+		{
+			CHECK(queue.queueEvent(kKnob, nextValue++));
+		}
+
+		queue.processAllEvents<TestDispatcher>();
+	}
+
+	CHECK_EQUAL(450, knobRecorder.count);
+	CHECK_EQUAL(0, queue.getDroppedEventCount());
+	CHECK_EQUAL(3, queue.getHighWaterMark(SCRadioEventQueue::kLowPriority));
+
+	bool inOrder = true;
+
+	for (uint16_t i = 0; i < knobRecorder.count; i++)
+	{
+		inOrder = inOrder && (knobRecorder.eventPayloads[i].value == i);
+	}
+
+	CHECK(inOrder);
+
+	// A full lane after wrapping still holds exactly EVENT_QUEUE_SIZE
+	for (int16_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK(queue.queueEvent(kKnob, i));
+	}
+
+	CHECK(!queue.queueEvent(kKnob, 99));
+	CHECK_EQUAL(1, queue.getDroppedEventCount());
+}
+
+static void testInterruptBufferDropsAndCounts()
+{
+	SCRadioEventQueue queue;
+	clearRecorders();
+
+	for (int16_t i = 0; i < EVENT_ISR_QUEUE_SIZE; i++)
+	{
+		CHECK(queue.queueEventFromISR(kKey, i, SCRadioEventQueue::kHighPriority));
+	}
+
+	CHECK(!queue.queueEventFromISR(kKey, 99, SCRadioEventQueue::kHighPriority));
+	CHECK_EQUAL(1, queue.getDroppedEventCount());
+
+	CHECK_EQUAL(EVENT_ISR_QUEUE_SIZE, queue.processAllEvents<TestDispatcher>());
+	CHECK_EQUAL(EVENT_ISR_QUEUE_SIZE, keyRecorder.count);
+
+	for (int16_t i = 0; i < EVENT_ISR_QUEUE_SIZE; i++)
+	{
+		CHECK_EQUAL(i, keyRecorder.eventPayloads[i].value);
+	}
+
+	// Emptied by processing, so there is room again
+	CHECK(queue.queueEventFromISR(kKey, 100, SCRadioEventQueue::kHighPriority));
+}
+
+static void testCountsStopAtTheTop()
+{
+	SCRadioEventQueue queue;
+
+	for (int16_t i = 0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		queue.queueEvent(kKnob, i);
+	}
+
+	for (uint32_t i = 0; i < 70000; i++)
+	{
+		queue.queueEvent(kKnob, 0);
+	}
+
+	CHECK_EQUAL(0xFFFF, queue.getDroppedEventCount());
+}
+
+int main()
+{
+	RUN_TEST(testFullLaneDropsAndCounts);
+	RUN_TEST(testPositionsWrapAround);
+	RUN_TEST(testInterruptBufferDropsAndCounts);
+	RUN_TEST(testCountsStopAtTheTop);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,297 @@
+/**
+ * EventTraceTest.cpp - The event trace keeps the newest EVENT_TRACE_SIZE records as it wraps
+ * around, and print() and dump() send them in the documented formats.  The dump is read back
+ * here the way a PC would, to get how long each event waited.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include <algorithm>
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioEventTrace.h"
+
+HostEventRecorder recorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(recorder, record)>,
+	SCRadioEventRoute<EventType::RIT_KNOB_TURNED, EVENT_HANDLER(recorder, record)>,
+	SCRadioEventRoute<EventType::FREQUENCY_CHANGED, EVENT_HANDLER(recorder, record)>
+> TestDispatcher;
+
+/**
+ * Bytes in one record of dump()
+ */
+#define TRACE_RECORD_BYTES 13
+
+/**
+ * One record read back from dump()
+ */
+struct TraceRecord
+{
+	uint32_t micros;
+	int16_t eventCode;
+	int32_t eventValue;
+	int8_t kind;
+	uint8_t priority;
+	uint8_t depth;
+};
+
+static uint32_t readLowByteFirst(const uint8_t *bytes, uint8_t count)
+{
+	uint32_t value = 0;
+
+	for (int8_t i = count - 1; i >= 0; i--)
+	{
+		value = (value << 8) | bytes[i];
+	}
+
+	return value;
+}
+
+// Reads what dump() sent.  Returns the number of records, or -1 if the header is wrong.
+static int readTraceDump(TraceRecord *records, int maxRecords)
+{
+	const uint8_t *bytes = (const uint8_t *)hostSerialOutput();
+	size_t length = hostSerialOutputLength();
+
+	if ((length < 4) || (bytes[0] != 'E') || (bytes[1] != 'T') || (bytes[3] != TRACE_RECORD_BYTES))
+	{
+		return -1;
+	}
+
+	int count = bytes[2];
+
+	if ((count > maxRecords) || (length != 4 + (size_t)count * TRACE_RECORD_BYTES))
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		const uint8_t *record = bytes + 4 + i * TRACE_RECORD_BYTES;
+
+		records[i].micros = readLowByteFirst(record, 4);
+		records[i].eventCode = (int16_t)readLowByteFirst(record + 4, 2);
+		records[i].eventValue = (int32_t)readLowByteFirst(record + 6, 4);
+		records[i].kind = (int8_t)record[10];
+		records[i].priority = record[11];
+		records[i].depth = record[12];
+	}
+
+	return count;
+}
+
+static int countLines(const char *text)
+{
+	int lines = 0;
+
+	for (; *text != '\0'; text++)
+	{
+		lines += (*text == '\n');
+	}
+
+	return lines;
+}
+
+static void testRingKeepsTheNewestRecords()
+{
+	hostReset();
+
+	SCRadioEventTrace trace;
+
+	// More than fit, and enough that the head wraps past 255 too
+	for (int16_t i = 0; i < 300; i++)
+	{
+		trace.record(EventTraceKind::QUEUED, 200 + (i % 7), i, (uint8_t)(i & 1), (uint8_t)(i % 5));
+		hostAdvanceMicros(10);
+	}
+
+	TraceRecord records[EVENT_TRACE_SIZE];
+
+	hostClearSerialOutput();
+	trace.dump();
+
+	if (CHECK_EQUAL(EVENT_TRACE_SIZE, readTraceDump(records, EVENT_TRACE_SIZE)))
+	{
+		bool allMatch = true;
+
+		// Oldest first: records 300 - EVENT_TRACE_SIZE through 299
+		for (int16_t i = 0; i < EVENT_TRACE_SIZE; i++)
+		{
+			int16_t recordNumber = 300 - EVENT_TRACE_SIZE + i;
+
+			allMatch = CHECK_EQUAL(recordNumber * 10, records[i].micros) && allMatch;
+			allMatch = CHECK_EQUAL(200 + (recordNumber % 7), records[i].eventCode) && allMatch;
+			allMatch = CHECK_EQUAL(recordNumber, records[i].eventValue) && allMatch;
+			allMatch = CHECK_EQUAL(recordNumber & 1, records[i].priority) && allMatch;
+			allMatch = CHECK_EQUAL(recordNumber % 5, records[i].depth) && allMatch;
+
+			if (!allMatch)
+			{
+				break;
+			}
+		}
+	}
+
+	// The same records as text, one line each after the header
+	hostClearSerialOutput();
+	trace.print();
+
+	CHECK_EQUAL(EVENT_TRACE_SIZE + 1, countLines(hostSerialOutput()));
+	CHECK(strncmp(hostSerialOutput(), "micros,kind,event,value,priority,depth\r\n", 40) == 0);
+	CHECK(strstr(hostSerialOutput(), "\n2680,queued,202,268,0,3\r\n") != NULL);
+	CHECK(strstr(hostSerialOutput(), "\n2990,queued,205,299,1,4\r\n") != NULL);
+	CHECK(strstr(hostSerialOutput(), ",267,") == NULL);
+
+	// reset() empties it
+	trace.reset();
+	hostClearSerialOutput();
+	trace.dump();
+
+	CHECK_EQUAL(0, readTraceDump(records, EVENT_TRACE_SIZE));
+}
+
+static void testDumpFormat()
+{
+	hostReset();
+	hostSetMicros(0x12345678);
+
+	SCRadioEventTrace trace;
+	trace.record(EventTraceKind::DISPATCHED, -2, -100000, 1, 16);
+
+	hostClearSerialOutput();
+	trace.dump();
+
+	// Header, then the record byte for byte (numbers low byte first)
+	const uint8_t expected[] = {
+		'E', 'T', 1, 13,
+		0x78, 0x56, 0x34, 0x12,
+		0xFE, 0xFF,
+		0x60, 0x79, 0xFE, 0xFF,
+		3, 1, 16
+	};
+
+	if (CHECK_EQUAL(sizeof(expected), hostSerialOutputLength()))
+	{
+		CHECK(memcmp(expected, hostSerialOutput(), sizeof(expected)) == 0);
+	}
+
+	hostClearSerialOutput();
+	trace.print();
+
+	CHECK_TEXT("micros,kind,event,value,priority,depth\r\n305419896,dispatched,-2,-100000,1,16\r\n", hostSerialOutput());
+}
+
+/**
+ * latencyPercentile
+ *
+ * @detail
+ *   What a PC does with a dump: matches each DISPATCHED record with the QUEUED record it
+ *   came from (events leave each lane in the order they went in) and returns a percentile
+ *   of the time in between for one event type.  Merged and dropped events never get their
+ *   own DISPATCHED record so they are skipped.
+ */
+static uint32_t latencyPercentile(const TraceRecord *records, int count, int16_t eventCode, uint8_t percent)
+{
+	uint32_t queuedMicros[2][EVENT_TRACE_SIZE];
+	int queuedHead[2] = {0, 0};
+	int queuedTail[2] = {0, 0};
+	uint32_t latencies[EVENT_TRACE_SIZE];
+	int latencyCount = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		uint8_t lane = records[i].priority;
+
+		if (records[i].kind == static_cast<int8_t>(EventTraceKind::QUEUED))
+		{
+			queuedMicros[lane][queuedHead[lane]++] = records[i].micros;
+		}
+		else if ((records[i].kind == static_cast<int8_t>(EventTraceKind::DISPATCHED)) && (queuedTail[lane] < queuedHead[lane]))
+		{
+			uint32_t latency = records[i].micros - queuedMicros[lane][queuedTail[lane]++];
+
+			if (records[i].eventCode == eventCode)
+			{
+				latencies[latencyCount++] = latency;
+			}
+		}
+	}
+
+	if (latencyCount == 0)
+	{
+		return 0;
+	}
+
+	std::sort(latencies, latencies + latencyCount);
+
+	return latencies[(latencyCount - 1) * percent / 100];
+}
+
+static void testQueueTraceGivesLatencies()
+{
+	hostReset();
+
+	SCRadioEventQueue queue;
+	const int kKeyLine = static_cast<int>(EventType::KEY_LINE_CHANGED);
+	const int kRitKnob = static_cast<int>(EventType::RIT_KNOB_TURNED);
+	const int kFrequency = static_cast<int>(EventType::FREQUENCY_CHANGED);
+
+	// Each round: a knob turn and a frequency change wait 400 us.  The key line goes
+	// in halfway through and waits 200 us.  A second knob click is merged into the first.
+	for (uint8_t round = 0; round < 4; round++)
+	{
+		queue.queueOrMergeEvent(kRitKnob, 1);
+		queue.queueOrMergeEvent(kRitKnob, 1);
+		queue.queueEvent(kFrequency, 7030000 + round);
+		hostAdvanceMicros(200);
+		queue.queueEvent(kKeyLine, round & 1, SCRadioEventQueue::kHighPriority);
+		hostAdvanceMicros(200);
+		queue.processAllEvents<TestDispatcher>();
+		hostAdvanceMicros(1000);
+	}
+
+	// 4 rounds of 3 queued, 1 merged and 3 dispatched (28 records) fit without wrapping
+	TraceRecord records[EVENT_TRACE_SIZE];
+
+	hostClearSerialOutput();
+	queue.getTrace().dump();
+
+	int count = readTraceDump(records, EVENT_TRACE_SIZE);
+
+	if (CHECK_EQUAL(28, count))
+	{
+		CHECK_EQUAL(static_cast<int8_t>(EventTraceKind::QUEUED), records[0].kind);
+		CHECK_EQUAL(kRitKnob, records[0].eventCode);
+		CHECK_EQUAL(static_cast<int8_t>(EventTraceKind::MERGED), records[1].kind);
+		CHECK_EQUAL(static_cast<int8_t>(EventTraceKind::DISPATCHED), records[4].kind);
+		CHECK_EQUAL(kKeyLine, records[4].eventCode);
+
+		CHECK_EQUAL(200, latencyPercentile(records, count, kKeyLine, 50));
+		CHECK_EQUAL(400, latencyPercentile(records, count, kRitKnob, 50));
+		CHECK_EQUAL(400, latencyPercentile(records, count, kFrequency, 99));
+	}
+}
+
+int main()
+{
+	RUN_TEST(testRingKeepsTheNewestRecords);
+	RUN_TEST(testDumpFormat);
+	RUN_TEST(testQueueTraceGivesLatencies);
+
+	return hostTestFinish();
+}
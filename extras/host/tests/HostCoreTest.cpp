@@ -0,0 +1,303 @@
+/**
+ * HostCoreTest.cpp - Checks the simulated Nano itself (see core/Arduino.h)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+
+#include "EEPROM.h"
+#include "EventManager.h"
+#include "LiquidCrystal_I2C.h"
+#include "Rotary.h"
+
+static uint16_t timer1Interrupts;
+static uint32_t timer1InterruptMicros[4];
+
+ISR(TIMER1_COMPA_vect)
+{
+	if (timer1Interrupts < 4)
+	{
+		timer1InterruptMicros[timer1Interrupts] = micros();
+	}
+
+	timer1Interrupts++;
+}
+
+static uint8_t pinInterrupts;
+
+static void pinInterruptRoutine()
+{
+	pinInterrupts++;
+}
+
+static void startTimer1(uint16_t top)
+{
+	timer1Interrupts = 0;
+	TCCR1A = 0;
+	TCCR1B = _BV(WGM12) | _BV(CS11);   // CTC, clock / 8 (2 counts a microsecond)
+	TCNT1 = 0;
+	OCR1A = top;
+	TIMSK1 |= _BV(OCIE1A);
+}
+
+static void testTimeOnlyMovesWhenTheTestMovesIt()
+{
+	hostReset();
+
+	CHECK_EQUAL(0, micros());
+	hostAdvanceMicros(1500);
+	CHECK_EQUAL(1500, micros());
+	CHECK_EQUAL(1, millis());
+
+	delay(10);
+	CHECK_EQUAL(11500, micros());
+
+	hostSetMicros(0xFFFFFFF0);
+	hostAdvanceMicros(0x20);
+	CHECK_EQUAL(0x10, micros());
+}
+
+static void testTimer1InterruptsAtItsCompareMatch()
+{
+	hostReset();
+	startTimer1(199);
+
+	hostAdvanceMicros(350);
+
+	CHECK_EQUAL(3, timer1Interrupts);
+	CHECK_EQUAL(100, timer1InterruptMicros[0]);
+	CHECK_EQUAL(200, timer1InterruptMicros[1]);
+	CHECK_EQUAL(300, timer1InterruptMicros[2]);
+
+	// Stopping the clock stops the interrupts
+	TCCR1B = 0;
+	hostAdvanceMicros(1000);
+	CHECK_EQUAL(3, timer1Interrupts);
+}
+
+static void testInterruptsWaitWhileHeldOff()
+{
+	hostReset();
+	startTimer1(199);
+
+	noInterrupts();
+	hostAdvanceMicros(450);
+
+	// Only one is remembered no matter how many matches went by, like the real flag
+	CHECK_EQUAL(0, timer1Interrupts);
+	interrupts();
+	CHECK_EQUAL(1, timer1Interrupts);
+
+	// Saving and restoring SREG only turns interrupts on if they were on
+	noInterrupts();
+	uint8_t oldSREG = SREG;
+	CHECK_EQUAL(0, oldSREG & _BV(SREG_I));
+	SREG = oldSREG;
+	CHECK(!hostInterruptsEnabled());
+	interrupts();
+	CHECK(hostInterruptsEnabled());
+}
+
+static void testPinChangesAreRecorded()
+{
+	hostReset();
+
+	pinMode(13, OUTPUT);
+	hostAdvanceMicros(10);
+	digitalWrite(13, HIGH);
+	hostAdvanceMicros(5);
+	digitalWrite(13, LOW);
+
+	// Writing the port register straight is seen too
+	volatile uint8_t *port = portOutputRegister(digitalPinToPort(8));
+	pinMode(8, OUTPUT);
+	pulsePortHigh(port, digitalPinToBitMask(8));
+
+	CHECK_EQUAL(4, hostPinChangeCount());
+	CHECK_EQUAL(13, hostPinChange(0).pin);
+	CHECK_EQUAL(HIGH, hostPinChange(0).level);
+	CHECK_EQUAL(10, hostPinChange(0).micros);
+	CHECK_EQUAL(LOW, hostPinChange(1).level);
+	CHECK_EQUAL(15, hostPinChange(1).micros);
+	CHECK_EQUAL(8, hostPinChange(2).pin);
+	CHECK_EQUAL(HIGH, hostPinChange(2).level);
+	CHECK_EQUAL(LOW, hostPinChange(3).level);
+	CHECK_EQUAL(2, hostDigitalWriteCount());
+}
+
+static void testInputsAndPinInterrupts()
+{
+	hostReset();
+	pinInterrupts = 0;
+
+	pinMode(7, INPUT_PULLUP);
+	CHECK_EQUAL(HIGH, digitalRead(7));
+	hostSetPin(7, LOW);
+	CHECK_EQUAL(LOW, digitalRead(7));
+	CHECK_EQUAL(0, PIND & _BV(7));
+	hostReleasePin(7);
+	CHECK_EQUAL(HIGH, digitalRead(7));
+
+	attachInterrupt(digitalPinToInterrupt(3), pinInterruptRoutine, CHANGE);
+	CHECK_EQUAL(NOT_AN_INTERRUPT, digitalPinToInterrupt(4));
+
+	hostSetPin(3, HIGH);
+	hostSetPin(3, LOW);
+	CHECK_EQUAL(2, pinInterrupts);
+
+	noInterrupts();
+	hostSetPin(3, HIGH);
+	CHECK_EQUAL(2, pinInterrupts);
+	interrupts();
+	CHECK_EQUAL(3, pinInterrupts);
+}
+
+static void testSimulatedInterruptLandsAfterCoreCalls()
+{
+	hostReset();
+	pinInterrupts = 0;
+
+	hostInterruptAfterCoreCalls(2, pinInterruptRoutine);
+	micros();
+	CHECK_EQUAL(0, pinInterrupts);
+	micros();
+	CHECK_EQUAL(1, pinInterrupts);
+	micros();
+	CHECK_EQUAL(1, pinInterrupts);
+}
+
+static void testEEPROMStartsErased()
+{
+	hostReset();
+
+	CHECK_EQUAL(0xFF, EEPROM.read(0));
+	CHECK_EQUAL(0xFF, EEPROM.read(HOST_EEPROM_SIZE - 1));
+
+	EEPROM.write(3, 0x42);
+	CHECK_EQUAL(0x42, EEPROM.read(3));
+	CHECK_EQUAL(1, hostEEPROMWriteCount());
+}
+
+static void testDisplayKeepsWhatWasPrinted()
+{
+	LiquidCrystal_I2C display(0x27, 16, 2);
+
+	display.init();
+	display.backlight();
+	display.setCursor(0, 1);
+	display.print("hello");
+	display.setCursor(14, 0);
+	display.print("abcd");
+
+	CHECK_TEXT("              ab", display.hostLine(0));
+	CHECK_TEXT("hello           ", display.hostLine(1));
+	CHECK(display.hostBacklight());
+}
+
+static void turnEncoder(const uint8_t (*positions)[2], uint8_t count)
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		hostSetPin(3, positions[i][0]);
+		hostSetPin(2, positions[i][1]);
+	}
+}
+
+static void testEncoderDecodesFullSteps()
+{
+	hostReset();
+
+	Rotary rotary(3, 2);
+	unsigned char result = DIR_NONE;
+
+	// pin1, pin2 from rest to rest: clockwise is pin 1 first
+	const uint8_t clockwise[][2] = { { 1, 1 }, { 0, 1 }, { 0, 0 }, { 1, 0 }, { 1, 1 } };
+	const uint8_t counterClockwise[][2] = { { 1, 1 }, { 1, 0 }, { 0, 0 }, { 0, 1 }, { 1, 1 } };
+	const uint8_t bounce[][2] = { { 1, 1 }, { 0, 1 }, { 1, 1 }, { 0, 1 }, { 1, 1 } };
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		turnEncoder(&clockwise[i], 1);
+		result |= rotary.process();
+	}
+
+	CHECK_EQUAL(DIR_CW, result);
+
+	result = DIR_NONE;
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		turnEncoder(&counterClockwise[i], 1);
+		result |= rotary.process();
+	}
+
+	CHECK_EQUAL(DIR_CCW, result);
+
+	result = DIR_NONE;
+
+	for (uint8_t i = 0; i < 5; i++)
+	{
+		turnEncoder(&bounce[i], 1);
+		result |= rotary.process();
+	}
+
+	CHECK_EQUAL(DIR_NONE, result);
+}
+
+static int eventManagerCalls[4];
+static uint8_t eventManagerCallCount;
+
+static void eventManagerListener(int eventCode, int eventParam)
+{
+	eventManagerCalls[eventManagerCallCount++ & 3] = eventCode * 100 + eventParam;
+}
+
+static void testEventManagerStandIn()
+{
+	EventManager eventManager;
+	eventManagerCallCount = 0;
+
+	CHECK(eventManager.addListener(1, eventManagerListener));
+	CHECK(eventManager.addListener(2, eventManagerListener));
+
+	eventManager.queueEvent(1, 5);
+	eventManager.queueEvent(2, 6, EventManager::kHighPriority);
+	CHECK_EQUAL(2, eventManager.processAllEvents());
+	CHECK_EQUAL(206, eventManagerCalls[0]);
+	CHECK_EQUAL(105, eventManagerCalls[1]);
+
+	// Fixed size queue.  A full queue refuses the event.
+	for (uint8_t i = 0; i < EVENTMANAGER_EVENT_QUEUE_SIZE; i++)
+	{
+		CHECK(eventManager.queueEvent(1, i));
+	}
+
+	CHECK(eventManager.isEventQueueFull());
+	CHECK(!eventManager.queueEvent(1, 99));
+}
+
+int main()
+{
+	RUN_TEST(testTimeOnlyMovesWhenTheTestMovesIt);
+	RUN_TEST(testTimer1InterruptsAtItsCompareMatch);
+	RUN_TEST(testInterruptsWaitWhileHeldOff);
+	RUN_TEST(testPinChangesAreRecorded);
+	RUN_TEST(testInputsAndPinInterrupts);
+	RUN_TEST(testSimulatedInterruptLandsAfterCoreCalls);
+	RUN_TEST(testEEPROMStartsErased);
+	RUN_TEST(testDisplayKeepsWhatWasPrinted);
+	RUN_TEST(testEncoderDecodesFullSteps);
+	RUN_TEST(testEventManagerStandIn);
+
+	return hostTestFinish();
+}
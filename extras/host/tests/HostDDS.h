@@ -0,0 +1,93 @@
+/**
+ * HostDDS.h - Reads DDS frames back out of the pin recorder (see HostCore.h)
+ *
+ * Plays the part of an AD9850 or AD9851 on the DDS pins: each rising edge of the word
+ * load clock shifts in the data pin (least significant bit first) and each rising edge
+ * of the frequency update pin latches what was shifted in as a frame.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostDDS_h
+#define HostDDS_h
+
+#include "HostCore.h"
+
+/**
+ * Most bytes a decoded frame can hold
+ */
+#define HOST_DDS_MAX_FRAME_BYTES 8
+
+/**
+ * One frame latched by the pretend DDS
+ */
+struct HostDDSFrame
+{
+	uint8_t bytes[HOST_DDS_MAX_FRAME_BYTES];
+	uint8_t bitCount;
+};
+
+/**
+ * decodeDDSFrames
+ *
+ * @detail
+ *   Goes through the pin recorder and picks out the frames the DDS latched.
+ *   The data pin is taken to be low where the recording starts.
+ *
+ * @param[in] clockPin word load clock pin
+ * @param[in] dataPin data pin
+ * @param[in] updatePin frequency update pin
+ * @param[out] frames frames latched, oldest first
+ * @param[in] maxFrames room in frames
+ *
+ * @returns number of frames latched
+ */
+inline uint8_t decodeDDSFrames(uint8_t clockPin, uint8_t dataPin, uint8_t updatePin, HostDDSFrame *frames, uint8_t maxFrames)
+{
+	uint8_t frameCount = 0;
+	uint8_t dataLevel = LOW;
+	HostDDSFrame frame;
+
+	memset(&frame, 0, sizeof(frame));
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		const HostPinChange &change = hostPinChange(i);
+
+		if (change.pin == dataPin)
+		{
+			dataLevel = change.level;
+		}
+		else if ((change.pin == clockPin) && (change.level == HIGH))
+		{
+			if (frame.bitCount < HOST_DDS_MAX_FRAME_BYTES * 8)
+			{
+				frame.bytes[frame.bitCount / 8] |= dataLevel << (frame.bitCount % 8);
+			}
+
+			frame.bitCount++;
+		}
+		else if ((change.pin == updatePin) && (change.level == HIGH))
+		{
+			if (frameCount < maxFrames)
+			{
+				frames[frameCount] = frame;
+			}
+
+			frameCount++;
+			memset(&frame, 0, sizeof(frame));
+		}
+	}
+
+	return frameCount;
+}
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * HostEvents.h - A listener that writes down the events it is handed
+ *
+ * Tests route events to one or more of these with EVENT_HANDLER(recorder, record)
+ * and then look at what each one got and in what order.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostEvents_h
+#define HostEvents_h
+
+#include "Arduino.h"
+
+#include "SCRadioEventPayload.h"
+
+/**
+ * Most events a recorder keeps
+ */
+#define HOST_EVENT_LOG_SIZE 512
+
+/**
+ * Counts calls across every recorder so a test can tell which listener went first
+ */
+inline uint16_t &hostEventCallCount()
+{
+	static uint16_t callCount = 0;
+	return callCount;
+}
+
+/**
+ * HostEventRecorder
+ *
+ * @detail
+ *   Writes down each event it is handed (code, payload and when it was called
+ *   among all recorders)
+ */
+class HostEventRecorder
+{
+public:
+	int16_t eventCodes[HOST_EVENT_LOG_SIZE];
+	SCRadioEventPayload eventPayloads[HOST_EVENT_LOG_SIZE];
+	uint16_t callOrder[HOST_EVENT_LOG_SIZE];
+	uint16_t count;
+
+	void clear()
+	{
+		count = 0;
+	}
+
+	void record(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		if (count < HOST_EVENT_LOG_SIZE)
+		{
+			eventCodes[count] = eventCode;
+			eventPayloads[count] = eventPayload;
+			callOrder[count] = hostEventCallCount();
+			count++;
+		}
+
+		hostEventCallCount()++;
+	}
+};
+
+#endif
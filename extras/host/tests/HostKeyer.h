@@ -0,0 +1,181 @@
+/**
+ * HostKeyer.h - Works the paddles and writes down the key line the keyer sends
+ *
+ * Tests route KEY_LINE_CHANGED to a HostKeyLine with EVENT_HANDLER(keyLine, keyLineChanged),
+ * run the keyer with runKeyer() (optionally working the paddles from a list of steps) and then
+ * compare the key down and key up times with the ones they expect (keyLineMatches()).
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostKeyer_h
+#define HostKeyer_h
+
+#include "HostCore.h"
+#include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
+#include "SCRadioEventQueue.h"
+
+/**
+ * Most key line changes a HostKeyLine keeps
+ */
+#define HOST_KEY_EDGE_LOG_SIZE 512
+
+/**
+ * How far time moves between looks at the event queue (microseconds).  The keyer ticks
+ * every KEYER_TICK_MICROS, so this divides a tick evenly and each change is seen at the
+ * tick that made it.
+ */
+#define HOST_KEYER_STEP_MICROS 10
+
+/**
+ * Paddle bits for HostPaddleStep
+ */
+#define HOST_DIT_PADDLE 0x01
+#define HOST_DAH_PADDLE 0x02
+
+/**
+ * One change of the paddles: from atMicros on, these paddles are held
+ */
+struct HostPaddleStep
+{
+	uint32_t atMicros;
+	uint8_t paddles;
+};
+
+/**
+ * HostKeyLine
+ *
+ * @detail
+ *   Writes down when the key line goes down and up (microseconds after clear())
+ */
+class HostKeyLine
+{
+public:
+	uint32_t edgeMicros[HOST_KEY_EDGE_LOG_SIZE];
+	bool edgeKeyDown[HOST_KEY_EDGE_LOG_SIZE];
+	uint16_t count;
+	uint32_t startMicros;
+
+	void clear()
+	{
+		count = 0;
+		startMicros = micros();
+	}
+
+	void keyLineChanged(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		if (count < HOST_KEY_EDGE_LOG_SIZE)
+		{
+			edgeMicros[count] = micros() - startMicros;
+			edgeKeyDown[count] = (eventPayload.value == static_cast<int>(KeyStatus::PRESSED));
+			count++;
+		}
+	}
+
+	/**
+	 * Time from change 'index' to the next one (microseconds)
+	 */
+	uint32_t lengthMicros(uint16_t index) const
+	{
+		return edgeMicros[index + 1] - edgeMicros[index];
+	}
+};
+
+/**
+ * setPaddles
+ *
+ * @detail
+ *   Presses the paddles given and lets go of the others (the tip is the dit paddle)
+ */
+inline void setPaddles(uint8_t paddles)
+{
+	hostSetPin(CW_KEY_PADDLE_JACK_TIP_PIN, (paddles & HOST_DIT_PADDLE) ? LOW : HIGH);
+	hostSetPin(CW_KEY_PADDLE_JACK_RING_PIN, (paddles & HOST_DAH_PADDLE) ? LOW : HIGH);
+}
+
+/**
+ * runKeyer
+ *
+ * @detail
+ *   Moves time forward, handing the key line events to their listeners as they come in.
+ *   Works the paddles along the way if steps are given.
+ *
+ * @param Dispatcher SCRadioEventDispatcher with a route to the HostKeyLine
+ * @param[in] queue event queue the keyer was given
+ * @param[in] runMicros how long to run
+ * @param[in] steps paddle changes, times from when this is called, earliest first
+ * @param[in] stepCount number of steps
+ */
+template <class Dispatcher>
+void runKeyer(SCRadioEventQueue &queue, uint32_t runMicros, const HostPaddleStep *steps = nullptr, uint16_t stepCount = 0)
+{
+	uint16_t nextStep = 0;
+
+	for (uint32_t elapsed = 0; elapsed < runMicros; elapsed += HOST_KEYER_STEP_MICROS)
+	{
+		while ((nextStep < stepCount) && (steps[nextStep].atMicros <= elapsed))
+		{
+			setPaddles(steps[nextStep].paddles);
+			nextStep++;
+		}
+
+		hostAdvanceMicros(HOST_KEYER_STEP_MICROS);
+		queue.processAllEvents<Dispatcher>();
+	}
+}
+
+/**
+ * keyLineMatches
+ *
+ * @detail
+ *   Compares the key line with the expected one: key down, key up, key down ... at the
+ *   times given.  If they differ both are printed, so a changed timeline can be looked at
+ *   (and copied into the test if the change was meant).
+ *
+ * @param[in] keyLine what the keyer sent
+ * @param[in] expectedMicros times of the changes, first one key down
+ * @param[in] expectedCount number of changes
+ *
+ * @returns true if they are the same
+ */
+inline bool keyLineMatches(const HostKeyLine &keyLine, const uint32_t *expectedMicros, uint16_t expectedCount)
+{
+	bool matches = (keyLine.count == expectedCount);
+
+	for (uint16_t i = 0; matches && (i < expectedCount); i++)
+	{
+		matches = (keyLine.edgeMicros[i] == expectedMicros[i]) && (keyLine.edgeKeyDown[i] == (i % 2 == 0));
+	}
+
+	if (!matches)
+	{
+		printf("  expected:");
+
+		for (uint16_t i = 0; i < expectedCount; i++)
+		{
+			printf(" %lu", (unsigned long)expectedMicros[i]);
+		}
+
+		printf("\n  got:     ");
+
+		for (uint16_t i = 0; i < keyLine.count; i++)
+		{
+			printf(" %s%lu", keyLine.edgeKeyDown[i] ? "" : "^", (unsigned long)keyLine.edgeMicros[i]);
+		}
+
+		printf("\n  (^ is key up)\n");
+	}
+
+	return matches;
+}
+
+#endif
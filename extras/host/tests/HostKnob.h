@@ -0,0 +1,50 @@
+/**
+ * HostKnob.h - Turns the main knob on the simulated Nano
+ *
+ * The knob is a quadrature encoder on MAIN_KNOB_PIN_1 and MAIN_KNOB_PIN_2 with both pins
+ * high at rest.  One detent clockwise takes pin 1 low, then pin 2, then lets pin 1 back
+ * up and then pin 2.  Counter clockwise is the same with the pins swapped.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostKnob_h
+#define HostKnob_h
+
+#include "HostCore.h"
+#include "SCRadioConstants.h"
+
+/**
+ * turnMainKnobOneStep
+ *
+ * @detail
+ *   Moves the knob's pins through one detent.  The knob's interrupt routine runs on each
+ *   pin change.  Time moves phaseMicros after each of the 4 changes (loop() does not run).
+ *
+ * @param[in] clockwise true for clockwise (up in frequency)
+ * @param[in] phaseMicros microseconds between pin changes
+ */
+inline void turnMainKnobOneStep(bool clockwise, uint32_t phaseMicros)
+{
+	uint8_t firstPin = clockwise ? MAIN_KNOB_PIN_1 : MAIN_KNOB_PIN_2;
+	uint8_t secondPin = clockwise ? MAIN_KNOB_PIN_2 : MAIN_KNOB_PIN_1;
+
+	hostSetPin(firstPin, LOW);
+	hostAdvanceMicros(phaseMicros);
+	hostSetPin(secondPin, LOW);
+	hostAdvanceMicros(phaseMicros);
+	hostSetPin(firstPin, HIGH);
+	hostAdvanceMicros(phaseMicros);
+	hostSetPin(secondPin, HIGH);
+	hostAdvanceMicros(phaseMicros);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * HostSketch.h - Runs the sketch on the simulated Nano (for the host tests built with it)
+ *
+ * The sketch's objects are globals, so a test reaches them with 'extern'.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostSketch_h
+#define HostSketch_h
+
+#include "HostCore.h"
+#include "SCRadioConstants.h"
+
+/**
+ * How long one pass of loop() takes on the simulated Nano (microseconds).
+ * Time only moves when a test moves it, so runSketch() moves it this much after each pass.
+ */
+#define HOST_LOOP_MICROS 100
+
+/**
+ * startSketch
+ *
+ * @detail
+ *   Powers up the simulated Nano and runs setup() (which includes the splash delay).
+ *   The paddles and the knob are wired up with nothing pressed: the paddle and knob
+ *   pins are held high like their pull ups would.
+ */
+inline void startSketch()
+{
+	hostReset();
+
+	hostSetPin(CW_KEY_PADDLE_JACK_TIP_PIN, HIGH);
+	hostSetPin(CW_KEY_PADDLE_JACK_RING_PIN, HIGH);
+	hostSetPin(MAIN_KNOB_PIN_1, HIGH);
+	hostSetPin(MAIN_KNOB_PIN_2, HIGH);
+	hostSetPin(MAIN_KNOB_SWITCH_PIN, HIGH);
+
+	setup();
+}
+
+/**
+ * runSketch
+ *
+ * @detail
+ *   Runs loop() over and over for a while, moving time HOST_LOOP_MICROS each pass
+ *
+ * @param[in] micros how long to run (microseconds)
+ */
+inline void runSketch(uint32_t micros)
+{
+	for (uint32_t elapsed = 0; elapsed < micros; elapsed += HOST_LOOP_MICROS)
+	{
+		loop();
+		hostAdvanceMicros(HOST_LOOP_MICROS);
+	}
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * HostTest.h - Checks used by the host tests
+ *
+ * Each test program is a main() that runs its tests with RUN_TEST() and returns
+ * hostTestFinish().  A failed check prints where it was and the program exits with
+ * an error, which is what ctest looks at.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <stdio.h>
+
+#include "HostCore.h"
+
+#define CHECK(condition) hostTestCheck((condition), #condition, __FILE__, __LINE__)
+
+#define CHECK_EQUAL(expected, actual) \
+	hostTestCheckEqual((long long)(expected), (long long)(actual), #expected, #actual, __FILE__, __LINE__)
+
+#define CHECK_TEXT(expected, actual) hostTestCheckText((expected), (actual), #actual, __FILE__, __LINE__)
+
+#define RUN_TEST(test) hostTestRun(test, #test)
+
+inline int &hostTestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+inline bool hostTestCheck(bool passed, const char *condition, const char *file, int line)
+{
+	if (!passed)
+	{
+		printf("%s:%d: CHECK(%s) failed\n", file, line, condition);
+		hostTestFailures()++;
+	}
+
+	return passed;
+}
+
+inline bool hostTestCheckEqual(long long expected, long long actual, const char *expectedText, const char *actualText,
+								const char *file, int line)
+{
+	if (expected != actual)
+	{
+		printf("%s:%d: %s is %lld, expected %s (%lld)\n", file, line, actualText, actual, expectedText, expected);
+		hostTestFailures()++;
+		return false;
+	}
+
+	return true;
+}
+
+inline bool hostTestCheckText(const char *expected, const char *actual, const char *actualText, const char *file, int line)
+{
+	if (strcmp(expected, actual) != 0)
+	{
+		printf("%s:%d: %s is \"%s\", expected \"%s\"\n", file, line, actualText, actual, expected);
+		hostTestFailures()++;
+		return false;
+	}
+
+	return true;
+}
+
+inline void hostTestRun(void (*test)(), const char *name)
+{
+	int failuresBefore = hostTestFailures();
+
+	test();
+
+	printf("%s %s\n", (hostTestFailures() == failuresBefore) ? "pass" : "FAIL", name);
+}
+
+inline int hostTestFinish()
+{
+	if (hostTestFailures() > 0)
+	{
+		printf("%d check(s) failed\n", hostTestFailures());
+		return 1;
+	}
+
+	return 0;
+}
+
+#endif
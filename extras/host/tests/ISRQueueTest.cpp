@@ -0,0 +1,209 @@
+/**
+ * ISRQueueTest.cpp - Events queued from a simulated interrupt at every point while loop()
+ * is moving and handling events arrive once each, in order, with merged counts adding up,
+ * and when the interrupt ring buffer overflows every dropped event is counted
+ *
+ * Built with the event trace on so the queue calls micros() while it works.  Each of those
+ * calls is a point where the simulated interrupt can land (see hostInterruptAfterCoreCalls()).
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+
+SCRadioEventQueue queue;
+
+/**
+ * A listener that does a little work (one micros() call) like the real ones do
+ */
+class TimedRecorder : public HostEventRecorder
+{
+public:
+	void handle(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		micros();
+		record(eventCode, eventPayload);
+	}
+};
+
+TimedRecorder keyRecorder;
+TimedRecorder knobRecorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyRecorder, handle)>,
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED, EVENT_HANDLER(knobRecorder, handle)>
+> TestDispatcher;
+
+static const int kKnob = static_cast<int>(EventType::VFO_KNOB_TURNED);
+static const int kKey = static_cast<int>(EventType::KEY_LINE_CHANGED);
+
+static bool interruptRan;
+static int16_t nextKeyValue;
+static uint16_t interruptsLeft;
+static uint16_t eventsQueuedFromInterrupts;
+
+static void startTest()
+{
+	hostReset();
+	queue.processAllEvents<TestDispatcher>();
+	keyRecorder.clear();
+	knobRecorder.clear();
+	interruptRan = false;
+	nextKeyValue = 1;
+	interruptsLeft = 0;
+	eventsQueuedFromInterrupts = 0;
+}
+
+/**
+ * The keyer and the knob both go off: a key line event and three knob steps
+ */
+static void keyerAndKnobInterrupt()
+{
+	interruptRan = true;
+	queue.queueEventFromISR(kKey, nextKeyValue++, SCRadioEventQueue::kHighPriority);
+	queue.queueOrMergeEventFromISR(kKnob, 3);
+}
+
+/**
+ * Queues the same events keyerAndKnobInterrupt() will be racing with
+ */
+static void queueStartingEvents()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		queue.queueEventFromISR(kKey, nextKeyValue++, SCRadioEventQueue::kHighPriority);
+		queue.queueOrMergeEventFromISR(kKnob, 1);
+	}
+}
+
+static int32_t totalKnobSteps()
+{
+	int32_t steps = 0;
+
+	for (uint16_t i = 0; i < knobRecorder.count; i++)
+	{
+		steps += knobRecorder.eventPayloads[i].value;
+	}
+
+	return steps;
+}
+
+static void testInterruptAtEveryPoint()
+{
+	// How many core calls handling the starting events takes with no interrupt
+	startTest();
+	queueStartingEvents();
+	uint32_t startCalls = hostCoreCallCount();
+	queue.processAllEvents<TestDispatcher>();
+	uint32_t callsToProcess = hostCoreCallCount() - startCalls;
+
+	CHECK(callsToProcess > 6);
+
+	for (uint32_t calls = 1; calls <= callsToProcess; calls++)
+	{
+		startTest();
+		uint16_t droppedBefore = queue.getDroppedEventCount();
+		queueStartingEvents();
+
+		hostInterruptAfterCoreCalls(calls, keyerAndKnobInterrupt);
+		queue.processAllEvents<TestDispatcher>();
+
+		// Anything queued after the last look waits for the next pass
+		queue.processAllEvents<TestDispatcher>();
+
+		if (!CHECK(interruptRan))
+		{
+			continue;
+		}
+
+		// Every key line event once, in the order queued
+		if (CHECK_EQUAL(4, keyRecorder.count))
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				CHECK_EQUAL(i + 1, keyRecorder.eventPayloads[i].value);
+			}
+		}
+
+		// Merged or not, none of the knob steps are lost or counted twice
+		CHECK_EQUAL(3 + 3, totalKnobSteps());
+		CHECK_EQUAL(droppedBefore, queue.getDroppedEventCount());
+	}
+}
+
+/**
+ * Interrupts coming faster than loop() can keep up: three key line events every core call
+ */
+static void fastInterrupt()
+{
+	for (int i = 0; i < 3; i++)
+	{
+		queue.queueEventFromISR(kKey, nextKeyValue++, SCRadioEventQueue::kHighPriority);
+		eventsQueuedFromInterrupts++;
+	}
+
+	if (--interruptsLeft > 0)
+	{
+		hostInterruptAfterCoreCalls(1, fastInterrupt);
+	}
+}
+
+static void testOverflowFromInterrupts()
+{
+	startTest();
+	uint16_t droppedBefore = queue.getDroppedEventCount();
+
+	interruptsLeft = 50;
+	hostInterruptAfterCoreCalls(1, fastInterrupt);
+
+	// loop() reads the clock every pass, so the interrupt gets in even when nothing is waiting
+	while (interruptsLeft > 0)
+	{
+		micros();
+		queue.processAllEvents<TestDispatcher>();
+	}
+
+	queue.processAllEvents<TestDispatcher>();
+
+	uint16_t dropped = queue.getDroppedEventCount() - droppedBefore;
+
+	// The ring buffer can't keep up, and every event is either handled or counted as dropped
+	CHECK(dropped > 0);
+	CHECK_EQUAL(150, eventsQueuedFromInterrupts);
+	CHECK_EQUAL(eventsQueuedFromInterrupts, keyRecorder.count + dropped);
+
+	// The ones that got through are in order with nothing repeated or torn
+	for (uint16_t i = 1; i < keyRecorder.count; i++)
+	{
+		if (!CHECK(keyRecorder.eventPayloads[i - 1].value < keyRecorder.eventPayloads[i].value))
+		{
+			break;
+		}
+	}
+
+	// Once the interrupts stop the buffer has room again
+	CHECK(queue.queueEventFromISR(kKey, 1, SCRadioEventQueue::kHighPriority));
+	queue.processAllEvents<TestDispatcher>();
+}
+
+int main()
+{
+	RUN_TEST(testInterruptAtEveryPoint);
+	RUN_TEST(testOverflowFromInterrupts);
+
+	return hostTestFinish();
+}
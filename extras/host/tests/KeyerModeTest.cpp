@@ -0,0 +1,189 @@
+/**
+ * KeyerModeTest.cpp - Paddle traces played into the keyer in Iambic A, Iambic B, Ultimatic
+ * and Bug modes give the key line timelines each mode should (golden timelines)
+ *
+ * Everything is at 20 WPM: a 60 ms dit, a 180 ms dah and a 60 ms space after each.  The
+ * paddles are first pressed at 0, so the first element starts on the next tick (100 us).
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKeyer.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioKeyer.h"
+
+SCRadioEventQueue queue;
+SCRadioKeyer keyer = SCRadioKeyer(queue, nullptr, 0);
+HostKeyLine keyLine;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyLine, keyLineChanged)>
+> TestDispatcher;
+
+#define BOTH_PADDLES (HOST_DIT_PADDLE | HOST_DAH_PADDLE)
+
+/**
+ * Plays a paddle trace into the keyer in a mode at 20 WPM and records the key line
+ */
+static void playTrace(KeyerMode keyerMode, const HostPaddleStep *steps, uint16_t stepCount)
+{
+	hostReset();
+	setPaddles(0);
+
+	keyer.begin();
+	keyer.setKeyerMode(keyerMode);
+	keyer.setKeyerWPM(20);
+
+	runKeyer<TestDispatcher>(queue, 1000);
+	keyLine.clear();
+
+	runKeyer<TestDispatcher>(queue, 1500000, steps, stepCount);
+}
+
+// Squeeze (dit first) and let go of both part way through the dah
+static const HostPaddleStep kSqueezeReleasedDuringDah[] = {
+	{ 0, HOST_DIT_PADDLE },
+	{ 10000, BOTH_PADDLES },
+	{ 150000, 0 }
+};
+
+static void testIambicAStopsAfterTheElement()
+{
+	playTrace(KeyerMode::IAMBICA, kSqueezeReleasedDuringDah, 3);
+
+	// dit, dah and nothing more
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 300100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 4));
+}
+
+static void testIambicBSendsOneMore()
+{
+	playTrace(KeyerMode::IAMBICB, kSqueezeReleasedDuringDah, 3);
+
+	// dit, dah and the dit that was squeezed in while the dah was sent
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 300100,
+		360100, 420100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 6));
+}
+
+static void testIambicSqueezeAlternates()
+{
+	// Hold the squeeze into the second dah: dit dah dit dah in both modes, then B adds a dit
+	static const HostPaddleStep steps[] = {
+		{ 0, BOTH_PADDLES },
+		{ 500000, 0 }
+	};
+
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 300100,
+		360100, 420100,
+		480100, 660100,
+		720100, 780100
+	};
+
+	playTrace(KeyerMode::IAMBICA, steps, 2);
+	CHECK(keyLineMatches(keyLine, expected, 8));
+
+	playTrace(KeyerMode::IAMBICB, steps, 2);
+	CHECK(keyLineMatches(keyLine, expected, 10));
+}
+
+static void testUltimaticRepeatsTheNewestPaddle()
+{
+	// Hold the dit, add the dah, let go of the dah, let go of the dit
+	static const HostPaddleStep steps[] = {
+		{ 0, HOST_DIT_PADDLE },
+		{ 200000, BOTH_PADDLES },
+		{ 700000, HOST_DIT_PADDLE },
+		{ 900000, 0 }
+	};
+
+	playTrace(KeyerMode::ULTIMATIC, steps, 4);
+
+	// dits, then dahs while both are held (no alternating), then dits again
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 180100,
+		240100, 420100,
+		480100, 660100,
+		720100, 780100,
+		840100, 900100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 12));
+}
+
+static void testBugDahPaddleKeysByHand()
+{
+	// Dits from the dit paddle, then the dah paddle held for 250 ms, then a quick one
+	static const HostPaddleStep steps[] = {
+		{ 0, HOST_DIT_PADDLE },
+		{ 200000, 0 },
+		{ 300000, HOST_DAH_PADDLE },
+		{ 550000, 0 },
+		{ 700000, HOST_DAH_PADDLE },
+		{ 730000, 0 }
+	};
+
+	playTrace(KeyerMode::BUG, steps, 6);
+
+	// The dah paddle's key down lasts as long as it is held (to the tick)
+	const uint32_t expected[] = {
+		100, 60100,
+		120100, 180100,
+		300100, 550100,
+		700100, 730100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 8));
+}
+
+static void testBugSqueezeKeysByHand()
+{
+	// Both paddles at once in bug mode: the dah side wins and keys by hand
+	static const HostPaddleStep steps[] = {
+		{ 0, BOTH_PADDLES },
+		{ 100000, 0 }
+	};
+
+	playTrace(KeyerMode::BUG, steps, 2);
+
+	const uint32_t expected[] = {
+		100, 100100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 2));
+}
+
+int main()
+{
+	RUN_TEST(testIambicAStopsAfterTheElement);
+	RUN_TEST(testIambicBSendsOneMore);
+	RUN_TEST(testIambicSqueezeAlternates);
+	RUN_TEST(testUltimaticRepeatsTheNewestPaddle);
+	RUN_TEST(testBugDahPaddleKeysByHand);
+	RUN_TEST(testBugSqueezeKeysByHand);
+
+	return hostTestFinish();
+}
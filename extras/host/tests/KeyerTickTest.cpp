@@ -0,0 +1,191 @@
+/**
+ * KeyerTickTest.cpp - The Timer1 keyer's elements are within a tick of the PARIS lengths
+ * from 5 to 50 WPM without drifting, and held paddles give the same key line every time
+ * (golden timelines)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKeyer.h"
+
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioKeyer.h"
+
+SCRadioEventQueue queue;
+SCRadioKeyer keyer = SCRadioKeyer(queue, nullptr, 0);
+HostKeyLine keyLine;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyLine, keyLineChanged)>
+> TestDispatcher;
+
+/**
+ * Number of dits held down for at each speed
+ */
+#define DIT_COUNT 20
+
+/**
+ * Powers up with the paddles let go and sets the keyer up.  The keyer sits idle for a
+ * moment first (it won't key until it has seen the paddles let go).
+ */
+static void startKeyer(KeyerMode keyerMode, int8_t wpm)
+{
+	hostReset();
+	setPaddles(0);
+
+	keyer.begin();
+	keyer.setKeyerMode(keyerMode);
+	keyer.setKeyerWPM(wpm);
+
+	runKeyer<TestDispatcher>(queue, 1000);
+	keyLine.clear();
+}
+
+static void testElementLengthsAcrossSpeeds()
+{
+	printf("  WPM   dit us   worst error us   jitter us   drift us\n");
+
+	for (int8_t wpm = 5; wpm <= 50; wpm++)
+	{
+		startKeyer(KeyerMode::IAMBICB, wpm);
+
+		uint32_t ditMicros = 1200000UL / wpm;
+
+		// Hold the dit paddle until the last dit has started, then let go
+		HostPaddleStep steps[] = {
+			{ 0, HOST_DIT_PADDLE },
+			{ (2 * DIT_COUNT - 1) * ditMicros, 0 }
+		};
+
+		runKeyer<TestDispatcher>(queue, 2 * DIT_COUNT * ditMicros + 10000, steps, 2);
+
+		if (!CHECK_EQUAL(2 * DIT_COUNT, keyLine.count))
+		{
+			continue;
+		}
+
+		int32_t worstError = 0;
+		uint32_t shortest = 0xFFFFFFFF;
+		uint32_t longest = 0;
+
+		// Every key down and every space between them
+		for (uint16_t i = 0; i + 1 < keyLine.count; i++)
+		{
+			uint32_t length = keyLine.lengthMicros(i);
+			int32_t error = (int32_t)length - (int32_t)ditMicros;
+
+			if (abs(error) > abs(worstError))
+			{
+				worstError = error;
+			}
+
+			shortest = (length < shortest) ? length : shortest;
+			longest = (length > longest) ? length : longest;
+		}
+
+		// The last dit starts where 2 * (DIT_COUNT - 1) exact dits say it should.
+		// Whatever a tick runs over is taken off the next element, so nothing adds up.
+		int32_t drift = (int32_t)(keyLine.edgeMicros[keyLine.count - 2] - keyLine.edgeMicros[0])
+							- (int32_t)(2 * (DIT_COUNT - 1) * ditMicros);
+
+		printf("  %3d   %6lu   %14ld   %9lu   %8ld\n", wpm, (unsigned long)ditMicros,
+			(long)worstError, (unsigned long)(longest - shortest), (long)drift);
+
+		CHECK(abs(worstError) < KEYER_TICK_MICROS);
+		CHECK(longest - shortest <= KEYER_TICK_MICROS);
+		CHECK(abs(drift) < KEYER_TICK_MICROS);
+	}
+}
+
+static void testGoldenDitsAt13WPM()
+{
+	// A dit at 13 WPM is 92307 us, not a whole number of ticks.  Each tick that runs over
+	// is taken off the next element, so the lengths go 92400, 92300, 92300, 92300 ...
+	startKeyer(KeyerMode::IAMBICB, 13);
+
+	HostPaddleStep steps[] = {
+		{ 0, HOST_DIT_PADDLE },
+		{ 400000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 600000, steps, 2);
+
+	const uint32_t expected[] = {
+		100, 92500,
+		184800, 277100,
+		369400, 461700
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 6));
+}
+
+static void testGoldenDahsAt20WPM()
+{
+	// 60 ms dit, 180 ms dah (whole ticks, so nothing to carry)
+	startKeyer(KeyerMode::IAMBICB, 20);
+
+	HostPaddleStep steps[] = {
+		{ 0, HOST_DAH_PADDLE },
+		{ 300000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 600000, steps, 2);
+
+	const uint32_t expected[] = {
+		100, 180100,
+		240100, 420100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 4));
+}
+
+static void testClockRolloverDoesNotMatter()
+{
+	// The keyer counts elements down rather than comparing clock readings, so the
+	// clock wrapping around in the middle of a dit changes nothing
+	startKeyer(KeyerMode::IAMBICB, 13);
+	hostSetMicros(0xFFFFFFFFUL - 150000UL);
+	runKeyer<TestDispatcher>(queue, 1000);
+	keyLine.clear();
+
+	HostPaddleStep steps[] = {
+		{ 0, HOST_DIT_PADDLE },
+		{ 400000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 600000, steps, 2);
+
+	if (CHECK_EQUAL(6, keyLine.count))
+	{
+		uint32_t start = keyLine.edgeMicros[0];
+		const uint32_t expectedLengths[] = { 92400, 92300, 92300, 92300, 92300 };
+
+		for (uint16_t i = 0; i < 5; i++)
+		{
+			CHECK_EQUAL(expectedLengths[i], keyLine.lengthMicros(i));
+		}
+
+		CHECK_EQUAL(461600, keyLine.edgeMicros[5] - start);
+	}
+}
+
+int main()
+{
+	RUN_TEST(testElementLengthsAcrossSpeeds);
+	RUN_TEST(testGoldenDitsAt13WPM);
+	RUN_TEST(testGoldenDahsAt20WPM);
+	RUN_TEST(testClockRolloverDoesNotMatter);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,228 @@
+/**
+ * KeyerTimingTest.cpp - The keyer's precomputed element lengths for the keyer speed, the
+ * Farnsworth (effective) speed, the dah ratio and the key compensation, and the key line
+ * they give
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKeyer.h"
+
+#include "SCRadioCWMessage.h"
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioKeyer.h"
+
+CW_MESSAGE(parisMessage, "PARIS PARIS");
+
+SCRadioEventQueue queue;
+SCRadioKeyer keyer = SCRadioKeyer(queue, nullptr, 0);
+HostKeyLine keyLine;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::KEY_LINE_CHANGED, EVENT_HANDLER(keyLine, keyLineChanged)>
+> TestDispatcher;
+
+/**
+ * Elements in PARIS: P .--. A .- R .-. I .. S ...
+ */
+#define PARIS_ELEMENT_COUNT 14
+
+/**
+ * Powers up with the paddles let go and the keyer timing set
+ */
+static void startKeyer(int8_t wpm, int8_t effectiveWPM, int8_t dahRatioTenths, uint16_t compensationMicros)
+{
+	hostReset();
+	setPaddles(0);
+
+	keyer.begin();
+	keyer.setKeyerMode(KeyerMode::IAMBICB);
+	keyer.setKeyerWPM(wpm);
+	keyer.setKeyerEffectiveWPM(effectiveWPM);
+	keyer.setDahRatio(dahRatioTenths);
+	keyer.setCompensation(compensationMicros);
+
+	runKeyer<TestDispatcher>(queue, 1000);
+	keyLine.clear();
+}
+
+static void testStandardTiming()
+{
+	SCRadioKeyerTiming timing;
+
+	// 20 WPM: a 60 ms dit, 3 dits to a dah, 3 between characters and 7 between words
+	timing.calculate(20, KEYER_DEFAULT_EFFECTIVE_WPM, KEYER_DEFAULT_DAH_RATIO_TENTHS, KEYER_DEFAULT_COMPENSATION_MICROS);
+
+	CHECK_EQUAL(60000, timing.ditKeyedMicros);
+	CHECK_EQUAL(180000, timing.dahKeyedMicros);
+	CHECK_EQUAL(60000, timing.elementSpaceMicros);
+	CHECK_EQUAL(120000, timing.characterSpaceMicros);
+	CHECK_EQUAL(240000, timing.wordSpaceMicros);
+
+	// An effective speed at or above the keyer speed is no Farnsworth spacing
+	timing.calculate(20, 20, 30, 0);
+	CHECK_EQUAL(120000, timing.characterSpaceMicros);
+	CHECK_EQUAL(240000, timing.wordSpaceMicros);
+
+	timing.calculate(20, 25, 30, 0);
+	CHECK_EQUAL(120000, timing.characterSpaceMicros);
+	CHECK_EQUAL(240000, timing.wordSpaceMicros);
+}
+
+static void testDahRatio()
+{
+	SCRadioKeyerTiming timing;
+
+	timing.calculate(20, 0, 35, 0);
+	CHECK_EQUAL(60000, timing.ditKeyedMicros);
+	CHECK_EQUAL(210000, timing.dahKeyedMicros);
+
+	// At 13 WPM the dit is 92307 us.  The dah comes from the speed (276923 us), not three
+	// rounded dits (276921 us).
+	timing.calculate(13, 0, 30, 0);
+	CHECK_EQUAL(92307, timing.ditKeyedMicros);
+	CHECK_EQUAL(276923, timing.dahKeyedMicros);
+}
+
+static void testFarnsworth()
+{
+	SCRadioKeyerTiming timing;
+
+	// Characters at 20 WPM, PARIS at 10 WPM.  PARIS takes 6 s, 1.86 s of it the 31 dits of
+	// characters.  The other 4.14 s is shared out over the 19 dits of space.
+	timing.calculate(20, 10, 30, 0);
+
+	CHECK_EQUAL(60000, timing.ditKeyedMicros);
+	CHECK_EQUAL(180000, timing.dahKeyedMicros);
+	CHECK_EQUAL(60000, timing.elementSpaceMicros);
+
+	// 3/19 of 4.14 s between characters (653684 us) and 7/19 between words (1525263 us),
+	// less what comes before each
+	CHECK_EQUAL(593684, timing.characterSpaceMicros);
+	CHECK_EQUAL(871579, timing.wordSpaceMicros);
+
+	// PARIS and the space after it add back up to 6 s (to a few microseconds of rounding)
+	uint32_t characterTotal = timing.elementSpaceMicros + timing.characterSpaceMicros;
+	uint32_t parisMicros = 1860000UL + 4 * characterTotal + (characterTotal + timing.wordSpaceMicros);
+
+	printf("  PARIS at 20/10 WPM: %lu us\n", (unsigned long)parisMicros);
+
+	CHECK(parisMicros <= 6000000UL);
+	CHECK(6000000UL - parisMicros < 10);
+}
+
+static void testCompensation()
+{
+	SCRadioKeyerTiming timing;
+
+	// Added to each key down and taken off the space after it, so the elements keep their pace
+	timing.calculate(20, 0, 30, 3000);
+
+	CHECK_EQUAL(63000, timing.ditKeyedMicros);
+	CHECK_EQUAL(183000, timing.dahKeyedMicros);
+	CHECK_EQUAL(57000, timing.elementSpaceMicros);
+	CHECK_EQUAL(120000, timing.characterSpaceMicros);
+	CHECK_EQUAL(240000, timing.wordSpaceMicros);
+
+	// No more than half a dit
+	timing.calculate(20, 0, 30, 40000);
+
+	CHECK_EQUAL(90000, timing.ditKeyedMicros);
+	CHECK_EQUAL(210000, timing.dahKeyedMicros);
+	CHECK_EQUAL(30000, timing.elementSpaceMicros);
+}
+
+static void testGoldenCompensatedDits()
+{
+	startKeyer(20, 0, 30, 3000);
+
+	HostPaddleStep steps[] = {
+		{ 0, HOST_DIT_PADDLE },
+		{ 250000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 600000, steps, 2);
+
+	// 63 ms down and 57 ms up, still a dit every 120 ms
+	const uint32_t expected[] = {
+		100, 63100,
+		120100, 183100,
+		240100, 303100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 6));
+}
+
+static void testGoldenLongDahs()
+{
+	startKeyer(20, 0, 35, 0);
+
+	HostPaddleStep steps[] = {
+		{ 0, HOST_DAH_PADDLE },
+		{ 300000, 0 }
+	};
+
+	runKeyer<TestDispatcher>(queue, 800000, steps, 2);
+
+	const uint32_t expected[] = {
+		100, 210100,
+		270100, 480100
+	};
+
+	CHECK(keyLineMatches(keyLine, expected, 4));
+}
+
+static void testFarnsworthMessage()
+{
+	startKeyer(20, 10, 30, 0);
+
+	keyer.playMessage(parisMessage.codes, 0);
+	runKeyer<TestDispatcher>(queue, 13000000);
+
+	if (!CHECK_EQUAL(4 * PARIS_ELEMENT_COUNT, keyLine.count))
+	{
+		return;
+	}
+
+	// From the start of one PARIS to the next is 6 s, the same as PARIS at 10 WPM
+	uint32_t wordMicros = keyLine.edgeMicros[2 * PARIS_ELEMENT_COUNT] - keyLine.edgeMicros[0];
+	int32_t wordError = (int32_t)wordMicros - 6000000L;
+
+	// From the end of P (4 elements) to the start of A is the stretched character space
+	uint32_t characterMicros = keyLine.lengthMicros(7);
+	int32_t characterError = (int32_t)characterMicros - 653684L;
+
+	printf("  PARIS %lu us (%ld us from 6 s), P to A %lu us (%ld us from 653684)\n",
+		(unsigned long)wordMicros, (long)wordError, (unsigned long)characterMicros, (long)characterError);
+
+	CHECK(abs(wordError) < KEYER_TICK_MICROS);
+	CHECK(abs(characterError) < KEYER_TICK_MICROS);
+
+	// The characters themselves are still sent at 20 WPM
+	CHECK_EQUAL(60000, keyLine.lengthMicros(0));
+	CHECK_EQUAL(180000, keyLine.lengthMicros(2));
+}
+
+int main()
+{
+	RUN_TEST(testStandardTiming);
+	RUN_TEST(testDahRatio);
+	RUN_TEST(testFarnsworth);
+	RUN_TEST(testCompensation);
+	RUN_TEST(testGoldenCompensatedDits);
+	RUN_TEST(testGoldenLongDahs);
+	RUN_TEST(testFarnsworthMessage);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,217 @@
+/**
+ * LoopProfilerTest.cpp - The loop profiler's numbers and histograms for loops timed on the simulated clock
+ *
+ * Built with LOOP_PROFILER_ENABLED set to 1.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+
+#include "SCRadioLoopProfiler.h"
+
+/**
+ * One stage's line from print()
+ */
+struct StageLine
+{
+	long min;
+	long max;
+	long mean;
+	long samples;
+	long histogram[LOOP_PROFILER_HISTOGRAM_BINS];
+};
+
+// Finds a stage's line in what print() sent and reads its numbers
+static bool readStageLine(const char *stageName, StageLine &line)
+{
+	char prefix[32];
+	snprintf(prefix, sizeof(prefix), "\n%s,", stageName);
+
+	const char *text = strstr(hostSerialOutput(), prefix);
+
+	if (text == NULL)
+	{
+		return false;
+	}
+
+	text += strlen(prefix);
+
+	long *fields[4 + LOOP_PROFILER_HISTOGRAM_BINS] = { &line.min, &line.max, &line.mean, &line.samples };
+
+	for (int8_t bin = 0; bin < LOOP_PROFILER_HISTOGRAM_BINS; bin++)
+	{
+		fields[4 + bin] = &line.histogram[bin];
+	}
+
+	for (int8_t field = 0; field < 4 + LOOP_PROFILER_HISTOGRAM_BINS; field++)
+	{
+		char *end;
+		*fields[field] = strtol(text, &end, 10);
+
+		if (end == text)
+		{
+			return false;
+		}
+
+		text = (*end == ',') ? end + 1 : end;
+	}
+
+	return true;
+}
+
+// The histogram bucket the given percentage of samples are at or below
+static int8_t percentileBin(const StageLine &line, int8_t percent)
+{
+	long count = 0;
+
+	for (int8_t bin = 0; bin < LOOP_PROFILER_HISTOGRAM_BINS; bin++)
+	{
+		count += line.histogram[bin];
+
+		if (count * 100 >= line.samples * percent)
+		{
+			return bin;
+		}
+	}
+
+	return LOOP_PROFILER_HISTOGRAM_BINS - 1;
+}
+
+// One pass through a pretend loop: the keyer takes 3 us, the DDS 'ddsMicros', the events 40 us
+static void timePass(SCRadioLoopProfiler &profiler, uint32_t ddsMicros)
+{
+	profiler.startLoop();
+
+	hostAdvanceMicros(3);
+	profiler.endStage(LoopStage::KEYER);
+
+	hostAdvanceMicros(ddsMicros);
+	profiler.endStage(LoopStage::DDS);
+
+	hostAdvanceMicros(40);
+	profiler.endStage(LoopStage::EVENTS);
+}
+
+static void testStageNumbersAndHistogram()
+{
+	hostReset();
+
+	SCRadioLoopProfiler profiler;
+	profiler.begin();
+
+	// 90 passes where the DDS takes 20 us and 10 where it takes 300 us
+	for (uint8_t pass = 0; pass < 100; pass++)
+	{
+		timePass(profiler, (pass % 10 == 9) ? 300 : 20);
+	}
+
+	profiler.startLoop();
+	hostClearSerialOutput();
+	profiler.print();
+
+	StageLine line;
+
+	CHECK(readStageLine("keyer", line));
+	CHECK_EQUAL(3, line.min);
+	CHECK_EQUAL(3, line.max);
+	CHECK_EQUAL(3, line.mean);
+	CHECK_EQUAL(100, line.samples);
+	CHECK_EQUAL(100, line.histogram[1]);      // 2 - 3 us
+
+	CHECK(readStageLine("dds", line));
+	CHECK_EQUAL(20, line.min);
+	CHECK_EQUAL(300, line.max);
+	CHECK_EQUAL((90 * 20 + 10 * 300) / 100, line.mean);
+	CHECK_EQUAL(100, line.samples);
+	CHECK_EQUAL(90, line.histogram[4]);       // 16 - 31 us
+	CHECK_EQUAL(10, line.histogram[8]);       // 256 - 511 us
+	CHECK_EQUAL(4, percentileBin(line, 50));
+	CHECK_EQUAL(4, percentileBin(line, 90));
+	CHECK_EQUAL(8, percentileBin(line, 99));
+
+	// Whole passes: one less than the number of startLoop() calls
+	CHECK(readStageLine("loop", line));
+	CHECK_EQUAL(3 + 20 + 40, line.min);
+	CHECK_EQUAL(3 + 300 + 40, line.max);
+	CHECK_EQUAL(100, line.samples);
+
+	// Stages never timed print zeros
+	CHECK(readStageLine("eeprom", line));
+	CHECK_EQUAL(0, line.min);
+	CHECK_EQUAL(0, line.samples);
+}
+
+static void testLongStagesGoInTheLastBucket()
+{
+	hostReset();
+
+	SCRadioLoopProfiler profiler;
+	profiler.begin();
+
+	timePass(profiler, 70000);
+	profiler.startLoop();
+
+	hostClearSerialOutput();
+	profiler.print();
+
+	StageLine line;
+
+	CHECK(readStageLine("dds", line));
+	CHECK_EQUAL(65535, line.max);
+	CHECK_EQUAL(70000, line.mean);
+	CHECK_EQUAL(1, line.histogram[LOOP_PROFILER_HISTOGRAM_BINS - 1]);
+}
+
+static void testPrintingPassIsNotTimed()
+{
+	hostReset();
+
+	SCRadioLoopProfiler profiler;
+	profiler.begin();
+
+	timePass(profiler, 20);
+	profiler.startLoop();
+	profiler.print();
+
+	// Printing takes a long time.  The next startLoop() doesn't count it.
+	hostAdvanceMicros(50000);
+	timePass(profiler, 20);
+	profiler.startLoop();
+
+	hostClearSerialOutput();
+	profiler.print();
+
+	StageLine line;
+
+	CHECK(readStageLine("loop", line));
+	CHECK_EQUAL(2, line.samples);
+	CHECK_EQUAL(63, line.max);
+
+	// reset() clears everything
+	profiler.reset();
+	hostClearSerialOutput();
+	profiler.print();
+
+	CHECK(readStageLine("dds", line));
+	CHECK_EQUAL(0, line.samples);
+	CHECK_EQUAL(0, line.histogram[4]);
+}
+
+int main()
+{
+	RUN_TEST(testStageNumbersAndHistogram);
+	RUN_TEST(testLongStagesGoInTheLastBucket);
+	RUN_TEST(testPrintingPassIsNotTimed);
+
+	return hostTestFinish();
+}
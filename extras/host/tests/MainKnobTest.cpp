@@ -0,0 +1,229 @@
+/**
+ * MainKnobTest.cpp - The knob's interrupt routine counts one step per detent in each
+ * direction, ignores contact bounce and half turns that come back, and times the steps
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostCore.h"
+#include "HostTest.h"
+#include "HostEvents.h"
+#include "HostKnob.h"
+
+#include "SCRadioButton.h"
+#include "SCRadioEventDispatcher.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioMainKnob.h"
+
+SCRadioEventQueue queue;
+SCRadioButton button = SCRadioButton(MAIN_KNOB_SWITCH_PIN, DEBOUNCE_THRESHOLD_MS, LONG_PRESS_THRESHOLD_MS);
+SCRadioMainKnob knob = SCRadioMainKnob(queue, MAIN_KNOB_PIN_1, MAIN_KNOB_PIN_2, button);
+
+HostEventRecorder turnRecorder;
+
+typedef SCRadioEventDispatcher<
+	SCRadioEventRoute<EventType::VFO_KNOB_TURNED, EVENT_HANDLER(turnRecorder, record)>
+> TestDispatcher;
+
+static void startTest()
+{
+	hostReset();
+
+	// The pull ups hold the knob's pins and the button high while nothing is touched
+	hostSetPin(MAIN_KNOB_PIN_1, HIGH);
+	hostSetPin(MAIN_KNOB_PIN_2, HIGH);
+	hostSetPin(MAIN_KNOB_SWITCH_PIN, HIGH);
+
+	knob.begin();
+	queue.processAllEvents<TestDispatcher>();
+	turnRecorder.clear();
+}
+
+/**
+ * Runs the knob's loop() and hands its events to the recorder
+ *
+ * @returns steps in the turn event (0 if none was sent)
+ */
+static int16_t takeSteps()
+{
+	uint16_t eventsBefore = turnRecorder.count;
+
+	knob.loop();
+	queue.processAllEvents<TestDispatcher>();
+
+	if (turnRecorder.count == eventsBefore)
+	{
+		return 0;
+	}
+
+	return turnRecorder.eventPayloads[turnRecorder.count - 1].knobTurn.steps;
+}
+
+/**
+ * Sets a pin and waits a little, like a contact closing or opening
+ */
+static void movePin(uint8_t pin, uint8_t level)
+{
+	hostSetPin(pin, level);
+	hostAdvanceMicros(50);
+}
+
+static void testCountsEachDetent()
+{
+	startTest();
+
+	for (int i = 0; i < 7; i++)
+	{
+		turnMainKnobOneStep(true, 200);
+	}
+
+	CHECK_EQUAL(7, takeSteps());
+
+	for (int i = 0; i < 3; i++)
+	{
+		turnMainKnobOneStep(false, 200);
+	}
+
+	CHECK_EQUAL(-3, takeSteps());
+
+	// Back and forth between two looks at the knob comes to nothing, so nothing is sent
+	turnMainKnobOneStep(true, 200);
+	turnMainKnobOneStep(false, 200);
+	CHECK_EQUAL(0, takeSteps());
+	CHECK_EQUAL(2, turnRecorder.count);
+}
+
+static void testStepsAreNotLostWhileLoopIsBusy()
+{
+	startTest();
+
+	// 200 detents while loop() is off doing something else (a DDS reload, the display)
+	for (int i = 0; i < 200; i++)
+	{
+		turnMainKnobOneStep(true, 100);
+	}
+
+	CHECK_EQUAL(200, takeSteps());
+	CHECK_EQUAL(1, turnRecorder.count);
+}
+
+static void testContactBounceIsIgnored()
+{
+	startTest();
+
+	// Clockwise: pin 1 goes low, then pin 2, then pin 1 back high, then pin 2.
+	// Each contact chatters on the way.
+	for (int i = 0; i < 5; i++)
+	{
+		movePin(MAIN_KNOB_PIN_1, LOW);
+		movePin(MAIN_KNOB_PIN_1, HIGH);
+	}
+	movePin(MAIN_KNOB_PIN_1, LOW);
+
+	for (int i = 0; i < 5; i++)
+	{
+		movePin(MAIN_KNOB_PIN_2, LOW);
+		movePin(MAIN_KNOB_PIN_2, HIGH);
+	}
+	movePin(MAIN_KNOB_PIN_2, LOW);
+
+	for (int i = 0; i < 5; i++)
+	{
+		movePin(MAIN_KNOB_PIN_1, HIGH);
+		movePin(MAIN_KNOB_PIN_1, LOW);
+	}
+	movePin(MAIN_KNOB_PIN_1, HIGH);
+
+	movePin(MAIN_KNOB_PIN_2, HIGH);
+
+	CHECK_EQUAL(1, takeSteps());
+
+	// Chatter on either pin while the knob sits in a detent isn't a step
+	for (int i = 0; i < 5; i++)
+	{
+		movePin(MAIN_KNOB_PIN_2, LOW);
+		movePin(MAIN_KNOB_PIN_2, HIGH);
+		movePin(MAIN_KNOB_PIN_1, LOW);
+		movePin(MAIN_KNOB_PIN_1, HIGH);
+	}
+
+	CHECK_EQUAL(0, takeSteps());
+
+	// The next detent counts as usual
+	turnMainKnobOneStep(false, 200);
+	CHECK_EQUAL(-1, takeSteps());
+}
+
+static void testHalfTurnThatComesBackIsIgnored()
+{
+	startTest();
+
+	// Past half way and back to the same detent
+	movePin(MAIN_KNOB_PIN_1, LOW);
+	movePin(MAIN_KNOB_PIN_2, LOW);
+	movePin(MAIN_KNOB_PIN_1, HIGH);
+	movePin(MAIN_KNOB_PIN_1, LOW);
+	movePin(MAIN_KNOB_PIN_2, HIGH);
+	movePin(MAIN_KNOB_PIN_1, HIGH);
+
+	CHECK_EQUAL(0, takeSteps());
+
+	turnMainKnobOneStep(true, 200);
+	CHECK_EQUAL(1, takeSteps());
+}
+
+static void testStepsAreTimed()
+{
+	startTest();
+
+	// The first step is timed from begin(), so it is taken on its own
+	turnMainKnobOneStep(true, 500);
+	CHECK_EQUAL(1, takeSteps());
+
+	// A detent every 2 ms (4 pin changes 500 us apart)
+	for (int i = 0; i < 4; i++)
+	{
+		turnMainKnobOneStep(true, 500);
+	}
+
+	CHECK_EQUAL(4, takeSteps());
+	CHECK_EQUAL(2000, turnRecorder.eventPayloads[1].knobTurn.stepIntervalMicros);
+
+	// A step after a long rest reads as the slowest there is
+	hostAdvanceMicros(100000);
+	turnMainKnobOneStep(true, 500);
+
+	CHECK_EQUAL(1, takeSteps());
+	CHECK_EQUAL(0xFFFF, turnRecorder.eventPayloads[2].knobTurn.stepIntervalMicros);
+
+	// Steps taken together carry the average of their intervals, not just the last one:
+	// 2 ms, 2 ms, 5 ms and 2 ms
+	turnMainKnobOneStep(true, 500);
+	turnMainKnobOneStep(true, 500);
+	hostAdvanceMicros(3000);
+	turnMainKnobOneStep(true, 500);
+	turnMainKnobOneStep(true, 500);
+
+	CHECK_EQUAL(4, takeSteps());
+	CHECK_EQUAL(2750, turnRecorder.eventPayloads[3].knobTurn.stepIntervalMicros);
+}
+
+int main()
+{
+	RUN_TEST(testCountsEachDetent);
+	RUN_TEST(testStepsAreNotLostWhileLoopIsBusy);
+	RUN_TEST(testContactBounceIsIgnored);
+	RUN_TEST(testHalfTurnThatComesBackIsIgnored);
+	RUN_TEST(testStepsAreTimed);
+
+	return hostTestFinish();
+}
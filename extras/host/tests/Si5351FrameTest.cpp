@@ -0,0 +1,147 @@
+/**
+ * Si5351FrameTest.cpp - Golden Si5351 register writes (built with DDS_CHIP set to SCRadioSi5351)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+
+#include "SCRadioDDS.h"
+
+typedef SCRadioSi5351<SI5351_CRYSTAL_FREQUENCY_HZ, SI5351_OUTPUT_DIVIDER> TestChip;
+
+#define TEST_FREQUENCY_COUNT 3
+
+static const int32_t kTestFrequencies[TEST_FREQUENCY_COUNT] = { 7030000, 7000000, 7299999 };
+
+// Worked out by hand for a 25 MHz crystal and an output divider of 120 (AN619):
+//   7030000: a = 33, b = 390070, P1 = 3807, P2 = 121600
+//   7000000: a = 33, b = 314572, P1 = 3788, P2 = 419328
+//   7299999: a = 35, b = 20969,  P1 = 3973, P2 = 62592
+// with c = P3 = 2^19.  Registers 26 through 33.
+static const uint8_t kGoldenFrames[TEST_FREQUENCY_COUNT][8] = {
+	{ 0x00, 0x00, 0x00, 0x0E, 0xDF, 0x81, 0xDB, 0x00 },
+	{ 0x00, 0x00, 0x00, 0x0E, 0xCC, 0x86, 0x66, 0x00 },
+	{ 0x00, 0x00, 0x00, 0x0F, 0x85, 0x80, 0xF4, 0x80 }
+};
+
+static_assert(TestChip::pllWhole(7030000) == 33, "Si5351 PLL multiplier is wrong");
+static_assert(TestChip::pllNumerator(7030000) == 390070UL, "Si5351 PLL fraction is wrong");
+
+// Checks transmission 'index' is a write of 'length' bytes starting at register 'reg'
+static bool checkRegisterWrite(uint16_t index, uint8_t reg, const uint8_t *values, uint8_t length)
+{
+	const HostWireTransmission &transmission = hostWireTransmission(index);
+
+	bool passed = CHECK_EQUAL(SI5351_I2C_ADDRESS, transmission.address)
+					&& CHECK_EQUAL(length + 1, transmission.length)
+					&& CHECK_EQUAL(reg, transmission.data[0]);
+
+	for (uint8_t i = 0; passed && i < length; i++)
+	{
+		passed = CHECK_EQUAL(values[i], transmission.data[i + 1]);
+	}
+
+	if (!passed)
+	{
+		printf("  (transmission %u)\n", index);
+	}
+
+	return passed;
+}
+
+static bool checkRegisterWrite(uint16_t index, uint8_t reg, uint8_t value)
+{
+	return checkRegisterWrite(index, reg, &value, 1);
+}
+
+static void testBeginSetsUpTheOutput()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	dds.begin();
+
+	// Outputs off, crystal load, CLK0 control, then the 8 multisynth 0 registers
+	// (divider 120: P1 = 128 x 120 - 512 = 0x3A00, P2 = 0, P3 = 1)
+	static const uint8_t multisynth0[8] = { 0x00, 0x01, 0x00, 0x3A, 0x00, 0x00, 0x00, 0x00 };
+
+	CHECK_EQUAL(11, hostWireTransmissionCount());
+	checkRegisterWrite(0, SI5351_OUTPUT_ENABLE_REGISTER, 0xFF);
+	checkRegisterWrite(1, SI5351_CRYSTAL_LOAD_REGISTER, 0xD2);
+	checkRegisterWrite(2, SI5351_CLK0_CONTROL_REGISTER, 0x4F);
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		checkRegisterWrite(3 + i, SI5351_MULTISYNTH0_FIRST_REGISTER + i, multisynth0[i]);
+	}
+
+	// The DDS pins are left alone
+	CHECK(!hostPinIsOutput(DDS_WORD_LOAD_CLOCK_PIN));
+	CHECK(!hostPinIsOutput(DDS_DATA_PIN));
+}
+
+static void testFramesMatchTheGoldenFrames()
+{
+	hostReset();
+
+	SCRadioDDS dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+					DDS_TUNING_WORD_MILLIONTHS, DDSTransport::BIT_BANG);
+	dds.begin();
+	hostClearWire();
+
+	for (uint8_t i = 0; i < TEST_FREQUENCY_COUNT; i++)
+	{
+		dds.sendFrequencyToDDS(kTestFrequencies[i]);
+	}
+
+	// The first frame is followed by a PLL reset and CLK0 being turned on.  The rest are just the frame.
+	CHECK_EQUAL(TEST_FREQUENCY_COUNT + 2, hostWireTransmissionCount());
+	checkRegisterWrite(0, SI5351_PLLA_FIRST_REGISTER, kGoldenFrames[0], 8);
+	checkRegisterWrite(1, SI5351_PLL_RESET_REGISTER, 0x20);
+	checkRegisterWrite(2, SI5351_OUTPUT_ENABLE_REGISTER, 0xFE);
+	checkRegisterWrite(3, SI5351_PLLA_FIRST_REGISTER, kGoldenFrames[1], 8);
+	checkRegisterWrite(4, SI5351_PLLA_FIRST_REGISTER, kGoldenFrames[2], 8);
+}
+
+static void testOutputIsWithinHalfAHertz()
+{
+	// Every 10 Hz across the band, the registers give back the frequency asked for
+	for (uint32_t frequency = VFO_LIMIT_LOW; frequency <= VFO_LIMIT_HIGH; frequency += 10)
+	{
+		TestChip::Frame frame = TestChip::buildFrame(frequency);
+
+		uint32_t p1 = ((uint32_t)(frame.bytes[2] & 0x03) << 16) | ((uint32_t)frame.bytes[3] << 8) | frame.bytes[4];
+		uint32_t p2 = ((uint32_t)(frame.bytes[5] & 0x0F) << 16) | ((uint32_t)frame.bytes[6] << 8) | frame.bytes[7];
+		uint32_t p3 = ((uint32_t)(frame.bytes[5] & 0xF0) << 12) | ((uint32_t)frame.bytes[0] << 8) | frame.bytes[1];
+
+		// a + b / c = (P1 + 512 + P2 / P3) / 128
+		double multiplier = (p1 + 512 + (double)p2 / p3) / 128.0;
+		double output = SI5351_CRYSTAL_FREQUENCY_HZ * multiplier / SI5351_OUTPUT_DIVIDER;
+
+		if (!CHECK(fabs(output - frequency) < 0.5))
+		{
+			printf("  (%u Hz came out as %.3f Hz)\n", (unsigned)frequency, output);
+			return;
+		}
+	}
+}
+
+int main()
+{
+	RUN_TEST(testBeginSetsUpTheOutput);
+	RUN_TEST(testFramesMatchTheGoldenFrames);
+	RUN_TEST(testOutputIsWithinHalfAHertz);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,231 @@
+/**
+ * SidetoneTest.cpp - The sidetone sets Timer2 up the way the ATmega328 needs it, the tone
+ * rises and falls over the raised cosine envelope a cycle at a time, and the timer stops
+ * itself once the tone has died away
+ *
+ * At 625 Hz a cycle is exactly 100 Timer2 counts (1600 us, 16 us a count).  At full volume
+ * the high part is up to 50 counts, so the envelope's steps (37, 128, 219 and 255 out of 256)
+ * give high parts of 7, 25, 42 and 49 counts.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+
+#include "SCRadioSidetone.h"
+
+SCRadioSidetone sidetone = SCRadioSidetone(SIDETONE_PIN, 625, SIDETONE_MAX_VOLUME);
+
+/**
+ * Microseconds in one Timer2 count (clock / 256)
+ */
+#define TIMER2_COUNT_MICROS 16
+
+/**
+ * Microseconds in one cycle of the 625 Hz tone
+ */
+#define TONE_CYCLE_MICROS 1600
+
+/**
+ * Most high parts of the tone a test looks at
+ */
+#define MAX_HIGH_PARTS 64
+
+/**
+ * Where each high part of the tone started and how long it lasted, from the pin log
+ */
+static uint16_t highParts(uint32_t *startMicros, uint32_t *lengthMicros)
+{
+	uint16_t count = 0;
+	uint32_t riseMicros = 0;
+	bool high = false;
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		const HostPinChange &change = hostPinChange(i);
+
+		if (change.pin != SIDETONE_PIN)
+		{
+			continue;
+		}
+
+		if (change.level == HIGH)
+		{
+			riseMicros = change.micros;
+			high = true;
+		}
+		else if (high && (count < MAX_HIGH_PARTS))
+		{
+			startMicros[count] = riseMicros;
+			lengthMicros[count] = change.micros - riseMicros;
+			count++;
+			high = false;
+		}
+	}
+
+	return count;
+}
+
+static void startSidetone()
+{
+	hostReset();
+	sidetone.begin();
+	sidetone.setVolume(SIDETONE_MAX_VOLUME);
+	hostClearPinChanges();
+}
+
+static void testTimer2Setup()
+{
+	startSidetone();
+
+	// Nothing runs until the key goes down
+	CHECK_EQUAL(0, TCCR2B);
+	CHECK_EQUAL(0, TIMSK2 & _BV(OCIE2A));
+
+	sidetone.keyDown();
+
+	// CTC mode with no output pins (D3 and D11 are the knob's and the DDS's), clock / 256,
+	// and the compare match interrupt on with nothing left over from before
+	CHECK_EQUAL(_BV(WGM21), TCCR2A);
+	CHECK_EQUAL(_BV(CS22) | _BV(CS21), TCCR2B);
+	CHECK(TIMSK2 & _BV(OCIE2A));
+	CHECK_EQUAL(1, OCR2A);
+	CHECK_EQUAL(0, TIFR2 & _BV(OCF2A));
+
+	// Partway into a cycle at full volume: counting to the end of the high part (49 counts,
+	// and OCR2A counts from 0) or the low part (the other 51)
+	hostAdvanceMicros(4 * TONE_CYCLE_MICROS);
+
+	CHECK((OCR2A == 48) || (OCR2A == 50));
+
+	sidetone.keyUp();
+	hostAdvanceMicros(10 * TONE_CYCLE_MICROS);
+
+	// Died away: the timer has stopped itself and the pin is left low
+	CHECK_EQUAL(0, TCCR2B);
+	CHECK_EQUAL(0, TIMSK2 & _BV(OCIE2A));
+	CHECK_EQUAL(LOW, hostPinLevel(SIDETONE_PIN));
+}
+
+static void testEnvelopeRisesAndFalls()
+{
+	startSidetone();
+
+	// Down for 10 cycles (the first starts 2 counts after the key goes down), then up
+	sidetone.keyDown();
+	hostAdvanceMicros(10 * TONE_CYCLE_MICROS);
+	sidetone.keyUp();
+	hostAdvanceMicros(10 * TONE_CYCLE_MICROS);
+
+	uint32_t startMicros[MAX_HIGH_PARTS];
+	uint32_t lengthMicros[MAX_HIGH_PARTS];
+	uint16_t count = highParts(startMicros, lengthMicros);
+
+	// Up over 4 cycles, 6 more at the top, and down over 3 cycles
+	const uint8_t expectedCounts[] = { 7, 25, 42, 49, 49, 49, 49, 49, 49, 49, 42, 25, 7 };
+
+	if (!CHECK_EQUAL(13, count))
+	{
+		return;
+	}
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		CHECK_EQUAL(expectedCounts[i] * TIMER2_COUNT_MICROS, lengthMicros[i]);
+
+		// A cycle every 1600 us whatever the high part is
+		if (i > 0)
+		{
+			CHECK_EQUAL(TONE_CYCLE_MICROS, startMicros[i] - startMicros[i - 1]);
+		}
+	}
+
+	CHECK_EQUAL(2 * TIMER2_COUNT_MICROS, startMicros[0]);
+	CHECK_EQUAL(0, TCCR2B);
+}
+
+static void testVolumeScalesTheHighPart()
+{
+	startSidetone();
+
+	// Volume 4 of 10: up to 20 counts high, so the top of the envelope is 19 (20 * 255 / 256)
+	sidetone.setVolume(4);
+	sidetone.keyDown();
+	hostAdvanceMicros(6 * TONE_CYCLE_MICROS);
+	sidetone.keyUp();
+	hostAdvanceMicros(10 * TONE_CYCLE_MICROS);
+
+	uint32_t startMicros[MAX_HIGH_PARTS];
+	uint32_t lengthMicros[MAX_HIGH_PARTS];
+	uint16_t count = highParts(startMicros, lengthMicros);
+
+	// 20 * 37 / 256 is 2 counts, 20 * 128 / 256 is 10, 20 * 219 / 256 is 17
+	const uint8_t expectedCounts[] = { 2, 10, 17, 19, 19, 19, 17, 10, 2 };
+
+	if (CHECK_EQUAL(9, count))
+	{
+		for (uint16_t i = 0; i < count; i++)
+		{
+			CHECK_EQUAL(expectedCounts[i] * TIMER2_COUNT_MICROS, lengthMicros[i]);
+		}
+	}
+
+	// No volume, no tone, and the timer never starts
+	startSidetone();
+	sidetone.setVolume(0);
+	sidetone.keyDown();
+	hostAdvanceMicros(4 * TONE_CYCLE_MICROS);
+
+	CHECK_EQUAL(0, TCCR2B);
+	CHECK_EQUAL(0, highParts(startMicros, lengthMicros));
+}
+
+static void testKeyDownWhileDyingAway()
+{
+	startSidetone();
+
+	sidetone.keyDown();
+	hostAdvanceMicros(6 * TONE_CYCLE_MICROS);
+
+	// Up for a little under one cycle: the envelope comes down a step and turns around
+	sidetone.keyUp();
+	hostAdvanceMicros(TONE_CYCLE_MICROS - 100);
+	sidetone.keyDown();
+	hostAdvanceMicros(3 * TONE_CYCLE_MICROS);
+	sidetone.keyUp();
+	hostAdvanceMicros(10 * TONE_CYCLE_MICROS);
+
+	uint32_t startMicros[MAX_HIGH_PARTS];
+	uint32_t lengthMicros[MAX_HIGH_PARTS];
+	uint16_t count = highParts(startMicros, lengthMicros);
+
+	// The tone never stops between the two, so no click and no restart from silence
+	const uint8_t expectedCounts[] = { 7, 25, 42, 49, 49, 49, 42, 49, 49, 49, 42, 25, 7 };
+
+	if (CHECK_EQUAL(13, count))
+	{
+		for (uint16_t i = 0; i < count; i++)
+		{
+			CHECK_EQUAL(expectedCounts[i] * TIMER2_COUNT_MICROS, lengthMicros[i]);
+		}
+	}
+}
+
+int main()
+{
+	RUN_TEST(testTimer2Setup);
+	RUN_TEST(testEnvelopeRisesAndFalls);
+	RUN_TEST(testVolumeScalesTheHighPart);
+	RUN_TEST(testKeyDownWhileDyingAway);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,128 @@
+/**
+ * SketchTest.cpp - Runs the whole sketch on the simulated Nano
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostSketch.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "SCRadioMenuItem.h"
+
+extern LiquidCrystal_I2C lcd;
+extern SCRadioMenuItem keyerEffectiveSpeedMenuItem;
+extern SCRadioMenuItem keyerDahRatioMenuItem;
+extern SCRadioMenuItem keyerCompensationMenuItem;
+extern SCRadioMenuItem sidetonePitchMenuItem;
+extern SCRadioMenuItem sidetoneVolumeMenuItem;
+
+void setupInitialKeyerTiming();
+void setupInitialSidetone();
+
+// Puts a value in one of the EEPROM's stored values (4 bytes each, low byte first)
+static void storeValue(EEPROMValueIndex whichValue, uint32_t value)
+{
+	uint8_t *bytes = hostEEPROMData() + static_cast<uint8_t>(whichValue) * 4;
+
+	for (int i = 0; i < 4; i++)
+	{
+		bytes[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+// setup() clears the splash when it is done and the power up knob event brings up the frequency
+static void testStartsUpShowingTheFrequency()
+{
+	startSketch();
+
+	CHECK_TEXT("                ", lcd.hostLine(0));
+	CHECK(lcd.hostBacklight());
+	CHECK(micros() >= (uint32_t)SPLASH_DELAY * 1000);
+
+	// The EEPROM is empty, so it starts on the default frequency
+	runSketch(100000);
+
+	CHECK_TEXT("7.030.000 MHz  n", lcd.hostLine(0));
+}
+
+// Nothing is keyed and nothing is sounding with the key up
+static void testIdlesWithTheKeyUp()
+{
+	runSketch(100000);
+
+	CHECK(hostPinIsOutput(KEY_OUT_PIN));
+	CHECK_EQUAL(LOW, hostPinLevel(KEY_OUT_PIN));
+	CHECK_EQUAL(LOW, hostPinLevel(SIDETONE_PIN));
+}
+
+// The keyer timing settings come back from the EEPROM at power up.  Ones that were never
+// stored (or are out of range) start at their defaults.
+static void testKeyerTimingIsReadAtPowerUp()
+{
+	startSketch();
+
+	CHECK_EQUAL(KEYER_DEFAULT_EFFECTIVE_WPM, keyerEffectiveSpeedMenuItem.getMenuItemValue());
+	CHECK_EQUAL(KEYER_DEFAULT_DAH_RATIO_TENTHS, keyerDahRatioMenuItem.getMenuItemValue());
+	CHECK_EQUAL(KEYER_DEFAULT_COMPENSATION_MICROS, keyerCompensationMenuItem.getMenuItemValue());
+
+	storeValue(EEPROMValueIndex::KEYER_EFFECTIVE_SPEED, 8);
+	storeValue(EEPROMValueIndex::KEYER_DAH_RATIO, 35);
+	storeValue(EEPROMValueIndex::KEYER_COMPENSATION, 1500);
+	setupInitialKeyerTiming();
+
+	CHECK_EQUAL(8, keyerEffectiveSpeedMenuItem.getMenuItemValue());
+	CHECK_EQUAL(35, keyerDahRatioMenuItem.getMenuItemValue());
+	CHECK_EQUAL(1500, keyerCompensationMenuItem.getMenuItemValue());
+
+	storeValue(EEPROMValueIndex::KEYER_DAH_RATIO, 90);
+	storeValue(EEPROMValueIndex::KEYER_COMPENSATION, 0xFFFFFFFF);
+	setupInitialKeyerTiming();
+
+	CHECK_EQUAL(8, keyerEffectiveSpeedMenuItem.getMenuItemValue());
+	CHECK_EQUAL(KEYER_DEFAULT_DAH_RATIO_TENTHS, keyerDahRatioMenuItem.getMenuItemValue());
+	CHECK_EQUAL(KEYER_DEFAULT_COMPENSATION_MICROS, keyerCompensationMenuItem.getMenuItemValue());
+}
+
+// The sidetone comes back from the EEPROM the same way.  An erased EEPROM gives the
+// default pitch and volume, not the lowest pitch and no sidetone at all.
+static void testSidetoneIsReadAtPowerUp()
+{
+	startSketch();
+
+	CHECK_EQUAL(SIDETONE_DEFAULT_PITCH_HZ, sidetonePitchMenuItem.getMenuItemValue());
+	CHECK_EQUAL(SIDETONE_DEFAULT_VOLUME, sidetoneVolumeMenuItem.getMenuItemValue());
+
+	storeValue(EEPROMValueIndex::SIDETONE_PITCH, 750);
+	storeValue(EEPROMValueIndex::SIDETONE_VOLUME, 0);
+	setupInitialSidetone();
+
+	CHECK_EQUAL(750, sidetonePitchMenuItem.getMenuItemValue());
+	CHECK_EQUAL(0, sidetoneVolumeMenuItem.getMenuItemValue());
+
+	storeValue(EEPROMValueIndex::SIDETONE_PITCH, 2000);
+	storeValue(EEPROMValueIndex::SIDETONE_VOLUME, 0xFFFFFFFF);
+	setupInitialSidetone();
+
+	CHECK_EQUAL(SIDETONE_DEFAULT_PITCH_HZ, sidetonePitchMenuItem.getMenuItemValue());
+	CHECK_EQUAL(SIDETONE_DEFAULT_VOLUME, sidetoneVolumeMenuItem.getMenuItemValue());
+}
+
+int main()
+{
+	RUN_TEST(testStartsUpShowingTheFrequency);
+	RUN_TEST(testIdlesWithTheKeyUp);
+	RUN_TEST(testKeyerTimingIsReadAtPowerUp);
+	RUN_TEST(testSidetoneIsReadAtPowerUp);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,158 @@
+/**
+ * StraightKeyTest.cpp - A bouncy straight key keys the rig once per press, quickly, without flooding the queue
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostSketch.h"
+
+#include "SCRadioDDS.h"
+#include "SCRadioEventQueue.h"
+
+// From the sketch
+extern SCRadioEventQueue eventManager;
+extern SCRadioDDS dds;
+
+// One second of keying: 10 presses of 40 ms, 60 ms apart.  Each press and release
+// bounces for the first BOUNCE_MICROS (the contacts open and close every loop pass).
+#define PRESS_COUNT         10
+#define PRESS_PERIOD_MICROS 100000UL
+#define PRESS_MICROS        40000UL
+#define BOUNCE_MICROS       1500UL
+
+// Longest the rig may take to key after the key first closes
+#define MAX_KEY_OUT_LATENCY_MICROS 1000UL
+
+// Key level 'micros' into the keying (LOW is pressed)
+static uint8_t bouncyKeyLevel(uint32_t micros)
+{
+	uint32_t intoPeriod = micros % PRESS_PERIOD_MICROS;
+	bool pressed = (intoPeriod < PRESS_MICROS);
+	uint32_t sinceEdge = pressed ? intoPeriod : (intoPeriod - PRESS_MICROS);
+
+	if (sinceEdge < BOUNCE_MICROS)
+	{
+		// bouncing: every other loop pass the contacts are the other way
+		if ((sinceEdge / HOST_LOOP_MICROS) % 2 == 1)
+		{
+			pressed = !pressed;
+		}
+	}
+
+	return pressed ? LOW : HIGH;
+}
+
+// Runs the sketch while working the key.  Returns micros() when keying started.
+static uint32_t runKeying(uint32_t keyingMicros, uint8_t (*keyLevel)(uint32_t))
+{
+	uint32_t startMicros = micros();
+
+	for (uint32_t elapsed = 0; elapsed < keyingMicros; elapsed += HOST_LOOP_MICROS)
+	{
+		hostSetPin(CW_KEY_PADDLE_JACK_TIP_PIN, keyLevel(elapsed));
+		loop();
+		hostAdvanceMicros(HOST_LOOP_MICROS);
+	}
+
+	return startMicros;
+}
+
+static uint8_t keyUpLevel(uint32_t micros)
+{
+	return HIGH;
+}
+
+static void testIdleKeySendsNothing()
+{
+	startSketch();
+	runSketch(100000);
+
+	uint32_t writesBefore = dds.getWritesIssued() + dds.getWritesElided();
+	hostClearPinChanges();
+
+	runKeying(1000000, keyUpLevel);
+
+	CHECK_EQUAL(writesBefore, dds.getWritesIssued() + dds.getWritesElided());
+	CHECK_EQUAL(0, eventManager.getDroppedEventCount());
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		CHECK(hostPinChange(i).pin != KEY_OUT_PIN);
+	}
+}
+
+static void testBouncyKeyKeysOncePerPress()
+{
+	startSketch();
+	runSketch(100000);
+
+	uint32_t writesBefore = dds.getWritesIssued();
+	hostClearPinChanges();
+
+	uint32_t startMicros = runKeying(PRESS_COUNT * PRESS_PERIOD_MICROS, bouncyKeyLevel);
+	runSketch(2 * QSK_DEFAULT_HANG_MS * 1000UL);
+
+	// Exactly one key out high and one low per press, each close behind the key
+	uint8_t rises = 0;
+	uint8_t falls = 0;
+	uint32_t maxLatency = 0;
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		const HostPinChange &change = hostPinChange(i);
+
+		if (change.pin != KEY_OUT_PIN)
+		{
+			continue;
+		}
+
+		uint32_t edgeMicros = startMicros + (change.level == HIGH ? rises : falls) * PRESS_PERIOD_MICROS
+								+ (change.level == HIGH ? 0 : PRESS_MICROS);
+		uint32_t latency = change.micros - edgeMicros;
+
+		if (latency > maxLatency)
+		{
+			maxLatency = latency;
+		}
+
+		if (change.level == HIGH)
+		{
+			rises++;
+		}
+		else
+		{
+			falls++;
+		}
+	}
+
+	CHECK_EQUAL(PRESS_COUNT, rises);
+	CHECK_EQUAL(PRESS_COUNT, falls);
+	CHECK(maxLatency <= MAX_KEY_OUT_LATENCY_MICROS);
+
+	// The key comes back down within the hang time, so the DDS only goes to transmit
+	// once and back to receive once for the whole second
+	uint32_t ddsWrites = dds.getWritesIssued() - writesBefore;
+	CHECK_EQUAL(2, ddsWrites);
+	CHECK_EQUAL(0, eventManager.getDroppedEventCount());
+
+	printf("%u key out changes, %u DDS writes in 1 s of keying, worst key out latency %u us\n",
+			(unsigned)(rises + falls), (unsigned)ddsWrites, (unsigned)maxLatency);
+}
+
+int main()
+{
+	RUN_TEST(testIdleKeySendsNothing);
+	RUN_TEST(testBouncyKeyKeysOncePerPress);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,219 @@
+/**
+ * TuningAcceleratorTest.cpp - The sketch's acceleration curve picks the tuning step from the
+ * smoothed knob speed, a steady spin gets to the fast step in a few steps, one quick step
+ * doesn't, and a pause in turning goes straight back to fine tuning
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostKnob.h"
+#include "HostSketch.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "SCRadioTuningAccelerator.h"
+
+extern SCRadioTuningAccelerator tuningAccelerator;
+extern LiquidCrystal_I2C lcd;
+
+/**
+ * Feeds the accelerator single steps at the same interval
+ */
+static void recordSteadySteps(int count, uint16_t stepIntervalMicros)
+{
+	for (int i = 0; i < count; i++)
+	{
+		tuningAccelerator.recordSteps(1, stepIntervalMicros);
+	}
+}
+
+/**
+ * Number of steady steps from rest until the fast tuning step is picked
+ */
+static int stepsToFastTuning(uint16_t stepIntervalMicros)
+{
+	tuningAccelerator.begin();
+
+	for (int steps = 1; steps < 100; steps++)
+	{
+		tuningAccelerator.recordSteps(1, stepIntervalMicros);
+
+		if (tuningAccelerator.getTuningIncrement() == TUNING_INCREMENT_FAST)
+		{
+			return steps;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * The frequency on the display's top line (Hz)
+ */
+static int32_t displayedFrequency()
+{
+	int megahertz = 0;
+	int kilohertz = 0;
+	int hertz = 0;
+
+	sscanf(lcd.hostLine(0), "%d.%d.%d", &megahertz, &kilohertz, &hertz);
+
+	return (int32_t)megahertz * 1000000 + (int32_t)kilohertz * 1000 + hertz;
+}
+
+/**
+ * Turns the knob one detent (4 pin changes phaseMicros apart) and runs loop() once
+ *
+ * @returns how far the frequency moved (Hz)
+ */
+static int32_t tuneOneDetent(uint32_t phaseMicros)
+{
+	int32_t frequencyBefore = displayedFrequency();
+
+	turnMainKnobOneStep(true, phaseMicros);
+	runSketch(HOST_LOOP_MICROS);
+
+	int32_t change = displayedFrequency() - frequencyBefore;
+
+	return (change < 0) ? -change : change;
+}
+
+static void testCurveRows()
+{
+	// At rest the slowest row
+	tuningAccelerator.begin();
+	CHECK_EQUAL(0xFFFF, tuningAccelerator.getSmoothedStepIntervalMicros());
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuningAccelerator.getTuningIncrement());
+
+	// Coming down from rest the average settles right on a steady interval.
+	// Each row is used below its threshold, the next row from the threshold on.
+	recordSteadySteps(60, TUNING_THRESHOLD_MEDIUM);
+	CHECK_EQUAL(TUNING_THRESHOLD_MEDIUM, tuningAccelerator.getSmoothedStepIntervalMicros());
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuningAccelerator.getTuningIncrement());
+
+	recordSteadySteps(60, TUNING_THRESHOLD_MEDIUM - 1);
+	CHECK_EQUAL(TUNING_INCREMENT_MEDIUM, tuningAccelerator.getTuningIncrement());
+
+	recordSteadySteps(60, TUNING_THRESHOLD_FAST);
+	CHECK_EQUAL(TUNING_THRESHOLD_FAST, tuningAccelerator.getSmoothedStepIntervalMicros());
+	CHECK_EQUAL(TUNING_INCREMENT_MEDIUM, tuningAccelerator.getTuningIncrement());
+
+	recordSteadySteps(60, TUNING_THRESHOLD_FAST - 1);
+	CHECK_EQUAL(TUNING_INCREMENT_FAST, tuningAccelerator.getTuningIncrement());
+
+	// Slowing down comes back up through the rows
+	recordSteadySteps(60, 30000);
+	CHECK_EQUAL(TUNING_INCREMENT_MEDIUM, tuningAccelerator.getTuningIncrement());
+
+	recordSteadySteps(60, 60000);
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuningAccelerator.getTuningIncrement());
+}
+
+static void testSpinUpTakesAFewSteps()
+{
+	// With TUNING_SMOOTHING_SHIFT 2 (each step goes a quarter of the way)
+	CHECK_EQUAL(7, stepsToFastTuning(5000));
+	CHECK_EQUAL(9, stepsToFastTuning(10000));
+
+	// One quick step from rest isn't enough for the fast step
+	tuningAccelerator.begin();
+	tuningAccelerator.recordSteps(1, 1000);
+	CHECK(tuningAccelerator.getTuningIncrement() != TUNING_INCREMENT_FAST);
+}
+
+static void testMergedStepsCountOneEach()
+{
+	// Steps merged into one event move the average as far as the same steps one at a time,
+	// whichever way the knob turned
+	tuningAccelerator.begin();
+	recordSteadySteps(5, 8000);
+	uint16_t oneAtATime = tuningAccelerator.getSmoothedStepIntervalMicros();
+
+	tuningAccelerator.begin();
+	tuningAccelerator.recordSteps(5, 8000);
+	CHECK_EQUAL(oneAtATime, tuningAccelerator.getSmoothedStepIntervalMicros());
+
+	tuningAccelerator.begin();
+	tuningAccelerator.recordSteps(-5, 8000);
+	CHECK_EQUAL(oneAtATime, tuningAccelerator.getSmoothedStepIntervalMicros());
+
+	// Past 16 steps the average has caught up and the rest are skipped
+	tuningAccelerator.begin();
+	tuningAccelerator.recordSteps(16, 8000);
+	uint16_t sixteenSteps = tuningAccelerator.getSmoothedStepIntervalMicros();
+
+	tuningAccelerator.begin();
+	tuningAccelerator.recordSteps(500, 8000);
+	CHECK_EQUAL(sixteenSteps, tuningAccelerator.getSmoothedStepIntervalMicros());
+}
+
+static void testPauseStartsOver()
+{
+	tuningAccelerator.begin();
+	recordSteadySteps(20, 5000);
+	CHECK_EQUAL(TUNING_INCREMENT_FAST, tuningAccelerator.getTuningIncrement());
+
+	// The knob times a step after a pause of 65.5 ms or more as 65535
+	tuningAccelerator.recordSteps(1, 0xFFFF);
+	CHECK_EQUAL(0xFFFF, tuningAccelerator.getSmoothedStepIntervalMicros());
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuningAccelerator.getTuningIncrement());
+
+	// and a quick step after that starts from rest, not from where it was
+	tuningAccelerator.recordSteps(1, 5000);
+	CHECK(tuningAccelerator.getTuningIncrement() != TUNING_INCREMENT_FAST);
+}
+
+static void testSpinAndPauseOnTheRadio()
+{
+	startSketch();
+	runSketch(100000);
+
+	// A detent about every 5 ms: the first one (after sitting still) tunes 10 Hz, the
+	// steps grow as the knob keeps going and end up at 1 kHz
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuneOneDetent(1250));
+
+	int32_t lastChange = 0;
+
+	for (int i = 0; i < 11; i++)
+	{
+		int32_t change = tuneOneDetent(1250);
+
+		CHECK(change >= lastChange);
+		lastChange = change;
+	}
+
+	CHECK_EQUAL(TUNING_INCREMENT_FAST, lastChange);
+
+	// Stop for a moment.  The next detent is fine tuning again.
+	runSketch(100000);
+	CHECK_EQUAL(TUNING_INCREMENT_SLOW, tuneOneDetent(1250));
+
+	// A pause shorter than that keeps the speed up
+	for (int i = 0; i < 11; i++)
+	{
+		tuneOneDetent(1250);
+	}
+
+	runSketch(20000);
+	CHECK(tuneOneDetent(1250) > TUNING_INCREMENT_SLOW);
+}
+
+int main()
+{
+	RUN_TEST(testCurveRows);
+	RUN_TEST(testSpinUpTakesAFewSteps);
+	RUN_TEST(testMergedStepsCountOneEach);
+	RUN_TEST(testPauseStartsOver);
+	RUN_TEST(testSpinAndPauseOnTheRadio);
+
+	return hostTestFinish();
+}
@@ -0,0 +1,195 @@
+/**
+ * TuningWordTest.cpp - The integer tuning word math lands within half a tuning word of the exact answer
+ * and within a tuning word of the floating point math it replaced
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include <chrono>
+
+#include "Arduino.h"
+#include "HostTest.h"
+
+#include "SCRadioTuningWord.h"
+
+// Tuning word constants either side of the default, as the calibration menu would set them
+#define TEST_CONSTANT_COUNT 5
+
+static const uint32_t kTestConstants[TEST_CONSTANT_COUNT] = { 34359900UL, 34359738UL, 34350000UL, 34369999UL, 34000001UL };
+
+static void testFractionMultiplierMatchesTheOld64BitMath()
+{
+	for (uint8_t i = 0; i < TEST_CONSTANT_COUNT; i++)
+	{
+		uint32_t millionths = kTestConstants[i];
+		uint32_t old64Bit = (uint32_t)((((uint64_t)(millionths % 1000000) << 32) + 500000) / 1000000);
+
+		CHECK_EQUAL(old64Bit, SCRadioTuningWord::fractionMultiplier(millionths));
+	}
+}
+
+// How far a tuning word is from frequency * millionths / 1000000 (the exact answer)
+static double tuningWordError(SCRadioTuningWord &tuningWord, uint32_t millionths, uint32_t frequency)
+{
+	int64_t exactTimesMillion = (int64_t)frequency * millionths;
+	int64_t errorTimesMillion = (int64_t)tuningWord.frequencyToTuningWord(frequency) * 1000000 - exactTimesMillion;
+
+	return fabs((double)errorTimesMillion / 1000000.0);
+}
+
+static void testTuningWordsAreWithinHalfATuningWord()
+{
+	// Rounding to a whole tuning word is off by up to 0.5.  The 32 bit fraction multiplier
+	// is itself rounded (off by up to 0.5 / 2^32), which adds up to frequency / 2^33 on top.
+	// Every 7 Hz from 1 MHz to 30 MHz, for each constant.
+	for (uint8_t i = 0; i < TEST_CONSTANT_COUNT; i++)
+	{
+		SCRadioTuningWord tuningWord(kTestConstants[i]);
+		bool withinBound = true;
+
+		for (uint32_t frequency = 1000000; frequency <= 30000000 && withinBound; frequency += 7)
+		{
+			withinBound = tuningWordError(tuningWord, kTestConstants[i], frequency) <= 0.5 + frequency / 8589934592.0;
+		}
+
+		CHECK(withinBound);
+	}
+}
+
+static void testTuningWordsAcrossTheVFOLimits()
+{
+	// Every Hertz the VFO can tune to with the default constant
+	SCRadioTuningWord tuningWord(DDS_TUNING_WORD_MILLIONTHS);
+	double maxError = 0;
+
+	for (uint32_t frequency = VFO_LIMIT_LOW; frequency <= VFO_LIMIT_HIGH; frequency++)
+	{
+		double error = tuningWordError(tuningWord, DDS_TUNING_WORD_MILLIONTHS, frequency);
+
+		if (error > maxError)
+		{
+			maxError = error;
+		}
+	}
+
+	printf("  max error %lu to %lu Hz: %.4f tuning words\n", (unsigned long)VFO_LIMIT_LOW, (unsigned long)VFO_LIMIT_HIGH, maxError);
+	CHECK(maxError <= 0.5002);
+}
+
+/**
+ * The tuning word the sketch worked out before the integer math:
+ * frequency * DDS_TUNING_WORD (as a decimal number), cut down to a whole number
+ */
+static uint32_t originalTuningWord(uint32_t frequency)
+{
+	return (uint32_t)((double)frequency * (DDS_TUNING_WORD_MILLIONTHS / 1000000.0));
+}
+
+/**
+ * The same with the Nano's 32 bit float (its double is a float too)
+ */
+static uint32_t originalFloatTuningWord(uint32_t frequency)
+{
+	return (uint32_t)((float)frequency * (float)(DDS_TUNING_WORD_MILLIONTHS / 1000000.0));
+}
+
+static void testIntegerMathMatchesTheOriginalCalculation()
+{
+	// The integer math rounds to the nearest tuning word and the original cut the fraction
+	// off, so they may differ by one tuning word.  That is 1000000 / DDS_TUNING_WORD_MILLIONTHS
+	// Hz (0.029 Hz on the 125 MHz AD9850).
+	const double hertzPerTuningWord = 1000000.0 / DDS_TUNING_WORD_MILLIONTHS;
+	SCRadioTuningWord tuningWord(DDS_TUNING_WORD_MILLIONTHS);
+	int32_t maxDifference = 0;
+	int32_t maxFloatDifference = 0;
+
+	for (uint32_t frequency = VFO_LIMIT_LOW; frequency <= VFO_LIMIT_HIGH; frequency++)
+	{
+		uint32_t integerWord = tuningWord.frequencyToTuningWord(frequency);
+		int32_t difference = abs((int32_t)(integerWord - originalTuningWord(frequency)));
+		int32_t floatDifference = abs((int32_t)(integerWord - originalFloatTuningWord(frequency)));
+
+		maxDifference = (difference > maxDifference) ? difference : maxDifference;
+		maxFloatDifference = (floatDifference > maxFloatDifference) ? floatDifference : maxFloatDifference;
+	}
+
+	printf("  max difference from the original: %ld tuning words (%.4f Hz), from the Nano's float version: %ld (%.4f Hz)\n",
+		(long)maxDifference, maxDifference * hertzPerTuningWord, (long)maxFloatDifference, maxFloatDifference * hertzPerTuningWord);
+
+	CHECK(maxDifference <= 1);
+	CHECK(maxDifference * hertzPerTuningWord < 0.03);
+
+	// The float version was only good to 24 bits, so it was off by more than the integer math
+	// is from the exact answer, but still well under a Hertz
+	CHECK(maxFloatDifference >= maxDifference);
+	CHECK(maxFloatDifference * hertzPerTuningWord < 1.0);
+}
+
+/**
+ * Runs 'calculate' over the VFO range 'passes' times and returns how long it took (seconds).
+ * The tuning words are added up so the compiler can't leave the work out.
+ */
+template <class Calculate>
+static double timeSweep(Calculate calculate, uint8_t passes, uint32_t &total)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (uint8_t pass = 0; pass < passes; pass++)
+	{
+		for (uint32_t frequency = VFO_LIMIT_LOW; frequency <= VFO_LIMIT_HIGH; frequency++)
+		{
+			total += calculate(frequency);
+		}
+	}
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static SCRadioTuningWord timedTuningWord(DDS_TUNING_WORD_MILLIONTHS);
+
+static uint32_t integerTuningWord(uint32_t frequency)
+{
+	return timedTuningWord.frequencyToTuningWord(frequency);
+}
+
+static void testRelativeCost()
+{
+	// A PC has a floating point unit and the Nano doesn't, so this is no measure of the
+	// speedup on the Nano (where a float multiply is a library call of a hundred or more
+	// cycles).  It shows what the integer math costs next to the float version here.
+	const uint8_t passes = 20;
+	volatile uint32_t keep;
+	uint32_t total = 0;
+
+	double floatSeconds = timeSweep(originalFloatTuningWord, passes, total);
+	double integerSeconds = timeSweep(integerTuningWord, passes, total);
+
+	keep = total;
+	(void)keep;
+
+	double calls = (double)passes * (VFO_LIMIT_HIGH - VFO_LIMIT_LOW + 1);
+
+	printf("  on this PC: float %.2f ns, integer %.2f ns a tuning word (%.2fx)\n",
+		floatSeconds * 1e9 / calls, integerSeconds * 1e9 / calls, floatSeconds / integerSeconds);
+
+	CHECK(integerSeconds > 0);
+}
+
+int main()
+{
+	RUN_TEST(testFractionMultiplierMatchesTheOld64BitMath);
+	RUN_TEST(testTuningWordsAreWithinHalfATuningWord);
+	RUN_TEST(testTuningWordsAcrossTheVFOLimits);
+	RUN_TEST(testIntegerMathMatchesTheOriginalCalculation);
+	RUN_TEST(testRelativeCost);
+
+	return hostTestFinish();
+}
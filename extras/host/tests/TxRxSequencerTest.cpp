@@ -0,0 +1,313 @@
+/**
+ * TxRxSequencerTest.cpp - The tx/rx sequencer keys the rig as soon as the key goes down
+ * (with the DDS already on the transmit frequency), tuning during the hang time is kept,
+ * and the key out timing holds steady element after element (the 'q' switching times)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+#include "HostKeyer.h"
+#include "HostKnob.h"
+#include "HostSketch.h"
+
+#include "LiquidCrystal_I2C.h"
+#include "SCRadioDDS.h"
+#include "SCRadioKeyer.h"
+#include "SCRadioTxRxSequencer.h"
+
+// From the sketch
+extern LiquidCrystal_I2C lcd;
+extern SCRadioDDS dds;
+extern SCRadioKeyer keyer;
+extern SCRadioTxRxSequencer txRxSequencer;
+
+/**
+ * Number of dits sent for the switching times
+ */
+#define DIT_COUNT 30
+
+/**
+ * How long main loop passes take while the dits are sent (microseconds), used in turn.
+ * The key line events are handled at the next pass, so the key out timing moves about
+ * by up to the longest pass.
+ */
+static const uint16_t kLoopPassMicros[] = { 100, 370, 730, 50, 1210, 260 };
+
+#define LONGEST_LOOP_PASS_MICROS 1210
+
+static HostDDSFrame frames[8];
+
+// Frames the DDS latched since the pin recorder was cleared
+static uint8_t framesLatched()
+{
+	return decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN, frames, 8);
+}
+
+static bool frameIs(const HostDDSFrame &frame, int32_t frequency)
+{
+	SCRadioDDSFrame expected;
+	dds.buildFrame(frequency, expected);
+
+	return memcmp(frame.bytes, expected.bytes, DDS_CHIP::FRAME_BYTES) == 0;
+}
+
+// Where key out went high in the pin recorder (or -1)
+static int16_t keyOutRise()
+{
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		if ((hostPinChange(i).pin == KEY_OUT_PIN) && (hostPinChange(i).level == HIGH))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+// Where the DDS last latched a frame in the pin recorder (or -1)
+static int16_t lastFrameLatch()
+{
+	int16_t latch = -1;
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		if ((hostPinChange(i).pin == DDS_FREQUENCY_UPDATE_PIN) && (hostPinChange(i).level == HIGH))
+		{
+			latch = i;
+		}
+	}
+
+	return latch;
+}
+
+// Runs the sketch with loop passes of uneven lengths
+static void runBusySketch(uint32_t runMicros)
+{
+	uint8_t pass = 0;
+
+	for (uint32_t elapsed = 0; elapsed < runMicros; elapsed += kLoopPassMicros[pass])
+	{
+		pass = (pass + 1) % (sizeof(kLoopPassMicros) / sizeof(kLoopPassMicros[0]));
+
+		loop();
+		hostAdvanceMicros(kLoopPassMicros[pass]);
+	}
+}
+
+// Straight key (the sketch's mode with nothing stored) down or up, then runs the sketch
+static void straightKey(bool down, uint32_t runMicros)
+{
+	hostSetPin(CW_KEY_PADDLE_JACK_TIP_PIN, down ? LOW : HIGH);
+	runSketch(runMicros);
+}
+
+static void testKeyOutComesWithTheKeyDown()
+{
+	startSketch();
+	runSketch(100000);
+	hostClearPinChanges();
+
+	// No main loop pass in between: the transmit frame goes out and the rig is keyed in the call
+	txRxSequencer.keyDown();
+
+	CHECK(txRxSequencer.isTransmitting());
+	CHECK_EQUAL(HIGH, hostPinLevel(KEY_OUT_PIN));
+
+	if (CHECK_EQUAL(1, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], INITIAL_FREQUENCY));
+	}
+
+	// and the DDS had it before key out went high
+	CHECK(lastFrameLatch() >= 0);
+	CHECK(keyOutRise() > lastFrameLatch());
+
+	// Key up: key out drops right away and the hang starts
+	hostClearPinChanges();
+	txRxSequencer.keyUp();
+
+	CHECK_EQUAL(LOW, hostPinLevel(KEY_OUT_PIN));
+	CHECK(!txRxSequencer.isTransmitting());
+	CHECK(!txRxSequencer.isReceiving());
+	CHECK_EQUAL(0, framesLatched());
+
+	// After the hang, back to receive.  The receive frame goes out in the same loop pass
+	// the hang runs out in, not a pass later.
+	uint32_t passes = 0;
+
+	while (!txRxSequencer.isReceiving() && (passes < (QSK_DEFAULT_HANG_MS + 10) * 1000UL / HOST_LOOP_MICROS))
+	{
+		CHECK_EQUAL(0, framesLatched());
+
+		runSketch(HOST_LOOP_MICROS);
+		passes++;
+	}
+
+	CHECK(txRxSequencer.isReceiving());
+
+	if (CHECK_EQUAL(1, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], INITIAL_FREQUENCY + RX_OFFSET));
+	}
+}
+
+static void testTuningDuringTheHangIsKept()
+{
+	startSketch();
+	runSketch(100000);
+
+	// Tuning is ignored with the key down
+	straightKey(true, 20000);
+	CHECK(txRxSequencer.isTransmitting());
+
+	turnMainKnobOneStep(true, 1250);
+	runSketch(HOST_LOOP_MICROS);
+
+	CHECK_TEXT("7.030.000 MHz  n", lcd.hostLine(0));
+
+	// In the hang time it changes the frequency, but the DDS stays where it is
+	straightKey(false, 20000);
+	CHECK(!txRxSequencer.isTransmitting());
+	CHECK(!txRxSequencer.isReceiving());
+
+	hostClearPinChanges();
+	turnMainKnobOneStep(true, 1250);
+	runSketch(HOST_LOOP_MICROS);
+
+	CHECK_TEXT("7.030.010 MHz  n", lcd.hostLine(0));
+	CHECK_EQUAL(0, framesLatched());
+
+	// Keying again in the hang sends on the new frequency
+	straightKey(true, 20000);
+
+	if (CHECK_EQUAL(1, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], INITIAL_FREQUENCY + 10));
+	}
+
+	CHECK(keyOutRise() > lastFrameLatch());
+
+	// and after the hang the receiver is on it too
+	hostClearPinChanges();
+	straightKey(false, (QSK_DEFAULT_HANG_MS + 20) * 1000UL);
+
+	CHECK(txRxSequencer.isReceiving());
+
+	if (CHECK_EQUAL(1, framesLatched()))
+	{
+		CHECK(frameIs(frames[0], INITIAL_FREQUENCY + 10 + RX_OFFSET));
+	}
+}
+
+/**
+ * Sends DIT_COUNT dits at 20 WPM with a hang time, then prints the switching times ('q')
+ * and checks the key out timing
+ */
+static void checkSwitchingTimes(uint16_t hangMillis)
+{
+	startSketch();
+	runSketch(100000);
+
+	keyer.setKeyerMode(KeyerMode::IAMBICB);
+	keyer.setKeyerWPM(20);
+	txRxSequencer.setHangTime(hangMillis);
+
+	// The sketch's serial commands are there without the loop profiler or the event trace
+	hostSerialInput("r");
+	runSketch(1000);
+	hostClearPinChanges();
+
+	// Hold the dit paddle until the last dit has started
+	setPaddles(HOST_DIT_PADDLE);
+	runBusySketch((2 * DIT_COUNT - 1) * 60000UL);
+	setPaddles(0);
+	runBusySketch((hangMillis + 100) * 1000UL);
+
+	// The keyer starts a dit every 120 ms exactly.  How far each key out rise is from
+	// that, taking the first one as on time.
+	uint32_t firstRiseMicros = 0;
+	int32_t earliest = 0;
+	int32_t latest = 0;
+	uint16_t rises = 0;
+
+	for (uint16_t i = 0; i < hostPinChangeCount(); i++)
+	{
+		const HostPinChange &change = hostPinChange(i);
+
+		if ((change.pin != KEY_OUT_PIN) || (change.level != HIGH))
+		{
+			continue;
+		}
+
+		if (rises == 0)
+		{
+			firstRiseMicros = change.micros;
+		}
+
+		int32_t offset = (int32_t)(change.micros - firstRiseMicros - rises * 120000UL);
+
+		earliest = (offset < earliest) ? offset : earliest;
+		latest = (offset > latest) ? offset : latest;
+		rises++;
+	}
+
+	hostClearSerialOutput();
+	hostSerialInput("q");
+	runSketch(1000);
+
+	unsigned long minDelay = 0;
+	unsigned long maxDelay = 0;
+	unsigned long meanDelay = 0;
+	unsigned long count = 0;
+	const char *line = strstr(hostSerialOutput(), "keyOutDelay,");
+
+	CHECK(line != nullptr);
+
+	if (line != nullptr)
+	{
+		sscanf(line, "keyOutDelay,%lu,%lu,%lu,%lu", &minDelay, &maxDelay, &meanDelay, &count);
+	}
+
+	printf("  hang %3u ms: %u dits, key out %ld to %ld us from the first (jitter %ld us), key out delay %lu/%lu/%lu us\n",
+		hangMillis, rises, (long)earliest, (long)latest, (long)(latest - earliest), minDelay, maxDelay, meanDelay);
+
+	CHECK_EQUAL(DIT_COUNT, rises);
+	CHECK_EQUAL(DIT_COUNT, count);
+
+	// Each dit is keyed at the first loop pass after the keyer's key down, whether the
+	// DDS had to be switched first or not.  So the jitter is no more than a loop pass.
+	// What is left is the wait for that pass: the keyer's key line event is handled by the
+	// main loop, not in the keyer's timer.
+	CHECK(latest - earliest <= LONGEST_LOOP_PASS_MICROS);
+
+	// and the DDS switch at key down takes well under a keyer tick
+	CHECK(maxDelay < KEYER_TICK_MICROS);
+}
+
+static void testSwitchingTimes()
+{
+	// No hang: the DDS goes to transmit for every dit.  A long one: only for the first.
+	checkSwitchingTimes(0);
+	checkSwitchingTimes(QSK_DEFAULT_HANG_MS);
+}
+
+int main()
+{
+	RUN_TEST(testKeyOutComesWithTheKeyDown);
+	RUN_TEST(testTuningDuringTheHangIsKept);
+	RUN_TEST(testSwitchingTimes);
+
+	return hostTestFinish();
+}
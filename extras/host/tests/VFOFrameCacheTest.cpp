@@ -0,0 +1,216 @@
+/**
+ * VFOFrameCacheTest.cpp - The DDS frames the VFO keeps ready are the ones buildFrame() makes for its frequencies
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "HostTest.h"
+#include "HostDDS.h"
+
+#include "SCRadioDDS.h"
+#include "SCRadioEventData.h"
+#include "SCRadioEventQueue.h"
+#include "SCRadioTuningAccelerator.h"
+#include "SCRadioTxRxSequencer.h"
+#include "SCRadioVFO.h"
+
+#define TEST_INITIAL_FREQUENCY 7030000
+
+static const SCRadioTuningCurvePoint kTuningCurve[] = {
+	{ 0xFFFF, TUNING_INCREMENT_SLOW }
+};
+
+static SCRadioEventQueue eventQueue;
+static SCRadioEventData eventData;
+
+// The VFO and everything under it, with the DDS set up for one tuning word constant.
+// The hang time is 0 so key up goes straight back to receive.
+struct TestRig
+{
+	SCRadioDDS dds;
+	SCRadioTxRxSequencer txRxSequencer;
+	SCRadioTuningAccelerator tuningAccelerator;
+	SCRadioVFO vfo;
+
+	TestRig(uint32_t ddsTuningWordMillionths) :
+		dds(DDS_WORD_LOAD_CLOCK_PIN, DDS_FREQUENCY_UPDATE_PIN, DDS_DATA_PIN, DDS_RESET_PIN,
+			ddsTuningWordMillionths, DDSTransport::BIT_BANG),
+		txRxSequencer(dds, KEY_OUT_PIN, 0),
+		tuningAccelerator(kTuningCurve, 1, TUNING_SMOOTHING_SHIFT),
+		vfo(eventQueue, eventData, txRxSequencer, RX_OFFSET, VFO_LIMIT_LOW, VFO_LIMIT_HIGH, RIT_MAX_OFFSET_HZ, tuningAccelerator)
+	{
+	}
+};
+
+static void startRig(TestRig &rig)
+{
+	hostReset();
+
+	rig.dds.begin();
+	rig.vfo.setInitialFrequency(TEST_INITIAL_FREQUENCY);
+	rig.vfo.begin();
+}
+
+// Runs the main loop's DDS and VFO parts until nothing is left to send
+static void settleRig(TestRig &rig)
+{
+	for (uint8_t pass = 0; pass < 100 && !rig.dds.isFrameLatched(); pass++)
+	{
+		rig.dds.loop();
+		rig.vfo.loop();
+	}
+
+	rig.vfo.loop();
+}
+
+static SCRadioEventPayload valuePayload(int32_t value)
+{
+	SCRadioEventPayload payload;
+	payload.value = value;
+	return payload;
+}
+
+static SCRadioEventPayload knobTurnPayload(int16_t steps)
+{
+	SCRadioEventPayload payload;
+	payload.knobTurn.steps = steps;
+	payload.knobTurn.stepIntervalMicros = 0xFFFF;
+	return payload;
+}
+
+static SCRadioEventPayload menuItemPayload(int16_t value)
+{
+	SCRadioEventPayload payload;
+	payload.menuItem.id = 0;
+	payload.menuItem.value = value;
+	return payload;
+}
+
+// Checks the last frame the DDS latched since the pin recorder was cleared is buildFrame(frequency)
+static void checkLastFrameIs(TestRig &rig, int32_t frequency, int line)
+{
+	HostDDSFrame frames[8];
+	uint8_t frameCount = decodeDDSFrames(DDS_WORD_LOAD_CLOCK_PIN, DDS_DATA_PIN, DDS_FREQUENCY_UPDATE_PIN, frames, 8);
+
+	SCRadioDDSFrame expected;
+	rig.dds.buildFrame(frequency, expected);
+
+	if (!CHECK(frameCount > 0 && frameCount <= 8))
+	{
+		printf("  (line %d)\n", line);
+		return;
+	}
+
+	const HostDDSFrame &frame = frames[frameCount - 1];
+
+	CHECK_EQUAL(DDS_CHIP::FRAME_BYTES * 8, frame.bitCount);
+
+	for (uint8_t b = 0; b < DDS_CHIP::FRAME_BYTES; b++)
+	{
+		if (!CHECK_EQUAL(expected.bytes[b], frame.bytes[b]))
+		{
+			printf("  (line %d, frequency %ld)\n", line, (long)frequency);
+			return;
+		}
+	}
+}
+
+// Keys down then up, checking the DDS gets the transmit frame and then the receive frame
+static void checkKeying(TestRig &rig, int32_t txFrequency, int32_t rxFrequency, int line)
+{
+	hostClearPinChanges();
+	rig.vfo.keyLineChangedListener(static_cast<int>(EventType::KEY_LINE_CHANGED), valuePayload(static_cast<int>(KeyStatus::PRESSED)));
+	settleRig(rig);
+
+	CHECK_EQUAL(HIGH, hostPinLevel(KEY_OUT_PIN));
+	checkLastFrameIs(rig, txFrequency, line);
+
+	hostClearPinChanges();
+	rig.vfo.keyLineChangedListener(static_cast<int>(EventType::KEY_LINE_CHANGED), valuePayload(static_cast<int>(KeyStatus::RELEASED)));
+	settleRig(rig);
+
+	CHECK_EQUAL(LOW, hostPinLevel(KEY_OUT_PIN));
+	checkLastFrameIs(rig, rxFrequency, line);
+}
+
+static void testFramesFollowFrequencyAndRITChanges()
+{
+	TestRig rig(DDS_TUNING_WORD_MILLIONTHS);
+	startRig(rig);
+
+	// (setInitialFrequency() leaves it 10 Hz low for the sketch's first knob event)
+	int32_t txFrequency = TEST_INITIAL_FREQUENCY - 10;
+
+	checkKeying(rig, txFrequency, txFrequency + RX_OFFSET, __LINE__);
+
+	// Tuning: the receiver is retuned right away, and keying uses the new frames
+	hostClearPinChanges();
+	rig.vfo.vfoKnobTurnedListener(static_cast<int>(EventType::VFO_KNOB_TURNED), knobTurnPayload(3));
+	settleRig(rig);
+	txFrequency += 3 * TUNING_INCREMENT_SLOW;
+
+	checkLastFrameIs(rig, txFrequency + RX_OFFSET, __LINE__);
+	checkKeying(rig, txFrequency, txFrequency + RX_OFFSET, __LINE__);
+
+	// RIT moves the receive frequency only
+	hostClearPinChanges();
+	rig.vfo.ritKnobTurnedListener(static_cast<int>(EventType::RIT_KNOB_TURNED), knobTurnPayload(5));
+	settleRig(rig);
+
+	checkLastFrameIs(rig, txFrequency + RX_OFFSET + 5 * RIT_ADJUST_INCREMENT, __LINE__);
+	checkKeying(rig, txFrequency, txFrequency + RX_OFFSET + 5 * RIT_ADJUST_INCREMENT, __LINE__);
+
+	// RIT off
+	hostClearPinChanges();
+	rig.vfo.ritStatusChangedListener(static_cast<int>(EventType::RIT_MENU_ITEM_VALUE_CHANGED), menuItemPayload(static_cast<int>(RitStatus::DISABLED)));
+	settleRig(rig);
+
+	checkLastFrameIs(rig, txFrequency + RX_OFFSET, __LINE__);
+	checkKeying(rig, txFrequency, txFrequency + RX_OFFSET, __LINE__);
+
+	// Receive offset to the other side
+	hostClearPinChanges();
+	rig.vfo.rxOffsetDirectionChangedListener(static_cast<int>(EventType::RX_OFFSET_DIRECTION_MENU_ITEM_VALUE_CHANGED),
+												menuItemPayload(static_cast<int>(RxOffsetDirection::ABOVE)));
+	settleRig(rig);
+
+	checkLastFrameIs(rig, txFrequency - RX_OFFSET, __LINE__);
+	checkKeying(rig, txFrequency, txFrequency - RX_OFFSET, __LINE__);
+}
+
+static void testFramesFollowTheCalibration()
+{
+	// 2^32 / 125 MHz, a little off the default constant
+	const uint32_t otherMillionths = 34359738UL;
+	int32_t txFrequency = TEST_INITIAL_FREQUENCY - 10;
+
+	TestRig defaultRig(DDS_TUNING_WORD_MILLIONTHS);
+	TestRig otherRig(otherMillionths);
+
+	SCRadioDDSFrame defaultFrame;
+	SCRadioDDSFrame otherFrame;
+	defaultRig.dds.buildFrame(txFrequency, defaultFrame);
+	otherRig.dds.buildFrame(txFrequency, otherFrame);
+
+	CHECK(memcmp(defaultFrame.bytes, otherFrame.bytes, DDS_CHIP::FRAME_BYTES) != 0);
+
+	startRig(otherRig);
+	checkKeying(otherRig, txFrequency, txFrequency + RX_OFFSET, __LINE__);
+}
+
+int main()
+{
+	RUN_TEST(testFramesFollowFrequencyAndRITChanges);
+	RUN_TEST(testFramesFollowTheCalibration);
+
+	return hostTestFinish();
+}
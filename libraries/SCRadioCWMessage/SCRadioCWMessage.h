@@ -0,0 +1,236 @@
+/**
+ * SCRadioCWMessage.h - Canned CW messages for the keyer, encoded when the sketch is compiled
+ *
+ * Notice there is no accompanying .cpp file.  Everything here is worked out by the compiler.
+ *
+ * Why does this exist?
+ *
+ * For contests and beacons it is handy to have the keyer send a stored message (CQ, your
+ * call, an exchange).  Text takes data memory unless it is kept in flash, and turning
+ * letters into dits and dahs while sending takes a lookup table.  So the compiler does
+ * the turning into Morse, and the result goes straight into flash (PROGMEM):
+ *
+ *   CW_MESSAGE(cqMessage, "CQ CQ DE K4KRW K");
+ *
+ * makes cqMessage.codes, one byte per character.  Pass that to SCRadioKeyer (see
+ * SCRadioCWStoredMessage).  A character with no Morse code stops the sketch compiling.
+ *
+ * Each byte holds a character's elements, first element in the lowest bit (0 is a dit,
+ * 1 is a dah), with a 1 'marker' bit just above the last one.  The keyer sends the low
+ * bit and shifts right until only the marker is left.  Ex: A (.-) is binary 110.
+ * CW_WORD_SPACE_CODE is a space between words and 0 is the end of the message.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioCWMessage_h
+#define SCRadioCWMessage_h
+
+#include "SCRadioConstants.h"
+
+/**
+ * Code for the space between words (a marker bit with no elements)
+ */
+#define CW_WORD_SPACE_CODE 1
+
+/**
+ * Code marking the end of a message
+ */
+#define CW_END_OF_MESSAGE_CODE 0
+
+/**
+ * SCRadioCWStoredMessage
+ *
+ * @detail
+ *   One message the keyer can send
+ */
+struct SCRadioCWStoredMessage
+{
+	/**
+	 * The message, in flash (the codes of a CW_MESSAGE)
+	 */
+	const uint8_t *codes;
+
+	/**
+	 * Seconds to wait before sending it again.  0 sends it once.
+	 */
+	uint8_t repeatSeconds;
+};
+
+/**
+ * SCRadioCWCodeFromPattern
+ *
+ * @detail
+ *   Turns a pattern like ".-" into its code
+ *
+ * @param[in] pattern dots and dashes
+ * @param[in] bit bit for the first element (leave this out)
+ *
+ * @returns code for the pattern
+ */
+constexpr uint8_t SCRadioCWCodeFromPattern(const char *pattern, uint8_t bit = 0)
+{
+	return (*pattern == 0)
+		? (1 << bit)
+		: (((*pattern == '-') ? (1 << bit) : 0) | SCRadioCWCodeFromPattern(pattern + 1, bit + 1));
+}
+
+/**
+ * Codes for A through Z
+ */
+constexpr uint8_t kSCRadioCWLetterCodes[26] = {
+	SCRadioCWCodeFromPattern(".-"), SCRadioCWCodeFromPattern("-..."), SCRadioCWCodeFromPattern("-.-."),
+	SCRadioCWCodeFromPattern("-.."), SCRadioCWCodeFromPattern("."), SCRadioCWCodeFromPattern("..-."),
+	SCRadioCWCodeFromPattern("--."), SCRadioCWCodeFromPattern("...."), SCRadioCWCodeFromPattern(".."),
+	SCRadioCWCodeFromPattern(".---"), SCRadioCWCodeFromPattern("-.-"), SCRadioCWCodeFromPattern(".-.."),
+	SCRadioCWCodeFromPattern("--"), SCRadioCWCodeFromPattern("-."), SCRadioCWCodeFromPattern("---"),
+	SCRadioCWCodeFromPattern(".--."), SCRadioCWCodeFromPattern("--.-"), SCRadioCWCodeFromPattern(".-."),
+	SCRadioCWCodeFromPattern("..."), SCRadioCWCodeFromPattern("-"), SCRadioCWCodeFromPattern("..-"),
+	SCRadioCWCodeFromPattern("...-"), SCRadioCWCodeFromPattern(".--"), SCRadioCWCodeFromPattern("-..-"),
+	SCRadioCWCodeFromPattern("-.--"), SCRadioCWCodeFromPattern("--..")
+};
+
+/**
+ * Codes for 0 through 9
+ */
+constexpr uint8_t kSCRadioCWDigitCodes[10] = {
+	SCRadioCWCodeFromPattern("-----"), SCRadioCWCodeFromPattern(".----"), SCRadioCWCodeFromPattern("..---"),
+	SCRadioCWCodeFromPattern("...--"), SCRadioCWCodeFromPattern("....-"), SCRadioCWCodeFromPattern("....."),
+	SCRadioCWCodeFromPattern("-...."), SCRadioCWCodeFromPattern("--..."), SCRadioCWCodeFromPattern("---.."),
+	SCRadioCWCodeFromPattern("----.")
+};
+
+/**
+ * SCRadioCWCodeForCharacter
+ *
+ * @detail
+ *   Looks up the code for one character.  Upper and lower case are the same.
+ *   Punctuation: / ? . , = (BT) + (AR) and * (SK)
+ *
+ * @param[in] character character to look up
+ *
+ * @returns code for the character (0 if it has none)
+ */
+constexpr uint8_t SCRadioCWCodeForCharacter(char character)
+{
+	return (character >= 'A' && character <= 'Z') ? kSCRadioCWLetterCodes[character - 'A']
+		: (character >= 'a' && character <= 'z') ? kSCRadioCWLetterCodes[character - 'a']
+		: (character >= '0' && character <= '9') ? kSCRadioCWDigitCodes[character - '0']
+		: (character == ' ') ? CW_WORD_SPACE_CODE
+		: (character == '/') ? SCRadioCWCodeFromPattern("-..-.")
+		: (character == '?') ? SCRadioCWCodeFromPattern("..--..")
+		: (character == '.') ? SCRadioCWCodeFromPattern(".-.-.-")
+		: (character == ',') ? SCRadioCWCodeFromPattern("--..--")
+		: (character == '=') ? SCRadioCWCodeFromPattern("-...-")
+		: (character == '+') ? SCRadioCWCodeFromPattern(".-.-.")
+		: (character == '*') ? SCRadioCWCodeFromPattern("...-.-")
+		: CW_END_OF_MESSAGE_CODE;
+}
+
+// A few codes worked out by hand, so a mistake in the tables above stops the sketch compiling
+static_assert(SCRadioCWCodeForCharacter('A') == 0x06, "A is .- (binary 110)");
+static_assert(SCRadioCWCodeForCharacter('a') == 0x06, "a is the same as A");
+static_assert(SCRadioCWCodeForCharacter('0') == 0x3F, "0 is ----- (binary 111111)");
+static_assert(SCRadioCWCodeForCharacter('?') == 0x4C, "? is ..--.. (binary 1001100)");
+static_assert(SCRadioCWCodeForCharacter('*') == 0x68, "* (SK) is ...-.- (binary 1101000)");
+static_assert(SCRadioCWCodeForCharacter('#') == CW_END_OF_MESSAGE_CODE, "# has no code");
+
+/**
+ * SCRadioCWIsValidText
+ *
+ * @detail
+ *   Checks every character of a message has a code
+ *
+ * @param[in] text message text
+ *
+ * @returns true if they all do
+ */
+constexpr bool SCRadioCWIsValidText(const char *text)
+{
+	return (*text == 0) || ((SCRadioCWCodeForCharacter(*text) != CW_END_OF_MESSAGE_CODE) && SCRadioCWIsValidText(text + 1));
+}
+
+/**
+ * SCRadioCWMessageCodes
+ *
+ * @detail
+ *   An encoded message.  One code per character plus the end of message code.
+ *
+ * @param Length length of the text including its terminating 0
+ */
+template <int Length>
+struct SCRadioCWMessageCodes
+{
+	uint8_t codes[Length];
+};
+
+/**
+ * SCRadioCWIndexes
+ *
+ * @detail
+ *   A list of the numbers 0, 1, 2 ... as a type.  Lets the encoder below
+ *   go through the text one character at a time without a loop (which
+ *   the compiler won't run at compile time in this version of C++).
+ */
+template <int... Indexes>
+struct SCRadioCWIndexes
+{
+};
+
+template <int Count, int... Indexes>
+struct SCRadioCWMakeIndexes : SCRadioCWMakeIndexes<Count - 1, Count - 1, Indexes...>
+{
+};
+
+template <int... Indexes>
+struct SCRadioCWMakeIndexes<0, Indexes...>
+{
+	typedef SCRadioCWIndexes<Indexes...> Type;
+};
+
+template <int Length, int... Indexes>
+constexpr SCRadioCWMessageCodes<Length> SCRadioCWEncode(const char (&text)[Length], SCRadioCWIndexes<Indexes...>)
+{
+	return SCRadioCWMessageCodes<Length>{ { SCRadioCWCodeForCharacter(text[Indexes])..., CW_END_OF_MESSAGE_CODE } };
+}
+
+/**
+ * SCRadioCWEncode
+ *
+ * @detail
+ *   Encodes message text.  Use CW_MESSAGE rather than calling this directly.
+ *
+ * @param[in] text message text
+ *
+ * @returns the encoded message
+ */
+template <int Length>
+constexpr SCRadioCWMessageCodes<Length> SCRadioCWEncode(const char (&text)[Length])
+{
+	return SCRadioCWEncode(text, typename SCRadioCWMakeIndexes<Length - 1>::Type());
+}
+
+/**
+ * CW_MESSAGE
+ *
+ * @detail
+ *   Macro to declare a message stored in flash
+ *   ex: CW_MESSAGE(cqMessage, "CQ CQ DE K4KRW K");
+ *
+ * @param[in] name name for the message.  Its codes are name.codes
+ * @param[in] text message text (at most 255 characters)
+ */
+#define CW_MESSAGE(name, text) \
+	static_assert(SCRadioCWIsValidText(text), "CW message has a character with no Morse code"); \
+	static_assert(sizeof(text) <= 256, "CW message is too long"); \
+	constexpr SCRadioCWMessageCodes<sizeof(text)> name PROGMEM = SCRadioCWEncode(text)
+
+#endif
@@ -140,14 +140,21 @@
 #define TUNING_INCREMENT_FAST     1000
 
 /**
- * Threshold between medium and slow knob turn event (milliseconds)
+ * Threshold between medium and slow knob speed (smoothed microseconds between knob steps)
+ * These make up the acceleration curve in the sketch (see SCRadioTuningAccelerator).
  */
-#define TUNING_THRESHOLD_MEDIUM   190
+#define TUNING_THRESHOLD_MEDIUM   50000
 
 /**
- * Threshold between medium and fast knob turn event (milliseconds)
+ * Threshold between medium and fast knob speed (smoothed microseconds between knob steps)
  */
-#define TUNING_THRESHOLD_FAST     90
+#define TUNING_THRESHOLD_FAST     15000
+
+/**
+ * How quickly the tuning speed follows the knob.  Each step moves the smoothed speed
+ * 1 / 2^TUNING_SMOOTHING_SHIFT of the way to the new speed.  Bigger is smoother but slower to speed up.
+ */
+#define TUNING_SMOOTHING_SHIFT    2
 
 /**
  * Increment to use when adjusting RIT
@@ -157,11 +164,59 @@
 // DDS related defines
 
 /**
- * DDS Tuning Word.
+ * Which oscillator chip generates the rig's frequency.  The choice is made when the
+ * sketch is compiled so only the code for that chip ends up on the Arduino.
+ *
+ * SCRadioAD9850 - AD9850 DDS (125 MHz clock) - the stock board
+ * SCRadioAD9851<true> - AD9851 DDS with its 6x clock multiplier turned on
+ *   (ex: a 30 MHz clock becomes 180 MHz).  Use SCRadioAD9851<false> to leave it off.
+ * SCRadioSi5351<SI5351_CRYSTAL_FREQUENCY_HZ, SI5351_OUTPUT_DIVIDER> - Si5351 clock generator
+ *   on the I2C bus (pins A4 and A5, shared with the display).  Output is CLK0.
+ *
+ * The AD9850 and AD9851 use the DDS pins and DDS_TRANSPORT below.  The Si5351 ignores them.
+ * For the Si5351 also set DDS_USES_I2C to 1.
+ * (The host build in extras/host sets it from the compiler command line, hence the #ifndef.)
+ */
+#ifndef DDS_CHIP
+#define DDS_CHIP                  SCRadioAD9850
+#endif
+
+/**
+ * Set to 1 when DDS_CHIP is on the I2C bus (SCRadioSi5351).
+ * When 0 the DDS library leaves out the Si5351 and doesn't include the Wire library.
+ */
+#ifndef DDS_USES_I2C
+#define DDS_USES_I2C              0
+#endif
+
+/**
+ * DDS Tuning Word (in millionths).
  * Use this to fine tune the frequency of your DDS.
- * Don't bother adding digits to the right.  They will be lost due to datatypes in use
+ * This is the tuning word times 1000000.  So a tuning word of 34.359900 is entered as 34359900.
+ * Keeping it a whole number lets the tuning word math be done without floating point and
+ * without losing digits.
+ *
+ * The tuning word is 2^32 divided by the DDS clock frequency.
+ * AD9850 with a 125 MHz clock : about 34359738
+ * AD9851 with a 30 MHz clock and the 6x multiplier (180 MHz) : about 23860929
+ * Not used by the Si5351 (calibrate it with SI5351_CRYSTAL_FREQUENCY_HZ instead)
+ */
+#define DDS_TUNING_WORD_MILLIONTHS 34359900UL
+
+/**
+ * Frequency of the crystal on the Si5351 board in Hertz.
+ * Use this to fine tune the frequency of the Si5351.
+ * Only used when DDS_CHIP is SCRadioSi5351
+ */
+#define SI5351_CRYSTAL_FREQUENCY_HZ 25000000UL
+
+/**
+ * Fixed divider between the Si5351 PLL and its output.  Tuning moves the PLL.
+ * The PLL has to stay between 600 and 900 MHz, so this value must be an even
+ * number that keeps (frequency x divider) in that range.  120 covers 5 to 7.5 MHz.
+ * Only used when DDS_CHIP is SCRadioSi5351
  */
-#define DDS_TUNING_WORD           34.359900
+#define SI5351_OUTPUT_DIVIDER     120
 
 /**
  * Pin on the Arduino connected to the Word load clock pin on the DDS
@@ -183,6 +238,34 @@
  */
 #define DDS_RESET_PIN             11
 
+/**
+ * How frames are shifted out to the DDS
+ *
+ * DDSTransport::BIT_BANG toggles the word load clock and data pins in software.
+ *   It works with any pins.
+ *
+ * DDSTransport::HARDWARE_SPI lets the SPI peripheral shift the frame out.  It is much
+ *   faster but the pins are fixed by the hardware.  The DDS word load clock must be wired
+ *   to pin 13 (SCK) and the DDS data line to pin 11 (MOSI).  Set DDS_WORD_LOAD_CLOCK_PIN
+ *   and DDS_DATA_PIN to match and move anything else (like the DDS reset and the key out
+ *   line) off of pins 10 through 13.  Pin 10 (SS) must be left as an output.
+ *   Also set DDS_USES_SPI to 1.  SCRadioDDS.h stops the build if pins 11 to 13 clash.
+ */
+#define DDS_TRANSPORT             DDSTransport::BIT_BANG
+
+/**
+ * Set to 1 when DDS_TRANSPORT is DDSTransport::HARDWARE_SPI.
+ * When 0 the DDS library leaves out the hardware SPI code and doesn't include the SPI library.
+ */
+#ifndef DDS_USES_SPI
+#define DDS_USES_SPI              0
+#endif
+
+/**
+ * SPI clock rate used when DDS_TRANSPORT is DDSTransport::HARDWARE_SPI
+ */
+#define DDS_SPI_CLOCK_HZ          8000000
+
 /**
  * Arduino pin listening for cw jack 'tip' signal
  * (This is usually the left 'dit' paddle or the cw key)
@@ -200,15 +283,87 @@
  * (This is usually the right 'dah' paddle)
  * This requires an additional key line to be added to the hardware
  * and routed to the specified pin.
+ * Keep it on the same port as the tip pin (D0 - D7 are one port) so the
+ * keyer can read both paddles at once.
  */
 #define CW_KEY_PADDLE_JACK_RING_PIN 6
 
+/**
+ * Straight key debounce time (milliseconds).
+ * When the straight key changes we act on it right away and then ignore any more
+ * changes for this long.  Increase it if your key contacts are noisy.
+ */
+#define STRAIGHT_KEY_DEBOUNCE_MS  5
+
+/**
+ * How often the keyer checks the paddles and times its elements (microseconds).
+ * The keyer runs from a Timer1 interrupt this often, so the key goes down or up
+ * within this long of when it should.  Timer1 is used only by the keyer.
+ */
+#define KEYER_TICK_MICROS         100
+
+/**
+ * Keyer timing settings at power up.  They can be changed from the menu.
+ *
+ * Effective speed: Farnsworth spacing for stored messages (words per minute).  0 is off.
+ * Dah ratio: dah length in tenths of a dit.  30 is the usual 3 to 1.
+ * Compensation: microseconds added to each key down (and taken off the space after it)
+ * to make up for the rig taking longer to start sending than to stop.
+ */
+#define KEYER_DEFAULT_EFFECTIVE_WPM         0
+#define KEYER_DEFAULT_DAH_RATIO_TENTHS      30
+#define KEYER_DEFAULT_COMPENSATION_MICROS   0
+
+/**
+ * Messages the keyer can send (chosen from the 'Kyr Msg' menu item).
+ * Put your own call sign in.  Letters, numbers, spaces and / ? . , = + *
+ * (= is BT, + is AR and * is SK).  They are stored in flash, not data memory.
+ */
+#define CW_MESSAGE_CQ_TEXT        "CQ CQ CQ DE K4KRW K4KRW K"
+#define CW_MESSAGE_BEACON_TEXT    "VVV DE K4KRW/B"
+
+/**
+ * Seconds between repeats of the beacon message.
+ * It keeps going until a paddle is touched or the menu item is set back to Off.
+ */
+#define CW_MESSAGE_BEACON_REPEAT_SECONDS 30
+
 /**
  * Arduino pin directing the 49er to transmit.
  * You have to have done the rxOffset modification for this to be relevant
  */
 #define KEY_OUT_PIN               13
 
+/**
+ * Semi break-in hang time at power up (milliseconds).  After the key comes up the rig
+ * stays on the transmit frequency this long before going back to receive, so the DDS
+ * isn't retuned between every element.  0 goes back to receive as soon as the key comes
+ * up (full break-in).  It can be changed from the menu, up to QSK_MAX_HANG_MS.
+ */
+#define QSK_DEFAULT_HANG_MS       100
+#define QSK_MAX_HANG_MS           1000
+
+/**
+ * Arduino pin the sidetone comes out on.  Put a small speaker or earphone on it
+ * through a resistor and capacitor (or feed it into the audio amplifier).
+ * The tone is made by Timer2, so Arduino's tone() can't be used alongside it.
+ */
+#define SIDETONE_PIN              5
+
+/**
+ * Sidetone pitch settings (Hz).  The pitch can be changed from the menu.
+ */
+#define SIDETONE_DEFAULT_PITCH_HZ 600
+#define SIDETONE_MIN_PITCH_HZ     400
+#define SIDETONE_MAX_PITCH_HZ     1000
+
+/**
+ * Sidetone volume settings.  0 turns the sidetone off and SIDETONE_MAX_VOLUME
+ * is the loudest.  The volume can be changed from the menu.
+ */
+#define SIDETONE_DEFAULT_VOLUME   5
+#define SIDETONE_MAX_VOLUME       10
+
 /**
  * Text for splash screen (line 1)
  */
@@ -249,30 +404,49 @@
 #define TEXT_FOR_DISPLAY_MAX_LENGTH 16
 
 /**
- * Number of frequencies in frequency array in the eventData class
+ * Number of bool fields in bool array in the eventData class
  */
-#define EVENT_DATA_FREQUENCY_FIELDS_COUNT 1
+#define EVENT_DATA_BOOL_FIELDS_COUNT 2
+
+// Event queue settings
 
 /**
- * Number of 32 bit integer fields in long array in the eventData class
+ * Number of events each lane (high priority and normal) of the event queue can hold.
+ * Must be a power of 2 (4, 8, 16, 32 ...).  Each event takes 6 bytes per lane.
+ * If a lane fills up, new events are dropped and counted (see SCRadioEventQueue).
  */
-#define EVENT_DATA_LONG_FIELDS_COUNT 1
+#define EVENT_QUEUE_SIZE 16
 
 /**
- * Number of bool fields in bool array in the eventData class
+ * Number of events interrupt routines can queue before loop() picks them up
+ * (see SCRadioEventQueue::queueEventFromISR()).
+ * Must be a power of 2 (4, 8, 16, 32 ...).  Each event takes 5 bytes.
  */
-#define EVENT_DATA_BOOL_FIELDS_COUNT 2
+#define EVENT_ISR_QUEUE_SIZE 8
+
+/**
+ * Longest time (microseconds) loop() spends handling events on each pass, so the knob,
+ * the DDS and the tx/rx switching aren't held up by a burst of events (see processEventsWithinBudget()).
+ * Set to 0 to handle every waiting event each pass the way it used to.
+ */
+#define EVENT_PROCESSING_BUDGET_MICROS 1000
+
+/**
+ * Number of normal priority events handled between checks for new high priority events
+ * (the key line and the knob)
+ */
+#define EVENT_PROCESSING_BATCH_SIZE 2
 
 /**
  * Maximum number of menu items.
  * If menu items are added, this number must be increased.
  */
-#define MAX_MENU_ITEMS 6
+#define MAX_MENU_ITEMS 13
 
 /**
  * Maximum number of choices each name value menu item can have.
  */
-#define MAX_NAME_VALUE_CHOICES 3
+#define MAX_NAME_VALUE_CHOICES 5
 
 /**
  * Arduino Pin to use to read rig voltage
@@ -328,6 +502,80 @@
  */
 #define LOOP_COUNT_BETWEEN_RIG_VOLTAGE_READS 30000
 
+// Loop profiler settings
+
+/**
+ * Set to 1 to time each part of the main loop (see SCRadioLoopProfiler).
+ * Send LOOP_PROFILER_PRINT_COMMAND from the serial monitor to print the timings.
+ * Leave at 0 for normal use.  When 0 the profiler adds no code and uses no memory.
+ * (The host build in extras/host sets it from the compiler command line, hence the #ifndef.)
+ */
+#ifndef LOOP_PROFILER_ENABLED
+#define LOOP_PROFILER_ENABLED     0
+#endif
+
+/**
+ * Number of histogram buckets kept for each part of the loop.
+ * Bucket n counts passes that took 2^n to 2^(n+1) microseconds.  The last one
+ * counts everything longer.  12 buckets tops out at 2 milliseconds and up.
+ */
+#define LOOP_PROFILER_HISTOGRAM_BINS 12
+
+/**
+ * Character sent from the serial monitor to print the loop timings
+ */
+#define LOOP_PROFILER_PRINT_COMMAND 'p'
+
+/**
+ * Character sent from the serial monitor to clear the loop timings
+ */
+#define LOOP_PROFILER_RESET_COMMAND 'r'
+
+/**
+ * Character sent from the serial monitor to print the tx/rx switching times
+ * (see SCRadioTxRxSequencer).  LOOP_PROFILER_RESET_COMMAND clears them too.
+ * Both work with the loop profiler and the event trace turned off.
+ */
+#define QSK_PRINT_COMMAND         'q'
+
+/**
+ * Number of values in the LoopStage enum
+ */
+#define LOOP_STAGE_COUNT          8
+
+// Event trace settings
+
+/**
+ * Set to 1 to record every event going through the event queue (see SCRadioEventTrace).
+ * Send EVENT_TRACE_PRINT_COMMAND or EVENT_TRACE_DUMP_COMMAND from the serial monitor to see it.
+ * Leave at 0 for normal use.  When 0 the trace adds no code and uses no memory.
+ * (The host build sets it from the compiler command line too.)
+ */
+#ifndef EVENT_TRACE_ENABLED
+#define EVENT_TRACE_ENABLED       0
+#endif
+
+/**
+ * Number of records the event trace keeps.  Once full, the oldest records are written over.
+ * Must be a power of 2 (8, 16, 32 ...).  Each record takes 13 bytes.
+ */
+#define EVENT_TRACE_SIZE          32
+
+/**
+ * Character sent from the serial monitor to print the event trace as comma separated text
+ */
+#define EVENT_TRACE_PRINT_COMMAND 't'
+
+/**
+ * Character sent from the serial monitor to send the event trace as binary (see SCRadioEventTrace::dump())
+ */
+#define EVENT_TRACE_DUMP_COMMAND  'b'
+
+/**
+ * Character sent from the serial monitor to clear the event trace
+ */
+#define EVENT_TRACE_RESET_COMMAND 'c'
+
 // The following are enums (Enumerations)
 // Rather than just having constants to represent the state of things, I am using enums.
 // 
@@ -371,7 +619,12 @@ enum class EEPROMValueIndex : uint8_t {
 	OPERATING_FREQUENCY = 0,
 	KEYER_MODE = 1,
 	KEYER_SPEED = 2,
-	PADDLES_ORIENTATION = 3
+	PADDLES_ORIENTATION = 3,
+	SIDETONE_PITCH = 4,
+	SIDETONE_VOLUME = 5,
+	KEYER_EFFECTIVE_SPEED = 6,
+	KEYER_DAH_RATIO = 7,
+	KEYER_COMPENSATION = 8
 };
 
 /** 
@@ -403,7 +656,16 @@ enum class EventType : int16_t
 	RIG_VOLTAGE_CHANGED,
 	KEYER_MODE_CHANGED,
 	KEYER_SPEED_CHANGED,
-	PADDLES_ORIENTATION_CHANGED
+	PADDLES_ORIENTATION_CHANGED,
+	ERROR_CLEARED,
+	KEYER_MESSAGE_CHANGED,
+	KEYER_MESSAGE_EXTERNALLY_CHANGED,
+	KEYER_EFFECTIVE_SPEED_CHANGED,
+	KEYER_DAH_RATIO_CHANGED,
+	KEYER_COMPENSATION_CHANGED,
+	SIDETONE_PITCH_CHANGED,
+	SIDETONE_VOLUME_CHANGED,
+	QSK_HANG_TIME_CHANGED
 };
 
 /**
@@ -441,9 +703,16 @@ enum class KeyerMode : int8_t
 {
 	STRAIGHT_KEY = 0,
 	IAMBICB = 1,
-	IAMBICA = 2
+	IAMBICA = 2,
+	ULTIMATIC = 3,
+	BUG = 4
 };
 
+/**
+ * Number of KeyerMode values
+ */
+#define KEYER_MODE_COUNT 5
+
 /**
  * KnobTurnDirection enum
  */
@@ -474,14 +743,6 @@ enum class EventTextField : int8_t
 	MENU_ITEM_NAME
 };
 
-/**
- * EventLongField enum
- */
-enum class EventLongField : int8_t
-{
-	RIT_OFFSET = 0
-};
-
 /**
  * EventBoolField enum
  */
@@ -491,14 +752,6 @@ enum class EventBoolField : int8_t
 	RX_OFFSET_IS_POSITIVE
 };
 
-/**
- * EventFrequencyField enum
- */
-enum class EventFrequencyField : int8_t 
-{
-	OPERATING_FREQUENCY = 0
-};
-
 enum class PaddlesOrientation : int8_t
 {
 	NORMAL = 0,
@@ -515,12 +768,64 @@ enum class RxOffsetDirection : int8_t
 };
 
 /**
- * RxTxStatus enum
+ * LoopStage enum
+ * 
+ * The parts of the main loop timed by the loop profiler
+ */
+enum class LoopStage : int8_t
+{
+	WHOLE_LOOP = 0,     /**< one full pass through loop() */
+	KEYER,
+	MAIN_KNOB,
+	DDS,
+	VFO,
+	EEPROM,
+	VOLTAGE_MONITOR,
+	EVENTS
+};
+
+/**
+ * EventTraceKind enum
+ * 
+ * What happened to an event when the event trace recorded it
+ */
+enum class EventTraceKind : int8_t
+{
+	QUEUED = 0,         /**< added to the queue */
+	MERGED,             /**< added to an event that was already waiting */
+	DROPPED,            /**< thrown away because the queue was full */
+	DISPATCHED          /**< taken off the queue and sent to its listeners */
+};
+
+/**
+ * DDSBus enum
+ */
+enum class DDSBus : int8_t
+{
+	SERIAL_SHIFT = 0,   /**< frames shifted out on the DDS pins (AD9850, AD9851) */
+	I2C                 /**< registers written over the I2C bus (Si5351) */
+};
+
+/**
+ * DDSTransport enum
+ */
+enum class DDSTransport : int8_t
+{
+	BIT_BANG = 0,   /**< pins toggled in software */
+	HARDWARE_SPI    /**< shifted out by the SPI peripheral */
+};
+
+/**
+ * TxRxSequencerState enum
+ * 
+ * Where the tx/rx sequencer is in switching between receive and transmit
  */
-enum class RxTxStatus : int8_t 
+enum class TxRxSequencerState : int8_t 
 {
-	RX = 0,
-	TX = 1
+	RX = 0,             /**< receiving */
+	WAITING_FOR_TX,     /**< key is down, waiting for the DDS to latch the transmit frequency */
+	KEYED,              /**< transmitting */
+	HANG                /**< key is up, holding the transmit frequency until the hang time is over */
 };
 	
 /**
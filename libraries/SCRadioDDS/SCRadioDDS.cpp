@@ -1,5 +1,5 @@
 /**
- * SCRadioDDS.cpp - Class for controlling AD9850 DDS
+ * SCRadioDDS.cpp - Class for controlling the DDS (AD9850, AD9851 or Si5351)
  *
  * Copyright (c) 2016 - Richard Young Dodd
  *
@@ -14,41 +14,134 @@
 
 #include "Arduino.h"
 #include "SCRadioDDS.h"
-#include "Wire.h"
+
+// Only the hardware SPI transport needs the SPI library.
+// (SCRadioDDSChips.h brings in the Wire library for chips on the I2C bus.)
+#if DDS_USES_SPI
+#include "SPI.h"
+#endif
+
+ // SCRadioDDSDriver is a template.  Each method below is written once for any chip.
+ // The compiler builds them for the chip picked by DDS_CHIP (see the bottom of this file).
+ // Tests like 'Chip::BUS == DDSBus::I2C' are settled while compiling, so the code for
+ // the other kind of chip is left out entirely.
 
  // Constructor
  // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioDDS::SCRadioDDS(int8_t ddsWordLoadClockPin,
+template <class Chip>
+SCRadioDDSDriver<Chip>::SCRadioDDSDriver(int8_t ddsWordLoadClockPin,
 						int8_t ddsFrequencyUpdatePin,
 						int8_t ddsDataPin,
 						int8_t ddsResetPin,
-						float ddsTuningWord) : _ddsWordLoadClockPin(ddsWordLoadClockPin),
+						uint32_t ddsTuningWordMillionths,
+						DDSTransport ddsTransport) : _ddsWordLoadClockPin(ddsWordLoadClockPin),
 												_ddsFrequencyUpdatePin(ddsFrequencyUpdatePin),
 												_ddsDataPin(ddsDataPin),
 												_ddsResetPin(ddsResetPin),
-												_ddsTuningWord(ddsTuningWord) 
+												_tuningWord(ddsTuningWordMillionths),
+												_ddsTransport(ddsTransport) 
 {
 	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
 	// Put your logic in 'begin() instead and call it after instantiating your object.
 }
 
-void SCRadioDDS::begin()
+template <class Chip>
+void SCRadioDDSDriver<Chip>::begin()
 {
+	// The reset means the DDS no longer holds the last frame we sent it
+	// and anything that was part way out is lost
+	_hasLatchedFrame = false;
+	_frameInProgress = false;
+	_frameQueued = false;
+
+	_beginHasRun = true;
+
+	// Chips on the I2C bus don't use the DDS pins.  They set themselves up.
+	if (Chip::BUS == DDSBus::I2C)
+	{
+		Chip::beginChip();
+		return;
+	}
+
 	// Initializing pins for sending data to the DDS
 	pinMode(_ddsFrequencyUpdatePin, OUTPUT);   
 	pinMode(_ddsWordLoadClockPin, OUTPUT);
 	pinMode(_ddsDataPin, OUTPUT);
 	pinMode(_ddsResetPin, OUTPUT);
 
+	// Looking up the port register and bit mask for each pin we toggle while sending a 
+	// frequency.  Doing it once here saves digitalWrite() from doing it for every bit.
+	_ddsWordLoadClockPort = portOutputRegister(digitalPinToPort(_ddsWordLoadClockPin));
+	_ddsWordLoadClockMask = digitalPinToBitMask(_ddsWordLoadClockPin);
+	_ddsFrequencyUpdatePort = portOutputRegister(digitalPinToPort(_ddsFrequencyUpdatePin));
+	_ddsFrequencyUpdateMask = digitalPinToBitMask(_ddsFrequencyUpdatePin);
+	_ddsDataPort = portOutputRegister(digitalPinToPort(_ddsDataPin));
+	_ddsDataMask = digitalPinToBitMask(_ddsDataPin);
+
 	// Initialize the DDS
 	pulseHigh(_ddsResetPin);
 	pulseHigh(_ddsWordLoadClockPin);
-	pulseHigh(_ddsFrequencyUpdatePin);  // this pulse enables serial mode on the AD9850 - Datasheet page 12.`
-  
-  SCRadioDDS::_beginHasRun = true;
+	pulseHigh(_ddsFrequencyUpdatePin);  // this pulse enables serial mode on the AD9850 and AD9851 - Datasheet page 12.`
+
+#if DDS_USES_SPI
+	// The SPI peripheral takes over the word load clock (SCK) and data (MOSI) pins from here on.
+	if (_ddsTransport == DDSTransport::HARDWARE_SPI)
+	{
+		SPI.begin();
+	}
+#endif
+
+	Chip::beginChip();
+}
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::sendFrequencyToDDS(int32_t frequency)
+{
+	Frame frame;
+
+	buildFrame(frequency, frame);
+
+	sendFrameToDDS(frame);
+//	
+//	Serial.print("Frequency : ");
+//	Serial.println(frequency);
+}
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::buildFrame(int32_t frequency, Frame &frame)
+{
+	// For the AD9850 and AD9851 the frequency is multiplied by the DDS tuning word
+	// before building the frame.  The DDS tuning word allows us to fine tune the frequency
+	// of the DDS.  If it just took the frequency directly, it would be harder to adjust 
+	// the DDS frequency precisely.
+	//
+	// The Si5351 works out its own register values straight from the frequency.
+	if (Chip::USES_TUNING_WORD)
+	{
+		frame = Chip::buildFrame(_tuningWord.frequencyToTuningWord((uint32_t)frequency));
+	}
+	else
+	{
+		frame = Chip::buildFrame((uint32_t)frequency);
+	}
 }
 
-void SCRadioDDS::sendFrequencyToDDS(int32_t frequency)
+template <class Chip>
+void SCRadioDDSDriver<Chip>::sendFrameToDDS(const Frame &frame)
+{
+	queueFrame(frame);
+
+	// Someone wants this frame in the DDS right now.  So, rather than waiting for
+	// loop() to send it a byte at a time, we keep going until it is latched.
+	// (A frame already part way out is finished first.)
+	while (!isFrameLatched())
+	{
+		loop();
+	}
+}
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::queueFrame(const Frame &frame)
 {
 	// I want to be sure this DDS object is initialized before it does anything.
 	// So, if begin() has not run, I'm running it before sending frequency info to the DDS
@@ -56,59 +149,229 @@ void SCRadioDDS::sendFrequencyToDDS(int32_t frequency)
 	{
 		begin();
 	}
-	
-	// The frequency is multiplied by the DDS tuning word before sending it to the DDS
-	// The DDS tuning word allows us to fine tune the frequency of the DDS
-	// If it just took the frequency directly, it would be harder to adjust the DDS 
-	// frequency precisely.
-	int32_t freq = (uint32_t) (((float)frequency * _ddsTuningWord));
-//	
-//	Serial.print("Frequency : ");
-//	Serial.println(frequency);
-	
-	// The following loop does the work of sending the frequency to the DDS
-	// It sends the first 32 bits (hence the 32)
+
+	// Nothing has gone out for a frame that is still waiting, so a newer one simply
+	// takes its place.  Only the newest frame matters.  (A frame part way out can't
+	// be stopped.  The new one waits for it.)
+	if (_frameQueued)
+	{
+		_frameQueued = false;
+		_writesElided++;
+	}
+
+	// Many callers send the same frequency again (rx reloads, RIT changes that
+	// end up where they started, menu changes ...).  If the DDS already has
+	// this frame (or will once the frame part way out is latched), there is
+	// nothing to do.
+	if (matchesFrameDDSWillHave(frame))
+	{
+		_writesElided++;
+		return;
+	}
+
+	_queuedFrame = frame;
+	_frameQueued = true;
+}
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::loop()
+{
+	if (!_frameInProgress)
+	{
+		if (!_frameQueued)
+		{
+			return;
+		}
+
+		// Start on the frame that was waiting
+		_shiftingFrame = _queuedFrame;
+		_bytesShifted = 0;
+		_frameInProgress = true;
+		_frameQueued = false;
+	}
+
+	if (Chip::BUS == DDSBus::I2C)
+	{
+		// I2C chips get the whole frame in one transfer.  The Wire library needs
+		// interrupts running, so unlike the pin shifting below they stay on.
+		Chip::writeFrame(_shiftingFrame.bytes);
+		_bytesShifted = Chip::FRAME_BYTES;
+	}
+	else
+	{
+		// We only send one byte each time we are called.  That way no single pass
+		// through the main loop is held up and interrupts are never off for more
+		// than a byte.
+		shiftNextByte();
+	}
+
+	if (_bytesShifted < Chip::FRAME_BYTES)
+	{
+		return;
+	}
+
+	Chip::frameLatched(!_hasLatchedFrame);
+
+	_lastLatchedFrame = _shiftingFrame;
+	_hasLatchedFrame = true;
+	_frameInProgress = false;
+	_writesIssued++;
+}
+
+template <class Chip>
+bool SCRadioDDSDriver<Chip>::isFrameLatched()
+{
+	return !_frameInProgress && !_frameQueued;
+}
+
+template <class Chip>
+uint32_t SCRadioDDSDriver<Chip>::getWritesIssued()
+{
+	return _writesIssued;
+}
+
+template <class Chip>
+uint32_t SCRadioDDSDriver<Chip>::getWritesElided()
+{
+	return _writesElided;
+}
+
+// private methods
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::shiftNextByte()
+{
+	// The AD9850 and AD9851 want 40 bits.  The 32 bit tuning word goes first followed 
+	// by the 8 bit control byte.  Everything is sent least significant bit first.
+	//
+	// Since the 40 bits line up on byte boundaries, the frame goes out as five 
+	// bytes: the low byte of the tuning word first, the control byte last.
+	uint8_t byteToSend = _shiftingFrame.bytes[_bytesShifted];
+
+	switch (_ddsTransport)
+	{
+#if DDS_USES_SPI
+	case DDSTransport::HARDWARE_SPI:
+		shiftByteHardwareSPI(byteToSend);
+		break;
+#endif
+	default:
+		shiftByteBitBang(byteToSend);
+	}
+
+	_bytesShifted++;
+
+	if (_bytesShifted == Chip::FRAME_BYTES)
+	{
+		// Now we are finished sending the new frequency information.  We pulse the
+		// Frequency update pin to tell the DDS to go ahead and use the new frequency
+		// we just sent.  (Its port is shared too, see shiftByteBitBang().)
+		uint8_t oldSREG = SREG;
+		noInterrupts();
+
+		pulsePortHigh(_ddsFrequencyUpdatePort, _ddsFrequencyUpdateMask);
+
+		SREG = oldSREG;
+	}
+}
+
+template <class Chip>
+bool SCRadioDDSDriver<Chip>::matchesFrameDDSWillHave(const Frame &frame)
+{
+	// A frame part way out will be latched, so that is what the DDS ends up with
+	if (_frameInProgress)
+	{
+		return framesMatch(frame, _shiftingFrame);
+	}
+
+	// Before anything has been sent there is nothing to match
+	if (!_hasLatchedFrame)
+	{
+		return false;
+	}
+
+	return framesMatch(frame, _lastLatchedFrame);
+}
+
+template <class Chip>
+bool SCRadioDDSDriver<Chip>::framesMatch(const Frame &frame, const Frame &otherFrame)
+{
+	for (int8_t b = 0; b < Chip::FRAME_BYTES; b++)
+	{
+		if (frame.bytes[b] != otherFrame.bytes[b])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template <class Chip>
+void SCRadioDDSDriver<Chip>::shiftByteBitBang(uint8_t byteToSend)
+{
+	// The following loop does the work of sending a byte to the DDS
 	//
 	// It only sends the right most bit each time info is sent.
 	//
-	// The 'freq >>= 1' logic shifts the frequency bits to the right
+	// The 'byteToSend >>= 1' logic shifts the bits to the right
 	// So after each loop, the shift occurs and now we are ready to send the next bit.
 	//
-	// The 'freq & '0x01' 'ands' the frequency and a 1.  
-	// A 1 in a 32 bit integer looks like this              : '00000000000000000000000000000001'
-	// The frequency initially might look like this (7.030) : '00001110011001011100001100010001'
+	// The 'byteToSend & 0x01' 'ands' the byte and a 1.  
+	// A 1 in an 8 bit integer looks like this : '00000001'
 	//
-	// So, if the rightmost bit  of the frequency = '1', the result of the
-	// first 'and' operation is 1.  
-	// If the rightmost bit of the frequency is 0, the 'and' operation results in a zero. 
+	// So, if the rightmost bit of the byte = '1', the result of the
+	// 'and' operation is 1.  
+	// If the rightmost bit is 0, the 'and' operation results in a zero. 
 	//
-	// All other bits of the frequency will 'and' as zero.  Since they 'anded'
+	// All other bits will 'and' as zero.  Since they 'anded'
 	// with a zero.  So, this gives us just the rightmost bit.
 	// 
-	// After sending the rightmust bit to the DDS, we send a pulse
+	// After sending the rightmost bit to the DDS, we send a pulse
 	// to the dds word load clock pin to tell it it has a bit to process.
 	//
-	// The next right shift of the frequency then gets us ready to send the next bit.
+	// The pins are written through the port registers looked up in begin().
 	//
-	for (int b = 0; b < 32; b++, freq >>= 1) 
+	// Other pins share the ports we write to.  digitalWrite() protects its
+	// read-modify-write of a port from interrupts.  We do the same here, but
+	// once for the whole byte rather than once per pin change.
+	uint8_t oldSREG = SREG;
+	noInterrupts();
+
+	for (int8_t b = 0; b < 8; b++, byteToSend >>= 1) 
 	{
-		digitalWrite(_ddsDataPin, freq & 0x01);
-		pulseHigh(_ddsWordLoadClockPin);
+		if (byteToSend & 0x01)
+		{
+			*_ddsDataPort |= _ddsDataMask;
+		}
+		else
+		{
+			*_ddsDataPort &= ~_ddsDataMask;
+		}
+		pulsePortHigh(_ddsWordLoadClockPort, _ddsWordLoadClockMask);
 	}
-	
-	// Here we are sending all zeros for the control byte to the dds
-	// (no control, power-down or phase configuration info to send)
-	// This is done after sending the frequency information
-	// 
-	// so after all of this is done, 40 bits was sent to the DDS
-	for (int b = 0; b < 8; b++) 
-	{
-		digitalWrite(_ddsDataPin, 0);
-		pulseHigh(_ddsWordLoadClockPin);
-	}
-	
-	// Now we are finished sending the new frequency information.  We pulse the
-	// Frequency update pin to tell the DDS to go ahead and use the new frequency
-	// we just sent.
-	pulseHigh(_ddsFrequencyUpdatePin);
-};
\ No newline at end of file
+
+	SREG = oldSREG;
+}
+
+#if DDS_USES_SPI
+template <class Chip>
+void SCRadioDDSDriver<Chip>::shiftByteHardwareSPI(uint8_t byteToSend)
+{
+	// The SPI peripheral shifts the byte out for us in a fraction of the time.
+	// LSBFIRST matches the bit order the DDS expects.  Mode 0 puts the data
+	// on the MOSI (data) pin before the rising edge of SCK (word load clock)
+	// which is the edge the DDS latches data on.
+	//
+	// The peripheral drives SCK and MOSI itself.  No port register is written, so
+	// unlike the bit bang transport interrupts stay on.
+	SPI.beginTransaction(SPISettings(DDS_SPI_CLOCK_HZ, LSBFIRST, SPI_MODE0));
+
+	SPI.transfer(byteToSend);
+
+	SPI.endTransaction();
+}
+#endif
+
+// This is where the compiler is told to build the driver for the chip picked by DDS_CHIP.
+template class SCRadioDDSDriver<DDS_CHIP>;
@@ -1,5 +1,5 @@
 /**
-* SCRadioDDS.h - Class for controlling AD9850 DDS
+* SCRadioDDS.h - Class for controlling the DDS (AD9850, AD9851 or Si5351)
 *
 * Copyright (c) 2016 - Richard Young Dodd
 *
@@ -15,7 +15,27 @@
 #ifndef SCRadioDDS_h
 #define SCRadioDDS_h
 
-#include "Wire.h"
+#include "SCRadioConstants.h"
+#include "SCRadioDDSChips.h"
+#include "SCRadioTuningWord.h"
+
+static_assert(DDS_USES_SPI || (DDS_TRANSPORT != DDSTransport::HARDWARE_SPI),
+			"Set DDS_USES_SPI to 1 to use DDSTransport::HARDWARE_SPI");
+
+/**
+ * True when the SPI peripheral shifts frames out on the DDS pins.  It takes pins 11 (MOSI),
+ * 12 (MISO) and 13 (SCK) for itself.  (Chips on the I2C bus ignore the transport.)
+ */
+#define DDS_PINS_USE_SPI ((DDS_TRANSPORT == DDSTransport::HARDWARE_SPI) && (DDS_CHIP::BUS != DDSBus::I2C))
+
+static_assert(!DDS_PINS_USE_SPI || ((DDS_WORD_LOAD_CLOCK_PIN == 13) && (DDS_DATA_PIN == 11)),
+			"DDSTransport::HARDWARE_SPI needs DDS_WORD_LOAD_CLOCK_PIN on pin 13 (SCK) and DDS_DATA_PIN on pin 11 (MOSI)");
+static_assert(!DDS_PINS_USE_SPI || (DDS_FREQUENCY_UPDATE_PIN < 11) || (DDS_FREQUENCY_UPDATE_PIN > 13),
+			"Move DDS_FREQUENCY_UPDATE_PIN off of pins 11 to 13 for DDSTransport::HARDWARE_SPI");
+static_assert(!DDS_PINS_USE_SPI || (DDS_RESET_PIN < 11) || (DDS_RESET_PIN > 13),
+			"Move DDS_RESET_PIN off of pins 11 to 13 for DDSTransport::HARDWARE_SPI");
+static_assert(!DDS_PINS_USE_SPI || (KEY_OUT_PIN < 11) || (KEY_OUT_PIN > 13),
+			"Move KEY_OUT_PIN off of pins 11 to 13 for DDSTransport::HARDWARE_SPI");
 
 /**
  * pulseHigh
@@ -27,8 +47,38 @@
  */
 #define pulseHigh(pin) {digitalWrite(pin, HIGH); digitalWrite(pin, LOW); }
 
-class SCRadioDDS
+/**
+ * pulsePortHigh
+ * 
+ * @detail
+ *   Macro to pulse a pin HIGH and then LOW by writing directly to its port register.
+ *   Much faster than pulseHigh() as the pin to port lookup has already been done.
+ *   (The host build in extras/host has its own that records each pulse.)
+ * 
+ * @param[in] port Output register of the port the pin belongs to
+ * @param[in] mask Bit mask for the pin within the port
+ */
+#ifndef pulsePortHigh
+#define pulsePortHigh(port, mask) {*(port) |= (mask); *(port) &= ~(mask); }
+#endif
+
+/**
+ * SCRadioDDSDriver
+ * 
+ * @detail
+ *   Drives the oscillator chip described by Chip (see SCRadioDDSChips.h).
+ *   The sketch and the other classes use it through the SCRadioDDS typedef at the
+ *   bottom of this file, which picks the chip named by DDS_CHIP.
+ */
+template <class Chip>
+class SCRadioDDSDriver
 {
+public:
+	/**
+	 * Everything the chip needs for one frequency change
+	 */
+	typedef typename Chip::Frame Frame;
+
 private:
 	// Private member variables
 
@@ -52,10 +102,50 @@ private:
 	 */
    const int8_t _ddsResetPin;
 
+	// digitalWrite() has to look up the port and bit for a pin every time it is called.
+	// We look them up once in begin() and keep them here so sending a frequency
+	// can write straight to the port registers.
+
 	/**
-	 * This holds the value that allows us to fine tune the frequency of the DDS
+	 * Output register of the port the word load clock pin belongs to
 	 */
-   const float _ddsTuningWord;
+   volatile uint8_t *_ddsWordLoadClockPort;
+
+	/**
+	 * Bit mask of the word load clock pin within its port
+	 */
+   uint8_t _ddsWordLoadClockMask;
+
+	/**
+	 * Output register of the port the frequency update pin belongs to
+	 */
+   volatile uint8_t *_ddsFrequencyUpdatePort;
+
+	/**
+	 * Bit mask of the frequency update pin within its port
+	 */
+   uint8_t _ddsFrequencyUpdateMask;
+
+	/**
+	 * Output register of the port the data pin belongs to
+	 */
+   volatile uint8_t *_ddsDataPort;
+
+	/**
+	 * Bit mask of the data pin within its port
+	 */
+   uint8_t _ddsDataMask;
+
+	/**
+	 * Turns frequencies into tuning words.
+	 * It holds the value that allows us to fine tune the frequency of the DDS
+	 */
+   SCRadioTuningWord _tuningWord;
+
+	/**
+	 * How the frame is shifted out to the DDS (bit bang or hardware SPI)
+	 */
+   const DDSTransport _ddsTransport;
 
 	/**
 	 * If this is true, then begin() has been run.
@@ -63,27 +153,78 @@ private:
 	 * This helps determine the status
 	 */
    bool _beginHasRun = false;
+
+	/**
+	 * The last frame the DDS latched.  Sending the same frame again would not change
+	 * anything so we skip it.
+	 */
+   Frame _lastLatchedFrame;
+
+	/**
+	 * If this is true, _lastLatchedFrame holds what the DDS is currently using
+	 */
+   bool _hasLatchedFrame = false;
+
+	/**
+	 * The frame currently being shifted out to the DDS
+	 */
+   Frame _shiftingFrame;
+
+	/**
+	 * How many bytes of _shiftingFrame have been sent so far
+	 */
+   int8_t _bytesShifted = 0;
+
+	/**
+	 * If this is true, _shiftingFrame is part way out to the DDS
+	 */
+   bool _frameInProgress = false;
+
+	/**
+	 * The frame waiting for loop() to start sending it
+	 */
+   Frame _queuedFrame;
+
+	/**
+	 * If this is true, _queuedFrame is waiting to be sent
+	 */
+   bool _frameQueued = false;
+
+	/**
+	 * Number of frames actually sent to the DDS
+	 */
+   uint32_t _writesIssued = 0;
+
+	/**
+	 * Number of frames skipped because the DDS already had them (or a newer
+	 * frame was queued before loop() got to them)
+	 */
+   uint32_t _writesElided = 0;
    
   public:
 	// public methods
 	
 	/**
-	 * SCRadioDDS
+	 * SCRadioDDSDriver
 	 * 
 	 * @detail
-	 *   Creates a SCRadioDDS class.
-	 *   begin() must be called before using
+	 *   Creates a SCRadioDDSDriver class.
+	 *   begin() must be called before using.
+	 *   Chips on the I2C bus (Si5351) ignore the pins and transport.
+	 *   DDSTransport::HARDWARE_SPI needs DDS_USES_SPI set to 1.  Otherwise frames are bit banged.
 	 * 
 	 * @param[in] ddsWordLoadClockPin The Arduino pin talking to the frequency update pin on the DDS
 	 * @param[in] ddsDataPin The Arduino pin talking to the data pin on the DDS
 	 * @param[in] ddsResetPin The Arduino pin talking to the reset pin on the DDS
-	 * @param[in] ddsTuningWord The value used to fine tune the frequency
+	 * @param[in] ddsTuningWordMillionths The value used to fine tune the frequency (in millionths)
+	 * @param[in] ddsTransport How frames are shifted out to the DDS (bit bang or hardware SPI)
 	 */
-    SCRadioDDS(int8_t ddsWordLoadClockPin,
+    SCRadioDDSDriver(int8_t ddsWordLoadClockPin,
    						int8_t ddsFrequencyUpdatePin,
    						int8_t ddsDataPin,
    						int8_t ddsResetPin,
-   						float ddsTuningWord);
+   						uint32_t ddsTuningWordMillionths,
+   						DDSTransport ddsTransport);
     
 	/**
 	 * sendFrequencyToDDS
@@ -94,6 +235,80 @@ private:
 	 * @param frequency Integer representation of a frequency ex: 7.030.000 would be 7030000
 	 */
 	void sendFrequencyToDDS(int32_t frequency);    	
+
+	/**
+	 * buildFrame
+	 * 
+	 * @detail
+	 *   Fills in a frame for a frequency so it can be sent later
+	 * 
+	 * @param[in] frequency Integer representation of a frequency ex: 7.030.000 would be 7030000
+	 * @param[out] frame Frame to fill in
+	 */
+	void buildFrame(int32_t frequency, Frame &frame);
+
+	/**
+	 * sendFrameToDDS
+	 * 
+	 * @detail
+	 *   Sends an already built frame to the DDS and waits until it is latched.
+	 *   A frame already part way out is finished first.
+	 * 
+	 * @param[in] frame Frame built by buildFrame()
+	 */
+	void sendFrameToDDS(const Frame &frame);
+
+	/**
+	 * queueFrame
+	 * 
+	 * @detail
+	 *   Queues an already built frame to be sent to the DDS without waiting.
+	 *   loop() sends it a byte at a time.  A frame queued before loop() starts on it
+	 *   replaces it.  Use isFrameLatched() to find out when the DDS is using it.
+	 * 
+	 * @param[in] frame Frame built by buildFrame()
+	 */
+	void queueFrame(const Frame &frame);
+
+	/**
+	 * loop
+	 * 
+	 * @detail
+	 *   Call this once each time the main application loop runs.
+	 *   Sends the next byte of a queued frame to the DDS and latches the frame after
+	 *   its last byte.  Chips on the I2C bus get the whole frame in one call.
+	 */
+	void loop();
+
+	/**
+	 * isFrameLatched
+	 * 
+	 * @detail
+	 *   Tells if the DDS is using the last frame queued (nothing left to send)
+	 * 
+	 * @returns true if all queued frames have been sent and latched
+	 */
+	bool isFrameLatched();
+
+	/**
+	 * getWritesIssued
+	 * 
+	 * @detail
+	 *   Returns how many frames have actually been sent to the DDS
+	 * 
+	 * @returns count of frames sent
+	 */
+	uint32_t getWritesIssued();
+
+	/**
+	 * getWritesElided
+	 * 
+	 * @detail
+	 *   Returns how many frames were skipped because the DDS was already using them
+	 * 
+	 * @returns count of frames skipped
+	 */
+	uint32_t getWritesElided();
    	
 	/**
 	 * begin
@@ -105,6 +320,79 @@ private:
     
   private:
 	 // private methods
+
+	/**
+	 * matchesFrameDDSWillHave
+	 * 
+	 * @detail
+	 *   Compares a frame with the one the DDS will be using once the frame part way
+	 *   out (if any) is latched.  Never matches before the first frame has been sent.
+	 * 
+	 * @param[in] frame frame to compare
+	 * 
+	 * @returns true if the DDS is (or will be) set the way the frame would set it
+	 */
+	bool matchesFrameDDSWillHave(const Frame &frame);
+
+	/**
+	 * framesMatch
+	 * 
+	 * @detail
+	 *   Compares two frames byte by byte
+	 * 
+	 * @param[in] frame first frame
+	 * @param[in] otherFrame second frame
+	 * 
+	 * @returns true if they would set the DDS the same way
+	 */
+	bool framesMatch(const Frame &frame, const Frame &otherFrame);
+
+	/**
+	 * shiftNextByte
+	 * 
+	 * @detail
+	 *   Shifts the next byte of the frame in progress out on the DDS pins and latches
+	 *   the frame with the frequency update pin after its last byte
+	 */
+	void shiftNextByte();
+
+	/**
+	 * shiftByteBitBang
+	 * 
+	 * @detail
+	 *   Shifts one byte to the DDS, least significant bit first, by toggling the pins
+	 * 
+	 * @param[in] byteToSend byte to shift out
+	 */
+	void shiftByteBitBang(uint8_t byteToSend);
+
+#if DDS_USES_SPI
+	/**
+	 * shiftByteHardwareSPI
+	 * 
+	 * @detail
+	 *   Shifts one byte to the DDS, least significant bit first, using the SPI peripheral
+	 * 
+	 * @param[in] byteToSend byte to shift out
+	 */
+	void shiftByteHardwareSPI(uint8_t byteToSend);
+#endif
 };
 
+/**
+ * SCRadioDDS
+ * 
+ * @detail
+ *   The driver for the chip selected with DDS_CHIP in SCRadioConstants.h
+ */
+typedef SCRadioDDSDriver<DDS_CHIP> SCRadioDDS;
+
+/**
+ * SCRadioDDSFrame
+ * 
+ * @detail
+ *   A frame for the chip selected with DDS_CHIP
+ */
+typedef SCRadioDDS::Frame SCRadioDDSFrame;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,480 @@
+/**
+ * SCRadioDDSChips.h - Descriptions of the oscillator chips SCRadioDDS can drive
+ *
+ * Notice there is no accompanying .cpp file.  Everything here is a template or
+ * a constexpr function and has to be visible to the compiler wherever it is used.
+ *
+ * Why does this exist?
+ *
+ * Each chip wants its frequency information in a different shape.  The AD9850 and
+ * AD9851 want a 40 bit frame shifted in on their data pin.  The Si5351 wants a block
+ * of registers written over I2C.  Each chip is described here by a struct that knows
+ * how to build its frame from a tuning word (or frequency) plus a few constants that
+ * say how the frame gets to the chip.
+ *
+ * SCRadioDDS is a template that takes one of these structs.  The chip is picked with
+ * DDS_CHIP in SCRadioConstants.h when the sketch is compiled.  There are no virtual
+ * methods, so nothing is looked up while the rig is running - the compiler builds
+ * the driver for exactly one chip.
+ *
+ * The frame builders are constexpr.  Given constant inputs the compiler can work
+ * them out while compiling, and they can be checked against the datasheet on a PC.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioDDSChips_h
+#define SCRadioDDSChips_h
+
+#include "SCRadioConstants.h"
+
+// Only the Si5351 needs the I2C bus
+#if DDS_USES_I2C
+#include "Wire.h"
+#endif
+
+/**
+ * AD9851 control byte bit that turns on the 6x reference clock multiplier
+ */
+#define AD9851_REFCLOCK_MULTIPLIER_BIT 0x01
+
+/**
+ * Si5351 I2C address
+ */
+#define SI5351_I2C_ADDRESS        0x60
+
+// Si5351 register numbers (see Silicon Labs AN619)
+
+/**
+ * Output enable control (one bit per output, 0 = enabled)
+ */
+#define SI5351_OUTPUT_ENABLE_REGISTER     3
+
+/**
+ * CLK0 control (power down, integer mode, PLL source, drive strength)
+ */
+#define SI5351_CLK0_CONTROL_REGISTER      16
+
+/**
+ * First of the 8 PLL A feedback multisynth registers
+ */
+#define SI5351_PLLA_FIRST_REGISTER        26
+
+/**
+ * First of the 8 output multisynth 0 registers
+ */
+#define SI5351_MULTISYNTH0_FIRST_REGISTER 42
+
+/**
+ * PLL reset
+ */
+#define SI5351_PLL_RESET_REGISTER         177
+
+/**
+ * Crystal load capacitance
+ */
+#define SI5351_CRYSTAL_LOAD_REGISTER      183
+
+/**
+ * Number of bits in the PLL fraction.  The fraction is (numerator / 2^19).
+ * With a 25 MHz crystal one step moves the PLL about 48 Hz, which is under
+ * half a Hertz at the output.
+ */
+#define SI5351_PLL_FRACTION_BITS  19
+
+/**
+ * SCRadioDDSChipFrame
+ *
+ * @detail
+ *   Everything a chip needs for one frequency change, in the order it is sent.
+ *   Frames can be built ahead of time and later sent with no further math.
+ */
+template <int8_t FrameBytes>
+struct SCRadioDDSChipFrame
+{
+	/**
+	 * The bytes to send, first one first
+	 */
+	uint8_t bytes[FrameBytes];
+};
+
+/**
+ * SCRadioDDSChip
+ *
+ * @detail
+ *   Defaults shared by all chips.  A chip only has to provide the ones that are
+ *   different for it.  (The chip's version hides the one here.)
+ */
+struct SCRadioDDSChip
+{
+	/**
+	 * How frames get to the chip
+	 */
+	static const DDSBus BUS = DDSBus::SERIAL_SHIFT;
+
+	/**
+	 * If this is true, buildFrame() takes a DDS tuning word (see SCRadioTuningWord).
+	 * Otherwise it takes the frequency in Hertz.
+	 */
+	static const bool USES_TUNING_WORD = true;
+
+	/**
+	 * beginChip
+	 *
+	 * @detail
+	 *   Chip specific setup run from SCRadioDDS::begin()
+	 */
+	static void beginChip() {}
+
+	/**
+	 * writeFrame
+	 *
+	 * @detail
+	 *   Sends a whole frame to a chip that is not on the DDS pins
+	 *
+	 * @param[in] bytes frame bytes
+	 */
+	static void writeFrame(const uint8_t *) {}
+
+	/**
+	 * frameLatched
+	 *
+	 * @detail
+	 *   Called after the chip has been given a new frame
+	 *
+	 * @param[in] firstFrame true if this is the first frame since begin()
+	 */
+	static void frameLatched(bool) {}
+};
+
+/**
+ * SCRadioAD985x
+ *
+ * @detail
+ *   The AD9850 and AD9851 share the same 40 bit serial frame.
+ *   The 32 bit tuning word goes first (lowest byte first) followed by the control byte.
+ *   Everything is shifted in least significant bit first and latched with the
+ *   frequency update pin.
+ */
+template <uint8_t ControlByte>
+struct SCRadioAD985x : SCRadioDDSChip
+{
+	/**
+	 * Number of bytes in a frame (tuning word plus control byte - 40 bits)
+	 */
+	static const int8_t FRAME_BYTES = 5;
+
+	/**
+	 * Frame type for this chip
+	 */
+	typedef SCRadioDDSChipFrame<FRAME_BYTES> Frame;
+
+	/**
+	 * buildFrame
+	 *
+	 * @detail
+	 *   Builds the frame for a tuning word
+	 *
+	 * @param[in] tuningWord 32 bit tuning word
+	 *
+	 * @returns frame ready to shift out
+	 */
+	static constexpr Frame buildFrame(uint32_t tuningWord)
+	{
+		return Frame{{(uint8_t)tuningWord,
+						(uint8_t)(tuningWord >> 8),
+						(uint8_t)(tuningWord >> 16),
+						(uint8_t)(tuningWord >> 24),
+						ControlByte}};
+	}
+};
+
+/**
+ * SCRadioAD9850
+ *
+ * @detail
+ *   AD9850 DDS.  The control byte is all zeros
+ *   (no factory test bits, not powered down, no phase offset)
+ */
+typedef SCRadioAD985x<0x00> SCRadioAD9850;
+
+/**
+ * SCRadioAD9851
+ *
+ * @detail
+ *   AD9851 DDS.  Bit 0 of the control byte turns on the 6x reference clock multiplier.
+ *   Everything else is the same as the AD9850.
+ *
+ * @param RefClockMultiplier true to turn on the 6x multiplier
+ */
+template <bool RefClockMultiplier>
+struct SCRadioAD9851 : SCRadioAD985x<RefClockMultiplier ? AD9851_REFCLOCK_MULTIPLIER_BIT : 0x00>
+{
+};
+
+#if DDS_USES_I2C
+
+/**
+ * SCRadioSi5351
+ *
+ * @detail
+ *   Si5351 clock generator with its output on CLK0.
+ *
+ *   The output multisynth divides PLL A by a fixed even number (set up once in beginChip()).
+ *   Tuning moves PLL A, which is the crystal frequency times (a + b / c).  A frame is
+ *   the 8 PLL A registers.  They are written in one I2C transfer.
+ *
+ * @param CrystalHz crystal frequency in Hertz (use the measured value to calibrate)
+ * @param OutputDivider fixed even divider between the PLL and the output
+ */
+template <uint32_t CrystalHz, uint16_t OutputDivider>
+struct SCRadioSi5351 : SCRadioDDSChip
+{
+	static const DDSBus BUS = DDSBus::I2C;
+
+	static const bool USES_TUNING_WORD = false;
+
+	/**
+	 * Number of bytes in a frame (PLL A registers 26 - 33)
+	 */
+	static const int8_t FRAME_BYTES = 8;
+
+	/**
+	 * Frame type for this chip
+	 */
+	typedef SCRadioDDSChipFrame<FRAME_BYTES> Frame;
+
+	/**
+	 * pllWhole
+	 *
+	 * @detail
+	 *   Whole number part (a) of the PLL multiplier for a frequency
+	 *
+	 * @param[in] frequency output frequency in Hertz
+	 *
+	 * @returns a
+	 */
+	static constexpr uint32_t pllWhole(uint32_t frequency)
+	{
+		return (frequency * OutputDivider) / CrystalHz;
+	}
+
+	/**
+	 * pllNumerator
+	 *
+	 * @detail
+	 *   Numerator (b) of the PLL multiplier fraction for a frequency.
+	 *   The denominator (c) is always 2^SI5351_PLL_FRACTION_BITS.
+	 *
+	 * @param[in] frequency output frequency in Hertz
+	 *
+	 * @returns b
+	 */
+	static constexpr uint32_t pllNumerator(uint32_t frequency)
+	{
+		return fractionBits((frequency * OutputDivider) % CrystalHz, SI5351_PLL_FRACTION_BITS, 0);
+	}
+
+	/**
+	 * buildFrame
+	 *
+	 * @detail
+	 *   Builds the PLL A register values for a frequency.
+	 *
+	 *   The chip wants the multiplier as three values (AN619):
+	 *     P1 = 128 * a + floor(128 * b / c) - 512
+	 *     P2 = 128 * b - c * floor(128 * b / c)
+	 *     P3 = c
+	 *   Since c is a power of 2 the divides are just shifts.
+	 *
+	 * @param[in] frequency output frequency in Hertz
+	 *
+	 * @returns frame ready to write
+	 */
+	static constexpr Frame buildFrame(uint32_t frequency)
+	{
+		return buildRegisters(pllP1(pllWhole(frequency), pllNumerator(frequency)),
+								pllP2(pllNumerator(frequency)));
+	}
+
+	/**
+	 * outputDividerRegister
+	 *
+	 * @detail
+	 *   Value of one of the 8 output multisynth 0 registers.
+	 *   An integer divider d is P1 = 128 * d - 512, P2 = 0, P3 = 1.
+	 *
+	 * @param[in] index register number less SI5351_MULTISYNTH0_FIRST_REGISTER
+	 *
+	 * @returns register value
+	 */
+	static constexpr uint8_t outputDividerRegister(int8_t index)
+	{
+		return (index == 1) ? 0x01
+			: (index == 2) ? (uint8_t)((((uint32_t)OutputDivider * 128 - 512) >> 16) & 0x03)
+			: (index == 3) ? (uint8_t)(((uint32_t)OutputDivider * 128 - 512) >> 8)
+			: (index == 4) ? (uint8_t)((uint32_t)OutputDivider * 128 - 512)
+			: 0x00;
+	}
+
+	/**
+	 * beginChip
+	 *
+	 * @detail
+	 *   Turns the outputs off, sets up CLK0 to come from PLL A through a fixed integer
+	 *   divider.  The output is turned on once the first frame has set PLL A.
+	 */
+	static void beginChip()
+	{
+		Wire.begin();
+
+		writeRegister(SI5351_OUTPUT_ENABLE_REGISTER, 0xFF);		// all outputs off
+		writeRegister(SI5351_CRYSTAL_LOAD_REGISTER, 0xD2);		// 10 pF crystal load
+
+		// CLK0 powered up, integer mode, from PLL A through multisynth 0, 8 mA drive
+		writeRegister(SI5351_CLK0_CONTROL_REGISTER, 0x4F);
+
+		for (int8_t index = 0; index < 8; index++)
+		{
+			writeRegister(SI5351_MULTISYNTH0_FIRST_REGISTER + index, outputDividerRegister(index));
+		}
+	}
+
+	/**
+	 * writeFrame
+	 *
+	 * @detail
+	 *   Writes the PLL A registers in one I2C transfer.
+	 *   The chip moves to the new frequency when the last one is written.
+	 *
+	 * @param[in] bytes frame bytes
+	 */
+	static void writeFrame(const uint8_t *bytes)
+	{
+		Wire.beginTransmission(SI5351_I2C_ADDRESS);
+		Wire.write(SI5351_PLLA_FIRST_REGISTER);
+		Wire.write(bytes, FRAME_BYTES);
+		Wire.endTransmission();
+	}
+
+	/**
+	 * frameLatched
+	 *
+	 * @detail
+	 *   After the first frame the PLL is reset so it locks cleanly and CLK0 is turned on.
+	 *   Later frames are small moves the PLL follows on its own (a reset would glitch).
+	 *
+	 * @param[in] firstFrame true if this is the first frame since begin()
+	 */
+	static void frameLatched(bool firstFrame)
+	{
+		if (!firstFrame)
+		{
+			return;
+		}
+
+		writeRegister(SI5351_PLL_RESET_REGISTER, 0x20);			// reset PLL A
+		writeRegister(SI5351_OUTPUT_ENABLE_REGISTER, 0xFE);		// CLK0 on
+	}
+
+private:
+
+	/**
+	 * fractionBits
+	 *
+	 * @detail
+	 *   Works out remainder * 2^bits / CrystalHz one bit at a time (long division in binary).
+	 *   Keeps everything in 32 bits, which matters on the Arduino.
+	 *
+	 * @param[in] remainder part of the PLL frequency left over after the whole multiplier
+	 * @param[in] bits bits still to work out
+	 * @param[in] numerator bits worked out so far
+	 *
+	 * @returns numerator
+	 */
+	static constexpr uint32_t fractionBits(uint32_t remainder, int8_t bits, uint32_t numerator)
+	{
+		return (bits == 0) ? numerator
+			: ((remainder << 1) >= CrystalHz)
+				? fractionBits((remainder << 1) - CrystalHz, bits - 1, (numerator << 1) | 0x01)
+				: fractionBits(remainder << 1, bits - 1, numerator << 1);
+	}
+
+	/**
+	 * pllP1
+	 *
+	 * @param[in] whole a
+	 * @param[in] numerator b
+	 *
+	 * @returns P1
+	 */
+	static constexpr uint32_t pllP1(uint32_t whole, uint32_t numerator)
+	{
+		return (whole * 128) + (numerator >> (SI5351_PLL_FRACTION_BITS - 7)) - 512;
+	}
+
+	/**
+	 * pllP2
+	 *
+	 * @param[in] numerator b
+	 *
+	 * @returns P2
+	 */
+	static constexpr uint32_t pllP2(uint32_t numerator)
+	{
+		return (numerator << 7) & ((1UL << SI5351_PLL_FRACTION_BITS) - 1);
+	}
+
+	/**
+	 * buildRegisters
+	 *
+	 * @detail
+	 *   Packs P1, P2 and P3 into registers 26 - 33
+	 *
+	 * @param[in] p1 P1
+	 * @param[in] p2 P2
+	 *
+	 * @returns frame
+	 */
+	static constexpr Frame buildRegisters(uint32_t p1, uint32_t p2)
+	{
+		return Frame{{(uint8_t)((1UL << SI5351_PLL_FRACTION_BITS) >> 8),		// P3 bits 15 - 8
+						(uint8_t)(1UL << SI5351_PLL_FRACTION_BITS),				// P3 bits 7 - 0
+						(uint8_t)((p1 >> 16) & 0x03),							// P1 bits 17 - 16
+						(uint8_t)(p1 >> 8),										// P1 bits 15 - 8
+						(uint8_t)p1,											// P1 bits 7 - 0
+						(uint8_t)((((1UL << SI5351_PLL_FRACTION_BITS) >> 12) & 0xF0)	// P3 bits 19 - 16
+							| ((p2 >> 16) & 0x0F)),								// P2 bits 19 - 16
+						(uint8_t)(p2 >> 8),										// P2 bits 15 - 8
+						(uint8_t)p2}};											// P2 bits 7 - 0
+	}
+
+	/**
+	 * writeRegister
+	 *
+	 * @detail
+	 *   Writes one Si5351 register
+	 *
+	 * @param[in] reg register number
+	 * @param[in] value value to write
+	 */
+	static void writeRegister(uint8_t reg, uint8_t value)
+	{
+		Wire.beginTransmission(SI5351_I2C_ADDRESS);
+		Wire.write(reg);
+		Wire.write(value);
+		Wire.endTransmission();
+	}
+};
+
+#endif
+
+#endif
@@ -14,10 +14,11 @@
 
 #include "Arduino.h"
 
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 
 #include "SCRadioConstants.h"
 #include "SCRadioEventData.h"
+#include "SCRadioEventPayload.h"
 #include "SCRadioFrequency.h"
 #include "SCRadioMenuItem.h"
 
@@ -43,11 +44,13 @@ void SCRadioDisplay::begin()
 	_lcd.backlight();
 	_mainKnobMode = MainKnobMode::VFO;
 	_lastMenuItemNumber = 0;
+	_frequencyHz = 0;
+	_ritOffsetHz = 0;
 }
 
-void SCRadioDisplay::backlightStatusChangedListener(int eventCode, int whichMenuItem)
+void SCRadioDisplay::backlightStatusChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeBacklight((int8_t)whichMenuItem);
+	changeBacklight((BacklightStatus)eventPayload.menuItem.value);
 }
 
 void SCRadioDisplay::displaySplash()
@@ -73,24 +76,33 @@ void SCRadioDisplay::displayVoltage(int16_t voltageX10)
 	_lcd.print(voltageText);
 }
 
-void SCRadioDisplay::errorOccurredListener(int eventCode, int errorCode)
+void SCRadioDisplay::errorOccurredListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	ErrorType whichErrorType = (ErrorType)errorCode;
+	ErrorType whichErrorType = (ErrorType)eventPayload.value;
 	displayErrorText(whichErrorType);
 }
 
-void SCRadioDisplay::frequencyChangedListener(int eventCode, int frequencyFlags)
+void SCRadioDisplay::errorClearedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
+	// the error text was written over the frequency
 	displayFrequency();
 }
 
-void SCRadioDisplay::mainKnobModeChangedListener(int eventCode, int newMode)
+void SCRadioDisplay::frequencyChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeDisplayForNewMainKnobMode((MainKnobMode)newMode);
+	_frequencyHz = eventPayload.hertz;
+	displayFrequency();
 }
 
-void SCRadioDisplay::menuItemSelectedListener(int eventCode, int whichMenuItem)
+void SCRadioDisplay::mainKnobModeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
+	changeDisplayForNewMainKnobMode((MainKnobMode)eventPayload.value);
+}
+
+void SCRadioDisplay::menuItemSelectedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	int8_t whichMenuItem = (int8_t)eventPayload.value;
+
 //	Serial.print("Which Menu Item = ");
 //	Serial.println(whichMenuItem);
 	_lastMenuItemNumber = whichMenuItem;
@@ -98,14 +110,16 @@ void SCRadioDisplay::menuItemSelectedListener(int eventCode, int whichMenuItem)
 	displayMenuItemValue(whichMenuItem);
 }
 
-void SCRadioDisplay::menuItemValueChangedListener(int eventCode, int whichMenuItem)
+void SCRadioDisplay::menuItemValueChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
 	// Serial.println("In menu item value changed listener.");
-	displayMenuItemValue(whichMenuItem);
+	displayMenuItemValue(eventPayload.menuItem.id);
 }
 
-void SCRadioDisplay::ritChangedListener(int eventCode, int ritOffset)
+void SCRadioDisplay::ritChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
+	_ritOffsetHz = eventPayload.hertz;
+
 	if (_mainKnobMode == MainKnobMode::RIT)
 	{
 		displayRIT();
@@ -125,22 +139,18 @@ void SCRadioDisplay::setStuckKeyErrorText(const char* stuckKeyText)
 	setTextField(_stuckKeyText, stuckKeyText, TEXT_FOR_DISPLAY_MAX_LENGTH);
 }
 
-void SCRadioDisplay::voltageReadListener(int eventCode, int voltageX10)
+void SCRadioDisplay::voltageReadListener(int eventCode, SCRadioEventPayload eventPayload)
 {
 	if (_mainKnobMode == MainKnobMode::VFO)
 	{
-		displayVoltage(voltageX10);
+		displayVoltage((int16_t)eventPayload.value);
 	}
 }
 
 // private object methods
 
-void SCRadioDisplay::changeBacklight(int8_t whichMenuItem)
+void SCRadioDisplay::changeBacklight(BacklightStatus backlightStatus)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-
-	BacklightStatus backlightStatus = (BacklightStatus)menuItem->getMenuItemValue();
-
 	if (backlightStatus == BacklightStatus::ENABLED)
 	{
 		_lcd.backlight();
@@ -183,8 +193,7 @@ void SCRadioDisplay::changeDisplayForNewMainKnobMode(MainKnobMode newMode)
 void SCRadioDisplay::displayRIT()
 {
 	char ritOffsetToDisplay[TEXT_FOR_DISPLAY_MAX_LENGTH + 1];
-	long ritOffset = _eventData.getEventRelatedLong(EventLongField::RIT_OFFSET);
-	sprintf(ritOffsetToDisplay, "  RIT %5ld Hz  ", ritOffset);
+	sprintf(ritOffsetToDisplay, "  RIT %5ld Hz  ", (long)_ritOffsetHz);
 	_lcd.setCursor(LCD_FIRST_COLUMN_NUMBER, static_cast<uint8_t>(LCDDisplayLine::SECOND_LINE));
 	_lcd.print(ritOffsetToDisplay);
 }
@@ -220,13 +229,13 @@ void SCRadioDisplay::displayFrequency()
 	}
 
 	char frequencyToDisplay[TEXT_FOR_DISPLAY_MAX_LENGTH + 1];
-	SCRadioFrequency *currentFrequency = _eventData.getEventRelatedFrequency(EventFrequencyField::OPERATING_FREQUENCY);
+	SCRadioFrequency currentFrequency(_frequencyHz);
 
 	sprintf(frequencyToDisplay,
 	"%d.%03d.%03d MHz %c%c",
-	currentFrequency->megaHertz(),
-	currentFrequency->kiloHertz(),
-	currentFrequency->hertz(), 
+	currentFrequency.megaHertz(),
+	currentFrequency.kiloHertz(),
+	currentFrequency.hertz(), 
 	ritIndicator,
 	offsetDirectionIndicator);
 
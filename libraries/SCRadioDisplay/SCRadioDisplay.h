@@ -22,13 +22,14 @@
 #define SCRadioDisplay_h
 
 // forwards for classes accessed via pointers and references only
-class EventManager;
+class SCRadioEventQueue;
 class SCRadioEventData;
 
 // includes
 #include "LiquidCrystal_I2C.h"
 
 #include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
 
 /**
  * SCRadioDisplay class
@@ -83,6 +84,17 @@ private:
 	 * Holds the last menu item accessed so it can be returned to if returning to menu
 	 */
 	int8_t _lastMenuItemNumber;
+
+	/**
+	 * Last operating frequency sent in a FREQUENCY_CHANGED event (Hz)
+	 * Kept so the frequency can be redrawn when the knob mode changes back to VFO
+	 */
+	int32_t _frequencyHz;
+
+	/**
+	 * Last RIT offset sent in a RIT_CHANGED event (Hz)
+	 */
+	int32_t _ritOffsetHz;
  
 public:  
 	// public methods
@@ -122,8 +134,8 @@ public:
 	*   Handles requests for turning on or off the LCD display backlight
 	*   
 	* @param[in] eventCode Identifies the type of event (Corresponds to EventType enum)
-	* @param[in] whichMenuItem The number of the menu item that initiated the event message
-	*/void backlightStatusChangedListener(int eventCode, int whichMenuItem);
+	* @param[in] eventPayload menuItem holds the menu item that initiated the event and its value (BacklightStatus)
+	*/void backlightStatusChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* displaySplash
@@ -144,27 +156,33 @@ public:
 	*   Listens for error occured messages
 	*   
 	* @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	* @param[in] errorCode Number identifying type of error (Corresponds to ErrorType enum)
+	* @param[in] eventPayload value identifies the type of error (Corresponds to ErrorType enum)
+	*/
+	void errorOccurredListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	* errorClearedListener
+	*
+	* @detail
+	*   Listens for error cleared messages and puts the frequency back on the display
+	*   
+	* @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
+	* @param[in] eventPayload value identifies the type of error (Corresponds to ErrorType enum)
 	*/
-	void errorOccurredListener(int eventCode, int errorCode);
+	void errorClearedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/** 
 	 * frequencyChangedListener
 	 * 
 	 * @detail
 	 *   Listens for change of freqency messages
-	 *   
-	 *   frequencyFlags:
-	 *   1 = rit enabed
-	 *   2 = receive offset reversed enabled
-	 *   3 = both enabled
 	 * 
 	 * @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	 * @param[in] frequencyFlags Int containing bit position flags for frequency related statuses
+	 * @param[in] eventPayload hertz holds the new operating frequency
 	 * 
 	 * logic to respond to frequency change events
 	*/
-	void frequencyChangedListener(int eventCode, int frequencyFlags);
+	void frequencyChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 	
 	/**
 	 * menuItemChangedListener
@@ -173,9 +191,9 @@ public:
 	 *   Listens for menu item value change messages
 	 *   
 	 * @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	 * @param[in] whichMenuItem Specifies the numerical id of the menu item that changed
+	 * @param[in] eventPayload menuItem holds the numerical id of the menu item that changed and its new value
 	 */
-	void menuItemValueChangedListener(int eventCode, int whichMenuItem);
+	void menuItemValueChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * menuItemSelectedListener
@@ -184,9 +202,9 @@ public:
 	 *   Listens for messages indicating the selected menu item changed
 	 * 
 	 * @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	 * @param[in] whichMenuItem Specifies the numerical id of the menu item that was selected
+	 * @param[in] eventPayload value holds the numerical id of the menu item that was selected
 	 */
-	void menuItemSelectedListener(int eventCode, int whichMenuItem);
+	void menuItemSelectedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * mainKnobModeChangedListener
@@ -195,9 +213,9 @@ public:
 	 *   Listens for messages indicating that the main knob mode has changed
 	 * 
 	 * @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	 * @param[in] newModeCode Identifies the new knob mode (Corresponds to MainKnobMode enum)
+	 * @param[in] eventPayload value identifies the new knob mode (Corresponds to MainKnobMode enum)
 	 */
-	void mainKnobModeChangedListener(int eventCode, int newModeCode);
+	void mainKnobModeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * ritChangedListener
@@ -206,9 +224,9 @@ public:
 	 *   Listens for rit changed messages
 	 * 
 	 * @param[in] eventCode Identifies the type of message (Corresponds to EventType enum)
-	 * @param[in] ritOffset Specifies the ritOffset value
+	 * @param[in] eventPayload hertz holds the RIT offset
 	 */
-	void ritChangedListener(int eventType, int ritOffset);
+	void ritChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	// the following methods set up text used by the display
 
@@ -240,9 +258,9 @@ public:
 	 *   Handles event triggered after the rig voltage is read
 	 * 
 	 * @param[in] eventCode Event Type Code
-	 * @param[in] voltageX100 The Rig's supply voltage multiplied by 100
+	 * @param[in] eventPayload value holds the Rig's supply voltage multiplied by 10
 	 */
-	void voltageReadListener(int eventCode, int voltageX100);
+	void voltageReadListener(int eventCode, SCRadioEventPayload eventPayload);
 
 private:
 	// private methods
@@ -253,9 +271,9 @@ private:
 	 * @detail
 	 *   Directs the turn on or off of the LCD backlight
 	 * 
-	 * @param[in] whichMenuItem The menu item that requested the change (holds the desired status)
+	 * @param[in] backlightStatus The desired status
 	 */
-	void changeBacklight(int8_t whichMenuItem);
+	void changeBacklight(BacklightStatus backlightStatus);
 
 	/**
 	 * changeDisplayForNewMainKnobMode
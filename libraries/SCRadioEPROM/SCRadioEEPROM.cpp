@@ -15,17 +15,12 @@
 #include "Arduino.h"
 
 #include "EEPROM.h"
-#include "ISCRadioReadOnlyMenuItem.h"
 #include "SCRadioConstants.h"
 #include "SCRadioEEPROM.h"
-#include "SCRadioEventData.h"
-#include "SCRadioFrequency.h"
 
 // Constructor
 // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioEEPROM::SCRadioEEPROM(SCRadioEventData &eventData,
-	          				int32_t minimumWriteIntervalMillis) :
-	          						_eventData(eventData), 
+SCRadioEEPROM::SCRadioEEPROM(int32_t minimumWriteIntervalMillis) :
 	          						_minimumWriteIntervalMillis(minimumWriteIntervalMillis) 
 {
 	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
@@ -40,26 +35,56 @@ void SCRadioEEPROM::begin()
 	_txFrequencyHasChanged = false;
 	_keyerModeHasChanged = false;
 	_keyerSpeedHasChanged = false;
+	_sidetonePitchHasChanged = false;
+	_sidetoneVolumeHasChanged = false;
+	_keyerEffectiveSpeedHasChanged = false;
+	_keyerDahRatioHasChanged = false;
+	_keyerCompensationHasChanged = false;
 }
 
-void SCRadioEEPROM::frequencyChangedListener(int eventCode, int eventFrequencyIndex) 
+void SCRadioEEPROM::frequencyChangedListener(int eventCode, SCRadioEventPayload eventPayload) 
 {
-	processFrequencyToPotentiallyArchive((EventFrequencyField)eventFrequencyIndex);
+	processFrequencyToPotentiallyArchive(eventPayload.hertz);
 }
 
-void SCRadioEEPROM::keyerModeChangedListener(int eventCode, int whichMenuItem)
+void SCRadioEEPROM::keyerModeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	processKeyerModeToPotentiallyArchive(whichMenuItem);
+	processKeyerModeToPotentiallyArchive(eventPayload.menuItem.value);
 }
 
-void SCRadioEEPROM::keyerSpeedChangedListener(int eventCode, int whichMenuItem)
+void SCRadioEEPROM::keyerSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	processKeyerSpeedToPotentiallyArchive(whichMenuItem);
+	processKeyerSpeedToPotentiallyArchive(eventPayload.menuItem.value);
 }
 
-void SCRadioEEPROM::paddlesOrientationChangedListener(int eventCode, int whichMenuItem)
+void SCRadioEEPROM::paddlesOrientationChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	processPaddlesOrientationToPotentiallyArchive(whichMenuItem);
+	processPaddlesOrientationToPotentiallyArchive(eventPayload.menuItem.value);
+}
+
+void SCRadioEEPROM::sidetonePitchChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	processSidetonePitchToPotentiallyArchive(eventPayload.menuItem.value);
+}
+
+void SCRadioEEPROM::sidetoneVolumeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	processSidetoneVolumeToPotentiallyArchive(eventPayload.menuItem.value);
+}
+
+void SCRadioEEPROM::keyerEffectiveSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	processKeyerEffectiveSpeedToPotentiallyArchive(eventPayload.menuItem.value);
+}
+
+void SCRadioEEPROM::keyerDahRatioChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	processKeyerDahRatioToPotentiallyArchive(eventPayload.menuItem.value);
+}
+
+void SCRadioEEPROM::keyerCompensationChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	processKeyerCompensationToPotentiallyArchive(eventPayload.menuItem.value);
 }
 
 // this should be called each time the app main loop executes
@@ -96,6 +121,31 @@ void SCRadioEEPROM::loop()
 		writePaddlesOrientation();
 	}
 
+	if (_sidetonePitchHasChanged)
+	{
+		writeSidetonePitch();
+	}
+
+	if (_sidetoneVolumeHasChanged)
+	{
+		writeSidetoneVolume();
+	}
+
+	if (_keyerEffectiveSpeedHasChanged)
+	{
+		writeKeyerEffectiveSpeed();
+	}
+
+	if (_keyerDahRatioHasChanged)
+	{
+		writeKeyerDahRatio();
+	}
+
+	if (_keyerCompensationHasChanged)
+	{
+		writeKeyerCompensation();
+	}
+
 	_itemsHaveChanged = false;
 }
 
@@ -131,6 +181,46 @@ int8_t SCRadioEEPROM::readStoredPaddlesOrientation()
 	return orientation;
 }
 
+int16_t SCRadioEEPROM::readStoredSidetonePitch()
+{
+	int16_t pitch = readStoredValue(EEPROMValueIndex::SIDETONE_PITCH);
+	_lastSidetonePitchWritten = pitch;
+	_sidetonePitchHasChanged = false;
+	return pitch;
+}
+
+int8_t SCRadioEEPROM::readStoredSidetoneVolume()
+{
+	int8_t volume = readStoredValue(EEPROMValueIndex::SIDETONE_VOLUME);
+	_lastSidetoneVolumeWritten = volume;
+	_sidetoneVolumeHasChanged = false;
+	return volume;
+}
+
+int8_t SCRadioEEPROM::readStoredKeyerEffectiveSpeed()
+{
+	int8_t effectiveSpeed = readStoredValue(EEPROMValueIndex::KEYER_EFFECTIVE_SPEED);
+	_lastKeyerEffectiveSpeedWritten = effectiveSpeed;
+	_keyerEffectiveSpeedHasChanged = false;
+	return effectiveSpeed;
+}
+
+int8_t SCRadioEEPROM::readStoredKeyerDahRatio()
+{
+	int8_t dahRatio = readStoredValue(EEPROMValueIndex::KEYER_DAH_RATIO);
+	_lastKeyerDahRatioWritten = dahRatio;
+	_keyerDahRatioHasChanged = false;
+	return dahRatio;
+}
+
+int16_t SCRadioEEPROM::readStoredKeyerCompensation()
+{
+	int16_t compensation = readStoredValue(EEPROMValueIndex::KEYER_COMPENSATION);
+	_lastKeyerCompensationWritten = compensation;
+	_keyerCompensationHasChanged = false;
+	return compensation;
+}
+
 uint32_t SCRadioEEPROM::readStoredValue(EEPROMValueIndex whichValue) 
 {
 	int offset = static_cast<int8_t>(whichValue) * sizeof(uint32_t);
@@ -143,25 +233,19 @@ uint32_t SCRadioEEPROM::readStoredValue(EEPROMValueIndex whichValue)
 	return (uint32_t)myUnion.val;
 }
 
-void SCRadioEEPROM::processFrequencyToPotentiallyArchive(EventFrequencyField eventFrequencyIndex)
+void SCRadioEEPROM::processFrequencyToPotentiallyArchive(int32_t frequencyHz)
 {
-	if (eventFrequencyIndex == EventFrequencyField::OPERATING_FREQUENCY)
+	_frequencyToWrite = (uint32_t)frequencyHz;
+	if (_frequencyToWrite != _lastTXFrequencyWritten)
 	{
-		SCRadioFrequency* currentFrequency = _eventData.getEventRelatedFrequency(EventFrequencyField(eventFrequencyIndex));
-		_frequencyToWrite = (uint32_t)(currentFrequency->asInt32());
-		if (_frequencyToWrite != _lastTXFrequencyWritten)
-		{
-			_itemsHaveChanged = true;
-			_txFrequencyHasChanged = true;
-		}
+		_itemsHaveChanged = true;
+		_txFrequencyHasChanged = true;
 	}
 }
 
-void SCRadioEEPROM::processKeyerModeToPotentiallyArchive(int whichMenuItem)
+void SCRadioEEPROM::processKeyerModeToPotentiallyArchive(int16_t keyerMode)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-
-	_keyerModeToWrite = menuItem->getMenuItemValue();
+	_keyerModeToWrite = keyerMode;
 
 	if (_keyerModeToWrite != _lastKeyerModeWritten)
 	{
@@ -170,11 +254,9 @@ void SCRadioEEPROM::processKeyerModeToPotentiallyArchive(int whichMenuItem)
 	}
 }
 
-void SCRadioEEPROM::processKeyerSpeedToPotentiallyArchive(int whichMenuItem)
+void SCRadioEEPROM::processKeyerSpeedToPotentiallyArchive(int16_t keyerSpeed)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-
-	_keyerSpeedToWrite = menuItem->getMenuItemValue();
+	_keyerSpeedToWrite = keyerSpeed;
 
 	if (_keyerSpeedToWrite != _lastKeyerSpeedWritten)
 	{
@@ -184,11 +266,9 @@ void SCRadioEEPROM::processKeyerSpeedToPotentiallyArchive(int whichMenuItem)
 }
 
 
-void SCRadioEEPROM::processPaddlesOrientationToPotentiallyArchive(int whichMenuItem)
+void SCRadioEEPROM::processPaddlesOrientationToPotentiallyArchive(int16_t paddlesOrientation)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-
-	_paddlesOrientationToWrite = menuItem->getMenuItemValue();
+	_paddlesOrientationToWrite = paddlesOrientation;
 
 	if (_paddlesOrientationToWrite != _lastPaddlesOrientationWritten)
 	{
@@ -197,6 +277,58 @@ void SCRadioEEPROM::processPaddlesOrientationToPotentiallyArchive(int whichMenuI
 	}
 }
 
+void SCRadioEEPROM::processSidetonePitchToPotentiallyArchive(int16_t sidetonePitch)
+{
+	_sidetonePitchToWrite = sidetonePitch;
+
+	if (_sidetonePitchToWrite != _lastSidetonePitchWritten)
+	{
+		_itemsHaveChanged = true;
+		_sidetonePitchHasChanged = true;
+	}
+}
+
+void SCRadioEEPROM::processSidetoneVolumeToPotentiallyArchive(int16_t sidetoneVolume)
+{
+	_sidetoneVolumeToWrite = sidetoneVolume;
+
+	if (_sidetoneVolumeToWrite != _lastSidetoneVolumeWritten)
+	{
+		_itemsHaveChanged = true;
+		_sidetoneVolumeHasChanged = true;
+	}
+}
+
+void SCRadioEEPROM::processKeyerEffectiveSpeedToPotentiallyArchive(int16_t effectiveSpeed)
+{
+	_keyerEffectiveSpeedToWrite = effectiveSpeed;
+	if (_keyerEffectiveSpeedToWrite != _lastKeyerEffectiveSpeedWritten)
+	{
+		_itemsHaveChanged = true;
+		_keyerEffectiveSpeedHasChanged = true;
+	}
+}
+
+void SCRadioEEPROM::processKeyerDahRatioToPotentiallyArchive(int16_t dahRatio)
+{
+	_keyerDahRatioToWrite = dahRatio;
+	if (_keyerDahRatioToWrite != _lastKeyerDahRatioWritten)
+	{
+		_itemsHaveChanged = true;
+		_keyerDahRatioHasChanged = true;
+	}
+}
+
+void SCRadioEEPROM::processKeyerCompensationToPotentiallyArchive(int16_t compensation)
+{
+	_keyerCompensationToWrite = compensation;
+	if (_keyerCompensationToWrite != _lastKeyerCompensationWritten)
+	{
+		_itemsHaveChanged = true;
+		_keyerCompensationHasChanged = true;
+	}
+}
+
 void SCRadioEEPROM::writeEEPROMValue(uint32_t valueToSet, uint8_t indexOfValue)
 {
 	myUnion.val = valueToSet;
@@ -239,4 +371,44 @@ void SCRadioEEPROM::writePaddlesOrientation()
 	_lastPaddlesOrientationWritten = _paddlesOrientationToWrite;
 	_lastWriteMillis = millis();
 	_paddlesOrientationHasChanged = false;
-}
\ No newline at end of file
+}
+
+void SCRadioEEPROM::writeSidetonePitch()
+{
+	writeEEPROMValue(_sidetonePitchToWrite, static_cast<uint8_t>(EEPROMValueIndex::SIDETONE_PITCH));
+	_lastSidetonePitchWritten = _sidetonePitchToWrite;
+	_lastWriteMillis = millis();
+	_sidetonePitchHasChanged = false;
+}
+
+void SCRadioEEPROM::writeSidetoneVolume()
+{
+	writeEEPROMValue(_sidetoneVolumeToWrite, static_cast<uint8_t>(EEPROMValueIndex::SIDETONE_VOLUME));
+	_lastSidetoneVolumeWritten = _sidetoneVolumeToWrite;
+	_lastWriteMillis = millis();
+	_sidetoneVolumeHasChanged = false;
+}
+
+void SCRadioEEPROM::writeKeyerEffectiveSpeed()
+{
+	writeEEPROMValue(_keyerEffectiveSpeedToWrite, static_cast<uint8_t>(EEPROMValueIndex::KEYER_EFFECTIVE_SPEED));
+	_lastKeyerEffectiveSpeedWritten = _keyerEffectiveSpeedToWrite;
+	_lastWriteMillis = millis();
+	_keyerEffectiveSpeedHasChanged = false;
+}
+
+void SCRadioEEPROM::writeKeyerDahRatio()
+{
+	writeEEPROMValue(_keyerDahRatioToWrite, static_cast<uint8_t>(EEPROMValueIndex::KEYER_DAH_RATIO));
+	_lastKeyerDahRatioWritten = _keyerDahRatioToWrite;
+	_lastWriteMillis = millis();
+	_keyerDahRatioHasChanged = false;
+}
+
+void SCRadioEEPROM::writeKeyerCompensation()
+{
+	writeEEPROMValue(_keyerCompensationToWrite, static_cast<uint8_t>(EEPROMValueIndex::KEYER_COMPENSATION));
+	_lastKeyerCompensationWritten = _keyerCompensationToWrite;
+	_lastWriteMillis = millis();
+	_keyerCompensationHasChanged = false;
+}
@@ -15,10 +15,8 @@
 #ifndef SCRadioEEPROM_h
 #define SCRadioEEPROM_h
 
-// forwards for classes accessed via pointers and references only
-class SCRadioEventData;
-
 #include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
 
 class SCRadioEEPROM
 {
@@ -35,11 +33,6 @@ private:
 	 */
 	uint32_t _lastWriteMillis;
 	
-	/**
-	 * Allows access to event related data
-	 */
-	SCRadioEventData &_eventData;
-	
 	/**
 	 * Used to help tell if frequency has changed since the last time it was written to EEPROM
 	 */
@@ -60,6 +53,28 @@ private:
 	 */
 	uint32_t _lastPaddlesOrientationWritten;
 
+	/**
+	 * Used to help tell if sidetone pitch has changed since the last time it was written
+	 */
+	uint32_t _lastSidetonePitchWritten;
+
+	/**
+	 * Used to help tell if sidetone volume has changed since the last time it was written
+	 */
+	uint32_t _lastSidetoneVolumeWritten;
+	/**
+	 * Used to help tell if keyer effective speed has changed since the last time it was written
+	 */
+	uint32_t _lastKeyerEffectiveSpeedWritten;
+	/**
+	 * Used to help tell if keyer dah ratio has changed since the last time it was written
+	 */
+	uint32_t _lastKeyerDahRatioWritten;
+	/**
+	 * Used to help tell if keyer compensation has changed since the last time it was written
+	 */
+	uint32_t _lastKeyerCompensationWritten;
+
 	/**
 	 * Frequency to be written to the EEPROM
 	 */
@@ -79,6 +94,28 @@ private:
 	* New paddles orientation to be written to the EEPROM
 	*/
 	uint32_t _paddlesOrientationToWrite;
+
+	/**
+	 * New sidetone pitch to be written to the EEPROM
+	 */
+	uint32_t _sidetonePitchToWrite;
+
+	/**
+	 * New sidetone volume to be written to the EEPROM
+	 */
+	uint32_t _sidetoneVolumeToWrite;
+	/**
+	 * New keyer effective speed to be written to the EEPROM
+	 */
+	uint32_t _keyerEffectiveSpeedToWrite;
+	/**
+	 * New keyer dah ratio to be written to the EEPROM
+	 */
+	uint32_t _keyerDahRatioToWrite;
+	/**
+	 * New keyer compensation to be written to the EEPROM
+	 */
+	uint32_t _keyerCompensationToWrite;
 	
 	/**
 	 * Minimum milliseconds between writes to EEPROM memory
@@ -110,6 +147,28 @@ private:
 	 */
 	bool _paddlesOrientationHasChanged;
 
+	/**
+	 * Flag tells us the sidetone pitch has changed since last written
+	 */
+	bool _sidetonePitchHasChanged;
+
+	/**
+	 * Flag tells us the sidetone volume has changed since last written
+	 */
+	bool _sidetoneVolumeHasChanged;
+	/**
+	 * Flag tells us the keyer effective speed has changed since last written
+	 */
+	bool _keyerEffectiveSpeedHasChanged;
+	/**
+	 * Flag tells us the keyer dah ratio has changed since last written
+	 */
+	bool _keyerDahRatioHasChanged;
+	/**
+	 * Flag tells us the keyer compensation has changed since last written
+	 */
+	bool _keyerCompensationHasChanged;
+
   public:     
 	// public methods
 
@@ -119,11 +178,9 @@ private:
 	 * @detail
 	 *   Creates a SCRadioEEPROM.  Run begin() after creating and before using.
 	 *   
-	 * @param[in] eventData Reference to eventData instance to allow access to event related data
 	 * @param[in] minimumWriteInervalMillis Minimum interval (milliseconds) between writes to EEPROM
 	 */
-	SCRadioEEPROM(SCRadioEventData &eventData,
-		int32_t minimumWriteIntervalMillis);
+	SCRadioEEPROM(int32_t minimumWriteIntervalMillis);
 
 	/**
 	 * frequencyChangedListener
@@ -132,9 +189,9 @@ private:
 	 *   Listens for frequency changed events
 	 * 
 	 * @param[in] eventCode identifies type of event
-	 * @param[in] eventFrequencyIndex index in eventData of frequency that changed
+	 * @param[in] eventPayload hertz is the new operating frequency
 	 */
-	void frequencyChangedListener(int eventCode, int eventFrequencyIndex);
+	void frequencyChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 	
 	/**
 	 * keyerModeChangedListener
@@ -143,9 +200,9 @@ private:
 	 *   Listens for changes in keyer mode
 	 * 
 	 * @param[in] eventCode Identifieds type of event
-	 * @param[in] whichMenuItem Identifies which menu item set the keyer mode
+	 * @param[in] eventPayload menuItem holds the new keyer mode
 	 */
-	void keyerModeChangedListener(int eventCode, int whichMenuItem);
+	void keyerModeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* keyerModeChangedListener
@@ -154,9 +211,9 @@ private:
 	*   Listens for changes in keyer speed
 	*
 	* @param[in] eventCode Identifieds type of event
-	* @param[in] whichMenuItem Identifies which menu item set the keyer speed
+	* @param[in] eventPayload menuItem holds the new keyer speed
 	*/	
-	void keyerSpeedChangedListener(int eventCode, int whichMenuItem);
+	void keyerSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* paddlesOrientationChangedListener
@@ -165,9 +222,61 @@ private:
 	*   Listens for changes in paddles orientation setting
 	*
 	* @param[in] eventCode Identifieds type of event
-	* @param[in] whichMenuItem Identifies which menu item set the orientation
+	* @param[in] eventPayload menuItem holds the new orientation
 	*/
-	void paddlesOrientationChangedListener(int eventCode, int whichMenuItem);
+	void paddlesOrientationChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * sidetonePitchChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in sidetone pitch
+	 *
+	 * @param[in] eventCode Identifies type of event
+	 * @param[in] eventPayload menuItem holds the new pitch
+	 */
+	void sidetonePitchChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * sidetoneVolumeChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in sidetone volume
+	 *
+	 * @param[in] eventCode Identifies type of event
+	 * @param[in] eventPayload menuItem holds the new volume
+	 */
+	void sidetoneVolumeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+	/**
+	 * keyerEffectiveSpeedChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in keyer effective (Farnsworth) speed
+	 *
+	 * @param[in] eventCode Identifies type of event
+	 * @param[in] eventPayload menuItem holds the new effective speed
+	 */
+	void keyerEffectiveSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+	/**
+	 * keyerDahRatioChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in keyer dah ratio
+	 *
+	 * @param[in] eventCode Identifies type of event
+	 * @param[in] eventPayload menuItem holds the new dah ratio
+	 */
+	void keyerDahRatioChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+	/**
+	 * keyerCompensationChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in keyer compensation
+	 *
+	 * @param[in] eventCode Identifies type of event
+	 * @param[in] eventPayload menuItem holds the new compensation
+	 */
+	void keyerCompensationChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 	
 	/**
 	 * begin
@@ -226,6 +335,53 @@ private:
 	*/	
 	int8_t readStoredPaddlesOrientation();
 
+	/**
+	 * readStoredSidetonePitch
+	 *
+	 * @detail
+	 *   returns the stored sidetone pitch from the eprom
+	 *
+	 * @returns sidetone pitch (Hz)
+	 */
+	int16_t readStoredSidetonePitch();
+
+	/**
+	 * readStoredSidetoneVolume
+	 *
+	 * @detail
+	 *   returns the stored sidetone volume from the eprom
+	 *
+	 * @returns sidetone volume
+	 */
+	int8_t readStoredSidetoneVolume();
+	/**
+	 * readStoredKeyerEffectiveSpeed
+	 *
+	 * @detail
+	 *   returns the stored keyer effective speed from the eprom
+	 *
+	 * @returns keyer effective speed
+	 */
+	int8_t readStoredKeyerEffectiveSpeed();
+	/**
+	 * readStoredKeyerDahRatio
+	 *
+	 * @detail
+	 *   returns the stored keyer dah ratio from the eprom
+	 *
+	 * @returns dah ratio (tenths of a dit)
+	 */
+	int8_t readStoredKeyerDahRatio();
+	/**
+	 * readStoredKeyerCompensation
+	 *
+	 * @detail
+	 *   returns the stored keyer compensation from the eprom
+	 *
+	 * @returns keyer compensation (microseconds)
+	 */
+	int16_t readStoredKeyerCompensation();
+
   private:
 	// private methods
 
@@ -234,8 +390,10 @@ private:
 	 * 
 	 * @detail
 	 *   Determines if the frequency has changed so we know we will need to save it to EEPROM
+	 *
+	 * @param[in] frequencyHz new operating frequency
 	 */
-	void processFrequencyToPotentiallyArchive(EventFrequencyField eventFrequencyIndex);
+	void processFrequencyToPotentiallyArchive(int32_t frequencyHz);
 
 	/**
 	 * processKeyerModeToPotentiallyArchive
@@ -243,9 +401,9 @@ private:
 	 * @detail
 	 *   Gets changed keyer mode to potentially archive
 	 *   
-	 * @param[in] whichMenuItem Menu item adjusting the keyer mode
+	 * @param[in] keyerMode new keyer mode
 	 */
-	void processKeyerModeToPotentiallyArchive(int whichMenuItem);
+	void processKeyerModeToPotentiallyArchive(int16_t keyerMode);
 
 	/**
 	* processKeyerSpeedToPotentiallyArchive
@@ -253,9 +411,9 @@ private:
 	* @detail
 	*   Gets changed keyer speed to potentially archive
 	*
-	* @param[in] whichMenuItem Menu item adjusting the keyer speed
+	* @param[in] keyerSpeed new keyer speed
 	*/
-	void processKeyerSpeedToPotentiallyArchive(int whichMenuItem);
+	void processKeyerSpeedToPotentiallyArchive(int16_t keyerSpeed);
 
 
 	/**
@@ -264,9 +422,56 @@ private:
 	* @detail
 	*   Gets changed paddles orientation to potentially archive
 	*
-	* @param[in] whichMenuItem Menu item adjusting the paddles orientation
+	* @param[in] paddlesOrientation new paddles orientation
 	*/
-	void processPaddlesOrientationToPotentiallyArchive(int whichMenuItem);
+	void processPaddlesOrientationToPotentiallyArchive(int16_t paddlesOrientation);
+
+	/**
+	 * processSidetonePitchToPotentiallyArchive
+	 *
+	 * @detail
+	 *   Gets changed sidetone pitch to potentially archive
+	 *
+	 * @param[in] sidetonePitch new sidetone pitch
+	 */
+	void processSidetonePitchToPotentiallyArchive(int16_t sidetonePitch);
+
+	/**
+	 * processSidetoneVolumeToPotentiallyArchive
+	 *
+	 * @detail
+	 *   Gets changed sidetone volume to potentially archive
+	 *
+	 * @param[in] sidetoneVolume new sidetone volume
+	 */
+	void processSidetoneVolumeToPotentiallyArchive(int16_t sidetoneVolume);
+	/**
+	 * processKeyerEffectiveSpeedToPotentiallyArchive
+	 *
+	 * @detail
+	 *   Gets changed keyer effective speed to potentially archive
+	 *
+	 * @param[in] effectiveSpeed new keyer effective speed
+	 */
+	void processKeyerEffectiveSpeedToPotentiallyArchive(int16_t effectiveSpeed);
+	/**
+	 * processKeyerDahRatioToPotentiallyArchive
+	 *
+	 * @detail
+	 *   Gets changed keyer dah ratio to potentially archive
+	 *
+	 * @param[in] dahRatio new keyer dah ratio
+	 */
+	void processKeyerDahRatioToPotentiallyArchive(int16_t dahRatio);
+	/**
+	 * processKeyerCompensationToPotentiallyArchive
+	 *
+	 * @detail
+	 *   Gets changed keyer compensation to potentially archive
+	 *
+	 * @param[in] compensation new keyer compensation
+	 */
+	void processKeyerCompensationToPotentiallyArchive(int16_t compensation);
 	
 	/**
 	* readStoredValue
@@ -313,6 +518,43 @@ private:
 	 */
 	void writePaddlesOrientation();
 
+	/**
+	 * writeSidetonePitch
+	 *
+	 * @detail
+	 *   Writes current sidetone pitch to EEPROM
+	 */
+	void writeSidetonePitch();
+
+	/**
+	 * writeSidetoneVolume
+	 *
+	 * @detail
+	 *   Writes current sidetone volume to EEPROM
+	 */
+	void writeSidetoneVolume();
+	/**
+	 * writeKeyerEffectiveSpeed
+	 *
+	 * @detail
+	 *   Writes current keyer effective speed to EEPROM
+	 */
+	void writeKeyerEffectiveSpeed();
+	/**
+	 * writeKeyerDahRatio
+	 *
+	 * @detail
+	 *   Writes current keyer dah ratio to EEPROM
+	 */
+	void writeKeyerDahRatio();
+	/**
+	 * writeKeyerCompensation
+	 *
+	 * @detail
+	 *   Writes current keyer compensation to EEPROM
+	 */
+	void writeKeyerCompensation();
+
 	/**
 	 * writeEEPROMValue
 	 * 
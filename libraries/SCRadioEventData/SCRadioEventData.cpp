@@ -19,7 +19,6 @@
 void SCRadioEventData::begin()
 {
 	//strcpy(_messageText, "        ");
-	setEventRelatedLong(0, EventLongField::RIT_OFFSET);
 }
 
 ISCRadioReadOnlyMenuItem* SCRadioEventData::getReadOnlyMenuItem(int8_t whichMenuItem)
@@ -32,31 +31,11 @@ bool SCRadioEventData::getEventRelatedBool(EventBoolField whichField)
 	return _boolValues[static_cast<int>(whichField)];
 }
 
-SCRadioFrequency* SCRadioEventData::getEventRelatedFrequency(EventFrequencyField whichField)
-{
-	return _frequencies[static_cast<int>(whichField)];
-}
-
-long SCRadioEventData::getEventRelatedLong(EventLongField whichField)
-{
-	return _longValues[static_cast<int>(whichField)];
-}
-
 void SCRadioEventData::setEventRelatedBool(bool valueToSet, EventBoolField whichField)
 {
 	_boolValues[static_cast<int>(whichField)] = valueToSet;
 }
 
-void SCRadioEventData::setEventRelatedFrequency(SCRadioFrequency *frequency, EventFrequencyField whichField)
-{
-	_frequencies[static_cast<int>(whichField)] = frequency;
-}
-
-void SCRadioEventData::setEventRelatedLong(long longValue, EventLongField whichField)
-{
-	_longValues[static_cast<int>(whichField)] = longValue;
-}
-
 void SCRadioEventData::setMenuItem(SCRadioMenuItem * menuItem, int8_t whichMenuItem)
 {
 	_menuItems[whichMenuItem] = menuItem;
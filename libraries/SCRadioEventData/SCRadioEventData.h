@@ -15,26 +15,21 @@
 #ifndef SCRadioEventData_h
 #define SCRadioEventData_h
 
-// forwards for classes accessed via pointers and references only
-class SCRadioFrequency;
-
 // includes
 #include "SCRadioConstants.h"
 #include "SCRadioMenuItem.h"
 
 /**
  * Class for accessing data related to events that could not be passed in the event message itself
+ *
+ * Frequencies, knob steps and menu item values now travel with the event (see SCRadioEventPayload).
+ * What is left here is the status flags shown on the display and the menu items (for their text).
  */
 class SCRadioEventData
 {
 private:
 	// private member variables
 
-	/**
-	 * Array of 32 bit integers used by event related logic
-	 */
-	int32_t _longValues[EVENT_DATA_LONG_FIELDS_COUNT];
-
 	/**
 	 * Array of boolean values used by event related logic
 	 */
@@ -45,11 +40,6 @@ private:
 	 */
 	SCRadioMenuItem* _menuItems[MAX_MENU_ITEMS];
 
-	/**
-	 * Array of frequencies used by event related logic
-	 */
-	SCRadioFrequency* _frequencies[EVENT_DATA_FREQUENCY_FIELDS_COUNT];
-
 public:	
 
 	// public methods
@@ -75,41 +65,6 @@ public:
 	 */
 	bool getEventRelatedBool(EventBoolField whichField);
 
-	/**
-	 * getEventRelatedFrequency
-	 * 
-	 * @detail
-	 *   Returns the specified frequency value from the event data
-	 * 
-	 * @param[in] whichField Field to retrieve
-	 * 
-	 * @returns specified frequency
-	 */
-	SCRadioFrequency* getEventRelatedFrequency(EventFrequencyField whichField);
-
-	/**
-	 * getEventRelatedLong
-	 * 
-	 * @detail
-	 *   Returns the specified 32 bit int from the event data
-	 * 
-	 * @param[in] whichField Field to retrieve
-	 * 
-	 * @returns 32 bit int specified
-	 */
-	int32_t getEventRelatedLong(EventLongField whichField);
-
-	/**
-	 * setEventRelatedLong
-	 * 
-	 * @detail
-	 *   Sets an event related long field to the specified value
-	 * 
-	 * @param[in] valueToSet
-	 * @param[in] whichField
-	 */
-	void setEventRelatedLong(long valueToSet, EventLongField whichField);
-
 	/**
 	 * setEventRelatedBool
 	 * 
@@ -121,17 +76,6 @@ public:
 	 */
 	void setEventRelatedBool(bool valueToSet, EventBoolField whichField);
 
-	/**
-	 * setEventRelatedFrequency
-	 * 
-	 * @detail
-	 *   Sets an event related frequency field to the specified value
-	 *   
-	 * @param[in] valueToSet pointer to SCRadioFrequeny instance
-	 * @param[in] whichField
-	 */
-	void setEventRelatedFrequency(SCRadioFrequency *valueToSet, EventFrequencyField whichField);
-
 	/**
 	 * setMenuItem
 	 * 
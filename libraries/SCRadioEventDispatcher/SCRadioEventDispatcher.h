@@ -0,0 +1,194 @@
+/**
+ * SCRadioEventDispatcher.h - Templates that route events straight to object methods
+ *
+ * Notice there is no accompanying .cpp file.  Everything here is a template and
+ * has to be visible to the compiler wherever it is used.
+ *
+ * Why does this exist?
+ *
+ * Listeners used to be plain functions kept in a list.  Since a plain function can't
+ * be an object's method, the sketch had a 'trampoline' function for every listener
+ * that just called the right method on the right object.  Every event then walked
+ * the whole list looking for listeners with a matching event code.
+ *
+ * Here the routing is written down once, in the sketch, as a type:
+ *
+ *   typedef SCRadioEventDispatcher<
+ *       SCRadioEventRoute<EventType::KEY_LINE_CHANGED,
+ *           EVENT_HANDLER(vfo, keyLineChangedListener)>,
+ *       SCRadioEventRoute<EventType::FREQUENCY_CHANGED,
+ *           EVENT_HANDLER(lcdControl, frequencyChangedListener),
+ *           EVENT_HANDLER(eeprom, frequencyChangedListener)>
+ *   > EventDispatcher;
+ *
+ * The compiler turns that into one function that compares the event code against
+ * each route and calls the methods directly.  There is no list in memory, nothing to
+ * search through at run time and no trampolines.  Put the routes that need to be
+ * fastest (like the key line) first.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioEventDispatcher_h
+#define SCRadioEventDispatcher_h
+
+#include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
+
+/**
+ * SCRadioEventObjectType
+ *
+ * @detail
+ *   Hands back the type it is given.  Used by EVENT_HANDLER because the compiler
+ *   won't accept decltype(object)::method there.
+ */
+template <class T>
+struct SCRadioEventObjectType
+{
+	typedef T Type;
+};
+
+/**
+ * EVENT_HANDLER
+ *
+ * @detail
+ *   Macro to name a handler without repeating the object's class
+ *   ex: EVENT_HANDLER(vfo, keyLineChangedListener)
+ *
+ * @param[in] object global object that handles the event
+ * @param[in] method name of the object's listener method
+ */
+#define EVENT_HANDLER(object, method) SCRadioEventHandler<decltype(object), object, \
+	decltype(&SCRadioEventObjectType<decltype(object)>::Type::method), \
+	&SCRadioEventObjectType<decltype(object)>::Type::method>
+
+/**
+ * SCRadioEventHandler
+ *
+ * @detail
+ *   One object's listener method.  Object must be a global.
+ *
+ * @param T class of the object
+ * @param Object the object
+ * @param MethodType type of the listener method (it may belong to a base class of T)
+ * @param Method listener method (takes the event code and the event payload)
+ */
+template <class T, T &Object, class MethodType, MethodType Method>
+struct SCRadioEventHandler
+{
+	static void handleEvent(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		(Object.*Method)(eventCode, eventPayload);
+	}
+};
+
+/**
+ * SCRadioEventHandlerList
+ *
+ * @detail
+ *   Calls a list of handlers in order.  (Works through the list by handling the
+ *   first one and then handing the rest to another SCRadioEventHandlerList.)
+ */
+template <class... Handlers>
+struct SCRadioEventHandlerList;
+
+template <>
+struct SCRadioEventHandlerList<>
+{
+	static void handleEvent(int, SCRadioEventPayload) {}
+};
+
+template <class FirstHandler, class... OtherHandlers>
+struct SCRadioEventHandlerList<FirstHandler, OtherHandlers...>
+{
+	static void handleEvent(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		FirstHandler::handleEvent(eventCode, eventPayload);
+		SCRadioEventHandlerList<OtherHandlers...>::handleEvent(eventCode, eventPayload);
+	}
+};
+
+/**
+ * SCRadioEventRoute
+ *
+ * @detail
+ *   The handlers for one event type, called in the order listed
+ *
+ * @param Event event type
+ * @param Handlers SCRadioEventHandler for each listener (see EVENT_HANDLER)
+ */
+template <EventType Event, class... Handlers>
+struct SCRadioEventRoute
+{
+	/**
+	 * Event code this route handles
+	 */
+	static const int16_t EVENT_CODE = static_cast<int16_t>(Event);
+
+	/**
+	 * Number of handlers called for the event
+	 */
+	static const int8_t HANDLER_COUNT = sizeof...(Handlers);
+
+	static void handleEvent(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		SCRadioEventHandlerList<Handlers...>::handleEvent(eventCode, eventPayload);
+	}
+};
+
+/**
+ * SCRadioEventDispatcher
+ *
+ * @detail
+ *   Sends an event to the route for its event code.  Events with no route are ignored.
+ *   Pass it to SCRadioEventQueue::processAllEvents() or processEvent().
+ *
+ * @param Routes SCRadioEventRoute for each event type
+ */
+template <class... Routes>
+struct SCRadioEventDispatcher;
+
+template <>
+struct SCRadioEventDispatcher<>
+{
+	static int dispatch(int, SCRadioEventPayload)
+	{
+		return 0;
+	}
+};
+
+template <class FirstRoute, class... OtherRoutes>
+struct SCRadioEventDispatcher<FirstRoute, OtherRoutes...>
+{
+	/**
+	 * dispatch
+	 *
+	 * @detail
+	 *   Calls the handlers for an event
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventPayload Value sent with the event
+	 *
+	 * @returns number of handlers called
+	 */
+	static int dispatch(int eventCode, SCRadioEventPayload eventPayload)
+	{
+		if (eventCode == FirstRoute::EVENT_CODE)
+		{
+			FirstRoute::handleEvent(eventCode, eventPayload);
+			return FirstRoute::HANDLER_COUNT;
+		}
+
+		return SCRadioEventDispatcher<OtherRoutes...>::dispatch(eventCode, eventPayload);
+	}
+};
+
+#endif
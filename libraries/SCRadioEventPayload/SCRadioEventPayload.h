@@ -0,0 +1,112 @@
+/**
+ * SCRadioEventPayload.h - The value carried by each event in the event queue
+ *
+ * Notice there is no accompanying .cpp file.  It is just a type.
+ *
+ * Why does this exist?
+ *
+ * Events used to carry one int.  Anything bigger (a frequency) or anything that was more than
+ * one value (a menu item and its new value) went into SCRadioEventData and the int just said
+ * where to look.  So most listeners had to go and look it up, often through a pointer to a menu item.
+ *
+ * Now each event carries one of these in its queue slot and listeners read what they need from it.
+ *
+ * It is a union.  A union is like a struct except all of its fields share the same memory, so it
+ * only holds one of them at a time.  Which one depends on the event type:
+ *
+ *   value    - most events (modes, key status, voltage x 10, error type ...)
+ *   hertz    - FREQUENCY_CHANGED (operating frequency) and RIT_CHANGED (RIT offset)
+ *   menuItem - MENU_ITEM_VALUE_CHANGED, the events a menu item sends when it changes and the
+ *              *_EXTERNALLY_CHANGED events that tell a menu item its new value
+ *   knobTurn - the knob turned events (VFO, RIT, menu and menu item)
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioEventPayload_h
+#define SCRadioEventPayload_h
+
+#include "SCRadioConstants.h"
+
+/**
+ * Menu item number sent with the *_EXTERNALLY_CHANGED events.  The sketch's route for
+ * the event already says which menu item it is for, so the sender doesn't need to know.
+ */
+#define EVENT_PAYLOAD_NO_MENU_ITEM -1
+
+/**
+ * SCRadioEventMenuItemPayload
+ *
+ * @detail
+ *   Which menu item changed and its new value
+ */
+struct SCRadioEventMenuItemPayload
+{
+	/**
+	 * Number of the menu item (its position in the menu)
+	 */
+	int8_t id;
+
+	/**
+	 * The menu item's new value
+	 */
+	int16_t value;
+};
+
+/**
+ * SCRadioEventKnobTurnPayload
+ *
+ * @detail
+ *   How far the knob turned and how fast
+ */
+struct SCRadioEventKnobTurnPayload
+{
+	/**
+	 * Steps turned (+ is clockwise)
+	 */
+	int16_t steps;
+
+	/**
+	 * Average microseconds between the steps (65535 if longer than that or not known)
+	 */
+	uint16_t stepIntervalMicros;
+};
+
+/**
+ * SCRadioEventPayload
+ *
+ * @detail
+ *   The value sent with an event (4 bytes)
+ */
+union SCRadioEventPayload
+{
+	/**
+	 * A plain number
+	 */
+	int32_t value;
+
+	/**
+	 * A frequency or offset in Hz
+	 */
+	int32_t hertz;
+
+	/**
+	 * A menu item and its new value
+	 */
+	SCRadioEventMenuItemPayload menuItem;
+
+	/**
+	 * Knob steps and how fast they came
+	 */
+	SCRadioEventKnobTurnPayload knobTurn;
+};
+
+#endif
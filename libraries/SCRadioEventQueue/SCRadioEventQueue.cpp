@@ -0,0 +1,324 @@
+/**
+ * SCRadioEventQueue.cpp - Class for queueing event messages and sending them to listeners
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+
+#include "SCRadioEventQueue.h"
+
+// Constructor
+// The queue is created as a global before setup() runs.  Everything it sets
+// here is plain memory so it is safe to do in a constructor.
+SCRadioEventQueue::SCRadioEventQueue() : _isrHead(0),
+											_isrTail(0),
+											_isrDroppedEventCount(0),
+											_droppedEventCount(0),
+											_mergedEventCount(0),
+											_budgetExceededCount(0)
+{
+	for (int8_t lane = 0; lane < 2; lane++)
+	{
+		_lanes[lane].head = 0;
+		_lanes[lane].tail = 0;
+		_lanes[lane].highWaterMark = 0;
+	}
+}
+
+bool SCRadioEventQueue::queueEvent(int eventCode, int32_t eventValue, EventPriority priority)
+{
+	SCRadioEventPayload eventPayload;
+	eventPayload.value = eventValue;
+
+	return queuePayload(eventCode, eventPayload, priority);
+}
+
+bool SCRadioEventQueue::queueMenuItemEvent(int eventCode, int8_t menuItemId, int16_t menuItemValue, EventPriority priority)
+{
+	SCRadioEventPayload eventPayload;
+	eventPayload.menuItem.id = menuItemId;
+	eventPayload.menuItem.value = menuItemValue;
+
+	return queuePayload(eventCode, eventPayload, priority);
+}
+
+bool SCRadioEventQueue::queueEventFromISR(int eventCode, int16_t eventValue, EventPriority priority)
+{
+	return queueISREvent(eventCode, eventValue, (priority == kLowPriority) ? kISRLowPriorityFlag : 0);
+}
+
+bool SCRadioEventQueue::queueOrMergeEventFromISR(int eventCode, int16_t eventValue, EventPriority priority)
+{
+	return queueISREvent(eventCode, eventValue, kISRMergeFlag | ((priority == kLowPriority) ? kISRLowPriorityFlag : 0));
+}
+
+bool SCRadioEventQueue::queueOrMergeEvent(int eventCode, int16_t eventValue, EventPriority priority)
+{
+	SCRadioEventPayload *waitingPayload = findNewestWaitingEvent(eventCode, priority);
+
+	if (waitingPayload == nullptr)
+	{
+		return queueEvent(eventCode, eventValue, priority);
+	}
+
+	waitingPayload->value = addCountsWithLimit(waitingPayload->value, eventValue);
+
+	finishMerge(eventCode, eventValue, priority, (waitingPayload->value == 0));
+
+	return true;
+}
+
+bool SCRadioEventQueue::queueOrMergeKnobTurnEvent(int eventCode, int16_t turnSteps, uint16_t stepIntervalMicros, EventPriority priority)
+{
+	SCRadioEventPayload *waitingPayload = findNewestWaitingEvent(eventCode, priority);
+
+	if (waitingPayload == nullptr)
+	{
+		SCRadioEventPayload eventPayload;
+		eventPayload.knobTurn.steps = turnSteps;
+		eventPayload.knobTurn.stepIntervalMicros = stepIntervalMicros;
+
+		return queuePayload(eventCode, eventPayload, priority);
+	}
+
+	// The merged interval is the average over both sets of steps.  At most 32768 steps of
+	// 65535 us each side, so the total fits in 32 bits.
+	int16_t waitingSteps = waitingPayload->knobTurn.steps;
+	uint32_t waitingStepCount = (waitingSteps < 0) ? -(int32_t)waitingSteps : waitingSteps;
+	uint32_t newStepCount = (turnSteps < 0) ? -(int32_t)turnSteps : turnSteps;
+	uint32_t stepCount = waitingStepCount + newStepCount;
+
+	if (stepCount > 0)
+	{
+		uint32_t totalMicros = (uint32_t)waitingPayload->knobTurn.stepIntervalMicros * waitingStepCount
+			+ (uint32_t)stepIntervalMicros * newStepCount;
+
+		waitingPayload->knobTurn.stepIntervalMicros = (uint16_t)(totalMicros / stepCount);
+	}
+
+	waitingPayload->knobTurn.steps = addCountsWithLimit(waitingSteps, turnSteps);
+
+	finishMerge(eventCode, turnSteps, priority, (waitingPayload->knobTurn.steps == 0));
+
+	return true;
+}
+
+uint16_t SCRadioEventQueue::getBudgetExceededCount()
+{
+	return _budgetExceededCount;
+}
+
+uint16_t SCRadioEventQueue::getDroppedEventCount()
+{
+	uint32_t droppedEventCount = (uint32_t)_droppedEventCount + _isrDroppedEventCount;
+
+	return (droppedEventCount > 0xFFFF) ? 0xFFFF : (uint16_t)droppedEventCount;
+}
+
+uint16_t SCRadioEventQueue::getMergedEventCount()
+{
+	return _mergedEventCount;
+}
+
+uint8_t SCRadioEventQueue::getHighWaterMark(EventPriority priority)
+{
+	return _lanes[priority].highWaterMark;
+}
+
+SCRadioEventTrace &SCRadioEventQueue::getTrace()
+{
+	return _trace;
+}
+
+// private methods
+
+bool SCRadioEventQueue::queuePayload(int eventCode, const SCRadioEventPayload &eventPayload, EventPriority priority)
+{
+	SCRadioEventLane &lane = _lanes[priority];
+
+	// head and tail only count up, so head - tail is the number of events waiting
+	// even after either of them wraps past 255.
+	uint8_t waiting = lane.head - lane.tail;
+
+	if (waiting >= EVENT_QUEUE_SIZE)
+	{
+		// Full.  Rather than writing over events that have not been handled yet
+		// we drop this one and count it.
+		if (_droppedEventCount < 0xFFFF)
+		{
+			_droppedEventCount++;
+		}
+
+		_trace.record(EventTraceKind::DROPPED, eventCode, eventPayload.value, priority, waiting);
+
+		return false;
+	}
+
+	lane.eventCodes[lane.head & EVENT_QUEUE_MASK] = eventCode;
+	lane.eventPayloads[lane.head & EVENT_QUEUE_MASK] = eventPayload;
+	lane.head++;
+
+	waiting++;
+
+	if (waiting > lane.highWaterMark)
+	{
+		lane.highWaterMark = waiting;
+	}
+
+	_trace.record(EventTraceKind::QUEUED, eventCode, eventPayload.value, priority, waiting);
+
+	return true;
+}
+
+SCRadioEventPayload *SCRadioEventQueue::findNewestWaitingEvent(int eventCode, EventPriority priority)
+{
+	SCRadioEventLane &lane = _lanes[priority];
+
+	// Nothing waiting means nothing to merge with
+	if (lane.head == lane.tail)
+	{
+		return nullptr;
+	}
+
+	// head is where the next event goes, so the newest event is just before it.
+	// (The event being handled right now has already been copied out and is not in the lane.)
+	uint8_t newest = (uint8_t)(lane.head - 1) & EVENT_QUEUE_MASK;
+
+	if (lane.eventCodes[newest] != eventCode)
+	{
+		return nullptr;
+	}
+
+	return &lane.eventPayloads[newest];
+}
+
+void SCRadioEventQueue::finishMerge(int eventCode, int32_t eventValue, EventPriority priority, bool cancelledOut)
+{
+	SCRadioEventLane &lane = _lanes[priority];
+
+	if (cancelledOut)
+	{
+		// The two cancel out (one click each way).  Taking the waiting event back out.
+		lane.head--;
+	}
+
+	if (_mergedEventCount < 0xFFFF)
+	{
+		_mergedEventCount++;
+	}
+
+	_trace.record(EventTraceKind::MERGED, eventCode, eventValue, priority, lane.head - lane.tail);
+}
+
+int16_t SCRadioEventQueue::addCountsWithLimit(int32_t count1, int32_t count2)
+{
+	int32_t sum = count1 + count2;
+
+	if (sum > INT16_MAX)
+	{
+		return INT16_MAX;
+	}
+
+	if (sum < INT16_MIN)
+	{
+		return INT16_MIN;
+	}
+
+	return (int16_t)sum;
+}
+
+bool SCRadioEventQueue::queueISREvent(int eventCode, int16_t eventValue, uint8_t flags)
+{
+	uint8_t head = _isrHead;
+
+	// loop() may move the tail while we look at it, but that only frees up room
+	if ((uint8_t)(head - _isrTail) >= EVENT_ISR_QUEUE_SIZE)
+	{
+		if (_isrDroppedEventCount < 0xFF)
+		{
+			_isrDroppedEventCount++;
+		}
+
+		return false;
+	}
+
+	_isrEventCodes[head & EVENT_ISR_QUEUE_MASK] = eventCode;
+	_isrEventValues[head & EVENT_ISR_QUEUE_MASK] = eventValue;
+	_isrEventFlags[head & EVENT_ISR_QUEUE_MASK] = flags;
+
+	// Moving the head last.  Until this point loop() can't see the event.
+	_isrHead = head + 1;
+
+	return true;
+}
+
+void SCRadioEventQueue::moveISREventsToLanes()
+{
+	uint8_t tail = _isrTail;
+
+	// An interrupt may queue more while we are doing this.  Those are picked up the next time.
+	uint8_t head = _isrHead;
+
+	while (tail != head)
+	{
+		int16_t eventCode = _isrEventCodes[tail & EVENT_ISR_QUEUE_MASK];
+		int16_t eventValue = _isrEventValues[tail & EVENT_ISR_QUEUE_MASK];
+		uint8_t flags = _isrEventFlags[tail & EVENT_ISR_QUEUE_MASK];
+
+		// Moving the tail only after the event is copied out, so the slot can't be reused under us
+		tail++;
+		_isrTail = tail;
+
+		EventPriority priority = (flags & kISRLowPriorityFlag) ? kLowPriority : kHighPriority;
+
+		if (flags & kISRMergeFlag)
+		{
+			queueOrMergeEvent(eventCode, eventValue, priority);
+		}
+		else
+		{
+			queueEvent(eventCode, eventValue, priority);
+		}
+	}
+}
+
+bool SCRadioEventQueue::takeNextEvent(int16_t &eventCode, SCRadioEventPayload &eventPayload)
+{
+	if (takeNextLaneEvent(kHighPriority, eventCode, eventPayload))
+	{
+		return true;
+	}
+
+	return takeNextLaneEvent(kLowPriority, eventCode, eventPayload);
+}
+
+bool SCRadioEventQueue::takeNextLaneEvent(EventPriority priority, int16_t &eventCode, SCRadioEventPayload &eventPayload)
+{
+	SCRadioEventLane &lane = _lanes[priority];
+
+	if (lane.head == lane.tail)
+	{
+		return false;
+	}
+
+	// Copying the event out and moving the tail before the listeners are called.
+	// That frees the slot in case a listener queues another event.
+	eventCode = lane.eventCodes[lane.tail & EVENT_QUEUE_MASK];
+	eventPayload = lane.eventPayloads[lane.tail & EVENT_QUEUE_MASK];
+	lane.tail++;
+
+	_trace.record(EventTraceKind::DISPATCHED, eventCode, eventPayload.value, priority, lane.head - lane.tail);
+
+	return true;
+}
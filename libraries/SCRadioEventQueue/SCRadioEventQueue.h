@@ -0,0 +1,616 @@
+/**
+ * SCRadioEventQueue.h - Class for queueing event messages and sending them to listeners
+ *
+ * Why does this exist?
+ *
+ * The app was built on the EventManager library.  Its queue was a fixed size array
+ * with nothing stopping it from being overrun.  The knob, keyer and menu items can all
+ * queue events and a fast spin of the knob could queue a lot of them.
+ *
+ * This class does the same job with the same method names (queueEvent, processEvent,
+ * processAllEvents) but keeps each priority in a ring buffer that can't be overrun.
+ * When a lane is full the new event is dropped and counted.  It also remembers the
+ * most events that have been waiting at one time (the high water mark) so you can
+ * tell how close it came to filling up.
+ *
+ * A ring buffer is an array where the writer and the reader each keep their own
+ * position.  Both move forward and wrap back to the start at the end of the array.
+ * Because the array size is a power of 2, wrapping is done with a bit mask rather
+ * than a divide or an if statement.
+ *
+ * The queue doesn't keep a list of listeners.  processEvent() and processAllEvents()
+ * are handed an SCRadioEventDispatcher (see SCRadioEventDispatcher.h) that knows at
+ * compile time which methods to call for each event.
+ *
+ * processEventsWithinBudget() is the one the sketch uses.  A burst of menu, display and
+ * EEPROM events can take milliseconds to get through.  So it handles the normal events a
+ * few at a time, picks up anything the interrupt routines queued in between, always sends
+ * high priority events (the key line and the knob) first and stops when its time is up.
+ * Whatever is left waits for the next pass through loop().
+ *
+ * Interrupt routines can't use queueEvent().  An interrupt can happen right in the middle
+ * of loop() changing a lane and would find it half updated.  They use queueEventFromISR()
+ * instead, which puts the event in a separate ring buffer that only interrupts write to.
+ * The process methods move those events into the normal lanes before handling them.
+ *
+ * That ring buffer is safe without turning interrupts off because:
+ *   - only interrupts move its head and only loop() moves its tail
+ *   - each is a single byte, which the Nano reads and writes in one step
+ *   - the event is written before the head is moved past it, and read before the tail is
+ *   - interrupts don't interrupt each other on the Nano, so there is only ever one writer
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioEventQueue_h
+#define SCRadioEventQueue_h
+
+#include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
+#include "SCRadioEventTrace.h"
+
+static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE must be a power of 2");
+static_assert(EVENT_QUEUE_SIZE <= 128, "EVENT_QUEUE_SIZE must be 128 or less");
+static_assert((EVENT_ISR_QUEUE_SIZE & (EVENT_ISR_QUEUE_SIZE - 1)) == 0, "EVENT_ISR_QUEUE_SIZE must be a power of 2");
+static_assert(EVENT_ISR_QUEUE_SIZE <= 128, "EVENT_ISR_QUEUE_SIZE must be 128 or less");
+
+/**
+ * Mask used to wrap ring buffer positions back to the start of the array
+ */
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+/**
+ * Mask used to wrap the interrupt ring buffer positions back to the start of the array
+ */
+#define EVENT_ISR_QUEUE_MASK (EVENT_ISR_QUEUE_SIZE - 1)
+
+class SCRadioEventQueue
+{
+public:
+
+	/**
+	 * Event priorities.  High priority events are always handled first.
+	 * (Same names as EventManager used)
+	 */
+	enum EventPriority
+	{
+		kHighPriority = 0,
+		kLowPriority
+	};
+
+private:
+
+	/**
+	 * SCRadioEventLane
+	 *
+	 * @detail
+	 *   One ring buffer of waiting events
+	 */
+	struct SCRadioEventLane
+	{
+		/**
+		 * Event codes waiting to be handled
+		 */
+		int16_t eventCodes[EVENT_QUEUE_SIZE];
+
+		/**
+		 * The values sent with those events (see SCRadioEventPayload)
+		 */
+		SCRadioEventPayload eventPayloads[EVENT_QUEUE_SIZE];
+
+		/**
+		 * Position the next event will be written to.  Only ever counts up (wraps at 256).
+		 */
+		uint8_t head;
+
+		/**
+		 * Position the next event will be read from.  Only ever counts up (wraps at 256).
+		 */
+		uint8_t tail;
+
+		/**
+		 * The most events that have been waiting at one time
+		 */
+		uint8_t highWaterMark;
+	};
+
+	/**
+	 * Bits in _isrEventFlags
+	 */
+	enum
+	{
+		kISRLowPriorityFlag = 0x01,     /**< goes in the low priority lane */
+		kISRMergeFlag = 0x02            /**< merge with the newest waiting event (queueOrMergeEvent) */
+	};
+
+	// private member data
+
+	/**
+	 * Lanes for high and low priority events (indexed by EventPriority)
+	 */
+	SCRadioEventLane _lanes[2];
+
+	// The interrupt ring buffer.  These are all volatile, which tells the compiler an interrupt
+	// can change them at any time.  So it reads them from memory every time and doesn't
+	// move reads and writes of them around.
+
+	/**
+	 * Event codes queued by interrupt routines
+	 */
+	volatile int16_t _isrEventCodes[EVENT_ISR_QUEUE_SIZE];
+
+	/**
+	 * The values sent with those events
+	 */
+	volatile int16_t _isrEventValues[EVENT_ISR_QUEUE_SIZE];
+
+	/**
+	 * Lane and merge flags for those events
+	 */
+	volatile uint8_t _isrEventFlags[EVENT_ISR_QUEUE_SIZE];
+
+	/**
+	 * Position the next interrupt event will be written to.  Only interrupts change it.
+	 */
+	volatile uint8_t _isrHead;
+
+	/**
+	 * Position the next interrupt event will be read from.  Only loop() changes it.
+	 */
+	volatile uint8_t _isrTail;
+
+	/**
+	 * Number of interrupt events dropped because the interrupt ring buffer was full.
+	 * Kept apart from _droppedEventCount because only interrupts change it.
+	 */
+	volatile uint8_t _isrDroppedEventCount;
+
+	/**
+	 * Number of events dropped because their lane was full
+	 */
+	uint16_t _droppedEventCount;
+
+	/**
+	 * Number of events merged into an event that was already waiting
+	 */
+	uint16_t _mergedEventCount;
+
+	/**
+	 * Number of times processEventsWithinBudget() ran out of time with events still waiting
+	 */
+	uint16_t _budgetExceededCount;
+
+	/**
+	 * Records events as they go through the queue (only when EVENT_TRACE_ENABLED is 1)
+	 */
+	SCRadioEventTrace _trace;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioEventQueue
+	 *
+	 * @detail
+	 *   Creates an empty event queue
+	 */
+	SCRadioEventQueue();
+
+	/**
+	 * queueEvent
+	 *
+	 * @detail
+	 *   Adds an event to the end of its lane
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event (the payload's value or hertz)
+	 * @param[in] priority Which lane to add it to
+	 *
+	 * @returns false if the lane was full and the event was dropped
+	 */
+	bool queueEvent(int eventCode, int32_t eventValue, EventPriority priority = kLowPriority);
+
+	/**
+	 * queueMenuItemEvent
+	 *
+	 * @detail
+	 *   Adds an event saying a menu item's value changed to the end of its lane
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] menuItemId Number of the menu item
+	 * @param[in] menuItemValue The menu item's new value
+	 * @param[in] priority Which lane to add it to
+	 *
+	 * @returns false if the lane was full and the event was dropped
+	 */
+	bool queueMenuItemEvent(int eventCode, int8_t menuItemId, int16_t menuItemValue, EventPriority priority = kLowPriority);
+
+	/**
+	 * queueOrMergeEvent
+	 *
+	 * @detail
+	 *   Like queueEvent(), but if the newest event waiting in the lane has the same event code,
+	 *   this event's value is added to that one's instead of taking another slot.  If the two
+	 *   add up to zero the waiting event is removed.
+	 *
+	 *   Use this for events whose value is a count.  Five quick clicks then become one event with
+	 *   a value of 5, so the listeners only act once.  (The knob uses queueOrMergeKnobTurnEvent(),
+	 *   which works the same way but also carries how fast the knob turned.)
+	 *   Only the newest event is checked so events are never handled out of order.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event (the merged value stops at -32768 and 32767)
+	 * @param[in] priority Which lane to add it to
+	 *
+	 * @returns false if the event could not be merged and the lane was full
+	 */
+	bool queueOrMergeEvent(int eventCode, int16_t eventValue, EventPriority priority = kLowPriority);
+
+	/**
+	 * queueOrMergeKnobTurnEvent
+	 *
+	 * @detail
+	 *   Like queueOrMergeEvent() for the knob turned events.  The steps are added to a waiting
+	 *   event with the same code and its interval becomes the average over all of the steps, so
+	 *   a turn taken in several pieces carries the same speed as one taken at once.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] turnSteps Steps turned (+ is clockwise.  The merged steps stop at -32768 and 32767)
+	 * @param[in] stepIntervalMicros Average microseconds between the steps (65535 if not known)
+	 * @param[in] priority Which lane to add it to
+	 *
+	 * @returns false if the event could not be merged and the lane was full
+	 */
+	bool queueOrMergeKnobTurnEvent(int eventCode, int16_t turnSteps, uint16_t stepIntervalMicros, EventPriority priority = kLowPriority);
+
+	/**
+	 * queueEventFromISR
+	 *
+	 * @detail
+	 *   Like queueEvent() but safe to call from an interrupt routine (and only from one).
+	 *   The event is moved into its lane the next time events are processed.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event
+	 * @param[in] priority Which lane it goes to
+	 *
+	 * @returns false if the interrupt ring buffer was full and the event was dropped
+	 */
+	bool queueEventFromISR(int eventCode, int16_t eventValue, EventPriority priority = kLowPriority);
+
+	/**
+	 * queueOrMergeEventFromISR
+	 *
+	 * @detail
+	 *   Like queueOrMergeEvent() but safe to call from an interrupt routine (and only from one).
+	 *   The merge happens when the event is moved into its lane.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event
+	 * @param[in] priority Which lane it goes to
+	 *
+	 * @returns false if the interrupt ring buffer was full and the event was dropped
+	 */
+	bool queueOrMergeEventFromISR(int eventCode, int16_t eventValue, EventPriority priority = kLowPriority);
+
+	/**
+	 * processEvent
+	 *
+	 * @detail
+	 *   Handles the next waiting event (high priority first)
+	 *   ex: eventManager.processEvent<EventDispatcher>();
+	 *
+	 * @param Dispatcher SCRadioEventDispatcher that sends the event to its listeners
+	 *
+	 * @returns number of listeners called
+	 */
+	template <class Dispatcher>
+	int processEvent()
+	{
+		int16_t eventCode;
+		SCRadioEventPayload eventPayload;
+
+		moveISREventsToLanes();
+
+		if (!takeNextEvent(eventCode, eventPayload))
+		{
+			return 0;
+		}
+
+		return Dispatcher::dispatch(eventCode, eventPayload);
+	}
+
+	/**
+	 * processAllEvents
+	 *
+	 * @detail
+	 *   Handles events until none are waiting.  This includes events queued by the
+	 *   listeners along the way.  High priority events always go next.
+	 *   ex: eventManager.processAllEvents<EventDispatcher>();
+	 *
+	 * @param Dispatcher SCRadioEventDispatcher that sends the events to their listeners
+	 *
+	 * @returns number of listeners called
+	 */
+	template <class Dispatcher>
+	int processAllEvents()
+	{
+		int listenersCalled = 0;
+		int16_t eventCode;
+		SCRadioEventPayload eventPayload;
+
+		moveISREventsToLanes();
+
+		while (takeNextEvent(eventCode, eventPayload))
+		{
+			listenersCalled += Dispatcher::dispatch(eventCode, eventPayload);
+		}
+
+		return listenersCalled;
+	}
+
+	/**
+	 * processEventsWithinBudget
+	 *
+	 * @detail
+	 *   Handles events until none are waiting or budgetMicros has gone by.
+	 *   ex: eventManager.processEventsWithinBudget<EventDispatcher>(EVENT_PROCESSING_BUDGET_MICROS);
+	 *
+	 *   Each time round it:
+	 *     1. moves in the events the interrupt routines queued (the keyer's key line, the knob)
+	 *     2. handles every waiting high priority event (the key line and the knob)
+	 *     3. handles up to EVENT_PROCESSING_BATCH_SIZE normal events
+	 *
+	 *   So a key line event queued while a slow batch is handled waits for that batch
+	 *   and no more.  At least one batch is always handled so events can't be put off
+	 *   forever.  A slow listener (the display) can still go past the budget, but only by
+	 *   one batch.  High priority events queued during the last batch are handled before returning.
+	 *
+	 * @param Dispatcher SCRadioEventDispatcher that sends the events to their listeners
+	 * @param[in] budgetMicros how long to spend handling events (microseconds)
+	 *
+	 * @returns number of listeners called
+	 */
+	template <class Dispatcher>
+	int processEventsWithinBudget(uint16_t budgetMicros)
+	{
+		int listenersCalled = 0;
+		uint32_t startMicros = micros();
+
+		do
+		{
+			moveISREventsToLanes();
+
+			listenersCalled += processLaneEvents<Dispatcher>(kHighPriority, 0xFF);
+
+			if (isLaneEmpty(kLowPriority))
+			{
+				return listenersCalled;
+			}
+
+			listenersCalled += processLaneEvents<Dispatcher>(kLowPriority, EVENT_PROCESSING_BATCH_SIZE);
+		} while ((uint32_t)(micros() - startMicros) < budgetMicros);
+
+		// The key may have gone down or up during the last batch.  That can't wait for the next loop.
+		moveISREventsToLanes();
+		listenersCalled += processLaneEvents<Dispatcher>(kHighPriority, 0xFF);
+
+		if (!isLaneEmpty(kLowPriority) && (_budgetExceededCount < 0xFFFF))
+		{
+			_budgetExceededCount++;
+		}
+
+		return listenersCalled;
+	}
+
+	/**
+	 * getBudgetExceededCount
+	 *
+	 * @detail
+	 *   Returns how many times processEventsWithinBudget() ran out of time and left events
+	 *   for the next pass through loop()
+	 *
+	 * @returns count (stops at 65535)
+	 */
+	uint16_t getBudgetExceededCount();
+
+	/**
+	 * getDroppedEventCount
+	 *
+	 * @detail
+	 *   Returns how many events have been dropped because their lane (or the interrupt ring buffer) was full
+	 *
+	 * @returns count of dropped events (stops at 65535)
+	 */
+	uint16_t getDroppedEventCount();
+
+	/**
+	 * getMergedEventCount
+	 *
+	 * @detail
+	 *   Returns how many events queueOrMergeEvent() has merged into an event that was already waiting
+	 *
+	 * @returns count of merged events (stops at 65535)
+	 */
+	uint16_t getMergedEventCount();
+
+	/**
+	 * getHighWaterMark
+	 *
+	 * @detail
+	 *   Returns the most events that have been waiting in a lane at one time
+	 *
+	 * @param[in] priority which lane
+	 *
+	 * @returns high water mark
+	 */
+	uint8_t getHighWaterMark(EventPriority priority);
+
+	/**
+	 * getTrace
+	 *
+	 * @detail
+	 *   Returns the event trace so it can be printed or cleared (see SCRadioEventTrace)
+	 *
+	 * @returns the event trace
+	 */
+	SCRadioEventTrace &getTrace();
+
+private:
+	// private methods
+
+	/**
+	 * queuePayload
+	 *
+	 * @detail
+	 *   Adds an event to the end of its lane.  queueEvent() and queueMenuItemEvent() fill
+	 *   in the payload and then call this.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventPayload Value sent with the event
+	 * @param[in] priority Which lane to add it to
+	 *
+	 * @returns false if the lane was full and the event was dropped
+	 */
+	bool queuePayload(int eventCode, const SCRadioEventPayload &eventPayload, EventPriority priority);
+
+	/**
+	 * findNewestWaitingEvent
+	 *
+	 * @detail
+	 *   Finds the newest event waiting in a lane if it has the given event code.
+	 *   Used to merge an event into it.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] priority which lane
+	 *
+	 * @returns the waiting event's payload, or nullptr if the newest event is a different type (or none are waiting)
+	 */
+	SCRadioEventPayload *findNewestWaitingEvent(int eventCode, EventPriority priority);
+
+	/**
+	 * finishMerge
+	 *
+	 * @detail
+	 *   Counts and traces a merge.  Removes the newest waiting event if the merge cancelled it out.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value that was merged
+	 * @param[in] priority which lane
+	 * @param[in] cancelledOut true if the merged value came to zero
+	 */
+	void finishMerge(int eventCode, int32_t eventValue, EventPriority priority, bool cancelledOut);
+
+	/**
+	 * addCountsWithLimit
+	 *
+	 * @detail
+	 *   Adds two counts, stopping at -32768 and 32767
+	 *
+	 * @returns the sum
+	 */
+	static int16_t addCountsWithLimit(int32_t count1, int32_t count2);
+
+	/**
+	 * queueISREvent
+	 *
+	 * @detail
+	 *   Adds an event to the interrupt ring buffer.  Only called from interrupt routines.
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event
+	 * @param[in] flags lane and merge flags
+	 *
+	 * @returns false if the ring buffer was full and the event was dropped
+	 */
+	bool queueISREvent(int eventCode, int16_t eventValue, uint8_t flags);
+
+	/**
+	 * moveISREventsToLanes
+	 *
+	 * @detail
+	 *   Moves the events interrupt routines have queued into the normal lanes, oldest first.
+	 *   Only called from loop().
+	 */
+	void moveISREventsToLanes();
+
+	/**
+	 * takeNextEvent
+	 *
+	 * @detail
+	 *   Removes the next waiting event (high priority first)
+	 *
+	 * @param[out] eventCode Identifies which event type
+	 * @param[out] eventPayload Value sent with the event
+	 *
+	 * @returns false if no events were waiting
+	 */
+	bool takeNextEvent(int16_t &eventCode, SCRadioEventPayload &eventPayload);
+
+	/**
+	 * takeNextLaneEvent
+	 *
+	 * @detail
+	 *   Removes the next waiting event from one lane
+	 *
+	 * @param[in] priority which lane
+	 * @param[out] eventCode Identifies which event type
+	 * @param[out] eventPayload Value sent with the event
+	 *
+	 * @returns false if no events were waiting in the lane
+	 */
+	bool takeNextLaneEvent(EventPriority priority, int16_t &eventCode, SCRadioEventPayload &eventPayload);
+
+	/**
+	 * isLaneEmpty
+	 *
+	 * @detail
+	 *   Checks if any events are waiting in a lane
+	 *
+	 * @param[in] priority which lane
+	 *
+	 * @returns true if no events are waiting
+	 */
+	bool isLaneEmpty(EventPriority priority)
+	{
+		return _lanes[priority].head == _lanes[priority].tail;
+	}
+
+	/**
+	 * processLaneEvents
+	 *
+	 * @detail
+	 *   Handles events from one lane until it is empty or maxEvents have been handled
+	 *
+	 * @param Dispatcher SCRadioEventDispatcher that sends the events to their listeners
+	 * @param[in] priority which lane
+	 * @param[in] maxEvents most events to handle
+	 *
+	 * @returns number of listeners called
+	 */
+	template <class Dispatcher>
+	int processLaneEvents(EventPriority priority, uint8_t maxEvents)
+	{
+		int listenersCalled = 0;
+		int16_t eventCode;
+		SCRadioEventPayload eventPayload;
+
+		while ((maxEvents > 0) && takeNextLaneEvent(priority, eventCode, eventPayload))
+		{
+			listenersCalled += Dispatcher::dispatch(eventCode, eventPayload);
+			maxEvents--;
+		}
+
+		return listenersCalled;
+	}
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * SCRadioEventTrace.cpp - Class for recording what goes through the event queue
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+
+#include "SCRadioEventTrace.h"
+
+// When the trace is turned off everything is in the header (and does nothing)
+#if EVENT_TRACE_ENABLED
+
+// Constructor
+// The trace belongs to the event queue, which is created as a global before setup() runs.
+// Everything it sets here is plain memory so it is safe to do in a constructor.
+SCRadioEventTrace::SCRadioEventTrace() : _head(0), _count(0)
+{
+}
+
+void SCRadioEventTrace::record(EventTraceKind kind, int16_t eventCode, int32_t eventValue, uint8_t priority, uint8_t depth)
+{
+	SCRadioEventTraceRecord &traceRecord = _records[_head & (EVENT_TRACE_SIZE - 1)];
+
+	traceRecord.micros = micros();
+	traceRecord.eventCode = eventCode;
+	traceRecord.eventValue = eventValue;
+	traceRecord.kind = static_cast<int8_t>(kind);
+	traceRecord.priority = priority;
+	traceRecord.depth = depth;
+
+	_head++;
+
+	if (_count < EVENT_TRACE_SIZE)
+	{
+		_count++;
+	}
+}
+
+void SCRadioEventTrace::print()
+{
+	Serial.println(F("micros,kind,event,value,priority,depth"));
+
+	// _head - _count is the oldest record still held
+	for (uint8_t i = _head - _count; i != _head; i++)
+	{
+		SCRadioEventTraceRecord &traceRecord = _records[i & (EVENT_TRACE_SIZE - 1)];
+
+		Serial.print(traceRecord.micros);
+		Serial.print(',');
+
+		switch ((EventTraceKind)traceRecord.kind)
+		{
+		case EventTraceKind::QUEUED:
+			Serial.print(F("queued"));
+			break;
+		case EventTraceKind::MERGED:
+			Serial.print(F("merged"));
+			break;
+		case EventTraceKind::DROPPED:
+			Serial.print(F("dropped"));
+			break;
+		case EventTraceKind::DISPATCHED:
+			Serial.print(F("dispatched"));
+			break;
+		}
+
+		Serial.print(',');
+		Serial.print(traceRecord.eventCode);
+		Serial.print(',');
+		Serial.print(traceRecord.eventValue);
+		Serial.print(',');
+		Serial.print(traceRecord.priority);
+		Serial.print(',');
+		Serial.println(traceRecord.depth);
+	}
+}
+
+void SCRadioEventTrace::dump()
+{
+	Serial.write('E');
+	Serial.write('T');
+	Serial.write(_count);
+	Serial.write((uint8_t)sizeof(SCRadioEventTraceRecord));
+
+	for (uint8_t i = _head - _count; i != _head; i++)
+	{
+		// The Nano stores numbers low byte first, so the record can be sent just as it sits in memory
+		Serial.write((const uint8_t *)&_records[i & (EVENT_TRACE_SIZE - 1)], sizeof(SCRadioEventTraceRecord));
+	}
+}
+
+void SCRadioEventTrace::reset()
+{
+	_head = 0;
+	_count = 0;
+}
+
+#endif
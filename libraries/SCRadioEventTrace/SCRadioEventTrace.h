@@ -0,0 +1,168 @@
+/**
+ * SCRadioEventTrace.h - Class for recording what goes through the event queue
+ *
+ * Why does this exist?
+ *
+ * When tuning feels slow or the keyer stutters, it helps to see what the event queue was
+ * doing at the time.  The event queue hands each event to this class when it is queued,
+ * merged, dropped or sent to its listeners.  Each one is recorded with the micros() time,
+ * the event code and value, which lane it was in and how many events were waiting.
+ *
+ * The records are kept in a ring buffer of EVENT_TRACE_SIZE records.  Once it is full the
+ * oldest records are written over, so it always holds the most recent events.
+ *
+ * Matching up a QUEUED record with the DISPATCHED record for the same lane (they come
+ * out in the same order they went in) gives how long the event waited.
+ *
+ * It is only built when EVENT_TRACE_ENABLED is 1 in SCRadioConstants.h.
+ * Otherwise every method is empty and the compiler removes the calls.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioEventTrace_h
+#define SCRadioEventTrace_h
+
+#include "SCRadioConstants.h"
+
+static_assert((EVENT_TRACE_SIZE & (EVENT_TRACE_SIZE - 1)) == 0, "EVENT_TRACE_SIZE must be a power of 2");
+static_assert(EVENT_TRACE_SIZE <= 128, "EVENT_TRACE_SIZE must be 128 or less");
+
+class SCRadioEventTrace
+{
+#if EVENT_TRACE_ENABLED
+private:
+
+	/**
+	 * SCRadioEventTraceRecord
+	 *
+	 * @detail
+	 *   One recorded event.  dump() sends these exactly as they are laid out here.
+	 *   The Nano never adds padding between the fields, but a PC compiler would, so
+	 *   it is marked packed to keep it 13 bytes everywhere.
+	 */
+	struct __attribute__((packed)) SCRadioEventTraceRecord
+	{
+		/**
+		 * micros() reading when it was recorded
+		 */
+		uint32_t micros;
+
+		/**
+		 * Identifies which event type
+		 */
+		int16_t eventCode;
+
+		/**
+		 * Value sent with the event (the payload's value.  For menu item events this is the
+		 * menu item number and value packed together)
+		 */
+		int32_t eventValue;
+
+		/**
+		 * What happened (EventTraceKind)
+		 */
+		int8_t kind;
+
+		/**
+		 * Which lane (0 is high priority)
+		 */
+		uint8_t priority;
+
+		/**
+		 * Events waiting in the lane afterwards
+		 */
+		uint8_t depth;
+	};
+
+	static_assert(sizeof(SCRadioEventTraceRecord) == 13, "dump() says a trace record is 13 bytes");
+
+	// private member data
+
+	/**
+	 * The recorded events
+	 */
+	SCRadioEventTraceRecord _records[EVENT_TRACE_SIZE];
+
+	/**
+	 * Position the next record will be written to.  Only ever counts up (wraps at 256).
+	 */
+	uint8_t _head;
+
+	/**
+	 * Number of records held (stops at EVENT_TRACE_SIZE)
+	 */
+	uint8_t _count;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioEventTrace
+	 *
+	 * @detail
+	 *   Creates an empty trace
+	 */
+	SCRadioEventTrace();
+
+	/**
+	 * record
+	 *
+	 * @detail
+	 *   Records one event.  Called by the event queue.
+	 *
+	 * @param[in] kind what happened to the event
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventValue Value sent with the event
+	 * @param[in] priority which lane (0 is high priority)
+	 * @param[in] depth events waiting in the lane afterwards
+	 */
+	void record(EventTraceKind kind, int16_t eventCode, int32_t eventValue, uint8_t priority, uint8_t depth);
+
+	/**
+	 * print
+	 *
+	 * @detail
+	 *   Prints the trace over the serial port, oldest first.  One comma separated line per record:
+	 *   micros,kind,event,value,priority,depth
+	 */
+	void print();
+
+	/**
+	 * dump
+	 *
+	 * @detail
+	 *   Sends the trace over the serial port as binary, oldest first.  This is much quicker than print().
+	 *   Sends 'E', 'T', the number of records and the size of a record (13),
+	 *   then each record: micros (4 bytes), event (2), value (4), kind (1), priority (1), depth (1).
+	 *   Numbers are sent low byte first.
+	 */
+	void dump();
+
+	/**
+	 * reset
+	 *
+	 * @detail
+	 *   Clears the trace
+	 */
+	void reset();
+
+#else
+public:
+	// Trace turned off.  These do nothing and the compiler leaves them out.
+	void record(EventTraceKind, int16_t, int32_t, uint8_t, uint8_t) {}
+	void print() {}
+	void dump() {}
+	void reset() {}
+#endif
+};
+
+#endif
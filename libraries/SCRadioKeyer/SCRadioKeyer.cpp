@@ -39,16 +39,99 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "Arduino.h"
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 #include "SCRadioConstants.h"
-#include "SCRadioEventData.h"
 #include "SCRadioKeyer.h"
-#include "ISCRadioReadOnlyMenuItem.h"
 
-SCRadioKeyer::SCRadioKeyer(EventManager &eventManager,
-							SCRadioEventData &eventData) : 
+// Timer1 counts at F_CPU / 8 (2 MHz on the Nano).  This is how many counts make one tick.
+#define KEYER_TIMER_COUNTS_PER_TICK ((F_CPU / 8 / 1000000UL) * KEYER_TICK_MICROS)
+
+static_assert(KEYER_TIMER_COUNTS_PER_TICK <= 65536UL, "KEYER_TICK_MICROS is too long for Timer1");
+
+SCRadioKeyer *SCRadioKeyer::_tickKeyer = nullptr;
+
+// Timer1 compare match interrupt routine.  Runs every KEYER_TICK_MICROS.
+ISR(TIMER1_COMPA_vect)
+{
+	SCRadioKeyer::handleTimerTick();
+}
+
+// Short names so the tables below fit on the page
+#define ___ static_cast<uint8_t>(KeyerElement::NONE)
+#define DIT static_cast<uint8_t>(KeyerElement::DIT)
+#define DAH static_cast<uint8_t>(KeyerElement::DAH)
+#define MAN static_cast<uint8_t>(KeyerElement::MANUAL)
+
+/**
+ * What to send next, looked up by [keyer mode][element just sent][paddles].
+ * The paddles are the latch bits plus NEWEST_DAH_BIT, so the columns are:
+ *
+ *   none, dit, dah, both (dit pressed last), then the same four with dah pressed last.
+ *
+ * Kept in flash (PROGMEM) and read with pgm_read_byte().
+ */
+static const uint8_t kKeyerTransitions[KEYER_MODE_COUNT][KEYER_ELEMENT_COUNT][PADDLE_TRANSITION_BITS + 1] PROGMEM =
+{
+	// STRAIGHT_KEY (not used, processStraightKey() handles the straight key)
+	{
+		{ ___, ___, ___, ___,   ___, ___, ___, ___ },
+		{ ___, ___, ___, ___,   ___, ___, ___, ___ },
+		{ ___, ___, ___, ___,   ___, ___, ___, ___ },
+		{ ___, ___, ___, ___,   ___, ___, ___, ___ }
+	},
+	// IAMBICB (squeeze alternates, starting with the dit)
+	{
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT },    // after nothing
+		{ ___, DIT, DAH, DAH,   ___, DIT, DAH, DAH },    // after a dit
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT },    // after a dah
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT }     // after manual (not used)
+	},
+	// IAMBICA (same table as B.  Only the latching differs.)
+	{
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT },
+		{ ___, DIT, DAH, DAH,   ___, DIT, DAH, DAH },
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT },
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DIT }
+	},
+	// ULTIMATIC (squeeze repeats the paddle pressed last)
+	{
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DAH },
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DAH },
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DAH },
+		{ ___, DIT, DAH, DIT,   ___, DIT, DAH, DAH }
+	},
+	// BUG (dit paddle sends dits, dah paddle keys by hand)
+	{
+		{ ___, DIT, MAN, MAN,   ___, DIT, MAN, MAN },
+		{ ___, DIT, MAN, MAN,   ___, DIT, MAN, MAN },
+		{ ___, DIT, MAN, MAN,   ___, DIT, MAN, MAN },
+		{ ___, DIT, MAN, MAN,   ___, DIT, MAN, MAN }
+	}
+};
+
+#undef ___
+#undef DIT
+#undef DAH
+#undef MAN
+
+/**
+ * Whether each keyer mode listens to the paddles while the key is down, by [keyer mode]
+ */
+static const uint8_t kKeyerLatchesWhileKeyed[KEYER_MODE_COUNT] PROGMEM =
+{
+	false,   // STRAIGHT_KEY
+	true,    // IAMBICB
+	false,   // IAMBICA
+	false,   // ULTIMATIC
+	false    // BUG
+};
+
+SCRadioKeyer::SCRadioKeyer(SCRadioEventQueue &eventManager,
+							const SCRadioCWStoredMessage *storedMessages,
+							int8_t storedMessageCount) : 
 								_eventManager(eventManager),
-								_eventData(eventData)
+								_storedMessages(storedMessages),
+								_storedMessageCount(storedMessageCount)
 {
 	
 }
@@ -58,6 +141,7 @@ void SCRadioKeyer::begin()
 	_stuckKeyCheckPassed = false;
 
 	_inStuckKeyErrorState = false;
+	_stuckKeyErrorReported = false;
 
 	// Setup outputs
 	pinMode(CW_KEY_PADDLE_JACK_TIP_PIN, INPUT);      // sets CW Key Jack tip
@@ -69,8 +153,23 @@ void SCRadioKeyer::begin()
 	digitalWrite(CW_KEY_PADDLE_JACK_TIP_PIN, HIGH);  // Enable pullup resistors
 	digitalWrite(CW_KEY_PADDLE_JACK_RING_PIN, HIGH);     
 
+	// Looked up once here so each tick can read the port directly (much quicker than digitalRead)
+	_tipPort = portInputRegister(digitalPinToPort(CW_KEY_PADDLE_JACK_TIP_PIN));
+	_tipMask = digitalPinToBitMask(CW_KEY_PADDLE_JACK_TIP_PIN);
+	_ringPort = portInputRegister(digitalPinToPort(CW_KEY_PADDLE_JACK_RING_PIN));
+	_ringMask = digitalPinToBitMask(CW_KEY_PADDLE_JACK_RING_PIN);
+
 	_keyerMode = KeyerMode::STRAIGHT_KEY;  // default mode straight key
 	_keyerState = KeyerState::IDLE;  
+	_lastElement = KeyerElement::NONE;
+	_lastPaddles = 0;
+
+	_messagePlaying = false;
+	_messagePlayingReported = false;
+	_elementMicrosRemaining = 0;
+
+	_straightKeyStatus = KeyStatus::RELEASED;
+	_straightKeyDebounceTicks = 0;
 
 	_keyerControl = 0;
 	
@@ -78,213 +177,448 @@ void SCRadioKeyer::begin()
 	// _keyerControl |= PDLSWAP_BIT;
 
 	_keyerWPM = 12;                        // default speed 12 WPM
+	_effectiveWPM = KEYER_DEFAULT_EFFECTIVE_WPM;
+	_dahRatioTenths = KEYER_DEFAULT_DAH_RATIO_TENTHS;
+	_compensationMicros = KEYER_DEFAULT_COMPENSATION_MICROS;
 
-	loadWPM(_keyerWPM);                    // Set element timing to match
+	loadTiming();                          // Set element timing to match
 	                                       // selected WPM
+
+	// Everything is set up.  Now the ticks can start.
+	startTimerTick();
+}
+
+void SCRadioKeyer::startTimerTick()
+{
+	_tickKeyer = this;
+
+	noInterrupts();
+
+	TCCR1A = 0;                              // no output pins, plain counting
+	TCCR1B = _BV(WGM12) | _BV(CS11);         // CTC mode (count up to OCR1A then start over), clock / 8
+	TCNT1 = 0;
+	OCR1A = KEYER_TIMER_COUNTS_PER_TICK - 1; // counts 0 through OCR1A, so one less
+	TIMSK1 |= _BV(OCIE1A);                   // interrupt each time it reaches OCR1A
+
+	interrupts();
+}
+
+void SCRadioKeyer::handleTimerTick()
+{
+	_tickKeyer->tick();
 }
 
 void SCRadioKeyer::loop()
 {
+	// The keying is all done in tick().  Here we tell the menu when a message has ended
+	// (on its own or because a paddle broke in)
+	if (_messagePlayingReported && !_messagePlaying)
+	{
+		_messagePlayingReported = false;
+
+		_eventManager.queueMenuItemEvent(static_cast<int>(EventType::KEYER_MESSAGE_EXTERNALLY_CHANGED), EVENT_PAYLOAD_NO_MENU_ITEM, 0);
+	}
+
+	// and tell the display about the stuck key error when it starts or ends.  Once is enough.
+	bool inStuckKeyErrorState = _inStuckKeyErrorState;
+
+	if (inStuckKeyErrorState == _stuckKeyErrorReported)
+	{
+		return;
+	}
+
+	_stuckKeyErrorReported = inStuckKeyErrorState;
+
+	if (inStuckKeyErrorState)
+	{
+		_eventManager.queueEvent(
+			static_cast<int>(EventType::ERROR_OCCURRED), 
+				static_cast<int>(ErrorType::STUCK_KEY));
+	}
+	else
+	{
+		// the following makes the display clear the error message
+		_eventManager.queueEvent(
+			static_cast<int>(EventType::ERROR_CLEARED), 
+				static_cast<int>(ErrorType::STUCK_KEY));
+	}
+}
+
+void SCRadioKeyer::tick()
+{
+	if (_messagePlaying)
+	{
+		processMessage();
+		return;
+	}
+
 	if (_keyerMode == KeyerMode::STRAIGHT_KEY) 
 	{
-		// Straight Key Mode
-		// Watch tip only
-		if (digitalRead(CW_KEY_PADDLE_JACK_TIP_PIN) == LOW)
+		processStraightKey();
+		return;
+	}
+
+	uint8_t paddles = readPaddles();
+
+	// Ultimatic needs to know which paddle went down last
+	uint8_t newlyPressedPaddles = paddles & ~_lastPaddles;
+	_lastPaddles = paddles;
+
+	if (newlyPressedPaddles == DAH_LATCH_BIT)
+	{
+		_keyerControl |= NEWEST_DAH_BIT;
+	}
+	else if (newlyPressedPaddles == DIT_LATCH_BIT)
+	{
+		_keyerControl &= ~NEWEST_DAH_BIT;
+	}
+
+	switch (_keyerState)
+	{
+	case KeyerState::IDLE:      // Wait for a paddle press
+		if (paddles == 0)
 		{
-			if (!_stuckKeyCheckPassed)
-			{
-				_eventManager.queueEvent(
-					static_cast<int>(EventType::ERROR_OCCURRED), 
-						static_cast<int>(ErrorType::STUCK_KEY));
+			// Sat idle for a tick.  Nothing left over from the last element to take off the next.
+			_elementMicrosRemaining = 0;
 
-				_inStuckKeyErrorState = true;
+			_inStuckKeyErrorState = false;
+			_stuckKeyCheckPassed = true;
+			break;
+		}
 
-				return;
-			}
-			_eventManager.queueEvent(
-				static_cast<int>(EventType::KEY_LINE_CHANGED), 
-					static_cast<int>(KeyStatus::PRESSED));
+		if (!_stuckKeyCheckPassed)
+		{
+			// loop() tells the display
+			_inStuckKeyErrorState = true;
+			break;
 		}
-		else {
-			if (_inStuckKeyErrorState)
-			{
-				_inStuckKeyErrorState = false;
-				_eventManager.queueEvent(
-					static_cast<int>(EventType::FREQUENCY_CHANGED),
-					static_cast<int>(EventFrequencyField::OPERATING_FREQUENCY));
-			}
 
-			_stuckKeyCheckPassed = true;
+		updatePaddleLatch(paddles);
+		startNextElement();
+		break;
 
-			_eventManager.queueEvent(
-				static_cast<int>(EventType::KEY_LINE_CHANGED), 
-					static_cast<int>(KeyStatus::RELEASED));
+	case KeyerState::KEYED:      // Wait for timer to expire
+		if (pgm_read_byte(&kKeyerLatchesWhileKeyed[static_cast<int8_t>(_keyerMode)]))
+		{
+			updatePaddleLatch(paddles);     // early paddle latch in Iambic B mode
 		}
 
-	}
-	else {
+		_elementMicrosRemaining -= KEYER_TICK_MICROS;
 
-		// _keyerControl contains processing flags and keyer mode bits
-		// Supports Iambic A and B
-		// State machine based, uses calls to millis() for timing.
-		switch (_keyerState)
+		if (_elementMicrosRemaining <= 0)  // are we at end of key down ?
 		{
-		case KeyerState::IDLE:      // Wait for direct or latched paddle press
-			if ((digitalRead(CW_KEY_PADDLE_JACK_TIP_PIN) == LOW) || 
-					(digitalRead(CW_KEY_PADDLE_JACK_RING_PIN) == LOW) || 
-						(_keyerControl & (DIT_LATCH_BIT + DAH_LATCH_BIT)))
-			{
-				if(!_stuckKeyCheckPassed)
-				{
-					_eventManager.queueEvent(
-						static_cast<int>(EventType::ERROR_OCCURRED), 
-							static_cast<int>(ErrorType::STUCK_KEY));
+			sendKeyLineChange(KeyStatus::RELEASED);   // Stop transmit
+
+			_elementMicrosRemaining += _timing.elementSpaceMicros;    // inter-element time
 
-					_inStuckKeyErrorState = true;
+			_keyerState = KeyerState::INTER_ELEMENT;      // next state
+		}
+		break;
 
-					return;
-				}
+	case KeyerState::MANUAL_KEYED:      // Bug mode dah.  Key down until the paddle is let go.
+		if (!(paddles & DAH_LATCH_BIT))
+		{
+			sendKeyLineChange(KeyStatus::RELEASED);
 
-				updatePaddleLatch();
-				_keyerState = KeyerState::CHK_DIT;
-			}
-			else
-			{
-				if (_inStuckKeyErrorState)
-				{
-					_inStuckKeyErrorState = false;
+			// A space afterward also rides out any contact bounce
+			_elementMicrosRemaining = _timing.elementSpaceMicros;
 
-					// the following makes the display update and clear the error message
-					_eventManager.queueEvent(
-						static_cast<int>(EventType::FREQUENCY_CHANGED), 
-							static_cast<int>(EventFrequencyField::OPERATING_FREQUENCY));
-				}
+			_keyerState = KeyerState::INTER_ELEMENT;
+		}
+		break;
 
-				_stuckKeyCheckPassed = true;
-			}
-			break;
+	case KeyerState::INTER_ELEMENT:      // Insert time between dits/dahs
+		updatePaddleLatch(paddles);        // latch paddle state
 
-		case KeyerState::CHK_DIT:      // See if the dit paddle was pressed
-			if (_keyerControl & DIT_LATCH_BIT)
-			{
-				_keyerControl |= DIT_PROC_BIT;
-				_keyerTimer = _ditTime;
-				_keyerState = KeyerState::KEYED_PREP;
-			}
-			else {
-				_keyerState = KeyerState::CHK_DAH;
-			}
-			break;
+		_elementMicrosRemaining -= KEYER_TICK_MICROS;
 
-		case KeyerState::CHK_DAH:      // See if dah paddle was pressed
-			if (_keyerControl & DAH_LATCH_BIT)
+		if (_elementMicrosRemaining <= 0)  // are we at end of inter-space ? 
+		{
+			// The paddle for the element just sent only repeats it if it is still held now.
+			// (Otherwise a quick tap could be latched while its own dit was being sent.)
+			if (_lastElement == KeyerElement::DIT)
 			{
-				_keyerTimer = _ditTime * DAH_TIMING_MULTIPLE;
-				_keyerState = KeyerState::KEYED_PREP;
+				_keyerControl &= ~DIT_LATCH_BIT;
 			}
-			else {
-				_keyerState = KeyerState::IDLE;
+			else if (_lastElement != KeyerElement::NONE)
+			{
+				_keyerControl &= ~DAH_LATCH_BIT;
 			}
-			break;
+			updatePaddleLatch(paddles);
 
-		case KeyerState::KEYED_PREP:	// Assert key down, start timing, 
-										// state shared for dit or dah
-			_eventManager.queueEvent(
-				static_cast<int>(EventType::KEY_LINE_CHANGED), 
-					static_cast<int>(KeyStatus::PRESSED),
-						EventManager::kHighPriority);       // tell rig to 
-															// transmit
+			// Right away, so the next element starts exactly when the space ends
+			startNextElement();
+		}
+		break;
+	}
+}
 
-			_keyerTimer += millis();                // set _keyerTimer to  
-													// interval end time
+void SCRadioKeyer::processMessage()
+{
+	uint8_t paddles = readPaddles();
 
-			_keyerControl &= ~(DIT_LATCH_BIT + DAH_LATCH_BIT);  // clear both 
-																// paddle latch 
-																// bits
+	// Break in.  The paddles take over after a space.
+	if (paddles != 0)
+	{
+		stopKeying();
 
-			_keyerState = KeyerState::KEYED;                  // next state
-			break;
+		updatePaddleLatch(paddles);
+		_elementMicrosRemaining = _timing.elementSpaceMicros;
+		_keyerState = KeyerState::INTER_ELEMENT;
+		return;
+	}
 
-		case KeyerState::KEYED:      // Wait for timer to expire
-			if (millis() > _keyerTimer)  // are we at end of key down ?
-			{
-				_eventManager.queueEvent(
-					static_cast<int>(EventType::KEY_LINE_CHANGED),
-					static_cast<int>(KeyStatus::RELEASED),
-					EventManager::kHighPriority);     // Stop transmit
+	_elementMicrosRemaining -= KEYER_TICK_MICROS;
 
-				_keyerTimer = millis() + _ditTime;     // inter-element time
+	if (_elementMicrosRemaining > 0)
+	{
+		return;
+	}
 
-				_keyerState = KeyerState::INTER_ELEMENT;      // next state
-			}
-			else if (_keyerMode == KeyerMode::IAMBICB) 
-			{
-				updatePaddleLatch();     // early paddle latch in Iambic B mode
-			}
-			break;
+	if (_keyerState == KeyerState::KEYED)
+	{
+		sendKeyLineChange(KeyStatus::RELEASED);
 
-		case KeyerState::INTER_ELEMENT:      // Insert time between dits/dahs
-			updatePaddleLatch();               // latch paddle state
-			if (millis() > _keyerTimer)  // are we at end of inter-space ? 
+		_elementMicrosRemaining += _timing.elementSpaceMicros;    // inter-element time
+
+		_keyerState = KeyerState::INTER_ELEMENT;
+		return;
+	}
+
+	startNextMessageElement();
+}
+
+void SCRadioKeyer::startNextMessageElement()
+{
+	// Finished the character?  Move on to the next one.
+	if (_messageCharacterCode <= 1)
+	{
+		// The element space was just sent.  Lengthening it to the space between characters.
+		// (None before the first character.)
+		uint32_t spaceMicros = (_messagePosition == 0) ? 0 : _timing.characterSpaceMicros;
+
+		uint8_t code = pgm_read_byte(_messageCodes + _messagePosition);
+
+		// And again to the space between words
+		while (code == CW_WORD_SPACE_CODE)
+		{
+			spaceMicros += _timing.wordSpaceMicros;
+			_messagePosition++;
+			code = pgm_read_byte(_messageCodes + _messagePosition);
+		}
+
+		if (code == CW_END_OF_MESSAGE_CODE)
+		{
+			if (_messageRepeatMicros == 0)
 			{
-				if (_keyerControl & DIT_PROC_BIT)      // was it a dit or dah?
-				{
-					_keyerControl &= ~(DIT_LATCH_BIT + DIT_PROC_BIT); // clear
-																// latch bits
-
-					_keyerState = KeyerState::CHK_DAH;		// dit done, 
-															// check for dah
-				}
-				else {
-					_keyerControl &= ~(DAH_LATCH_BIT);       // clear dah latch
-					_keyerState = KeyerState::IDLE;          // go idle
-				}
+				// All done
+				_messagePlaying = false;
+				_keyerState = KeyerState::IDLE;
+				return;
 			}
-			break;
+
+			// Wait, then start over
+			_messagePosition = 0;
+			_elementMicrosRemaining += _messageRepeatMicros;
+			return;
+		}
+
+		_messagePosition++;
+		_messageCharacterCode = code;
+
+		if (spaceMicros > 0)
+		{
+			_elementMicrosRemaining += spaceMicros;
+			return;
 		}
 	}
-}  // End Main Loop
 
-void SCRadioKeyer::keyerModeChangedListener(int eventCode, int whichMenuItem)
+	// The low bit is the next element (1 is a dah)
+	_elementMicrosRemaining += (_messageCharacterCode & 1) ? _timing.dahKeyedMicros : _timing.ditKeyedMicros;
+	_messageCharacterCode >>= 1;
+
+	sendKeyLineChange(KeyStatus::PRESSED);
+
+	_keyerState = KeyerState::KEYED;
+}
+
+void SCRadioKeyer::stopKeying()
+{
+	if ((_keyerState == KeyerState::KEYED) || (_keyerState == KeyerState::MANUAL_KEYED)
+		|| (_straightKeyStatus == KeyStatus::PRESSED))
+	{
+		sendKeyLineChange(KeyStatus::RELEASED);
+	}
+
+	_straightKeyStatus = KeyStatus::RELEASED;
+
+	_messagePlaying = false;
+
+	_keyerState = KeyerState::IDLE;
+	_lastElement = KeyerElement::NONE;
+	_keyerControl &= ~(DIT_LATCH_BIT + DAH_LATCH_BIT);
+}
+
+void SCRadioKeyer::startNextElement()
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
+	KeyerElement nextElement = KeyerElement(pgm_read_byte(&kKeyerTransitions
+		[static_cast<int8_t>(_keyerMode)]
+		[static_cast<int8_t>(_lastElement)]
+		[_keyerControl & PADDLE_TRANSITION_BITS]));
+
+	_keyerControl &= ~(DIT_LATCH_BIT + DAH_LATCH_BIT);  // clear both paddle latch bits
 
-	long menuItemValue = menuItem->getMenuItemValue();
+	_lastElement = nextElement;
 
-	_keyerMode = KeyerMode(menuItemValue);
+	switch (nextElement)
+	{
+	case KeyerElement::NONE:
+		_keyerState = KeyerState::IDLE;
+		return;
+
+	case KeyerElement::DIT:
+		_elementMicrosRemaining += _timing.ditKeyedMicros;
+		_keyerState = KeyerState::KEYED;
+		break;
+
+	case KeyerElement::DAH:
+		_elementMicrosRemaining += _timing.dahKeyedMicros;
+		_keyerState = KeyerState::KEYED;
+		break;
+
+	case KeyerElement::MANUAL:
+		_keyerState = KeyerState::MANUAL_KEYED;
+		break;
+	}
+
+	sendKeyLineChange(KeyStatus::PRESSED);   // tell rig to transmit
 }
 
-void SCRadioKeyer::keyerSpeedChangedListener(int eventCode, int whichMenuItem)
+void SCRadioKeyer::keyerModeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
+	setKeyerMode(KeyerMode(eventPayload.menuItem.value));
+}
 
-	_keyerWPM = menuItem->getMenuItemValue();
+void SCRadioKeyer::keyerSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setKeyerWPM(eventPayload.menuItem.value);
+}
 
-	loadWPM(_keyerWPM);
+void SCRadioKeyer::keyerEffectiveSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setKeyerEffectiveWPM(eventPayload.menuItem.value);
 }
 
-void SCRadioKeyer::keyerPaddlesOrientationChangedListener(int eventCode, int whichMenuItem)
+void SCRadioKeyer::keyerDahRatioChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
+	setDahRatio(eventPayload.menuItem.value);
+}
 
-	long paddlesOrientation = menuItem->getMenuItemValue();
+void SCRadioKeyer::keyerCompensationChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setCompensation(eventPayload.menuItem.value);
+}
 
-	setPaddlesOrientation(PaddlesOrientation(paddlesOrientation));
+void SCRadioKeyer::keyerPaddlesOrientationChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setPaddlesOrientation(PaddlesOrientation(eventPayload.menuItem.value));
 }
 
 void SCRadioKeyer::setKeyerMode(KeyerMode newKeyerMode)
 {
+	// Holding off the timer interrupt so it doesn't key the rig in the middle of this
+	noInterrupts();
+
+	// If we change modes with the key down, nothing would ever unkey the
+	// transmitter.  So, we do it here.  The new mode starts fresh.
+	stopKeying();
+
 	_keyerMode = newKeyerMode;
+
+	interrupts();
+}
+
+void SCRadioKeyer::keyerMessageChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	int8_t messageNumber = eventPayload.menuItem.value;
+
+	if ((messageNumber < 1) || (messageNumber > _storedMessageCount))
+	{
+		stopMessage();
+		return;
+	}
+
+	const SCRadioCWStoredMessage &storedMessage = _storedMessages[messageNumber - 1];
+
+	playMessage(storedMessage.codes, storedMessage.repeatSeconds);
+}
+
+void SCRadioKeyer::playMessage(const uint8_t *messageCodes, uint8_t repeatSeconds)
+{
+	noInterrupts();
+
+	stopKeying();
+
+	_messageCodes = messageCodes;
+	_messagePosition = 0;
+	_messageCharacterCode = 1;
+	_messageRepeatMicros = repeatSeconds * 1000000UL;
+
+	// The first element starts on the next tick
+	_elementMicrosRemaining = KEYER_TICK_MICROS;
+	_keyerState = KeyerState::INTER_ELEMENT;
+
+	_messagePlaying = true;
+
+	interrupts();
+
+	_messagePlayingReported = true;
+}
+
+void SCRadioKeyer::stopMessage()
+{
+	noInterrupts();
+
+	if (_messagePlaying)
+	{
+		stopKeying();
+	}
+
+	interrupts();
+
+	_messagePlayingReported = false;
 }
 
 void SCRadioKeyer::setKeyerWPM(int8_t keyerWPM)
 {
 	_keyerWPM = keyerWPM;
-	loadWPM(_keyerWPM);
+	loadTiming();
+}
+
+void SCRadioKeyer::setKeyerEffectiveWPM(int8_t effectiveWPM)
+{
+	_effectiveWPM = effectiveWPM;
+	loadTiming();
+}
+
+void SCRadioKeyer::setDahRatio(int8_t dahRatioTenths)
+{
+	_dahRatioTenths = dahRatioTenths;
+	loadTiming();
+}
+
+void SCRadioKeyer::setCompensation(uint16_t compensationMicros)
+{
+	_compensationMicros = compensationMicros;
+	loadTiming();
 }
 
 void SCRadioKeyer::setPaddlesOrientation(PaddlesOrientation orientation)
 {
+	// The timer interrupt changes the latch bits in _keyerControl too.  Changing it with
+	// the interrupt held off keeps either change from being lost.
+	noInterrupts();
+
 	if (orientation == PaddlesOrientation::NORMAL)
 	{
 		// clear paddle swap bit
@@ -295,34 +629,143 @@ void SCRadioKeyer::setPaddlesOrientation(PaddlesOrientation orientation)
 		_keyerControl |= PDLSWAP_BIT;
 	}
 
+	interrupts();
 }
 
-void SCRadioKeyer::updatePaddleLatch()
+void SCRadioKeyer::processStraightKey()
 {
-	if (digitalRead(CW_KEY_PADDLE_JACK_RING_PIN) == LOW) {
-		if (_keyerControl & PDLSWAP_BIT)
-		{
-			_keyerControl |= DIT_LATCH_BIT;
-		}
-		else
+	// Straight Key Mode
+	// Watch tip only (LOW is pressed)
+	KeyStatus keyStatus = ((*_tipPort & _tipMask) == 0) ? KeyStatus::PRESSED : KeyStatus::RELEASED;
+
+	if (keyStatus == KeyStatus::PRESSED)
+	{
+		if (!_stuckKeyCheckPassed)
 		{
-			_keyerControl |= DAH_LATCH_BIT;
+			// loop() tells the display.  Only once, not on every tick.
+			_inStuckKeyErrorState = true;
+
+			return;
 		}
 	}
-	if (digitalRead(CW_KEY_PADDLE_JACK_TIP_PIN) == LOW) {
-		if (_keyerControl & PDLSWAP_BIT)
-		{
-			_keyerControl |= DAH_LATCH_BIT;
-		}
-		else
-		{
-			_keyerControl |= DIT_LATCH_BIT;
-		}
+	else {
+		_inStuckKeyErrorState = false;
+		_stuckKeyCheckPassed = true;
+	}
+
+	// Key contacts bounce.  The first change is acted on right away (so there is no
+	// added delay keying the rig) and then further changes are ignored until the
+	// debounce time has passed.
+	if (_straightKeyDebounceTicks > 0)
+	{
+		_straightKeyDebounceTicks--;
+		return;
+	}
+
+	// We only send a message when the key actually changes.  Sending one every tick
+	// would flood the event queue and reload the DDS over and over.
+	if (keyStatus == _straightKeyStatus)
+	{
+		return;
+	}
+
+	_straightKeyStatus = keyStatus;
+	_straightKeyDebounceTicks = (STRAIGHT_KEY_DEBOUNCE_MS * 1000UL) / KEYER_TICK_MICROS;
+
+	sendKeyLineChange(keyStatus);
+}
+
+void SCRadioKeyer::sendKeyLineChange(KeyStatus keyStatus)
+{
+	_eventManager.queueEventFromISR(
+		static_cast<int>(EventType::KEY_LINE_CHANGED), 
+			static_cast<int>(keyStatus),
+				SCRadioEventQueue::kHighPriority);
+}
+
+uint8_t SCRadioKeyer::readPaddles()
+{
+	// One read of the port gets both paddles when they share it
+	uint8_t tipPortPins = *_tipPort;
+	uint8_t ringPortPins = (_ringPort == _tipPort) ? tipPortPins : *_ringPort;
+
+	// LOW is pressed
+	bool tipPressed = ((tipPortPins & _tipMask) == 0);
+	bool ringPressed = ((ringPortPins & _ringMask) == 0);
+
+	uint8_t paddles = 0;
+
+	// The tip is normally the dit paddle
+	if (tipPressed)
+	{
+		paddles |= (_keyerControl & PDLSWAP_BIT) ? DAH_LATCH_BIT : DIT_LATCH_BIT;
 	}
 
+	if (ringPressed)
+	{
+		paddles |= (_keyerControl & PDLSWAP_BIT) ? DIT_LATCH_BIT : DAH_LATCH_BIT;
+	}
+
+	return paddles;
+}
+
+void SCRadioKeyer::updatePaddleLatch(uint8_t paddles)
+{
+	_keyerControl |= paddles;
+}
+
+void SCRadioKeyer::loadTiming()
+{
+	// Worked out here, outside the interrupt, where the divides don't hold anything up
+	SCRadioKeyerTiming timing;
+
+	timing.calculate(_keyerWPM, _effectiveWPM, _dahRatioTenths, _compensationMicros);
+
+	// 32 bits takes more than one instruction to write.  Holding off the timer
+	// interrupt so it never sees half of the old values and half of the new.
+	noInterrupts();
+	_timing = timing;
+	interrupts();
 }
 
-void SCRadioKeyer::loadWPM(int8_t wpm)
+void SCRadioKeyerTiming::calculate(int8_t characterWPM, int8_t effectiveWPM, int8_t dahRatioTenths, uint16_t compensationMicros)
 {
-	_ditTime = 1200 / wpm;
+	if (characterWPM < 1)
+	{
+		characterWPM = 1;
+	}
+
+	// 1200 ms per dit at 1 WPM (the PARIS standard), in microseconds
+	uint32_t ditMicros = 1200000UL / characterWPM;
+	// (worked out from the speed, not the dit, so the dit's rounding isn't multiplied)
+	uint32_t dahMicros = (120000UL * dahRatioTenths) / characterWPM;
+
+	// Any more and there would be hardly any space left between elements
+	if (compensationMicros > ditMicros / 2)
+	{
+		compensationMicros = ditMicros / 2;
+	}
+
+	ditKeyedMicros = ditMicros + compensationMicros;
+	dahKeyedMicros = dahMicros + compensationMicros;
+	elementSpaceMicros = ditMicros - compensationMicros;
+
+	// Normally 3 dits between characters and 7 between words
+	uint32_t characterSpaceTotalMicros = 3 * ditMicros;
+	uint32_t wordSpaceTotalMicros = 7 * ditMicros;
+
+	if ((effectiveWPM > 0) && (effectiveWPM < characterWPM))
+	{
+		// Farnsworth (the ARRL formula).  PARIS is 31 dits of characters and 19 dits of spaces.
+		// At the effective speed it takes 60 / effectiveWPM seconds.  The characters still
+		// take 31 dits at the keyer speed (37.2 / characterWPM seconds).  What's left is
+		// shared out over the 19 dits of space.
+		uint32_t spacesMicros = (60000000UL / effectiveWPM) - (37200000UL / characterWPM);
+
+		characterSpaceTotalMicros = (3 * spacesMicros) / 19;
+		wordSpaceTotalMicros = (7 * spacesMicros) / 19;
+	}
+
+	characterSpaceMicros = characterSpaceTotalMicros - ditMicros;
+	wordSpaceMicros = wordSpaceTotalMicros - characterSpaceTotalMicros;
 }
\ No newline at end of file
@@ -36,22 +36,85 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+ * Timing
+ *
+ * The keyer used to time dits and dahs in whole milliseconds with millis() and was only
+ * checked once each pass through loop().  At 30 WPM a dit is 40 ms, so being a millisecond
+ * off plus however long the loop took was easy to hear.
+ *
+ * Now Timer1 interrupts every KEYER_TICK_MICROS (100 microseconds) and the keyer does all of
+ * its work there: it reads the paddles, runs the state machine and times each element in
+ * microseconds.  Elements count down, so there is no clock reading to roll over.  Whatever
+ * an element runs past its tick is taken off the next element, so the timing doesn't drift.
+ *
+ * The interrupt only sends key line changes (through the event queue's interrupt safe
+ * queueEventFromISR()).  loop() just reports the stuck key error, which isn't time critical.
+ *
+ * The length of each element and space is worked out once, when a setting changes
+ * (see SCRadioKeyerTiming), so the interrupt just adds them up:
+ *
+ *   Speed           sets the dit: 1.2 seconds / WPM (the PARIS standard)
+ *   Dah length      in tenths of a dit.  30 is the usual 3 to 1.
+ *   Effective speed Farnsworth spacing for stored messages.  Characters are sent at the keyer
+ *                   speed with longer spaces between them and between words, so the message
+ *                   takes as long as it would at this speed.  0 (or the keyer speed or faster) is off.
+ *   Compensation    microseconds added to each key down and taken off the space after it.  Makes
+ *                   up for the rig taking longer to start sending (the DDS has to be loaded with
+ *                   the transmit frequency) than it takes to stop.
+ */
+
+/*
+ * Modes
+ *
+ * Each tick reads both paddles with one read of their port.  A paddle pressed at any time
+ * while the keyer is listening is 'latched' (remembered) until the next element starts.
+ *
+ * When an element and its space are done, the keyer looks up what to send next in a table
+ * (kKeyerTransitions in SCRadioKeyer.cpp).  The table is indexed by the keyer mode, the
+ * element just sent and the latched paddles.  That lookup is the only place the modes differ,
+ * apart from whether the paddles are listened to while the key is down:
+ *
+ *   Iambic A   Squeeze both paddles for alternating dits and dahs.  Let go and it stops
+ *              after the element being sent.
+ *   Iambic B   Same, but the paddles are also listened to while the key is down, so letting
+ *              go of a squeeze sends one more (opposite) element.
+ *   Ultimatic  Squeezing sends the element of whichever paddle was pressed last, over and over.
+ *              Let go of one paddle and the other one's element continues.
+ *   Bug        The dit paddle sends dits.  The dah paddle keys the rig for as long as it is
+ *              held, like the dah side of a semi-automatic 'bug' key.
+ */
+
+/*
+ * Stored messages
+ *
+ * The keyer can also send the messages given to its constructor (see SCRadioCWMessage.h).
+ * They are sent from the same timer tick at the keyer's speed and key the rig through the
+ * same key line changed events.  Touching a paddle (or the straight key) stops the message
+ * so you can break in.  A message can repeat after a wait, for a beacon.
+ *
+ * The keyer mode menu isn't involved.  The message menu item sends KEYER_MESSAGE_CHANGED with
+ * the message number (1 is the first, 0 stops).  When a message ends on its own or is broken
+ * into, loop() sends KEYER_MESSAGE_EXTERNALLY_CHANGED with 0 so the menu item shows it stopped.
+ */
+
 #ifndef SCRadioKeyer_h
 #define SCRadioKeyer_h
 
+#include "SCRadioEventPayload.h"
+#include "SCRadioCWMessage.h"
+
 ///////////////////////////////////////////////////////////////////////////////
 //  keyerControl bit definitions
 //
 #define     DIT_LATCH_BIT  0x01     // Dit latch
 #define     DAH_LATCH_BIT  0x02     // Dah latch
-#define     DIT_PROC_BIT   0x04     // Dit is being processed
+#define     NEWEST_DAH_BIT 0x04     // 1 if dah was the paddle pressed last (Ultimatic)
 #define     PDLSWAP_BIT    0x08     // 0 for normal, 1 for swap
-#define     IAMBICB_BIT    0x10     // 0 for Iambic A, 1 for B   (Not Used)
-#define     ULTIMATIC_BIT  0x20     // 1 for ultimatic           (Not used)
-#define     STRAIGHT_BIT   0x80     // 1 for straight key mode   (Not Used)
 //////////////////////////////////////////////////////////////////////////////
 
-#define		DAH_TIMING_MULTIPLE 3
+// The latch and newest paddle bits together, as used to index the transition table
+#define     PADDLE_TRANSITION_BITS (DIT_LATCH_BIT | DAH_LATCH_BIT | NEWEST_DAH_BIT)
 
 /**
  * CW Keyer states enum
@@ -59,13 +122,75 @@
 enum class KeyerState : int8_t
 {
 	IDLE = 0,
-	CHK_DIT,
-	CHK_DAH,
-	KEYED_PREP,
-	KEYED,
+	KEYED,           // sending a timed dit or dah
+	MANUAL_KEYED,    // key down for as long as the dah paddle is held (bug mode)
 	INTER_ELEMENT
 };
 
+/**
+ * What the keyer sends.  The transition table holds these.
+ */
+enum class KeyerElement : int8_t
+{
+	NONE = 0,
+	DIT,
+	DAH,
+	MANUAL
+};
+
+/**
+ * Number of KeyerElement values
+ */
+#define KEYER_ELEMENT_COUNT 4
+
+/**
+ * SCRadioKeyerTiming
+ *
+ * @detail
+ *   How long each element and space lasts (microseconds).  Worked out once by
+ *   calculate() when a setting changes.
+ */
+struct SCRadioKeyerTiming
+{
+	/**
+	 * Key down for a dit
+	 */
+	uint32_t ditKeyedMicros;
+
+	/**
+	 * Key down for a dah
+	 */
+	uint32_t dahKeyedMicros;
+
+	/**
+	 * Key up after each element
+	 */
+	uint32_t elementSpaceMicros;
+
+	/**
+	 * Added to the element space after the last element of a character (stored messages)
+	 */
+	uint32_t characterSpaceMicros;
+
+	/**
+	 * Added again for each space between words (stored messages)
+	 */
+	uint32_t wordSpaceMicros;
+
+	/**
+	 * calculate
+	 *
+	 * @detail
+	 *   Works out the timing from the keyer settings
+	 *
+	 * @param[in] characterWPM keyer speed (words per minute)
+	 * @param[in] effectiveWPM Farnsworth speed.  0 or at least characterWPM for none.
+	 * @param[in] dahRatioTenths dah length in tenths of a dit
+	 * @param[in] compensationMicros added to each key down and taken off the space after it
+	 */
+	void calculate(int8_t characterWPM, int8_t effectiveWPM, int8_t dahRatioTenths, uint16_t compensationMicros);
+};
+
 
 class SCRadioKeyer
 {
@@ -73,34 +198,45 @@ private:
 	/**
 	 * Used to queue events to key and unkey transmitter
 	 */
-	EventManager	&_eventManager;
+	SCRadioEventQueue	&_eventManager;
 
 	/**
-	 * Used to read event related data when an event message
-	 * is received (like keyer speed, mode or paddles
-	 * orientation changed).
+	 * Holds keyer words per minute setting
 	 */
-	SCRadioEventData &_eventData;
+	int8_t			_keyerWPM;	// variable for keying speed
 
 	/**
-	 * Holds keyer words per minute setting
+	 * Farnsworth speed for stored messages (0 for none)
 	 */
-	int8_t			_keyerWPM;	// variable for keying speed
+	int8_t			_effectiveWPM;
+
+	/**
+	 * Dah length in tenths of a dit
+	 */
+	int8_t			_dahRatioTenths;
+
+	/**
+	 * Microseconds added to each key down and taken off the space after it
+	 */
+	uint16_t		_compensationMicros;
+
+	// The following are used by the timer interrupt.  The ones loop() also changes are
+	// volatile (read from memory every time) and loop() changes them with interrupts held off.
 
 	/**
 	 * Holds keyer current mode (straight key, iambic a, iambic b)
 	 */
-	KeyerMode		_keyerMode; // variable for keying mode
+	volatile KeyerMode	_keyerMode; // variable for keying mode
 
 	/**
-	 * Number of milliseconds per dit
+	 * Element and space lengths.  Only written with interrupts held off.
 	 */
-	uint32_t		_ditTime;
+	SCRadioKeyerTiming	_timing;
 
 	/**
 	 * additional keyer configuration data
 	 */
-	uint8_t			_keyerControl;
+	volatile uint8_t	_keyerControl;
 
 	/**
 	 * Current keyer state
@@ -108,9 +244,52 @@ private:
 	KeyerState		_keyerState;
 
 	/**
-	 * keyer timer value for current element
+	 * The element being sent or just sent (NONE when idle)
+	 */
+	KeyerElement	_lastElement;
+
+	/**
+	 * Paddles pressed on the last tick (DIT_LATCH_BIT and DAH_LATCH_BIT).
+	 * Used to see which paddle was pressed last.
+	 */
+	uint8_t			_lastPaddles;
+
+	/**
+	 * Input register of the port the paddle jack tip pin belongs to
+	 */
+	volatile uint8_t *_tipPort;
+
+	/**
+	 * Bit mask of the paddle jack tip pin within its port
+	 */
+	uint8_t			_tipMask;
+
+	/**
+	 * Input register of the port the paddle jack ring pin belongs to
+	 */
+	volatile uint8_t *_ringPort;
+
+	/**
+	 * Bit mask of the paddle jack ring pin within its port
+	 */
+	uint8_t			_ringMask;
+
+	/**
+	 * Microseconds left in the current element or space.  Goes below zero by whatever
+	 * the last tick ran over, which is then taken off the next element.
 	 */
-	uint32_t		_keyerTimer;
+	int32_t			_elementMicrosRemaining;
+
+	/**
+	 * Key status last reported in straight key mode
+	 */
+	volatile KeyStatus	_straightKeyStatus;
+
+	/**
+	 * Ticks left before the straight key is looked at again after it changed.
+	 * Used to ignore contact bounce.
+	 */
+	uint16_t		_straightKeyDebounceTicks;
 
 	/**
 	* Indicates whether the rig has successfully passed the stuck key check
@@ -120,8 +299,61 @@ private:
 
 	/**
 	* Indicates whether the stuck key state is currently being experienced
+	* (set by the timer interrupt)
 	*/
-	bool			_inStuckKeyErrorState;
+	volatile bool	_inStuckKeyErrorState;
+
+	/**
+	 * Whether loop() has told the display about the stuck key error
+	 */
+	bool			_stuckKeyErrorReported;
+
+	/**
+	 * The keyer the timer interrupt works for.  Interrupt routines can't be
+	 * object methods, so this is how the routine finds its object.
+	 */
+	static SCRadioKeyer *_tickKeyer;
+
+	/**
+	 * The messages that can be sent
+	 */
+	const SCRadioCWStoredMessage *_storedMessages;
+
+	/**
+	 * Number of messages
+	 */
+	const int8_t	_storedMessageCount;
+
+	/**
+	 * Whether a message is being sent (cleared by the timer interrupt when it ends)
+	 */
+	volatile bool	_messagePlaying;
+
+	/**
+	 * Whether loop() thinks a message is being sent.  Used to tell the menu when one ends.
+	 */
+	bool			_messagePlayingReported;
+
+	/**
+	 * The message being sent (in flash)
+	 */
+	const uint8_t	*_messageCodes;
+
+	/**
+	 * Position of the next character in the message
+	 */
+	uint8_t			_messagePosition;
+
+	/**
+	 * What is left of the character being sent.  Elements in the low bits above
+	 * a marker bit, so it is 1 when the character is done.
+	 */
+	uint8_t			_messageCharacterCode;
+
+	/**
+	 * Microseconds to wait before sending the message again (0 sends it once)
+	 */
+	uint32_t		_messageRepeatMicros;
 
 public:
 	/**
@@ -130,10 +362,11 @@ public:
 	 * @detail 
 	 *   Constructor for class
 	 * 
-	 * @param[in] eventManager Reference to EventManager
-	 * @param[in] eventData    Reference to EventData
+	 * @param[in] eventManager Reference to SCRadioEventQueue
+	 * @param[in] storedMessages messages the keyer can send
+	 * @param[in] storedMessageCount number of messages
 	 */
-	SCRadioKeyer(EventManager &eventManager, SCRadioEventData &eventData);
+	SCRadioKeyer(SCRadioEventQueue &eventManager, const SCRadioCWStoredMessage *storedMessages, int8_t storedMessageCount);
 
 	/**
 	 * begin
@@ -148,9 +381,27 @@ public:
 	 * 
 	 * @detail
 	 *   Should be called each time the main application loop executes.
+	 *   Reports the stuck key error.  The keying itself happens in tick().
 	 */
 	void loop();
 
+	/**
+	 * tick
+	 *
+	 * @detail
+	 *   Reads the paddles (or straight key) and runs the keyer.  Called by the Timer1
+	 *   interrupt every KEYER_TICK_MICROS.  Don't call it from anywhere else.
+	 */
+	void tick();
+
+	/**
+	 * handleTimerTick
+	 *
+	 * @detail
+	 *   Called by the Timer1 interrupt routine.  Passes the tick on to the keyer.
+	 */
+	static void handleTimerTick();
+
 	/**
 	 * keyerModeChangedListener
 	 * 
@@ -158,9 +409,9 @@ public:
 	 *   Listens for changes in the keyer's mode setting
 	 * 
 	 * @param[in] eventCode Identifies event message type
-	 * @param[in] whichMenuItem Identifies menu item where message originated
+	 * @param[in] eventPayload menuItem holds the new KeyerMode
 	 */
-	void keyerModeChangedListener(int eventCode, int whichMenuItem);
+	void keyerModeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * keyerSpeedChangedListener
@@ -169,9 +420,42 @@ public:
 	 *   Listens for changes in the keyer's speed setting
 	 * 
 	 * @param[in] eventCode Identifies event message type
-	 * @param[in] whichMenuItem Identifies menu item where message originated
+	 * @param[in] eventPayload menuItem holds the new speed in words per minute
+	 */
+	void keyerSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * keyerEffectiveSpeedChangedListener
+	 * 
+	 * @detail
+	 *   Listens for changes in the keyer's effective (Farnsworth) speed setting
+	 * 
+	 * @param[in] eventCode Identifies event message type
+	 * @param[in] eventPayload menuItem holds the new speed in words per minute (0 for none)
 	 */
-	void keyerSpeedChangedListener(int eventCode, int whichMenuItem);
+	void keyerEffectiveSpeedChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * keyerDahRatioChangedListener
+	 * 
+	 * @detail
+	 *   Listens for changes in the keyer's dah length setting
+	 * 
+	 * @param[in] eventCode Identifies event message type
+	 * @param[in] eventPayload menuItem holds the dah length in tenths of a dit
+	 */
+	void keyerDahRatioChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * keyerCompensationChangedListener
+	 * 
+	 * @detail
+	 *   Listens for changes in the keyer's compensation setting
+	 * 
+	 * @param[in] eventCode Identifies event message type
+	 * @param[in] eventPayload menuItem holds the compensation in microseconds
+	 */
+	void keyerCompensationChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* keyerPaddlesOrientationChangedListener
@@ -180,9 +464,39 @@ public:
 	*   Listens for changes in the keyer paddles orientation setting
 	*
 	* @param[in] eventCode Identifies event message type
-	* @param[in] whichMenuItem Identifies menu item where message originated
+	* @param[in] eventPayload menuItem holds the new PaddlesOrientation
 	*/
-	void keyerPaddlesOrientationChangedListener(int eventCode, int whichMenuItem);
+	void keyerPaddlesOrientationChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * keyerMessageChangedListener
+	 *
+	 * @detail
+	 *   Listens for the message menu item.  Starts sending the message chosen or stops.
+	 *
+	 * @param[in] eventCode Identifies event message type
+	 * @param[in] eventPayload menuItem holds the message number (1 is the first, 0 stops)
+	 */
+	void keyerMessageChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * playMessage
+	 *
+	 * @detail
+	 *   Starts sending a message at the keyer's speed.  Stops anything being sent.
+	 *
+	 * @param[in] messageCodes message in flash (the codes of a CW_MESSAGE)
+	 * @param[in] repeatSeconds seconds to wait before sending it again.  0 sends it once.
+	 */
+	void playMessage(const uint8_t *messageCodes, uint8_t repeatSeconds);
+
+	/**
+	 * stopMessage
+	 *
+	 * @detail
+	 *   Stops sending a message (and unkeys the rig if needed)
+	 */
+	void stopMessage();
 
 	/**
 	 * setKeyerMode
@@ -204,6 +518,36 @@ public:
 	 */
 	void setKeyerWPM(int8_t keyerWPM);
 
+	/**
+	 * setKeyerEffectiveWPM
+	 * 
+	 * @detail
+	 *   Sets the effective (Farnsworth) speed used for stored messages
+	 * 
+	 * @param[in] effectiveWPM words per minute.  0 (or the keyer speed or faster) for none.
+	 */
+	void setKeyerEffectiveWPM(int8_t effectiveWPM);
+
+	/**
+	 * setDahRatio
+	 * 
+	 * @detail
+	 *   Sets how long a dah is compared to a dit
+	 * 
+	 * @param[in] dahRatioTenths dah length in tenths of a dit (30 is the usual 3 to 1)
+	 */
+	void setDahRatio(int8_t dahRatioTenths);
+
+	/**
+	 * setCompensation
+	 * 
+	 * @detail
+	 *   Sets the time added to each key down (and taken off the space after it)
+	 * 
+	 * @param[in] compensationMicros microseconds (no more than half a dit is used)
+	 */
+	void setCompensation(uint16_t compensationMicros);
+
 	/**
 	 * setPaddlesOrientation
 	 * 
@@ -215,24 +559,102 @@ public:
 	void setPaddlesOrientation(PaddlesOrientation orientation);
 
 private:
+	/**
+	 * startTimerTick
+	 *
+	 * @detail
+	 *   Sets Timer1 to interrupt every KEYER_TICK_MICROS
+	 */
+	void startTimerTick();
+
+	/**
+	 * readPaddles
+	 *
+	 * @detail
+	 *   Reads both paddles.  When the tip and ring pins are on the same port
+	 *   (they are on the Nano, D7 and D6) this is a single read of the port.
+	 *   The paddle swap setting is applied here.
+	 *
+	 * @returns DIT_LATCH_BIT and/or DAH_LATCH_BIT for the paddles pressed
+	 */
+	uint8_t readPaddles();
+
+	/**
+	 * processMessage
+	 *
+	 * @detail
+	 *   Sends a stored message.  Called by tick() instead of the paddle keyer while
+	 *   a message is playing.  Stops if a paddle is pressed.
+	 */
+	void processMessage();
+
+	/**
+	 * startNextMessageElement
+	 *
+	 * @detail
+	 *   At the end of a space, starts the next element of the message.  Or lengthens the space
+	 *   between characters or words, waits to repeat the message or ends it.
+	 */
+	void startNextMessageElement();
+
+	/**
+	 * stopKeying
+	 *
+	 * @detail
+	 *   Unkeys the rig if it is keyed, stops any message and goes idle.  Only called
+	 *   with interrupts off (from the timer interrupt or with noInterrupts()).
+	 */
+	void stopKeying();
+
+	/**
+	 * startNextElement
+	 *
+	 * @detail
+	 *   Looks up what to send next in the transition table and starts it.
+	 *   Clears the paddle latches.
+	 */
+	void startNextElement();
+
+	/**
+	 * processStraightKey
+	 * 
+	 * @detail
+	 *   Watches the key in straight key mode.  Sends a key line changed
+	 *   message only when the key actually changes (after debouncing).
+	 */
+	void processStraightKey();
+
+	/**
+	 * sendKeyLineChange
+	 *
+	 * @detail
+	 *   Queues a key line changed event.  Only called with interrupts off
+	 *   (from the timer interrupt or with noInterrupts()).
+	 *
+	 * @param[in] keyStatus pressed or released
+	 */
+	void sendKeyLineChange(KeyStatus keyStatus);
+
 	/**
 	 * In steps where a follow on dit or dah is required, this 
 	 * method commits to sending the next element by setting
 	 * the approprate latch bit in the keyer control variable.
 	 * 
-	 * Is cleared in later steps as items are sent.
+	 * Is cleared when the next element starts.
 	 * 
 	 * ex:
 	 * Between elements and paddle is still held down.
 	 * In iambic B and paddles squeezed while an element i being sent.
+	 *
+	 * @param[in] paddles paddles pressed (from readPaddles())
 	 */
-	void updatePaddleLatch();
+	void updatePaddleLatch(uint8_t paddles);
 
 	/**
-	 * Sets the timer setting to support the specified
-	 * words per minute value.
+	 * Works out the element timing from the speed, dah length,
+	 * effective speed and compensation settings.
 	 */
-	void loadWPM(int8_t wpm);
+	void loadTiming();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,194 @@
+/**
+ * SCRadioLoopProfiler.cpp - Class for timing each part of the main loop
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+
+#include "SCRadioLoopProfiler.h"
+
+// When the profiler is turned off everything is in the header (and does nothing)
+#if LOOP_PROFILER_ENABLED
+
+void SCRadioLoopProfiler::begin()
+{
+	reset();
+}
+
+void SCRadioLoopProfiler::startLoop()
+{
+	uint32_t currentMicros = micros();
+
+	if (_loopStarted)
+	{
+		record(LoopStage::WHOLE_LOOP, currentMicros - _loopStartMicros);
+	}
+
+	_loopStartMicros = currentMicros;
+	_stageStartMicros = currentMicros;
+	_loopStarted = true;
+}
+
+void SCRadioLoopProfiler::endStage(LoopStage stage)
+{
+	uint32_t currentMicros = micros();
+
+	record(stage, currentMicros - _stageStartMicros);
+
+	// Reading micros() again so the time spent recording is not charged to the next stage
+	_stageStartMicros = micros();
+}
+
+void SCRadioLoopProfiler::print()
+{
+	Serial.println(F("stage,min,max,mean,samples,histogram (1us 2us 4us ...)"));
+
+	for (int8_t stage = 0; stage < LOOP_STAGE_COUNT; stage++)
+	{
+		printStageName((LoopStage)stage);
+		Serial.print(',');
+
+		// No samples means min still holds its starting value.  Print zeros instead.
+		if (_samples[stage] == 0)
+		{
+			Serial.print(F("0,0,0,0"));
+		}
+		else
+		{
+			Serial.print(_minMicros[stage]);
+			Serial.print(',');
+			Serial.print(_maxMicros[stage]);
+			Serial.print(',');
+			Serial.print(_totalMicros[stage] / _samples[stage]);
+			Serial.print(',');
+			Serial.print(_samples[stage]);
+		}
+
+		for (int8_t bin = 0; bin < LOOP_PROFILER_HISTOGRAM_BINS; bin++)
+		{
+			Serial.print(',');
+			Serial.print(_histogram[stage][bin]);
+		}
+
+		Serial.println();
+	}
+
+	// Printing at 9600 baud takes a long time.  We don't want that counted
+	// as a pass through the loop, so the pass we printed in is not timed.
+	_loopStarted = false;
+}
+
+void SCRadioLoopProfiler::reset()
+{
+	for (int8_t stage = 0; stage < LOOP_STAGE_COUNT; stage++)
+	{
+		_minMicros[stage] = 0xFFFF;
+		_maxMicros[stage] = 0;
+		_totalMicros[stage] = 0;
+		_samples[stage] = 0;
+
+		for (int8_t bin = 0; bin < LOOP_PROFILER_HISTOGRAM_BINS; bin++)
+		{
+			_histogram[stage][bin] = 0;
+		}
+	}
+
+	_loopStarted = false;
+}
+
+// private methods
+
+void SCRadioLoopProfiler::record(LoopStage stage, uint32_t elapsedMicros)
+{
+	int8_t index = static_cast<int8_t>(stage);
+
+	// Min and max are 16 bits to save memory.  Anything over 65 milliseconds shows as 65535.
+	uint16_t clippedMicros = (elapsedMicros > 0xFFFF) ? 0xFFFF : (uint16_t)elapsedMicros;
+
+	if (clippedMicros < _minMicros[index])
+	{
+		_minMicros[index] = clippedMicros;
+	}
+
+	if (clippedMicros > _maxMicros[index])
+	{
+		_maxMicros[index] = clippedMicros;
+	}
+
+	// The sample count is 16 bits too.  When it fills up, the count and the total are both
+	// halved.  The average stays the same and newer passes keep counting.
+	if (_samples[index] == 0xFFFF)
+	{
+		_samples[index] >>= 1;
+		_totalMicros[index] >>= 1;
+	}
+
+	_samples[index]++;
+	_totalMicros[index] += elapsedMicros;
+
+	// Histogram buckets stop counting when they fill up rather than rolling back to zero
+	uint16_t &bucket = _histogram[index][histogramBin(elapsedMicros)];
+
+	if (bucket < 0xFFFF)
+	{
+		bucket++;
+	}
+}
+
+int8_t SCRadioLoopProfiler::histogramBin(uint32_t elapsedMicros)
+{
+	int8_t bin = 0;
+
+	// Counting how many times we can halve the time before it gets to 1
+	while ((elapsedMicros > 1) && (bin < (LOOP_PROFILER_HISTOGRAM_BINS - 1)))
+	{
+		elapsedMicros >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+void SCRadioLoopProfiler::printStageName(LoopStage stage)
+{
+	switch (stage)
+	{
+	case LoopStage::WHOLE_LOOP:
+		Serial.print(F("loop"));
+		break;
+	case LoopStage::KEYER:
+		Serial.print(F("keyer"));
+		break;
+	case LoopStage::MAIN_KNOB:
+		Serial.print(F("mainKnob"));
+		break;
+	case LoopStage::DDS:
+		Serial.print(F("dds"));
+		break;
+	case LoopStage::VFO:
+		Serial.print(F("vfo"));
+		break;
+	case LoopStage::EEPROM:
+		Serial.print(F("eeprom"));
+		break;
+	case LoopStage::VOLTAGE_MONITOR:
+		Serial.print(F("voltageMonitor"));
+		break;
+	case LoopStage::EVENTS:
+		Serial.print(F("events"));
+		break;
+	}
+}
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * SCRadioLoopProfiler.h - Class for timing each part of the main loop
+ *
+ * Why does this exist?
+ *
+ * Everything in loop() waits its turn.  So the longest pass through the loop decides
+ * how late a knob turn, a DDS frame or the end of the hang time can be handled.  (The
+ * keying itself runs from a timer interrupt and doesn't wait for the loop.)  This class
+ * times each part of the loop with micros() so we can see where the time goes.
+ *
+ * For each part it keeps the shortest, longest and average time plus a histogram
+ * (how many passes fell in each power of 2 range of microseconds).  Everything is
+ * kept in fixed size arrays.  With the default settings that is about 280 bytes.
+ *
+ * It is only built when LOOP_PROFILER_ENABLED is 1 in SCRadioConstants.h.
+ * Otherwise every method is empty and the compiler removes the calls.
+ *
+ * Note: micros() counts in steps of 4 microseconds on a 16 MHz Nano.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioLoopProfiler_h
+#define SCRadioLoopProfiler_h
+
+#include "SCRadioConstants.h"
+
+class SCRadioLoopProfiler
+{
+#if LOOP_PROFILER_ENABLED
+private:
+	// private member data
+
+	/**
+	 * Shortest time seen for each stage (microseconds)
+	 */
+	uint16_t _minMicros[LOOP_STAGE_COUNT];
+
+	/**
+	 * Longest time seen for each stage (microseconds)
+	 */
+	uint16_t _maxMicros[LOOP_STAGE_COUNT];
+
+	/**
+	 * Sum of the times for each stage.  Divided by _samples for the average.
+	 */
+	uint32_t _totalMicros[LOOP_STAGE_COUNT];
+
+	/**
+	 * Number of times each stage has been timed
+	 */
+	uint16_t _samples[LOOP_STAGE_COUNT];
+
+	/**
+	 * Histogram of the times for each stage
+	 */
+	uint16_t _histogram[LOOP_STAGE_COUNT][LOOP_PROFILER_HISTOGRAM_BINS];
+
+	/**
+	 * micros() reading when the current pass through the loop started
+	 */
+	uint32_t _loopStartMicros;
+
+	/**
+	 * micros() reading when the current stage started
+	 */
+	uint32_t _stageStartMicros;
+
+	/**
+	 * If this is true, _loopStartMicros holds the start of the last pass
+	 */
+	bool _loopStarted;
+
+public:
+	// public methods
+
+	/**
+	 * begin
+	 *
+	 * @detail
+	 *   sets up object so it is ready to use - constructor type logic goes here.
+	 *   It gets called in the 'setup()' section of the main program
+	 */
+	void begin();
+
+	/**
+	 * startLoop
+	 *
+	 * @detail
+	 *   Call at the top of loop().  Times the last whole pass through the loop and
+	 *   starts timing the first stage.
+	 */
+	void startLoop();
+
+	/**
+	 * endStage
+	 *
+	 * @detail
+	 *   Call right after each part of the loop.  Records how long it took since the
+	 *   last call (or since startLoop()) and starts timing the next stage.
+	 *
+	 * @param[in] stage the part of the loop that just finished
+	 */
+	void endStage(LoopStage stage);
+
+	/**
+	 * print
+	 *
+	 * @detail
+	 *   Prints the timings over the serial port.  One comma separated line per stage:
+	 *   stage,min,max,mean,samples followed by the histogram buckets.
+	 *   The pass through the loop that printed is left out of the timings.
+	 */
+	void print();
+
+	/**
+	 * reset
+	 *
+	 * @detail
+	 *   Clears all of the timings
+	 */
+	void reset();
+
+private:
+	// private methods
+
+	/**
+	 * record
+	 *
+	 * @detail
+	 *   Adds one timing to a stage's numbers
+	 *
+	 * @param[in] stage stage being timed
+	 * @param[in] elapsedMicros how long it took
+	 */
+	void record(LoopStage stage, uint32_t elapsedMicros);
+
+	/**
+	 * histogramBin
+	 *
+	 * @detail
+	 *   Works out which histogram bucket a time falls in (its base 2 logarithm)
+	 *
+	 * @param[in] elapsedMicros time to place
+	 *
+	 * @returns bucket number
+	 */
+	int8_t histogramBin(uint32_t elapsedMicros);
+
+	/**
+	 * printStageName
+	 *
+	 * @detail
+	 *   Prints the name of a stage over the serial port
+	 *
+	 * @param[in] stage stage to name
+	 */
+	void printStageName(LoopStage stage);
+
+#else
+public:
+	// Profiler turned off.  These do nothing and the compiler leaves them out.
+	void begin() {}
+	void startLoop() {}
+	void endStage(LoopStage) {}
+	void print() {}
+	void reset() {}
+#endif
+};
+
+#endif
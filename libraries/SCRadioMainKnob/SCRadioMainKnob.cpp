@@ -12,19 +12,25 @@
   @version 1.0.3  12/22/2016.
 */
 
-#include "EventManager.h"
+#include "Arduino.h"
+#include "SCRadioEventQueue.h"
 #include "SCRadioButton.h"
 #include "SCRadioMainKnob.h"
 
+// There is only one main knob.  It is set in begin().
+SCRadioMainKnob *SCRadioMainKnob::_interruptKnob = nullptr;
+
 // Constructor
 // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioMainKnob::SCRadioMainKnob(EventManager &eventManager,
+SCRadioMainKnob::SCRadioMainKnob(SCRadioEventQueue &eventManager,
 								byte rotaryPin1, 
 								byte rotaryPin2, 
 								SCRadioButton &button) : 
 									_eventManager(eventManager), 
 									_rotary(rotaryPin1, rotaryPin2), 
-									_button(button) 
+									_button(button),
+									_rotaryPin1(rotaryPin1),
+									_rotaryPin2(rotaryPin2)
 {      
 	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
 	// Put your logic in 'begin() instead and call it after instantiating your object.
@@ -35,19 +41,48 @@ void SCRadioMainKnob::begin()
 {
 	_mainKnobMode = MainKnobMode::VFO;
 	_button.begin();
+
+	_pendingTurnSteps = 0;
+	_lastStepMicros = micros();
+	_pendingStepMicros = 0;
+	_pendingStepCount = 0;
+
+	_useInterrupts = (digitalPinToInterrupt(_rotaryPin1) != NOT_AN_INTERRUPT)
+		&& (digitalPinToInterrupt(_rotaryPin2) != NOT_AN_INTERRUPT);
+
+	if (_useInterrupts)
+	{
+		_interruptKnob = this;
+
+		// CHANGE runs the routine on both the rising and falling edge of each pin
+		attachInterrupt(digitalPinToInterrupt(_rotaryPin1), handleRotaryInterrupt, CHANGE);
+		attachInterrupt(digitalPinToInterrupt(_rotaryPin2), handleRotaryInterrupt, CHANGE);
+	}
 }
 
 void SCRadioMainKnob::loop() 
 {
 	processButton();
-	KnobTurnDirection knobTurnDirection = processRotaryEncoder();
 
-	if (knobTurnDirection == KnobTurnDirection::NONE) 
+	if (!_useInterrupts)
+	{
+		KnobTurnDirection knobTurnDirection = processRotaryEncoder();
+
+		if (knobTurnDirection != KnobTurnDirection::NONE)
+		{
+			recordStep(knobTurnDirection);
+		}
+	}
+
+	uint16_t stepIntervalMicros;
+	int16_t turnSteps = takeTurnSteps(stepIntervalMicros);
+
+	if (turnSteps == 0) 
 	{
 		return;
 	}
 
-	sendTurnEventMessage(knobTurnDirection);
+	sendTurnEventMessage(turnSteps, stepIntervalMicros);
 }
 
 // private methods
@@ -161,7 +196,74 @@ KnobTurnDirection SCRadioMainKnob::processRotaryEncoder()
 	return knobTurnDirection;
 }
 
-void SCRadioMainKnob::sendTurnEventMessage(KnobTurnDirection knobTurnDirection) 
+void SCRadioMainKnob::recordStep(KnobTurnDirection knobTurnDirection)
+{
+	uint32_t currentMicros = micros();
+	uint32_t stepIntervalMicros = currentMicros - _lastStepMicros;
+
+	_lastStepMicros = currentMicros;
+
+	// Each step's time is added up, so steps taken together still carry how fast they came
+	// (a step after a rest counts as 65535)
+	if (_pendingStepCount < UINT16_MAX)
+	{
+		_pendingStepMicros += (stepIntervalMicros > 0xFFFF) ? 0xFFFF : stepIntervalMicros;
+		_pendingStepCount++;
+	}
+
+	// stops at the limits rather than wrapping around and turning the wrong way
+	int16_t turnSteps = _pendingTurnSteps;
+
+	if (knobTurnDirection == KnobTurnDirection::CLOCKWISE)
+	{
+		if (turnSteps < INT16_MAX)
+		{
+			_pendingTurnSteps = turnSteps + 1;
+		}
+	}
+	else if (turnSteps > INT16_MIN)
+	{
+		_pendingTurnSteps = turnSteps - 1;
+	}
+}
+
+int16_t SCRadioMainKnob::takeTurnSteps(uint16_t &stepIntervalMicros)
+{
+	// The count is two bytes.  The interrupt could change it between reading the first byte
+	// and the second, or between reading it and zeroing it.  So interrupts are held off
+	// for these few instructions.  A step that comes in meanwhile runs right after.
+	noInterrupts();
+	int16_t turnSteps = _pendingTurnSteps;
+	uint32_t pendingStepMicros = _pendingStepMicros;
+	uint16_t pendingStepCount = _pendingStepCount;
+	_pendingTurnSteps = 0;
+	_pendingStepMicros = 0;
+	_pendingStepCount = 0;
+	interrupts();
+
+	// The divide is done out here so the interrupt isn't held off for it
+	stepIntervalMicros = (pendingStepCount == 0) ? 0xFFFF : (uint16_t)(pendingStepMicros / pendingStepCount);
+
+	return turnSteps;
+}
+
+void SCRadioMainKnob::handleRotaryInterrupt()
+{
+	SCRadioMainKnob *knob = _interruptKnob;
+
+	// Interrupts are off while this runs, so nothing else changes the knob's numbers under us
+	KnobTurnDirection knobTurnDirection = knob->processRotaryEncoder();
+
+	if (knobTurnDirection == KnobTurnDirection::NONE)
+	{
+		// not a full step yet (the encoder is part way between detents) or contact bounce
+		return;
+	}
+
+	knob->recordStep(knobTurnDirection);
+}
+
+void SCRadioMainKnob::sendTurnEventMessage(int16_t turnSteps, uint16_t stepIntervalMicros) 
 {
 	EventType eventTypeToSend;
 
@@ -188,6 +290,8 @@ void SCRadioMainKnob::sendTurnEventMessage(KnobTurnDirection knobTurnDirection)
 	}
 
 	// Serial.println("Queueing turn event.");
-	_eventManager.queueEvent(static_cast<int>(eventTypeToSend), static_cast<int>(knobTurnDirection), EventManager::kHighPriority);
+	// The event value is the number of steps turned (+ is clockwise).  If a turn event of the same
+	// type is still waiting to be handled, these steps are added to it rather than queueing another one.
+	_eventManager.queueOrMergeKnobTurnEvent(static_cast<int>(eventTypeToSend), turnSteps, stepIntervalMicros, SCRadioEventQueue::kHighPriority);
 }
 
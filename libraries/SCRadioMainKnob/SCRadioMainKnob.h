@@ -12,12 +12,24 @@ SCRadioMainKnob.h - Class for controlling the main rotary encoder knob for softw
 @version 1.0.3  12/22/2016.
 */
 
+/*
+ * Why interrupts?
+ *
+ * The knob used to be checked once each pass through loop().  A long DDS reload, LCD print
+ * or delay() meant the knob wasn't looked at for a while and steps turned in that time were
+ * lost.  The knob's pins (2 and 3) are the Nano's two external interrupt pins (INT0 and INT1).
+ * So now any change on either pin runs an interrupt routine right away.  It decodes the step
+ * and adds it to a running count.  loop() just takes whatever count has built up.
+ *
+ * If the knob is moved to pins that aren't interrupt pins, it goes back to being checked in loop().
+ */
+
 #ifndef SCRadioMainKnob_h
 #define SCRadioMainKnob_h
 
 // forwards for class pointers and references
 class SCRadioButton;
-class EventManager;
+class SCRadioEventQueue;
 
 // includes
 #include "Rotary.h"
@@ -32,7 +44,7 @@ private:
 	/**
 	 * Event manager is used to place knob and knob button events in the event queue
 	 */
-	EventManager &_eventManager;
+	SCRadioEventQueue &_eventManager;
 
 	/**
 	 * Rotary encoder object used to interact with encoder for knob
@@ -49,6 +61,48 @@ private:
 	 */
 	MainKnobMode _mainKnobMode;
 
+	/**
+	 * Arduino pins the rotary encoder is wired to
+	 */
+	const byte _rotaryPin1;
+	const byte _rotaryPin2;
+
+	/**
+	 * true if the encoder is read by interrupts, false if it is checked in loop()
+	 */
+	bool _useInterrupts;
+
+	// The following are changed by the interrupt routine (or by loop() when the knob isn't
+	// on interrupt pins).  volatile tells the compiler they can change at any time so it
+	// reads them from memory every time.
+
+	/**
+	 * Steps turned since loop() last took them (+ is clockwise)
+	 */
+	volatile int16_t _pendingTurnSteps;
+
+	/**
+	 * micros() reading at the last step
+	 */
+	volatile uint32_t _lastStepMicros;
+
+	/**
+	 * Microseconds each of the steps since loop() last took them came after the one
+	 * before, added up (each one 65535 at most)
+	 */
+	volatile uint32_t _pendingStepMicros;
+
+	/**
+	 * Steps in _pendingStepMicros (in both directions)
+	 */
+	volatile uint16_t _pendingStepCount;
+
+	/**
+	 * The main knob the interrupt routine works for.  Interrupt routines can't be
+	 * object methods, so this is how the routine finds its object.
+	 */
+	static SCRadioMainKnob *_interruptKnob;
+
 public:
 	// public methods
 
@@ -63,7 +117,7 @@ public:
 	 * @param[in] rotaryPin2 Arduino pin listening for rotary encoder input
 	 * @parma[in] button Reference to button representing knob's button
 	 */
-	SCRadioMainKnob(EventManager &eventManager, byte rotaryPin1, byte rotaryPin2, SCRadioButton &button);
+	SCRadioMainKnob(SCRadioEventQueue &eventManager, byte rotaryPin1, byte rotaryPin2, SCRadioButton &button);
 
 	/**
 	 * begin
@@ -94,6 +148,36 @@ private:
 	 */
 	KnobTurnDirection processRotaryEncoder();
 
+	/**
+	 * recordStep
+	 *
+	 * @detail
+	 *   Counts one step of the knob and times it
+	 *
+	 * @param[in] knobTurnDirection direction of the step (CW or CCW)
+	 */
+	void recordStep(KnobTurnDirection knobTurnDirection);
+
+	/**
+	 * takeTurnSteps
+	 *
+	 * @detail
+	 *   Takes the steps counted since the last call and starts the count over
+	 *
+	 * @param[out] stepIntervalMicros average microseconds between steps over those steps (65535 if none)
+	 *
+	 * @returns steps turned (+ is clockwise)
+	 */
+	int16_t takeTurnSteps(uint16_t &stepIntervalMicros);
+
+	/**
+	 * handleRotaryInterrupt
+	 *
+	 * @detail
+	 *   Interrupt routine run when either encoder pin changes.  Decodes the step and counts it.
+	 */
+	static void handleRotaryInterrupt();
+
 	/**
 	 * processButton
 	 * 
@@ -108,8 +192,13 @@ private:
 	 * @detail
 	 *   Enqueues a message saying that the knob has turned
 	 *   the exact message type sent depends on the current main knob mode (vfo, rit, menu, menu item)
+	 *   The message carries a signed step count and the average time between those steps (used for
+	 *   tuning acceleration).  Steps are merged into a turn message that is still waiting.
+	 *
+	 * @param[in] turnSteps steps turned (+ is clockwise)
+	 * @param[in] stepIntervalMicros average microseconds between steps
 	 */
-	void sendTurnEventMessage(KnobTurnDirection knobTurnDirection);
+	void sendTurnEventMessage(int16_t turnSteps, uint16_t stepIntervalMicros);
 };
 
 #endif
\ No newline at end of file
@@ -15,7 +15,7 @@
 
 #include "Arduino.h"
 
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 
 #include "SCRadioConstants.h"
 #include "SCRadioEventData.h"
@@ -24,7 +24,7 @@
 
 // Constructor
 // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioMenu::SCRadioMenu(EventManager &eventManager,
+SCRadioMenu::SCRadioMenu(SCRadioEventQueue &eventManager,
 						SCRadioEventData &eventData) : _eventManager(eventManager), 
 														_eventData(eventData)
 {
@@ -47,9 +47,9 @@ void SCRadioMenu::begin()
 	_numberOfMenuItems = 0;
 }
 
-void SCRadioMenu::changeSelectedMenuItem(int turnDirection)
+void SCRadioMenu::changeSelectedMenuItem(int turnSteps)
 {
-	int newMenuItemNumber = _selectedMenuItem + turnDirection;
+	int newMenuItemNumber = _selectedMenuItem + turnSteps;
 
 	if (newMenuItemNumber < 0)
 	{
@@ -64,15 +64,14 @@ void SCRadioMenu::changeSelectedMenuItem(int turnDirection)
 	_selectedMenuItem = newMenuItemNumber;
 }
 
-void SCRadioMenu::menuKnobTurnedListener(int eventCode, int turnDirection)
+void SCRadioMenu::menuKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeSelectedMenuItem(turnDirection);
+	changeSelectedMenuItem(eventPayload.knobTurn.steps);
 	_eventManager.queueEvent(static_cast<int>(EventType::MENU_ITEM_SELECTED), _selectedMenuItem);
 }
 
-void SCRadioMenu::menuItemKnobTurnedListener(int eventCode, int turnDirection)
+void SCRadioMenu::menuItemKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
 	// Serial.println("Menu item knob turn listener");
-	KnobTurnDirection knobTurnDirection = (KnobTurnDirection)turnDirection;
-	_menuItems[_selectedMenuItem]->adjustMenuItemValue(knobTurnDirection);
+	_menuItems[_selectedMenuItem]->adjustMenuItemValue(eventPayload.knobTurn.steps);
 }
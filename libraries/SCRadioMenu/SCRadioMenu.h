@@ -16,10 +16,11 @@
 #define SCRadioMenu_h
 
 // forwards for classes accessed via pointers and references only
-class EventManager;
+class SCRadioEventQueue;
 class SCRadioEventData;
 
 #include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
 #include "SCRadioMenuItem.h"
 
 class SCRadioMenu
@@ -40,7 +41,7 @@ private:
 	/**
 	 * Used to send messages about menu related events
 	 */
-	EventManager &_eventManager;
+	SCRadioEventQueue &_eventManager;
 
 	/**
 	 * Used to access data related to events
@@ -64,7 +65,7 @@ public:
 	 * @param[in] eventManager Reference to eventManager object used for enqueueing messages
 	 * @param[in] eventData Reference to eventData object having event related data
 	 */
-	SCRadioMenu(EventManager &eventManager,
+	SCRadioMenu(SCRadioEventQueue &eventManager,
     			SCRadioEventData &eventData);
 
 	/**
@@ -89,11 +90,11 @@ public:
 	 * changeSelectedMenuItem
 	 * 
 	 * @detail
-	 *   Changes focus to the next or previous menu item depending on knob direction of turn
+	 *   Moves focus forward or back one menu item for each step the knob turned
 	 * 
-	 * @param[in] turnDirection Direction knob was rotated
+	 * @param[in] turnSteps Number of steps the knob turned (+ is clockwise)
 	 */
-	void changeSelectedMenuItem(int turnDirection);
+	void changeSelectedMenuItem(int turnSteps);
 
 	/**
 	 * menuItemKnobTurnedListener
@@ -102,9 +103,9 @@ public:
 	 *   Listens for menu item knob turn events
 	 * 
 	 * @param[in] eventCode Identifies what type of event message
-	 * @param[in] turnDirection Identifies direction of knob turn
+	 * @param[in] eventPayload knobTurn holds the number of steps the knob turned (+ is clockwise)
 	 */
-	void menuItemKnobTurnedListener(int eventCode, int turnDirection);
+	void menuItemKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload);
 	
 	/**
 	* menuKnobTurnedListener
@@ -113,9 +114,9 @@ public:
 	*   Listens for menu knob turn events
 	*
 	* @param[in] eventCode Identifies what type of event message
-	* @param[in] turnDirection Identifies direction of knob turn
+	* @param[in] eventPayload knobTurn holds the number of steps the knob turned (+ is clockwise)
 	*/
-	void menuKnobTurnedListener(int eventCode, int turnDirection);
+	void menuKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload);
     
 	private:
 };
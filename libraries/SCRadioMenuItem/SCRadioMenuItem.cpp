@@ -13,13 +13,13 @@
  */
 
 #include "Arduino.h"
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 #include "SCRadioConstants.h"
 #include "SCRadioMenuItem.h"
 
  // Constructor
  // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioMenuItem::SCRadioMenuItem(EventManager &eventManager,
+SCRadioMenuItem::SCRadioMenuItem(SCRadioEventQueue &eventManager,
 									int32_t initialValue,
 										int8_t incrementValue,
 										int32_t minimumValue,
@@ -36,7 +36,7 @@ SCRadioMenuItem::SCRadioMenuItem(EventManager &eventManager,
 
 // Constructor
 // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioMenuItem::SCRadioMenuItem(EventManager &eventManager,
+SCRadioMenuItem::SCRadioMenuItem(SCRadioEventQueue &eventManager,
 	int32_t initialValue,
 	int32_t minimumValue,
 	int32_t maximumValue) :
@@ -51,13 +51,14 @@ SCRadioMenuItem::SCRadioMenuItem(EventManager &eventManager,
 
 // public member methods
 
-void SCRadioMenuItem::adjustMenuItemValue(KnobTurnDirection turnDirection)
+void SCRadioMenuItem::adjustMenuItemValue(int16_t turnSteps)
 {
 	// Serial.println("In adjust menu item value");
-	int32_t newValue = _menuItemValue + _incrementValue * static_cast<int32_t>(turnDirection);
+	int32_t newValue = _menuItemValue + _incrementValue * static_cast<int32_t>(turnSteps);
 	_menuItemValue = rangeCheckValue(newValue);
-	_eventManager.queueEvent(static_cast<int>(EventType::MENU_ITEM_VALUE_CHANGED), _menuItemIndex);
-	_eventManager.queueEvent(static_cast<int>(_menuItemEventType), _menuItemIndex);
+	// the listeners get the new value with the event so they don't have to come back and ask for it
+	_eventManager.queueMenuItemEvent(static_cast<int>(EventType::MENU_ITEM_VALUE_CHANGED), _menuItemIndex, (int16_t)_menuItemValue);
+	_eventManager.queueMenuItemEvent(static_cast<int>(_menuItemEventType), _menuItemIndex, (int16_t)_menuItemValue);
 }
 
 // sets up object so it is ready for use.  Type of logic that is normally in a constructor
@@ -93,9 +94,9 @@ int32_t SCRadioMenuItem::getMenuItemValue()
 	return _menuItemValue;
 }
 
-void SCRadioMenuItem::menuItemExternallyChangedListener(int eventCode, int menuItemValue)
+void SCRadioMenuItem::menuItemExternallyChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	setMenuItemValue(menuItemValue);
+	setMenuItemValue(eventPayload.menuItem.value);
 }
 
 int32_t SCRadioMenuItem::rangeCheckValue(int32_t valueToCheck)
@@ -20,10 +20,11 @@
 #define SCRadioMenuItem_h
 
 // forwards for classes accessed via pointers and references only
-class EventManager;
+class SCRadioEventQueue;
 
 // includes
 #include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
 #include "ISCRadioReadOnlyMenuItem.h"
 
 // Notice below that we are inheriting 
@@ -68,7 +69,7 @@ public:
 	/**
 	* Used to enqueue messages resulting from menu item value changes
 	*/
-	EventManager &_eventManager;
+	SCRadioEventQueue &_eventManager;
 
 	// protected member data
 
@@ -126,7 +127,7 @@ public:
 	* @param[in] minimumValue minimum value
 	* @param[in] maximumValue maximum value
 	*/
-	SCRadioMenuItem(EventManager &eventManager,
+	SCRadioMenuItem(SCRadioEventQueue &eventManager,
 		int32_t initialValue,
 		int8_t incrementValue,
 		int32_t minimumValue,
@@ -143,7 +144,7 @@ public:
 	 * @param[in] minimumValue minimum value
 	 * @param[in] maximumValue maximum value
 	 */
-	SCRadioMenuItem(EventManager &eventManager,
+	SCRadioMenuItem(SCRadioEventQueue &eventManager,
 		             int32_t initialValue,
 		             	int32_t minimumValue,
 		             		int32_t maximumValue);
@@ -152,11 +153,11 @@ public:
 	* adjustMenuItemValue
 	*
 	* @detail
-	*   Adjusts this menu item's value based on the direction of the turn of the main knob
+	*   Adjusts this menu item's value by its increment for each step the main knob turned
 	*
-	* @param[in] turnDirection Directionknob was turned
+	* @param[in] turnSteps Number of steps the knob turned (+ is clockwise)
 	*/
-	void adjustMenuItemValue(KnobTurnDirection turnDirection);
+	void adjustMenuItemValue(int16_t turnSteps);
 
 	/**
 	 * getMenuItemEventType
@@ -193,9 +194,9 @@ public:
 	 *   Adjusts menu item value if an external process changes requests a change
 	 *   
 	 * @param[in] eventCode event type of message
-	 * @param[in] menuItemValue new menu item value
+	 * @param[in] eventPayload menuItem.value holds the new menu item value
 	 */
-	void menuItemExternallyChangedListener(int eventCode, int menuItemValue);
+	void menuItemExternallyChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * setMenuItemEventType
@@ -13,13 +13,13 @@
 */
 
 #include "Arduino.h"
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 #include "SCRadioConstants.h"
 #include "SCRadioEventData.h"
 #include "SCRadioMenuItem.h"
 #include "SCRadioMenuItemNameValue.h"
 
-SCRadioMenuItemNameValue::SCRadioMenuItemNameValue(EventManager &eventManager,
+SCRadioMenuItemNameValue::SCRadioMenuItemNameValue(SCRadioEventQueue &eventManager,
 	int32_t initialValue,
 	int8_t incrementValue,
 	int32_t minimumValue,
@@ -31,7 +31,7 @@ SCRadioMenuItemNameValue::SCRadioMenuItemNameValue(EventManager &eventManager,
 {
 }
 
-SCRadioMenuItemNameValue::SCRadioMenuItemNameValue(EventManager &eventManager,
+SCRadioMenuItemNameValue::SCRadioMenuItemNameValue(SCRadioEventQueue &eventManager,
 	int32_t initialValue,
 	int32_t minimumValue,
 	int32_t maximumValue) : SCRadioMenuItem(eventManager,
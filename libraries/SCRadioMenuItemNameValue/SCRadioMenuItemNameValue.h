@@ -17,7 +17,7 @@
 
 // forwards for classes accessed via pointers and references only
 class EventData;
-class EventManager;
+class SCRadioEventQueue;
 
 #include "SCRadioConstants.h"
 #include "SCRadioMenuItem.h"
@@ -27,7 +27,7 @@ class SCRadioMenuItemNameValue : public SCRadioMenuItem
 private:
 	// private member data
 
-	const char* _displayValues[MAX_NAME_VALUE_CHOICES] = {0,0,0};
+	const char* _displayValues[MAX_NAME_VALUE_CHOICES] = {0,0,0,0,0};
 
 public:
 	// public methods
@@ -45,7 +45,7 @@ public:
 	 * @param[in] minimumValue Minimum value for the menu item
 	 * @param[in] maximumValue Maximum value for the minu item
 	 */
-	SCRadioMenuItemNameValue(EventManager &eventManager,
+	SCRadioMenuItemNameValue(SCRadioEventQueue &eventManager,
 		int32_t initialValue,
 			int8_t incrementValue,
 				int32_t minimumValue,
@@ -63,7 +63,7 @@ public:
 	* @param[in] minimumValue Minimum value for the menu item
 	* @param[in] maximumValue Maximum value for the minu item
 	*/
-	SCRadioMenuItemNameValue(EventManager &eventManager,
+	SCRadioMenuItemNameValue(SCRadioEventQueue &eventManager,
 		int32_t initialValue,
 		int32_t minimumValue,
 		int32_t maximumValue);
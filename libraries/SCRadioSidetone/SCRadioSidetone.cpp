@@ -0,0 +1,235 @@
+/**
+ * SCRadioSidetone.cpp - Class for making the CW sidetone with Timer2
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+
+#include "SCRadioSidetone.h"
+
+// Timer2 counts at F_CPU / 256 (62500 a second on the Nano, 16 microseconds each)
+#define SIDETONE_TIMER_COUNTS_PER_SECOND (F_CPU / 256)
+
+// Timer2 only counts to 255, so the lowest pitch has to fit in that many counts
+static_assert(SIDETONE_TIMER_COUNTS_PER_SECOND / SIDETONE_MIN_PITCH_HZ <= 255, "SIDETONE_MIN_PITCH_HZ is too low for Timer2");
+
+// How loud each step of the envelope is (out of 256).  Half a raised cosine: (1 - cos(pi * step / 4)) / 2
+static const uint8_t kSidetoneEnvelope[SIDETONE_ENVELOPE_STEPS] PROGMEM = { 0, 37, 128, 219, 255 };
+
+SCRadioSidetone *SCRadioSidetone::_timerSidetone = nullptr;
+
+// Timer2 compare match interrupt routine.  Runs at the end of each high and low part of the tone.
+ISR(TIMER2_COMPA_vect)
+{
+	SCRadioSidetone::handleTimerInterrupt();
+}
+
+// Constructor
+// The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
+SCRadioSidetone::SCRadioSidetone(uint8_t tonePin, int16_t pitchHz, int8_t volume) :
+									_tonePin(tonePin),
+									_pitchHz(pitchHz),
+									_volume(volume)
+{
+	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
+	// Put your logic in 'begin() instead and call it after instantiating your object.
+}
+
+void SCRadioSidetone::begin()
+{
+	pinMode(_tonePin, OUTPUT);
+	digitalWrite(_tonePin, LOW);
+
+	// Looked up once here so the interrupt can set the pin directly (much quicker than digitalWrite)
+	_tonePort = portOutputRegister(digitalPinToPort(_tonePin));
+	_toneMask = digitalPinToBitMask(_tonePin);
+
+	_timerSidetone = this;
+
+	_keyDown = false;
+	_running = false;
+	_pinHigh = false;
+	_envelopeStep = 0;
+
+	setPitch(_pitchHz);
+	setVolume(_volume);
+}
+
+void SCRadioSidetone::keyLineChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	if ((KeyStatus)eventPayload.value == KeyStatus::PRESSED)
+	{
+		keyDown();
+	}
+	else
+	{
+		keyUp();
+	}
+}
+
+void SCRadioSidetone::pitchChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setPitch(eventPayload.menuItem.value);
+}
+
+void SCRadioSidetone::volumeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setVolume(eventPayload.menuItem.value);
+}
+
+void SCRadioSidetone::setPitch(int16_t pitchHz)
+{
+	if (pitchHz < SIDETONE_MIN_PITCH_HZ)
+	{
+		pitchHz = SIDETONE_MIN_PITCH_HZ;
+	}
+	else if (pitchHz > SIDETONE_MAX_PITCH_HZ)
+	{
+		pitchHz = SIDETONE_MAX_PITCH_HZ;
+	}
+
+	_pitchHz = pitchHz;
+	calculateCounts();
+}
+
+void SCRadioSidetone::setVolume(int8_t volume)
+{
+	if (volume < 0)
+	{
+		volume = 0;
+	}
+	else if (volume > SIDETONE_MAX_VOLUME)
+	{
+		volume = SIDETONE_MAX_VOLUME;
+	}
+
+	_volume = volume;
+	calculateCounts();
+}
+
+void SCRadioSidetone::keyDown()
+{
+	if (_volume == 0)
+	{
+		return;
+	}
+
+	noInterrupts();
+
+	_keyDown = true;
+
+	// If the tone is still dying away the timer is running.  The envelope just turns around and rises again.
+	if (!_running)
+	{
+		startTimer();
+	}
+
+	interrupts();
+}
+
+void SCRadioSidetone::keyUp()
+{
+	// The interrupt routine lets the tone die away and then stops the timer
+	_keyDown = false;
+}
+
+void SCRadioSidetone::handleTimerInterrupt()
+{
+	_timerSidetone->timerInterrupt();
+}
+
+void SCRadioSidetone::timerInterrupt()
+{
+	// End of the high part.  Pin goes low for the rest of the cycle.
+	if (_pinHigh)
+	{
+		*_tonePort &= ~_toneMask;
+		OCR2A = _lowCounts - 1;   // counts 0 through OCR2A, so one less
+		_pinHigh = false;
+		return;
+	}
+
+	// Start of a new cycle.  Moving the envelope one step up while the key is down, or down while it is up.
+	if (_keyDown)
+	{
+		if (_envelopeStep < (SIDETONE_ENVELOPE_STEPS - 1))
+		{
+			_envelopeStep++;
+		}
+	}
+	else if (_envelopeStep > 0)
+	{
+		_envelopeStep--;
+	}
+
+	// All the way down.  The tone has died away.
+	if (_envelopeStep == 0)
+	{
+		stopTimer();
+		return;
+	}
+
+	// (counts * level) >> 8 is counts * level / 256 done with a shift instead of a divide
+	uint8_t highCounts = ((uint16_t)_fullHighCounts * pgm_read_byte(&kSidetoneEnvelope[_envelopeStep])) >> 8;
+
+	// Too quiet to have a high part at all.  Staying low for the whole cycle.
+	if (highCounts == 0)
+	{
+		OCR2A = _periodCounts - 1;
+		return;
+	}
+
+	*_tonePort |= _toneMask;
+	OCR2A = highCounts - 1;
+	_lowCounts = _periodCounts - highCounts;
+	_pinHigh = true;
+}
+
+void SCRadioSidetone::calculateCounts()
+{
+	// Rounding to the nearest count
+	uint8_t periodCounts = (SIDETONE_TIMER_COUNTS_PER_SECOND + (_pitchHz / 2)) / _pitchHz;
+
+	// At full volume the high part is half the cycle (a square wave, the loudest it gets)
+	uint8_t fullHighCounts = ((uint16_t)periodCounts * _volume) / (2 * SIDETONE_MAX_VOLUME);
+
+	// The interrupt picks these up at the start of its next cycle
+	noInterrupts();
+	_periodCounts = periodCounts;
+	_fullHighCounts = fullHighCounts;
+	interrupts();
+}
+
+void SCRadioSidetone::startTimer()
+{
+	_envelopeStep = 0;
+	_pinHigh = false;
+	_running = true;
+
+	TCCR2A = _BV(WGM21);                     // no output pins, CTC mode (count up to OCR2A then start over)
+	TCCR2B = _BV(CS22) | _BV(CS21);          // clock / 256
+	TCNT2 = 0;
+	OCR2A = 1;                               // first interrupt (start of the first cycle) right away
+	TIFR2 = _BV(OCF2A);                      // throwing away any interrupt left over from last time
+	TIMSK2 |= _BV(OCIE2A);                   // interrupt each time it reaches OCR2A
+}
+
+void SCRadioSidetone::stopTimer()
+{
+	TIMSK2 &= ~_BV(OCIE2A);
+	TCCR2B = 0;                              // no clock, so the timer stops counting
+	*_tonePort &= ~_toneMask;
+	_pinHigh = false;
+	_running = false;
+}
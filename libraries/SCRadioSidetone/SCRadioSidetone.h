@@ -0,0 +1,263 @@
+/**
+ * SCRadioSidetone.h - Class for making the CW sidetone with Timer2
+ *
+ * Why does this exist?
+ *
+ * With the key down you want to hear what you are sending.  The tone is made entirely
+ * by Timer2 and its interrupt routine, so the main loop doesn't spend any time on it.
+ *
+ * Timer2's own output pins (D3 and D11) are already used by the knob and the DDS, so the
+ * interrupt routine switches SIDETONE_PIN itself.  Each cycle of the tone is a high part
+ * and a low part, and the timer interrupts at the end of each part:
+ *
+ *   ___|‾‾‾‾‾|_______|‾‾‾‾‾|_______
+ *      | high|  low  |
+ *      |<-- period ->|
+ *
+ * The longer the high part (up to half the cycle) the louder the tone, so the volume
+ * is set by the high part's length.  When the key goes down the high part grows over a
+ * few cycles following a raised cosine curve, and when it comes up it shrinks the same
+ * way.  A tone switched on and off all at once clicks.  This doesn't.  Once the tone has
+ * died away the timer stops itself.
+ *
+ * The tone follows the KEY_LINE_CHANGED events, the same ones that key the transmitter.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioSidetone_h
+#define SCRadioSidetone_h
+
+#include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
+
+/**
+ * Number of steps in the rise (and fall) of the tone, counting silent as a step.
+ * The envelope moves one step each cycle of the tone.
+ */
+#define SIDETONE_ENVELOPE_STEPS 5
+
+class SCRadioSidetone
+{
+private:
+	// private member data
+
+	/**
+	 * Arduino pin the tone comes out on
+	 */
+	uint8_t			_tonePin;
+
+	/**
+	 * Output register of the port the tone pin belongs to
+	 */
+	volatile uint8_t *_tonePort;
+
+	/**
+	 * Bit mask of the tone pin within its port
+	 */
+	uint8_t			_toneMask;
+
+	/**
+	 * Tone pitch (Hz)
+	 */
+	int16_t			_pitchHz;
+
+	/**
+	 * Tone volume (0 through SIDETONE_MAX_VOLUME)
+	 */
+	int8_t			_volume;
+
+	// The following are used by the timer interrupt.  The ones loop() also changes are
+	// volatile (read from memory every time) and loop() changes them with interrupts held off.
+
+	/**
+	 * Timer2 counts in one cycle of the tone
+	 */
+	volatile uint8_t	_periodCounts;
+
+	/**
+	 * Timer2 counts in the high part of a cycle at the set volume, with the envelope all the way up
+	 */
+	volatile uint8_t	_fullHighCounts;
+
+	/**
+	 * Timer2 counts in the low part of the cycle being played
+	 */
+	uint8_t			_lowCounts;
+
+	/**
+	 * Where the envelope is (0 is silent, SIDETONE_ENVELOPE_STEPS - 1 is all the way up)
+	 */
+	uint8_t			_envelopeStep;
+
+	/**
+	 * Whether the tone pin is in the high part of a cycle
+	 */
+	bool			_pinHigh;
+
+	/**
+	 * Whether the key is down (the envelope rises while it is and falls while it isn't)
+	 */
+	volatile bool	_keyDown;
+
+	/**
+	 * Whether Timer2 is running (the interrupt routine clears this when the tone has died away)
+	 */
+	volatile bool	_running;
+
+	/**
+	 * The sidetone the timer interrupt works for.  Interrupt routines can't be
+	 * object methods, so this is how the routine finds its object.
+	 */
+	static SCRadioSidetone *_timerSidetone;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioSidetone
+	 *
+	 * @detail
+	 *   Creates a sidetone
+	 *   Note: You must call the begin() method before using the created object
+	 *
+	 * @param[in] tonePin Arduino pin the tone comes out on
+	 * @param[in] pitchHz tone pitch (Hz)
+	 * @param[in] volume tone volume (0 is off, SIDETONE_MAX_VOLUME is loudest)
+	 */
+	SCRadioSidetone(uint8_t tonePin, int16_t pitchHz, int8_t volume);
+
+	/**
+	 * begin
+	 *
+	 * @detail
+	 *   sets up object so it is ready to use - constructor type logic goes here.
+	 *   It gets called in the 'setup()' section of the main program
+	 */
+	void begin();
+
+	/**
+	 * keyLineChangedListener
+	 *
+	 * @detail
+	 *   Listens for the key going down and up and starts and stops the tone
+	 *
+	 * @param[in] eventCode identifies type of event
+	 * @param[in] eventPayload value is the KeyStatus
+	 */
+	void keyLineChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * pitchChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in the sidetone pitch
+	 *
+	 * @param[in] eventCode identifies type of event
+	 * @param[in] eventPayload menuItem holds the new pitch (Hz)
+	 */
+	void pitchChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * volumeChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in the sidetone volume
+	 *
+	 * @param[in] eventCode identifies type of event
+	 * @param[in] eventPayload menuItem holds the new volume
+	 */
+	void volumeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * setPitch
+	 *
+	 * @detail
+	 *   Sets the tone pitch.  A tone that is playing changes at the start of its next cycle.
+	 *
+	 * @param[in] pitchHz pitch (Hz).  Kept within SIDETONE_MIN_PITCH_HZ and SIDETONE_MAX_PITCH_HZ.
+	 */
+	void setPitch(int16_t pitchHz);
+
+	/**
+	 * setVolume
+	 *
+	 * @detail
+	 *   Sets the tone volume.  A tone that is playing changes at the start of its next cycle.
+	 *
+	 * @param[in] volume 0 (off) through SIDETONE_MAX_VOLUME
+	 */
+	void setVolume(int8_t volume);
+
+	/**
+	 * keyDown
+	 *
+	 * @detail
+	 *   Starts the tone (it rises over the next few cycles).  Does nothing when the volume is 0.
+	 */
+	void keyDown();
+
+	/**
+	 * keyUp
+	 *
+	 * @detail
+	 *   Stops the tone (it falls over the next few cycles and then the timer stops)
+	 */
+	void keyUp();
+
+	/**
+	 * timerInterrupt
+	 *
+	 * @detail
+	 *   Ends the high or low part of a cycle and starts the next one.  Called by the
+	 *   Timer2 interrupt.  Don't call it from anywhere else.
+	 */
+	void timerInterrupt();
+
+	/**
+	 * handleTimerInterrupt
+	 *
+	 * @detail
+	 *   Called by the Timer2 interrupt routine.  Passes the interrupt on to the sidetone.
+	 */
+	static void handleTimerInterrupt();
+
+private:
+	// private methods
+
+	/**
+	 * calculateCounts
+	 *
+	 * @detail
+	 *   Works out the Timer2 counts for the pitch and volume and hands them to
+	 *   the timer interrupt
+	 */
+	void calculateCounts();
+
+	/**
+	 * startTimer
+	 *
+	 * @detail
+	 *   Sets Timer2 to count in CTC mode and interrupt at the end of each part of a cycle.
+	 *   Call with interrupts held off.
+	 */
+	void startTimer();
+
+	/**
+	 * stopTimer
+	 *
+	 * @detail
+	 *   Stops Timer2 and leaves the tone pin low.  Call with interrupts held off.
+	 */
+	void stopTimer();
+};
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * SCRadioTuningAccelerator.cpp - Class for picking the VFO tuning step from how fast the knob is turning
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+
+#include "SCRadioTuningAccelerator.h"
+
+// Constructor
+// The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
+SCRadioTuningAccelerator::SCRadioTuningAccelerator(const SCRadioTuningCurvePoint *curve,
+													int8_t curvePointCount,
+													uint8_t smoothingShift) :
+														_curve(curve),
+														_curvePointCount(curvePointCount),
+														_smoothingShift(smoothingShift)
+{
+	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
+	// Put your logic in 'begin() instead and call it after instantiating your object.
+}
+
+void SCRadioTuningAccelerator::begin()
+{
+	_smoothedStepIntervalMicros = 0xFFFF;
+}
+
+void SCRadioTuningAccelerator::recordSteps(int16_t turnSteps, uint16_t stepIntervalMicros)
+{
+	// The knob stopped for a moment.  Start over so the next steps are fine tuning.
+	if (stepIntervalMicros == 0xFFFF)
+	{
+		_smoothedStepIntervalMicros = 0xFFFF;
+		return;
+	}
+
+	int16_t stepCount = (turnSteps < 0) ? -turnSteps : turnSteps;
+
+	// After about 16 steps at the same interval the average has caught up.  No need to go further.
+	if (stepCount > 16)
+	{
+		stepCount = 16;
+	}
+
+	int32_t smoothedStepIntervalMicros = _smoothedStepIntervalMicros;
+
+	for (int16_t step = 0; step < stepCount; step++)
+	{
+		// Moving the average part of the way toward the new interval.
+		// (difference >> shift is difference / 2^shift done with a shift instead of a divide)
+		smoothedStepIntervalMicros += ((int32_t)stepIntervalMicros - smoothedStepIntervalMicros) >> _smoothingShift;
+	}
+
+	_smoothedStepIntervalMicros = (uint16_t)smoothedStepIntervalMicros;
+}
+
+int16_t SCRadioTuningAccelerator::getTuningIncrement()
+{
+	for (int8_t point = 0; point < _curvePointCount; point++)
+	{
+		if (_smoothedStepIntervalMicros < _curve[point].maxStepIntervalMicros)
+		{
+			return _curve[point].tuningIncrementHz;
+		}
+	}
+
+	// Slower than every row.  Using the last (slowest) row.
+	return _curve[_curvePointCount - 1].tuningIncrementHz;
+}
+
+uint16_t SCRadioTuningAccelerator::getSmoothedStepIntervalMicros()
+{
+	return _smoothedStepIntervalMicros;
+}
@@ -0,0 +1,146 @@
+/**
+ * SCRadioTuningAccelerator.h - Class for picking the VFO tuning step from how fast the knob is turning
+ *
+ * Why does this exist?
+ *
+ * The VFO used to time how far apart the knob turned events were with millis() when it
+ * handled them.  That is not when the knob was turned.  A slow display update or EEPROM
+ * write bunches events up, so it needed a 'two in a row' rule to keep from jumping to a
+ * big step by mistake.
+ *
+ * The knob's interrupt routine now times each step (detent) in microseconds and sends that
+ * with the turn event.  This class smooths those times and looks the result up in a table
+ * (the acceleration curve) to get the tuning step:
+ *
+ *   const SCRadioTuningCurvePoint tuningCurve[] = {
+ *       { 15000, 1000 },      // steps less than 15 ms apart tune 1 kHz per step
+ *       { 50000, 100 },       // less than 50 ms apart tune 100 Hz per step
+ *       { 0xFFFF, 10 }        // anything slower tunes 10 Hz per step
+ *   };
+ *
+ * Smoothing uses an exponential moving average.  Each step moves the average part of the way
+ * (1/2, 1/4, 1/8 ... set by the smoothing shift) toward the new time.  One quick step doesn't
+ * jump the tuning step, but a steady spin gets there in a few steps.  When the knob stops for
+ * a moment the average starts over, so fine tuning is right back.
+ *
+ * It only does integer math on the numbers it is given.  The same steps always give the same answer.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioTuningAccelerator_h
+#define SCRadioTuningAccelerator_h
+
+#include "SCRadioConstants.h"
+
+/**
+ * SCRadioTuningCurvePoint
+ *
+ * @detail
+ *   One row of the acceleration curve
+ */
+struct SCRadioTuningCurvePoint
+{
+	/**
+	 * Use this row if the smoothed time between steps is less than this (microseconds)
+	 */
+	uint16_t maxStepIntervalMicros;
+
+	/**
+	 * Tuning step for this row (Hz)
+	 */
+	int16_t tuningIncrementHz;
+};
+
+class SCRadioTuningAccelerator
+{
+private:
+	// private member data
+
+	/**
+	 * The acceleration curve.  Fastest row first.
+	 */
+	const SCRadioTuningCurvePoint *_curve;
+
+	/**
+	 * Number of rows in the curve
+	 */
+	const int8_t _curvePointCount;
+
+	/**
+	 * How far each step moves the average.  Each step moves it 1 / 2^smoothingShift of the way.
+	 */
+	const uint8_t _smoothingShift;
+
+	/**
+	 * The smoothed time between steps (microseconds)
+	 */
+	uint16_t _smoothedStepIntervalMicros;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioTuningAccelerator
+	 *
+	 * @detail
+	 *   Creates a tuning accelerator
+	 *   Note: You must call the begin() method before using the created object
+	 *
+	 * @param[in] curve acceleration curve, fastest row first.  The last row should have 0xFFFF so every speed has a row.
+	 * @param[in] curvePointCount number of rows in the curve
+	 * @param[in] smoothingShift how far each step moves the average (1 / 2^smoothingShift of the way)
+	 */
+	SCRadioTuningAccelerator(const SCRadioTuningCurvePoint *curve, int8_t curvePointCount, uint8_t smoothingShift);
+
+	/**
+	 * begin
+	 *
+	 * @detail
+	 *   sets up object so it is ready to use - constructor type logic goes here.
+	 *   It gets called in the 'setup()' section of the main program
+	 */
+	void begin();
+
+	/**
+	 * recordSteps
+	 *
+	 * @detail
+	 *   Adds knob steps to the smoothed speed.  When several steps were merged into one event
+	 *   they are taken as evenly spaced at the interval given.
+	 *
+	 * @param[in] turnSteps steps turned (either direction)
+	 * @param[in] stepIntervalMicros microseconds between the last two steps (65535 if longer or not known)
+	 */
+	void recordSteps(int16_t turnSteps, uint16_t stepIntervalMicros);
+
+	/**
+	 * getTuningIncrement
+	 *
+	 * @detail
+	 *   Looks up the tuning step for the smoothed speed
+	 *
+	 * @returns tuning step in Hz
+	 */
+	int16_t getTuningIncrement();
+
+	/**
+	 * getSmoothedStepIntervalMicros
+	 *
+	 * @detail
+	 *   Returns the smoothed time between steps
+	 *
+	 * @returns microseconds (65535 when the knob has been still)
+	 */
+	uint16_t getSmoothedStepIntervalMicros();
+};
+
+#endif
@@ -0,0 +1,54 @@
+/**
+ * SCRadioTuningWord.cpp - Class for turning a frequency into a DDS tuning word
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+#include "SCRadioTuningWord.h"
+
+// The constructor is in the header.  It is constexpr so the compiler can run it.
+
+uint32_t SCRadioTuningWord::frequencyToTuningWord(uint32_t frequency)
+{
+	// The tuning word is:
+	//   (frequency * whole multiplier) + (frequency * fraction multiplier / 2^32)
+	//
+	// The first part is a plain 32 bit multiply.
+	//
+	// The second part needs the top 32 bits of a 32 x 32 bit multiply.  Rather than
+	// letting the compiler do a full 64 bit multiply, we break both numbers into
+	// 16 bit halves and multiply the halves (the Arduino does 16 x 16 bit multiplies
+	// quickly).  It is the same way you would multiply two digit numbers by hand.
+	//
+	//   frequency = frequencyHigh * 2^16 + frequencyLow
+	//   fraction  = fractionHigh  * 2^16 + fractionLow
+	uint16_t frequencyHigh = (uint16_t)(frequency >> 16);
+	uint16_t frequencyLow = (uint16_t)frequency;
+	uint16_t fractionHigh = (uint16_t)(_fractionMultiplier >> 16);
+	uint16_t fractionLow = (uint16_t)_fractionMultiplier;
+
+	uint32_t lowTimesLow = (uint32_t)frequencyLow * fractionLow;		// bits 0 - 31 of the product
+	uint32_t lowTimesHigh = (uint32_t)frequencyLow * fractionHigh;		// bits 16 - 47
+	uint32_t highTimesLow = (uint32_t)frequencyHigh * fractionLow;		// bits 16 - 47
+	uint32_t highTimesHigh = (uint32_t)frequencyHigh * fractionHigh;	// bits 32 - 63
+
+	// Adding up everything that lands in bits 16 - 31 so we know what carries into bit 32
+	uint32_t middleBits = (lowTimesLow >> 16) + (lowTimesHigh & 0xFFFF) + (highTimesLow & 0xFFFF);
+
+	uint32_t fractionPart = highTimesHigh + (lowTimesHigh >> 16) + (highTimesLow >> 16) + (middleBits >> 16);
+
+	// Bit 31 of the product is bit 15 of middleBits.  If it is set, the part we
+	// dropped is a half or more so we round up.
+	fractionPart += (middleBits >> 15) & 0x01;
+
+	return (frequency * _wholeMultiplier) + fractionPart;
+}
@@ -0,0 +1,124 @@
+/**
+ * SCRadioTuningWord.h - Class for turning a frequency into a DDS tuning word
+ *
+ * Why does this exist?
+ *
+ * The DDS wants a 32 bit tuning word rather than a frequency.  The tuning word is
+ * the frequency multiplied by the DDS tuning word constant (2^32 / DDS clock frequency).
+ *
+ * Doing that multiply with a float is slow on the Arduino (there is no floating point
+ * hardware) and a float only holds about 7 digits.  At 7 MHz that throws away close to
+ * a Hertz of resolution.
+ *
+ * This class does the multiply with integers only.  The tuning word constant is split
+ * into a whole number part and a 32 bit binary fraction part (fixed point) so no digits
+ * are lost.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioTuningWord_h
+#define SCRadioTuningWord_h
+
+#include "SCRadioConstants.h"
+
+class SCRadioTuningWord
+{
+private:
+	// private member data
+
+	/**
+	 * Whole number part of the DDS tuning word constant (ex: 34 for 34.359900)
+	 */
+	const uint16_t _wholeMultiplier;
+
+	/**
+	 * Fractional part of the DDS tuning word constant times 2^32
+	 * (ex: 0.359900 * 4294967296 = 1545758730 for 34.359900)
+	 */
+	const uint32_t _fractionMultiplier;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioTuningWord
+	 * 
+	 * @detail
+	 *   Creates a tuning word calculator.
+	 *   It is constexpr so, given a constant, the compiler works the multipliers out
+	 *   while compiling.  Nothing is left to do at startup.
+	 * 
+	 * @param[in] ddsTuningWordMillionths DDS tuning word constant in millionths (34.359900 is 34359900)
+	 */
+	constexpr SCRadioTuningWord(uint32_t ddsTuningWordMillionths) :
+		_wholeMultiplier((uint16_t)(ddsTuningWordMillionths / 1000000)),
+		_fractionMultiplier(fractionMultiplier(ddsTuningWordMillionths))
+	{
+	}
+
+	/**
+	 * fractionMultiplier
+	 * 
+	 * @detail
+	 *   Works out the fraction part of a DDS tuning word constant times 2^32, rounded.
+	 * 
+	 * @param[in] ddsTuningWordMillionths DDS tuning word constant in millionths (34.359900 is 34359900)
+	 * 
+	 * @returns fraction multiplier (ex: 1545758730 for 34359900)
+	 */
+	static constexpr uint32_t fractionMultiplier(uint32_t ddsTuningWordMillionths)
+	{
+		return fractionBits(ddsTuningWordMillionths % 1000000, 32, 0);
+	}
+
+	/**
+	 * frequencyToTuningWord
+	 * 
+	 * @detail
+	 *   Calculates the tuning word for a frequency, rounded to the nearest tuning word.
+	 * 
+	 * @param[in] frequency Integer representation of a frequency ex: 7.030.000 would be 7030000
+	 * 
+	 * @returns 32 bit tuning word to send to the DDS
+	 */
+	uint32_t frequencyToTuningWord(uint32_t frequency);
+
+private:
+	// private methods
+
+	/**
+	 * fractionBits
+	 * 
+	 * @detail
+	 *   Works out millionths * 2^bits / 1000000 one bit at a time (long division in binary)
+	 *   and rounds the last bit.  Keeps everything in 32 bits, so there is no 64 bit
+	 *   divide for the Arduino to do.
+	 * 
+	 * @param[in] remainder millionths left over
+	 * @param[in] bits bits still to work out
+	 * @param[in] fraction bits worked out so far
+	 * 
+	 * @returns fraction
+	 */
+	static constexpr uint32_t fractionBits(uint32_t remainder, int8_t bits, uint32_t fraction)
+	{
+		return (bits == 0) ? fraction + (((remainder << 1) >= 1000000) ? 1 : 0)
+			: ((remainder << 1) >= 1000000)
+				? fractionBits((remainder << 1) - 1000000, bits - 1, (fraction << 1) | 0x01)
+				: fractionBits(remainder << 1, bits - 1, fraction << 1);
+	}
+};
+
+static_assert(SCRadioTuningWord::fractionMultiplier(34359900UL) == 1545758730UL,
+			"SCRadioTuningWord::fractionMultiplier() is wrong");
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * SCRadioTxRxSequencer.cpp - Class for switching the rig between receive and transmit
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#include "Arduino.h"
+
+#include "SCRadioConstants.h"
+#include "SCRadioDDS.h"
+
+#include "SCRadioTxRxSequencer.h"
+
+// Constructor
+// The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
+SCRadioTxRxSequencer::SCRadioTxRxSequencer(SCRadioDDS &dds, int8_t keyOutPin, uint16_t hangMillis) :
+												_dds(dds),
+												_keyOutPin(keyOutPin),
+												_hangMicros((uint32_t)hangMillis * 1000)
+{
+	// Don't bother putting any logic here.  Arduino constructors are not.  This section will never run.
+	// Put your logic in 'begin() instead and call it after instantiating your object.
+}
+
+void SCRadioTxRxSequencer::begin()
+{
+	pinMode(_keyOutPin, OUTPUT);
+	digitalWrite(_keyOutPin, LOW);
+
+	_state = TxRxSequencerState::RX;
+
+	resetTimings();
+}
+
+void SCRadioTxRxSequencer::loop()
+{
+	switch (_state)
+	{
+	case TxRxSequencerState::WAITING_FOR_TX:
+		// The transmitter is only keyed once the DDS is actually on the transmit frequency.
+		// Otherwise the start of each element could go out on the receive frequency.
+		if (_dds.isFrameLatched())
+		{
+			keyOut();
+		}
+		break;
+	case TxRxSequencerState::HANG:
+	{
+		// (subtracting and comparing the difference still works when micros() wraps around)
+		uint32_t sinceKeyUpMicros = micros() - _keyUpMicros;
+
+		if (sinceKeyUpMicros >= _hangMicros)
+		{
+			returnToRx(sinceKeyUpMicros);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void SCRadioTxRxSequencer::hangTimeChangedListener(int eventCode, SCRadioEventPayload eventPayload)
+{
+	setHangTime(eventPayload.menuItem.value);
+}
+
+void SCRadioTxRxSequencer::setHangTime(uint16_t hangMillis)
+{
+	_hangMicros = (uint32_t)hangMillis * 1000;
+}
+
+void SCRadioTxRxSequencer::setFrequencies(int32_t txFrequency, int32_t rxFrequency)
+{
+	_dds.buildFrame(txFrequency, _txFrame);
+	_dds.buildFrame(rxFrequency, _rxFrame);
+}
+
+void SCRadioTxRxSequencer::retuneReceiver()
+{
+	// While transmitting the new frame is picked up when the hang time is over
+	if (_state == TxRxSequencerState::RX)
+	{
+		_dds.queueFrame(_rxFrame);
+	}
+}
+
+void SCRadioTxRxSequencer::keyDown()
+{
+	if (isTransmitting())
+	{
+		// Already keyed
+		return;
+	}
+
+	_keyDownMicros = micros();
+	_state = TxRxSequencerState::WAITING_FOR_TX;
+
+	// Waiting for the main loop to send the frame would hold the key out back by up to a
+	// whole loop.  So it goes to the DDS right now.  During the hang the DDS is normally
+	// still on the transmit frequency and this sends nothing.  If the frequency was
+	// changed during the hang the new transmit frame goes out here.
+	_dds.sendFrameToDDS(_txFrame);
+
+	// The DDS has the transmit frame now, so this keys the transmitter right away
+	loop();
+}
+
+void SCRadioTxRxSequencer::keyUp()
+{
+	// Unkeying can't wait.  The pin drops right away (and a key out that
+	// was still waiting for the DDS is cancelled).
+	digitalWrite(_keyOutPin, LOW);
+
+	if (_state == TxRxSequencerState::RX)
+	{
+		return;
+	}
+
+	_keyUpMicros = micros();
+	_state = TxRxSequencerState::HANG;
+
+	// With no hang time this goes straight back to receive
+	loop();
+}
+
+bool SCRadioTxRxSequencer::isReceiving()
+{
+	return (_state == TxRxSequencerState::RX);
+}
+
+bool SCRadioTxRxSequencer::isTransmitting()
+{
+	return (_state == TxRxSequencerState::WAITING_FOR_TX) || (_state == TxRxSequencerState::KEYED);
+}
+
+void SCRadioTxRxSequencer::print()
+{
+	Serial.println(F("switch,min,max,mean,count"));
+
+	Serial.print(F("keyOutDelay,"));
+
+	if (_keyOutCount == 0)
+	{
+		Serial.println(F("0,0,0,0"));
+	}
+	else
+	{
+		Serial.print(_minKeyOutDelayMicros);
+		Serial.print(',');
+		Serial.print(_maxKeyOutDelayMicros);
+		Serial.print(',');
+		Serial.print(_totalKeyOutDelayMicros / _keyOutCount);
+		Serial.print(',');
+		Serial.println(_keyOutCount);
+	}
+
+	Serial.print(F("hangOvershoot,,"));
+	Serial.print(_maxHangOvershootMicros);
+	Serial.print(F(",,"));
+	Serial.println(_returnToRxCount);
+}
+
+void SCRadioTxRxSequencer::resetTimings()
+{
+	_minKeyOutDelayMicros = 0xFFFFFFFF;
+	_maxKeyOutDelayMicros = 0;
+	_totalKeyOutDelayMicros = 0;
+	_keyOutCount = 0;
+	_maxHangOvershootMicros = 0;
+	_returnToRxCount = 0;
+}
+
+// private methods
+
+void SCRadioTxRxSequencer::keyOut()
+{
+	digitalWrite(_keyOutPin, HIGH);
+	_state = TxRxSequencerState::KEYED;
+
+	uint32_t keyOutDelayMicros = micros() - _keyDownMicros;
+
+	if (keyOutDelayMicros < _minKeyOutDelayMicros)
+	{
+		_minKeyOutDelayMicros = keyOutDelayMicros;
+	}
+
+	if (keyOutDelayMicros > _maxKeyOutDelayMicros)
+	{
+		_maxKeyOutDelayMicros = keyOutDelayMicros;
+	}
+
+	// Stop adding once the count is as high as it goes so the average stays right
+	if (_keyOutCount < 0xFFFF)
+	{
+		_totalKeyOutDelayMicros += keyOutDelayMicros;
+		_keyOutCount++;
+	}
+}
+
+void SCRadioTxRxSequencer::returnToRx(uint32_t sinceKeyUpMicros)
+{
+	_state = TxRxSequencerState::RX;
+
+	// Like keyDown(), straight to the DDS.  Queued, the frame would only start going out at
+	// the next main loop pass (the DDS's loop() runs before this one), and the receiver
+	// would stay on the transmit frequency until then.
+	_dds.sendFrameToDDS(_rxFrame);
+
+	uint32_t hangOvershootMicros = sinceKeyUpMicros - _hangMicros;
+
+	if (hangOvershootMicros > _maxHangOvershootMicros)
+	{
+		_maxHangOvershootMicros = hangOvershootMicros;
+	}
+
+	if (_returnToRxCount < 0xFFFF)
+	{
+		_returnToRxCount++;
+	}
+}
@@ -0,0 +1,274 @@
+/**
+ * SCRadioTxRxSequencer.h - Class for switching the rig between receive and transmit
+ *
+ * Why does this exist?
+ *
+ * The VFO used to retune the DDS and set the key out pin itself each time the key went
+ * down or up.  So the receiver got retuned between every element, even in the middle of
+ * a character.  This class does the switching in a set order:
+ *
+ *   key down:  DDS to the transmit frequency (sent right then, not from the main loop),
+ *              then key out goes high once it has latched
+ *   key up:    key out goes low right away, then the transmit frequency is held for the
+ *              hang time.  If the key goes down again in that time the transmitter is keyed
+ *              straight away, since the DDS is already there.
+ *   hang over: DDS back to the receive frequency
+ *
+ * The transmit and receive DDS frames are built when the frequencies change, so switching
+ * only sends a frame that is ready to go.  The hang time is timed with micros().
+ *
+ * It also keeps track of how long it took from the key going down to key out going high
+ * and how late the hang time ended.  print() sends those to the serial monitor.  How far
+ * apart the shortest and longest are is the jitter in the switching.
+ *
+ * Copyright (c) 2016 - Richard Young Dodd
+ *
+ * Richard Young Dodd licenses this file to you under the MIT license.
+ * See the LICENSE file in the project root for more information.
+ * If you did not receive the 'LICENSE' file with this software
+ * see <https://opensource.org/licenses/MIT>.
+ *
+ * @author Richard Y. Dodd - K4KRW
+ * @version 1.0.3  12/22/2016.
+ */
+
+#ifndef SCRadioTxRxSequencer_h
+#define SCRadioTxRxSequencer_h
+
+#include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
+#include "SCRadioDDS.h"
+
+class SCRadioTxRxSequencer
+{
+private:
+	// private member data
+
+	/**
+	 * Object actually interacting directly with DDS
+	 */
+	SCRadioDDS &_dds;
+
+	/**
+	 * Arduino pin number that is sending the keying signal to the transceiver
+	 */
+	const int8_t _keyOutPin;
+
+	/**
+	 * How long the transmit frequency is held after the key comes up (microseconds)
+	 */
+	uint32_t _hangMicros;
+
+	// The DDS frames are built whenever the frequency, RIT or rx offset changes.
+	// That way switching only has to send a frame that is ready to go.
+
+	/**
+	 * DDS frame for the current transmit frequency
+	 */
+	SCRadioDDSFrame _txFrame;
+
+	/**
+	 * DDS frame for the current receive frequency
+	 */
+	SCRadioDDSFrame _rxFrame;
+
+	/**
+	 * Where we are in switching between receive and transmit
+	 */
+	TxRxSequencerState _state;
+
+	/**
+	 * micros() when the key last went down
+	 */
+	uint32_t _keyDownMicros;
+
+	/**
+	 * micros() when the key last came up
+	 */
+	uint32_t _keyUpMicros;
+
+	// switching times (see print())
+
+	/**
+	 * Shortest time from the key going down to key out going high (microseconds)
+	 */
+	uint32_t _minKeyOutDelayMicros;
+
+	/**
+	 * Longest time from the key going down to key out going high (microseconds)
+	 */
+	uint32_t _maxKeyOutDelayMicros;
+
+	/**
+	 * All of the key down to key out times added up (for the average)
+	 */
+	uint32_t _totalKeyOutDelayMicros;
+
+	/**
+	 * Number of times key out went high
+	 */
+	uint16_t _keyOutCount;
+
+	/**
+	 * Longest the hang time ran past what it was set to (microseconds)
+	 */
+	uint32_t _maxHangOvershootMicros;
+
+	/**
+	 * Number of times the hang time ran out and the DDS went back to receive
+	 */
+	uint16_t _returnToRxCount;
+
+public:
+	// public methods
+
+	/**
+	 * SCRadioTxRxSequencer
+	 *
+	 * @detail
+	 *   Creates a tx/rx sequencer
+	 *   Note: You must call the begin() method before using the created object
+	 *
+	 * @param[in] dds interacts with DDS hardware
+	 * @param[in] keyOutPin Arduino pin that keys the transmitter
+	 * @param[in] hangMillis how long the transmit frequency is held after the key comes up (milliseconds)
+	 */
+	SCRadioTxRxSequencer(SCRadioDDS &dds, int8_t keyOutPin, uint16_t hangMillis);
+
+	/**
+	 * begin
+	 *
+	 * @detail
+	 *   sets up object so it is ready to use - constructor type logic goes here.
+	 *   It gets called by the VFO's begin()
+	 */
+	void begin();
+
+	/**
+	 * loop
+	 *
+	 * @detail
+	 *   Call this once each time the main application loop runs.
+	 *   Keys the transmitter once the DDS is on the transmit frequency and
+	 *   goes back to the receive frequency once the hang time is over.
+	 */
+	void loop();
+
+	/**
+	 * hangTimeChangedListener
+	 *
+	 * @detail
+	 *   Listens for changes in the hang time
+	 *
+	 * @param[in] eventCode Identifies which event type
+	 * @param[in] eventPayload menuItem holds the new hang time (milliseconds)
+	 */
+	void hangTimeChangedListener(int eventCode, SCRadioEventPayload eventPayload);
+
+	/**
+	 * setHangTime
+	 *
+	 * @detail
+	 *   Sets how long the transmit frequency is held after the key comes up
+	 *
+	 * @param[in] hangMillis hang time (milliseconds).  0 goes back to receive right away.
+	 */
+	void setHangTime(uint16_t hangMillis);
+
+	/**
+	 * setFrequencies
+	 *
+	 * @detail
+	 *   Builds the DDS frames for the transmit and receive frequencies.
+	 *   Doesn't send anything to the DDS (see retuneReceiver()).
+	 *
+	 * @param[in] txFrequency transmit frequency (Hz)
+	 * @param[in] rxFrequency receive frequency (Hz)
+	 */
+	void setFrequencies(int32_t txFrequency, int32_t rxFrequency);
+
+	/**
+	 * retuneReceiver
+	 *
+	 * @detail
+	 *   Sends the receive frequency to the DDS if we are receiving.  While transmitting
+	 *   it waits until the hang time is over.
+	 */
+	void retuneReceiver();
+
+	/**
+	 * keyDown
+	 *
+	 * @detail
+	 *   Switches to transmit.  Key out goes high once the DDS is on the transmit frequency.
+	 */
+	void keyDown();
+
+	/**
+	 * keyUp
+	 *
+	 * @detail
+	 *   Key out goes low right away.  The DDS goes back to receive after the hang time.
+	 */
+	void keyUp();
+
+	/**
+	 * isReceiving
+	 *
+	 * @detail
+	 *   Tells whether the rig is receiving.  It isn't while the key is down or during the hang time.
+	 *
+	 * @returns true if receiving
+	 */
+	bool isReceiving();
+
+	/**
+	 * isTransmitting
+	 *
+	 * @detail
+	 *   Tells whether the key is down.  During the hang time it isn't (and the rig isn't
+	 *   receiving either), so the frequency can still be changed.
+	 *
+	 * @returns true if the key is down
+	 */
+	bool isTransmitting();
+
+	/**
+	 * print
+	 *
+	 * @detail
+	 *   Sends the switching times to the serial monitor as comma separated text
+	 */
+	void print();
+
+	/**
+	 * resetTimings
+	 *
+	 * @detail
+	 *   Clears the switching times
+	 */
+	void resetTimings();
+
+private:
+	// private methods
+
+	/**
+	 * keyOut
+	 *
+	 * @detail
+	 *   Sets key out high and records how long it took since the key went down
+	 */
+	void keyOut();
+
+	/**
+	 * returnToRx
+	 *
+	 * @detail
+	 *   Sends the receive frequency to the DDS and records how late the hang time ended
+	 *
+	 * @param[in] sinceKeyUpMicros microseconds since the key came up
+	 */
+	void returnToRx(uint32_t sinceKeyUpMicros);
+};
+
+#endif
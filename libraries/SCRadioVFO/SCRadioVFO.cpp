@@ -13,14 +13,15 @@
 */
 
 #include "Arduino.h"
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 #include "WString.h"
 
 #include "ISCRadioReadOnlyMenuItem.h"
 #include "SCRadioConstants.h"
-#include "SCRadioDDS.h"
 #include "SCRadioEventData.h"
 #include "SCRadioFrequency.h"
+#include "SCRadioTuningAccelerator.h"
+#include "SCRadioTxRxSequencer.h"
 
 //#pragma GCC diagnostic push
 //#pragma GCC diagnostic ignored "-Wreorder"
@@ -29,32 +30,20 @@
 
 // Constructor
 // The logic after the ':' is initializer logic.  It will assign the input parameter values to object instance variables.
-SCRadioVFO::SCRadioVFO(EventManager &eventManager,
+SCRadioVFO::SCRadioVFO(SCRadioEventQueue &eventManager,
 	          SCRadioEventData &eventData,
-	          SCRadioDDS &dds,
-	          int8_t keyOutPin,
-	          float ddsTuningWord,
+	          SCRadioTxRxSequencer &txRxSequencer,
 	          int32_t rxOffset,
     				int32_t lowerFrequencyLimit,
     				int32_t upperFrequencyLimit,
     				int32_t ritMaxOffsetHz,
-    				int16_t slowTuningIncrement,
-    				int16_t mediumTuningIncrement,
-    				int16_t fastTuningIncrement,
-    				uint16_t mediumTuningThresholdms,
-    				uint16_t fastTuningThresholdms) : 
+    				SCRadioTuningAccelerator &tuningAccelerator) : 
 						_eventManager(eventManager),
     					_eventData(eventData),
-    					_dds(dds),
-    					_ddsTuningWord(ddsTuningWord),
+    					_txRxSequencer(txRxSequencer),
     					_lowerFrequencyLimit(lowerFrequencyLimit),
 						_upperFrequencyLimit(upperFrequencyLimit),
-    					_slowTuningIncrement(slowTuningIncrement),
-    					_mediumTuningIncrement(mediumTuningIncrement),
-    					_fastTuningIncrement(fastTuningIncrement),
-    					_mediumTuningThresholdms(mediumTuningThresholdms),
-    					_fastTuningThresholdms(fastTuningThresholdms),
-						_keyOutPin(keyOutPin),
+    					_tuningAccelerator(tuningAccelerator),
 						_rxOffset(rxOffset),
 						_ritMaxOffsetHz(ritMaxOffsetHz)
 {
@@ -68,45 +57,58 @@ SCRadioVFO::SCRadioVFO(EventManager &eventManager,
 // logic would normally be in a constructor.
 void SCRadioVFO::begin()
 {
-	initializeKeyOutPin();
+	_txRxSequencer.begin();
 
 	// set some class status variables
 	_ritStatus = RitStatus::DISABLED;
-	_rxTXStatus = RxTxStatus::RX;
-	_currentTuningIncrement = _slowTuningIncrement;
+	_tuningAccelerator.begin();
+	_currentTuningIncrement = _tuningAccelerator.getTuningIncrement();
 	_currentTXFrequency = _initialFrequency;
+	_ritOffsetHz = 0;
 	_ritUpperLimitHz = _ritMaxOffsetHz;
 	_ritLowerLimitHz = _ritMaxOffsetHz * -1;
 
-	// initialize data in the eventData object which holds values needed by all 
-	// event handling logic.  Since we can't pass an object with the event message
-	// the _eventData class holds the data we would normally pass with the event message
-	_eventData.setEventRelatedLong(0, EventLongField::RIT_OFFSET);
+	// initialize the flags in the eventData object the display uses to show
+	// the RIT and rx offset status next to the frequency
 	_eventData.setEventRelatedBool(false, EventBoolField::RIT_IS_ENABLED);
 	_eventData.setEventRelatedBool(false, EventBoolField::RX_OFFSET_IS_POSITIVE);
 
 	calculateRXFrequency();
 }
 
-void SCRadioVFO::keyLineChangedListener(int eventCode, int keyStatus)
+void SCRadioVFO::loop()
+{
+	// The transmitter is only keyed once the DDS is actually on the transmit frequency,
+	// and the DDS goes back to receive once the hang time is over.
+	_txRxSequencer.loop();
+}
+
+void SCRadioVFO::keyLineChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
 	// respond to CW key press
-	sendToDDSTxRxFrequencyAndChangeTxRxStatus(keyStatus);
+	if ((KeyStatus)eventPayload.value == KeyStatus::PRESSED)
+	{
+		_txRxSequencer.keyDown();
+	}
+	else
+	{
+		_txRxSequencer.keyUp();
+	}
 }
 
-void SCRadioVFO::ritKnobTurnedListener(int eventCode, int turnDirection)
+void SCRadioVFO::ritKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeRITOffset(turnDirection);
+	changeRITOffset(eventPayload.knobTurn.steps);
 }
 
-void SCRadioVFO::ritStatusChangedListener(int eventCode, int whichMenuItem)
+void SCRadioVFO::ritStatusChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeRITStatus(whichMenuItem);
+	changeRITStatus((RitStatus)eventPayload.menuItem.value);
 }
 
-void SCRadioVFO::rxOffsetDirectionChangedListener(int eventCode, int whichMenuItem)
+void SCRadioVFO::rxOffsetDirectionChangedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	changeRxOffsetDirection(whichMenuItem);
+	changeRxOffsetDirection((RxOffsetDirection)eventPayload.menuItem.value);
 }
 
 void SCRadioVFO::setInitialFrequency(int32_t initialFrequency)
@@ -117,97 +119,71 @@ void SCRadioVFO::setInitialFrequency(int32_t initialFrequency)
 	// And everything (DDS, eventData, display) will have the correct frequency information
 	_initialFrequency.replaceValue((int32_t)(initialFrequency - 10));
 	_currentTXFrequency.replaceValue((int32_t)(initialFrequency - 10));
-	_eventData.setEventRelatedFrequency(&_currentTXFrequency, EventFrequencyField::OPERATING_FREQUENCY);
+
+	// make sure the DDS frames match the new frequency right away
+	calculateRXFrequency();
 }
 
-void SCRadioVFO::vfoKnobTurnedListener(int eventCode, int turnDirection)
+void SCRadioVFO::vfoKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload)
 {
-	// I don't want to change the frequency while transmitting.  So, I just bail
-	if (_rxTXStatus == RxTxStatus::TX)
+	// I don't want to change the frequency while transmitting.  So, I just bail.
+	// During the hang time it changes and goes to the DDS at the next key down or back to receive.
+	if (_txRxSequencer.isTransmitting())
 	{
 		return;
 	}
 
-	calculateTuningIncrement();
+	calculateTuningIncrement(eventPayload.knobTurn);
 
-	changeFrequency(turnDirection);
+	changeFrequency(eventPayload.knobTurn.steps);
 }
 
 // private methods
 
 // calculate RX frequency happens every time the tx frequency, rit or rx offset direction change.
-// we use the calculated value every time we switch to rx status.
+// we use the calculated value (and the DDS frames built from it) every time we switch to rx status.
 void SCRadioVFO::calculateRXFrequency()
 {
 	_currentRXFrequency.replaceValue(_currentTXFrequency);
 
 	_currentRXFrequency.addHertz(_rxOffset);
 
-	long currentRITOffsetHz = _eventData.getEventRelatedLong(EventLongField::RIT_OFFSET);
-
 	if (_ritStatus == RitStatus::ENABLED)
 	{
-		_currentRXFrequency.addHertz(currentRITOffsetHz);
+		_currentRXFrequency.addHertz(_ritOffsetHz);
 	}
+
+	// every change to the rx frequency goes through here, so this is where we
+	// get the DDS frames ready for the next key up or key down
+	buildDDSFrames();
 }
 
-void SCRadioVFO::calculateTuningIncrement() 
+void SCRadioVFO::buildDDSFrames()
 {
-	uint32_t currentMillis = millis();
-	int16_t calculatedIncrement;
-
-	// Since these are static method variables, they will retain their value
-	// between calls to this method.  They are only set to zero on the first call
-	static int16_t lastCalculatedIncrement = 0;
-	static uint32_t mSecsAtLastKnobTurn	= 0;
-
-	// timediff is the number of milliseconds since the last knob turn event
-	uint16_t timeDiff = currentMillis - mSecsAtLastKnobTurn;
-  
-	if (timeDiff > _mediumTuningThresholdms) 
-	{
-		calculatedIncrement = _slowTuningIncrement;
-	} 
-	else if (timeDiff > _fastTuningThresholdms) 
-		{
-			calculatedIncrement = _mediumTuningIncrement;
-		} 
-		else 
-		{
-			calculatedIncrement = _fastTuningIncrement;
-		}
-	
-	// I had a problem with the tuning increment where I believe on board events
-	// were causing the millis() to return abnormally low millisecond values 
-	// (millis clock does not increment during interrupts)
-	// So, to move to a larger tuning increment, 
-	// I require two larger calculated tuning increments in a row.
-	// to move to a smaller tuning increment, I don't
-	if ((calculatedIncrement < _currentTuningIncrement)
-	   || (calculatedIncrement == lastCalculatedIncrement))
-	{
-		_currentTuningIncrement = calculatedIncrement;
-	}
-	
-	lastCalculatedIncrement = calculatedIncrement;
-	
-	mSecsAtLastKnobTurn = currentMillis;
+	_txRxSequencer.setFrequencies(_currentTXFrequency.asInt32(), _currentRXFrequency.asInt32());
 }
 
-void SCRadioVFO::changeFrequency(int8_t turnDirection)
+void SCRadioVFO::calculateTuningIncrement(const SCRadioEventKnobTurnPayload &knobTurn) 
+{
+	// The time between steps comes from the knob's interrupt routine, so it is when the knob
+	// actually turned rather than when we got around to handling the event.
+	_tuningAccelerator.recordSteps(knobTurn.steps, knobTurn.stepIntervalMicros);
+
+	_currentTuningIncrement = _tuningAccelerator.getTuningIncrement();
+}
+
+void SCRadioVFO::changeFrequency(int16_t turnSteps)
 {
 	SCRadioFrequency lastTXFrequency(_currentTXFrequency);
 
 	SCRadioFrequency newTXFrequency(_currentTXFrequency);
 
-	if ((KnobTurnDirection)turnDirection == KnobTurnDirection::CLOCKWISE)
-	{
-		newTXFrequency.addHertz(_currentTuningIncrement);
-	}
-	else
-	{
-		newTXFrequency.addHertz(_currentTuningIncrement * -1);
-	}
+	// Several steps at a large increment can be more than addHertz() can take (32767 Hz).
+	// So the change is added as kilohertz and then the hertz left over.
+	int32_t hertzToAdd = (int32_t)_currentTuningIncrement * turnSteps;
+
+	newTXFrequency.addKiloHertz((int16_t)(hertzToAdd / 1000));
+	newTXFrequency.addHertz((int16_t)(hertzToAdd % 1000));
 
 	if (newTXFrequency.equals(lastTXFrequency))
 	{
@@ -221,41 +197,35 @@ void SCRadioVFO::changeFrequency(int8_t turnDirection)
 
 	calculateRXFrequency();
 
-	_dds.sendFrequencyToDDS(_currentRXFrequency.asInt32());
-
-	// store off new value in eventData so display can pick it up when it gets frequency changed message
-	_eventData.setEventRelatedFrequency(&_currentTXFrequency, EventFrequencyField::OPERATING_FREQUENCY);
+	_txRxSequencer.retuneReceiver();
 
-	_eventManager.queueEvent(static_cast<int>(EventType::FREQUENCY_CHANGED), static_cast<int>(EventFrequencyField::OPERATING_FREQUENCY));
+	// the new frequency goes out with the message so the display and EEPROM don't have to look it up
+	_eventManager.queueEvent(static_cast<int>(EventType::FREQUENCY_CHANGED), _currentTXFrequency.asInt32());
 }
 
-void SCRadioVFO::changeRITStatus(int8_t whichMenuItem)
+void SCRadioVFO::changeRITStatus(RitStatus ritStatus)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-
-	long menuItemValue = menuItem->getMenuItemValue();
-
-	_ritStatus = (RitStatus)menuItemValue;
+	_ritStatus = ritStatus;
 
 	// this value is used by the display when it gets notified that RIT status changed
 	_eventData.setEventRelatedBool((_ritStatus == RitStatus::ENABLED), EventBoolField::RIT_IS_ENABLED);
 
 	calculateRXFrequency();
 
-	_dds.sendFrequencyToDDS(_currentRXFrequency.asInt32());
+	_txRxSequencer.retuneReceiver();
 }
 
-void SCRadioVFO::changeRITOffset(int8_t turnDirection)
+void SCRadioVFO::changeRITOffset(int16_t turnSteps)
 {
 	int32_t newRITOffsetHz;
 
 	// if we are transmitting, don't respond to RIT change requests
-	if (_rxTXStatus == RxTxStatus::TX)
+	if (_txRxSequencer.isTransmitting())
 	{
 		return;
 	}
 
-	long currentRITOffsetHz = _eventData.getEventRelatedLong(EventLongField::RIT_OFFSET);
+	int32_t currentRITOffsetHz = _ritOffsetHz;
 
 	// if current rit setting is zero, we are changing it to a non-zero value.  So, turn rit on.
 	if (currentRITOffsetHz == 0)
@@ -263,16 +233,7 @@ void SCRadioVFO::changeRITOffset(int8_t turnDirection)
 		initiateRITStatusChange(RitStatus::ENABLED);
 	}
 
-	newRITOffsetHz = currentRITOffsetHz;
-
-	if (turnDirection == 1)
-	{
-		newRITOffsetHz += RIT_ADJUST_INCREMENT;
-	}
-	else
-	{
-		newRITOffsetHz -= RIT_ADJUST_INCREMENT;
-	}
+	newRITOffsetHz = currentRITOffsetHz + (int32_t)RIT_ADJUST_INCREMENT * turnSteps;
 
 	newRITOffsetHz = checkRITBoundariesAndCorrectIfNeeded(newRITOffsetHz);
 
@@ -285,15 +246,14 @@ void SCRadioVFO::changeRITOffset(int8_t turnDirection)
 		initiateRITStatusChange(RitStatus::DISABLED);
 	}
 
-	// store away in event data so Display can pick up the value to display
-	_eventData.setEventRelatedLong(currentRITOffsetHz, EventLongField::RIT_OFFSET);
+	_ritOffsetHz = currentRITOffsetHz;
 
 	// update the rx frequency to reflect the new RIT adjustment
 	calculateRXFrequency();
 
-	_dds.sendFrequencyToDDS(_currentRXFrequency.asInt32());
+	_txRxSequencer.retuneReceiver();
 
-	// inform world is RIT is changed (display picks this up)
+	// inform world is RIT is changed (display picks this up and shows the new offset sent with it)
 	_eventManager.queueEvent(static_cast<int>(EventType::RIT_CHANGED), currentRITOffsetHz);
 }
 
@@ -305,16 +265,11 @@ void SCRadioVFO::initiateRITStatusChange(RitStatus ritStatus)
 	_eventData.setEventRelatedBool((_ritStatus == RitStatus::ENABLED), EventBoolField::RIT_IS_ENABLED);
 
 	// this tells the menu item to update so it shows the correct RIT status
-	_eventManager.queueEvent(static_cast<int>(EventType::RIT_STATUS_EXTERNALLY_CHANGED), static_cast<int>(ritStatus));
+	_eventManager.queueMenuItemEvent(static_cast<int>(EventType::RIT_STATUS_EXTERNALLY_CHANGED), EVENT_PAYLOAD_NO_MENU_ITEM, static_cast<int16_t>(ritStatus));
 }
 
-void SCRadioVFO::changeRxOffsetDirection(int8_t whichMenuItem)
+void SCRadioVFO::changeRxOffsetDirection(RxOffsetDirection rxOffsetDirection)
 {
-	ISCRadioReadOnlyMenuItem* menuItem = _eventData.getReadOnlyMenuItem(whichMenuItem);
-	long menuItemValue = menuItem->getMenuItemValue();
-
-	RxOffsetDirection rxOffsetDirection = (RxOffsetDirection)menuItemValue;
-
 	if (((RxOffsetDirection::BELOW == rxOffsetDirection)
 		&& (_rxOffset > 0))
 		|| ((RxOffsetDirection::ABOVE == rxOffsetDirection)
@@ -329,7 +284,7 @@ void SCRadioVFO::changeRxOffsetDirection(int8_t whichMenuItem)
 	// recalculate RX frequency to reflect the new offset
 	calculateRXFrequency();
 
-	_dds.sendFrequencyToDDS(_currentRXFrequency.asInt32());
+	_txRxSequencer.retuneReceiver();
 }
 
 void SCRadioVFO::checkBoundsAndCorrectIfNeeded(SCRadioFrequency &newTXFrequency)
@@ -362,26 +317,4 @@ int16_t SCRadioVFO::checkRITBoundariesAndCorrectIfNeeded(int16_t newRITOffsetHz)
 	}	
 
 	return newRITOffsetHz;
-}
-
-void SCRadioVFO::initializeKeyOutPin()
-{
-	pinMode(_keyOutPin, OUTPUT);
-	digitalWrite(_keyOutPin, LOW);
-}
-
-void SCRadioVFO::sendToDDSTxRxFrequencyAndChangeTxRxStatus(int16_t keyStatus)
-{
-	switch ((KeyStatus)keyStatus)
-	{
-	case KeyStatus::PRESSED:
-		_rxTXStatus = RxTxStatus::TX;
-		_dds.sendFrequencyToDDS(_currentTXFrequency.asInt32());
-		digitalWrite(_keyOutPin, HIGH);
-		break;
-	default:
-		digitalWrite(_keyOutPin, LOW);
-		_rxTXStatus = RxTxStatus::RX;
-		_dds.sendFrequencyToDDS(_currentRXFrequency.asInt32());
-	}
 }
\ No newline at end of file
@@ -16,12 +16,14 @@
 #define SCRadioVFO_h
 
 // forwards for class pointers and references
-class EventManager;
-class SCRadioDDS;
+class SCRadioEventQueue;
 class SCRadioEventData;
+class SCRadioTuningAccelerator;
+class SCRadioTxRxSequencer;
 
 // includes
 #include "SCRadioConstants.h"
+#include "SCRadioEventPayload.h"
 #include "SCRadioFrequency.h"
 
 class SCRadioVFO
@@ -33,7 +35,7 @@ private:
 	/**
 	 * Object used to enqueue new messages
 	 */
-	EventManager &_eventManager;
+	SCRadioEventQueue &_eventManager;
 
 	/**
 	 * Data needed while processing events
@@ -41,14 +43,9 @@ private:
 	SCRadioEventData &_eventData;
 
 	/**
-	 * Object actually interacting directly with DDS;
+	 * Switches the DDS and the key out pin between receive and transmit
 	 */
-	SCRadioDDS &_dds;
-
-	/**
-	 * Used to fine tune the accuracy of the DDS
-	 */
-	const float _ddsTuningWord;
+	SCRadioTxRxSequencer &_txRxSequencer;
 
 	/**
 	 * Frequency limit for the bottom of the band
@@ -76,50 +73,16 @@ private:
 	 */
 	SCRadioFrequency _currentRXFrequency;
 
-
-	// adjustable tuning increment settings
-
 	/**
-	 * Increment value when turning vfo knob slow
+	 * Picks the tuning increment from how fast the knob is turning
 	 */
-	const int16_t _slowTuningIncrement;
-
-	/**
-	 * Increment value when turning the vfo knob at a medium speed
-	 */
-	const int16_t _mediumTuningIncrement;
-
-	/**
-	 * Increment value when turning the vfo knob at a fast speed
-	 */
-	const int16_t _fastTuningIncrement;
+	SCRadioTuningAccelerator &_tuningAccelerator;
 
 	/**
 	 * The current tuning increment
 	 */
 	int16_t _currentTuningIncrement;
 
-	/**
-	 * The calculated tuning increment the last time it was computed
-	 */
-	int8_t _lastTuningIncrement;
-	
-	/**
-	 * Milliseconds boundary between slow and medium knob turn event intervals
-	 */
-	const uint16_t _mediumTuningThresholdms;
-
-	/**
-	 * Milliseconds boundary between fast and meduim knob turn event intervals
-	 */
-	const uint16_t _fastTuningThresholdms;
-
-
-	/**
-	 * Arduino pin number that is sending the keying signal to the transceiver
-	 */
-	const int8_t _keyOutPin;
-
 	/**
 	 * The current RIT status (enabled, disabled)
 	 */
@@ -135,6 +98,11 @@ private:
 	 */
 	int32_t _rxOffset;
 
+	/**
+	 * The current RIT offset
+	 */
+	int32_t _ritOffsetHz;
+
 	/**
 	 * The maximum offset for the RIT
 	 */
@@ -150,11 +118,6 @@ private:
 	 */
 	int32_t _ritLowerLimitHz;
 
-	/**
-	 * Indicates whether we are receiving or transmitting
-	 */
-	RxTxStatus _rxTXStatus;
-
 	/**
 	 * indicates whether offset is positive or negative
 	 */
@@ -170,34 +133,22 @@ public:
 	 * @detail
 	 *   Creates an instance of the SCRadioVFO class
 	 * 
-	 * @param[in] eventManager EventManager object (used to send event messages)
+	 * @param[in] eventManager SCRadioEventQueue object (used to send event messages)
 	 * @param[in] eventData holds data needed for event related logic
-	 * @param[in] dds interacts with DDS hardware
-	 * @param[in] keyOutPin Arduino pin that keys the transmitter
-	 * @param[in] ddsTuningWord Used as a means of fine tuning the frequency of the DDS
+	 * @param[in] txRxSequencer switches the DDS and the key out pin between receive and transmit
 	 * @param[in] lowerFrequencyLimit Bottom of the ham band 
 	 * @param[in] upperFrequencyLimit Top of the ham band
 	 * @param[in] ritMaxOffsetHz Maximum RIT offset
-	 * @param[in] slowTuningIncrement Frequency increment in Hertz when turning knob slow
-	 * @param[in] mediumTuningIncrement Frequency increment in Hertz when turning knob at a medium speed
-	 * @param[in] fastTuningIncrement Frequency increment in Hertz when turning knob fast
-	 * @param[in] mediumTuningThreshold Milliseconds since last knob turn boundary between slow and medium knob speed
-	 * @param[in] fastTuningThreshold Milliseconds since last knob turn boundary between medium and fast knob speed
+	 * @param[in] tuningAccelerator picks the tuning increment from how fast the knob is turning
 	 */
-	SCRadioVFO(EventManager &eventManager,
+	SCRadioVFO(SCRadioEventQueue &eventManager,
 					SCRadioEventData &eventData,
-					SCRadioDDS &dds,
-					int8_t keyOutPin,
-					float ddsTuningWord,
+					SCRadioTxRxSequencer &txRxSequencer,
 					int32_t rxOffset,
     				int32_t lowerFrequencyLimit,
     				int32_t upperFrequencyLimit,
     				int32_t ritMaxOffsetHz,
-    				int16_t slowTuningIncrement,
-    				int16_t mediumTuningIncrement,
-    				int16_t fastTuningIncrement,
-    				uint16_t mediumTuningThresholdms,
-    				uint16_t fastTuningThresholdms);
+    				SCRadioTuningAccelerator &tuningAccelerator);
 
 	/**
 	 * begin
@@ -207,6 +158,15 @@ public:
      *   It gets called in the 'setup()' section of the main program
 	 */
 	void begin();
+
+	/**
+	 * loop
+	 * 
+	 * @detail
+	 *   Call this once each time the main application loop runs.
+	 *   Lets the tx/rx sequencer key the transmitter and go back to receive when it is time.
+	 */
+	void loop();
 	
 	/**
 	 * keyLineChangedListener
@@ -215,9 +175,9 @@ public:
 	 *   Listens for key state changed events
 	 * 
 	 * @param[in] eventCode Identifies which event type
-	 * @param[in] keyStatus Indicates whether pressed or released
+	 * @param[in] eventPayload value is the KeyStatus (pressed or released)
 	 */
-	void keyLineChangedListener(int eventCode, int keyStatus); 
+	void keyLineChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* ritKnobTurnListener
@@ -226,9 +186,9 @@ public:
 	*   Listens for rit knob turned events
 	*
 	* @param[in] eventCode Identifies which event type
-	* @param[in] turnDirection Indicates which direction the knob turned
+	* @param[in] eventPayload knobTurn holds the number of steps the knob turned (+ is clockwise) and how fast
 	*/	
-	void ritKnobTurnedListener(int eventCode, int turnDirection);
+	void ritKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	* ritStatusChangedListener
@@ -237,9 +197,9 @@ public:
 	*   Listens for rit status changed events
 	*
 	* @param[in] eventCode Identifies which event type
-	* @param[in] whichMenuItem indicates which menu item sent the message
+	* @param[in] eventPayload menuItem holds the new RitStatus
 	*/
-	void ritStatusChangedListener(int eventCode, int whichMenuItem);
+	void ritStatusChangedListener(int eventCode, SCRadioEventPayload eventPayload);
    	
 	/**
 	* rxOffsetDirectionChangedListener
@@ -248,9 +208,9 @@ public:
 	*   Listens for rx Offset Direction change events
 	*
 	* @param[in] eventCode Identifies which event type
-	* @param[in] whichMenuItem indicates which menu item sent the message
+	* @param[in] eventPayload menuItem holds the new RxOffsetDirection
 	*/
-	void rxOffsetDirectionChangedListener(int eventCode, int whichMenuItem);
+	void rxOffsetDirectionChangedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 	/**
 	 * setInitialFrequency
@@ -269,9 +229,9 @@ public:
 	*   Listens for vfo knob turn event
 	*
 	* @param[in] eventCode Identifies which event type
-	* @param[in] turnDirection indicates which direction it turned
+	* @param[in] eventPayload knobTurn holds the number of steps the knob turned (+ is clockwise) and how fast
 	*/
-	void vfoKnobTurnedListener(int eventCode, int turnDirection);
+	void vfoKnobTurnedListener(int eventCode, SCRadioEventPayload eventPayload);
 
 private:
    	
@@ -294,35 +254,49 @@ private:
 	 * 
 	 * @detail
 	 *   Calculates a new receive frequency taking into account RxOffset 
-	 *   value and direction and also RIT status and setting
+	 *   value and direction and also RIT status and setting.
+	 *   Then has the DDS frames for the transmit and receive frequencies rebuilt.
 	 */
 	void calculateRXFrequency();
 
+	/**
+	 * buildDDSFrames
+	 * 
+	 * @detail
+	 *   Has the tx/rx sequencer build the DDS frames for the current transmit and
+	 *   receive frequencies so they are ready to send when the key changes state
+	 */
+	void buildDDSFrames();
+
 	/**
 	 * calculateTuningIncrement
 	 * 
 	 * @detail
-	 *   Calculates a new tuning increment value
+	 *   Calculates a new tuning increment value from the speed of the knob
+	 *
+	 * @param[in] knobTurn steps turned and the time between the last two steps
 	 */
-	void calculateTuningIncrement();
+	void calculateTuningIncrement(const SCRadioEventKnobTurnPayload &knobTurn);
    	
 	/**
 	 * changeFrequency
 	 * 
 	 * @detail
-	 *   Changes frequency based on the last knob turn direction and tuning increment
+	 *   Changes frequency by the tuning increment for each step the knob turned
 	 * 
-	 * @param[in] turnDirection
+	 * @param[in] turnSteps Number of steps the knob turned (+ is clockwise)
 	 */
-	void changeFrequency(int8_t turnDirection);
+	void changeFrequency(int16_t turnSteps);
 	
 	/**
 	 * changeRITOffset
 	 * 
 	 * @detail
-	 *   Changes the RIT offset based on the last knob turn direction and configured RIT tuning increment
+	 *   Changes the RIT offset by the configured RIT tuning increment for each step the knob turned
+	 *
+	 * @param[in] turnSteps Number of steps the knob turned (+ is clockwise)
 	 */
-	void changeRITOffset(int8_t turnDirection);
+	void changeRITOffset(int16_t turnSteps);
 	
 	/**
 	 * changeRITStatus
@@ -330,9 +304,9 @@ private:
 	 * @detail
 	 *   Changes RIT between enabled and disabled status
 	 *   
-	 * @param[in] whichMenuItem Number of menu item that directed the change
+	 * @param[in] ritStatus new RIT status
 	 */
-	void changeRITStatus(int8_t whichMenuItem);
+	void changeRITStatus(RitStatus ritStatus);
 
 	/**
 	 * changeRxOffsetDirection
@@ -340,9 +314,9 @@ private:
 	 * @detail
 	 *   Changes the RxOffset to the opposite side of the receive frequency
 	 *   
-	 * @param[in] whichMenuItem Number of menu item that directed the change
+	 * @param[in] rxOffsetDirection new offset direction
 	 */
-	void changeRxOffsetDirection(int8_t whichMenuItem);
+	void changeRxOffsetDirection(RxOffsetDirection rxOffsetDirection);
 
 	/**
 	 * checkBoundsAndCorrectIfNeeded
@@ -366,14 +340,6 @@ private:
 	 */
 	int16_t checkRITBoundariesAndCorrectIfNeeded(int16_t newRitOffsetHz);
 
-	/**
-	 * initializeKeyOutPin
-	 * 
-	 * @detail
-	 *   Sets up the output pin that keys the 49er to transmit
-	 */
-	void initializeKeyOutPin();
-
 	/**
 	 * initiateRITStatusChange
 	 * 
@@ -384,18 +350,6 @@ private:
 	 * @param[in] ritStatus The new rit status (enabled or disabled)
 	 */
 	void initiateRITStatusChange(RitStatus ritStatus);
-
-	/**
-	 * switchTXRXFrequencyAndStatus
-	 * 
-	 * @detail
-	 *   Does either:
-	 *   Send the TX frequency to the DDS and key the transmitter
-	 *   Unkey the transmitter and send the RX frequency to the DDS
-	 *   
-	 * @param[in] keyStatus status of the key 
-	 */
-	void sendToDDSTxRxFrequencyAndChangeTxRxStatus(int16_t keyStatus);
 };
 
 #endif
\ No newline at end of file
@@ -18,13 +18,13 @@
 
 #include "Arduino.h"
 
-#include "EventManager.h"
+#include "SCRadioEventQueue.h"
 
 #include "SCRadioConstants.h"
 
 #include "SCRadioVoltageMonitor.h"
 
-SCRadioVoltageMonitor::SCRadioVoltageMonitor(EventManager &eventManager,
+SCRadioVoltageMonitor::SCRadioVoltageMonitor(SCRadioEventQueue &eventManager,
 											int8_t arduinoPinToRead,
 											float   voltageCalcMultiplier,
 											EventType voltageChangedEventTypeCode,
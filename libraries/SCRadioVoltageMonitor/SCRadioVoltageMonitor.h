@@ -28,7 +28,7 @@ private:
 	 * The event manager is used to enqueue messages that tell the
 	 * remaining logic that the voltage has changed.
 	 */
-	EventManager &_eventManager;
+	SCRadioEventQueue &_eventManager;
 
 	int8_t _arduinoPinToRead;
 
@@ -87,7 +87,7 @@ public:
 	 *                         this value, we will read the voltage and
 	 *                         reset the counter.
 	 */
-	SCRadioVoltageMonitor(EventManager &eventManager, 
+	SCRadioVoltageMonitor(SCRadioEventQueue &eventManager, 
 							int8_t arduinoPinToRead,
 							float voltageCalcMultiplier,
 							EventType voltageChangedEventTypeCode, 